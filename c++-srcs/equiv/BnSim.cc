@@ -0,0 +1,341 @@
+
+/// @file BnSim.cc
+/// @brief BnSim の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "BnSim.h"
+#include "ym/BnNetwork.h"
+#include "ym/BnNode.h"
+#include "ym/Range.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_MAGUS
+
+BEGIN_NONAMESPACE
+
+// 全ビットが1の語
+const std::uint64_t kAll1 = ~0UL;
+
+// MUX の値を計算する．
+inline
+std::uint64_t
+mux_val(
+  std::uint64_t cval,
+  std::uint64_t val0,
+  std::uint64_t val1
+)
+{
+  return (~cval & val0) | (cval & val1);
+}
+
+// 1語の真理値表で表せる入力数
+const SizeType kTvWordInputs = 6;
+
+// BDD の枝の値を得る．
+inline
+std::uint64_t
+edge_val(
+  SizeType edge,
+  const vector<std::uint64_t>& val_array
+)
+{
+  if ( edge == 0 ) {
+    return 0UL;
+  }
+  if ( edge == 1 ) {
+    return kAll1;
+  }
+  SizeType node = BddInfo::edge2node(edge);
+  bool inv = BddInfo::edge2inv(edge);
+  auto val = val_array[node];
+  if ( inv ) {
+    val = ~val;
+  }
+  return val;
+}
+
+END_NONAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+// クラス BnSim
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+//
+// ノードごとの評価方法はここで一度だけ求めておき，
+// simulate() ではノードの種類ごとの配列を読むだけにする．
+BnSim::BnSim(
+  const BnNetwork& network
+) : mNetwork{network},
+    mValArray(network.node_num(), 0UL),
+    mTvVals(1U << kTvWordInputs, 0UL)
+{
+  SizeType max_fanin = 0;
+  SizeType max_bdd = 0;
+  // logic_list() はトポロジカル順に並んでいる．
+  for ( auto node: mNetwork.logic_list() ) {
+    NodePlan plan;
+    plan.mId = node.id();
+    plan.mType = node.type();
+    plan.mPrimType = PrimType::None;
+    plan.mFaninBegin = mFaninIdArray.size();
+    plan.mFaninNum = node.fanin_num();
+    plan.mDataId = 0;
+    for ( auto inode: node.fanin_list() ) {
+      mFaninIdArray.push_back(inode.id());
+    }
+    max_fanin = std::max<SizeType>(max_fanin, plan.mFaninNum);
+
+    switch ( node.type() ) {
+    case BnNodeType::Prim:
+      plan.mPrimType = node.primitive_type();
+      break;
+
+    case BnNodeType::Expr:
+      plan.mDataId = node.expr_id();
+      break;
+
+    case BnNodeType::TvFunc:
+      {
+	// 真理値表を語単位に詰めておく．
+	auto& func = mNetwork.func(node.func_id());
+	SizeType ni = func.input_num();
+	SizeType nexp = 1U << ni;
+	TvPlan tv_plan;
+	tv_plan.mInputNum = ni;
+	tv_plan.mTable.resize((nexp + 63) / 64, 0UL);
+	for ( SizeType m = 0; m < nexp; ++ m ) {
+	  if ( func.value(m) ) {
+	    tv_plan.mTable[m / 64] |= 1UL << (m % 64);
+	  }
+	}
+	plan.mDataId = mTvList.size();
+	mTvList.push_back(std::move(tv_plan));
+      }
+      break;
+
+    case BnNodeType::Bdd:
+      {
+	// 下位のインデックスから順に並べた MUX のリストに変換する．
+	// ノード番号は 1 から始まる．
+	BddPlan bdd_plan;
+	auto node_list = node.bdd().node_info(bdd_plan.mRoot);
+	SizeType max_index = 0;
+	for ( auto& info: node_list ) {
+	  max_index = std::max<SizeType>(max_index, info.index() + 1);
+	}
+	vector<vector<MuxOp>> indexed_list(max_index);
+	SizeType id = 1;
+	for ( auto& info: node_list ) {
+	  indexed_list[info.index()].push_back(MuxOp{id, info.index(),
+						     info.edge0(), info.edge1()});
+	  ++ id;
+	}
+	bdd_plan.mMuxList.reserve(node_list.size());
+	for ( SizeType i = max_index; i > 0; -- i ) {
+	  for ( auto& op: indexed_list[i - 1] ) {
+	    bdd_plan.mMuxList.push_back(op);
+	  }
+	}
+	max_bdd = std::max<SizeType>(max_bdd, node_list.size() + 1);
+	plan.mDataId = mBddList.size();
+	mBddList.push_back(std::move(bdd_plan));
+      }
+      break;
+
+    default:
+      ASSERT_NOT_REACHED;
+      break;
+    }
+    mPlanList.push_back(plan);
+  }
+  mFaninVals.resize(max_fanin, 0UL);
+  mBddVals.resize(max_bdd, 0UL);
+}
+
+// @brief シミュレーションを行う．
+vector<std::uint64_t>
+BnSim::simulate(
+  const vector<std::uint64_t>& input_vals
+)
+{
+  SizeType ni = mNetwork.input_num();
+  ASSERT_COND( input_vals.size() == ni );
+  for ( auto i: Range(ni) ) {
+    mValArray[mNetwork.input_id(i)] = input_vals[i];
+  }
+
+  for ( auto& plan: mPlanList ) {
+    auto src = &mFaninIdArray[plan.mFaninBegin];
+    for ( SizeType i = 0; i < plan.mFaninNum; ++ i ) {
+      mFaninVals[i] = mValArray[src[i]];
+    }
+    mValArray[plan.mId] = eval_node(plan);
+  }
+
+  vector<std::uint64_t> output_vals;
+  output_vals.reserve(mNetwork.output_num());
+  for ( auto node: mNetwork.output_list() ) {
+    output_vals.push_back(mValArray[node.output_src().id()]);
+  }
+  return output_vals;
+}
+
+// @brief 論理ノードの値を計算する．
+std::uint64_t
+BnSim::eval_node(
+  const NodePlan& plan
+)
+{
+  switch ( plan.mType ) {
+  case BnNodeType::Prim:
+    {
+      std::uint64_t and_val = kAll1;
+      std::uint64_t or_val = 0UL;
+      std::uint64_t xor_val = 0UL;
+      for ( SizeType i = 0; i < plan.mFaninNum; ++ i ) {
+	auto val = mFaninVals[i];
+	and_val &= val;
+	or_val |= val;
+	xor_val ^= val;
+      }
+      switch ( plan.mPrimType ) {
+      case PrimType::C0:   return 0UL;
+      case PrimType::C1:   return kAll1;
+      case PrimType::Buff: return mFaninVals[0];
+      case PrimType::Not:  return ~mFaninVals[0];
+      case PrimType::And:  return and_val;
+      case PrimType::Nand: return ~and_val;
+      case PrimType::Or:   return or_val;
+      case PrimType::Nor:  return ~or_val;
+      case PrimType::Xor:  return xor_val;
+      case PrimType::Xnor: return ~xor_val;
+      case PrimType::None: break;
+      }
+    }
+    break;
+
+  case BnNodeType::Expr:
+    return eval_expr(mNetwork.expr(plan.mDataId));
+
+  case BnNodeType::TvFunc:
+    return eval_tv(mTvList[plan.mDataId]);
+
+  case BnNodeType::Bdd:
+    return eval_bdd(mBddList[plan.mDataId]);
+
+  default:
+    break;
+  }
+  ASSERT_NOT_REACHED;
+  return 0UL;
+}
+
+// @brief 論理式の値を計算する．
+std::uint64_t
+BnSim::eval_expr(
+  const Expr& expr
+)
+{
+  if ( expr.is_zero() ) {
+    return 0UL;
+  }
+  if ( expr.is_one() ) {
+    return kAll1;
+  }
+  if ( expr.is_posi_literal() ) {
+    auto var = expr.varid();
+    ASSERT_COND( var < mFaninVals.size() );
+    return mFaninVals[var];
+  }
+  if ( expr.is_nega_literal() ) {
+    auto var = expr.varid();
+    ASSERT_COND( var < mFaninVals.size() );
+    return ~mFaninVals[var];
+  }
+
+  if ( expr.is_and() ) {
+    std::uint64_t val = kAll1;
+    for ( auto& opr: expr.operand_list() ) {
+      val &= eval_expr(opr);
+    }
+    return val;
+  }
+  if ( expr.is_or() ) {
+    std::uint64_t val = 0UL;
+    for ( auto& opr: expr.operand_list() ) {
+      val |= eval_expr(opr);
+    }
+    return val;
+  }
+  if ( expr.is_xor() ) {
+    std::uint64_t val = 0UL;
+    for ( auto& opr: expr.operand_list() ) {
+      val ^= eval_expr(opr);
+    }
+    return val;
+  }
+
+  ASSERT_NOT_REACHED;
+  return 0UL;
+}
+
+// @brief TvFunc の値を計算する．
+std::uint64_t
+BnSim::eval_tv(
+  const TvPlan& tv_plan
+)
+{
+  SizeType ni = tv_plan.mInputNum;
+  if ( ni <= kTvWordInputs ) {
+    // 真理値表の各ビットを語に広げてから
+    // 上位の入力から順に MUX で畳み込む．
+    auto table = tv_plan.mTable[0];
+    SizeType nexp = 1U << ni;
+    for ( SizeType m = 0; m < nexp; ++ m ) {
+      mTvVals[m] = ((table >> m) & 1UL) ? kAll1 : 0UL;
+    }
+    for ( SizeType k = ni; k > 0; -- k ) {
+      auto cval = mFaninVals[k - 1];
+      SizeType half = 1U << (k - 1);
+      for ( SizeType m = 0; m < half; ++ m ) {
+	mTvVals[m] = mux_val(cval, mTvVals[m], mTvVals[m + half]);
+      }
+    }
+    return mTvVals[0];
+  }
+
+  // 入力数が多い時は語を展開すると大きくなりすぎるので
+  // パタンごとに真理値表を引く．
+  std::uint64_t ans = 0UL;
+  for ( SizeType b = 0; b < 64; ++ b ) {
+    SizeType m = 0;
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      m |= ((mFaninVals[i] >> b) & 1UL) << i;
+    }
+    if ( (tv_plan.mTable[m / 64] >> (m % 64)) & 1UL ) {
+      ans |= 1UL << b;
+    }
+  }
+  return ans;
+}
+
+// @brief BDD の値を計算する．
+std::uint64_t
+BnSim::eval_bdd(
+  const BddPlan& bdd_plan
+)
+{
+  for ( auto& op: bdd_plan.mMuxList ) {
+    auto val0 = edge_val(op.mEdge0, mBddVals);
+    auto val1 = edge_val(op.mEdge1, mBddVals);
+    mBddVals[op.mNode] = mux_val(mFaninVals[op.mVar], val0, val1);
+  }
+  return edge_val(bdd_plan.mRoot, mBddVals);
+}
+
+END_NAMESPACE_MAGUS
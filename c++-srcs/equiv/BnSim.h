@@ -0,0 +1,188 @@
+#ifndef BNSIM_H
+#define BNSIM_H
+
+/// @file BnSim.h
+/// @brief BnSim のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "magus.h"
+#include "ym/bnet.h"
+#include "ym/Expr.h"
+#include "ym/TvFunc.h"
+#include "ym/Bdd.h"
+
+
+BEGIN_NAMESPACE_MAGUS
+
+//////////////////////////////////////////////////////////////////////
+/// @class BnSim BnSim.h "BnSim.h"
+/// @brief BnNetwork の 64 ビット並列の論理シミュレーションを行うクラス
+///
+/// 1語の各ビットがそれぞれ1つの入力パタンに対応する．
+//////////////////////////////////////////////////////////////////////
+class BnSim
+{
+public:
+
+  /// @brief コンストラクタ
+  BnSim(
+    const BnNetwork& network ///< [in] 対象のネットワーク
+  );
+
+  /// @brief デストラクタ
+  ~BnSim() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief シミュレーションを行う．
+  /// @return 出力番号の順に出力の値を返す．
+  vector<std::uint64_t>
+  simulate(
+    const vector<std::uint64_t>& input_vals ///< [in] 入力番号の順の入力の値
+  );
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 論理ノードの評価方法
+  struct NodePlan
+  {
+    // ノード番号
+    SizeType mId;
+
+    // ノードの種類
+    BnNodeType mType;
+
+    // プリミティブの種類
+    // mType が BnNodeType::Prim の時のみ意味を持つ．
+    PrimType mPrimType;
+
+    // mFaninIdArray 上のファンインの開始位置
+    SizeType mFaninBegin;
+
+    // ファンイン数
+    SizeType mFaninNum;
+
+    // 関数の番号
+    // Expr の時は論理式番号，TvFunc の時は mTvList 上の位置，
+    // Bdd の時は mBddList 上の位置を表す．
+    SizeType mDataId;
+  };
+
+  // TvFunc の評価用の真理値表
+  struct TvPlan
+  {
+    // 入力数
+    SizeType mInputNum;
+
+    // 真理値表
+    // 入力の値を2進数とみなした位置のビットに関数値を詰めて格納する．
+    vector<std::uint64_t> mTable;
+  };
+
+  // BDD のノードに対応する MUX
+  struct MuxOp
+  {
+    // 結果を格納する位置
+    SizeType mNode;
+
+    // 制御入力のファンイン番号
+    SizeType mVar;
+
+    // 0 の時の枝
+    SizeType mEdge0;
+
+    // 1 の時の枝
+    SizeType mEdge1;
+  };
+
+  // BDD の評価用の MUX のリスト
+  struct BddPlan
+  {
+    // 下位のインデックスから順に並べた MUX のリスト
+    vector<MuxOp> mMuxList;
+
+    // 根の枝
+    SizeType mRoot;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 論理ノードの値を計算する．
+  ///
+  /// ファンインの値は mFaninVals に入っているものとする．
+  std::uint64_t
+  eval_node(
+    const NodePlan& plan ///< [in] 評価方法
+  );
+
+  /// @brief 論理式の値を計算する．
+  std::uint64_t
+  eval_expr(
+    const Expr& expr ///< [in] 論理式
+  );
+
+  /// @brief TvFunc の値を計算する．
+  std::uint64_t
+  eval_tv(
+    const TvPlan& tv_plan ///< [in] 真理値表
+  );
+
+  /// @brief BDD の値を計算する．
+  std::uint64_t
+  eval_bdd(
+    const BddPlan& bdd_plan ///< [in] MUX のリスト
+  );
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 対象のネットワーク
+  const BnNetwork& mNetwork;
+
+  // ノード番号をキーにして値を格納する配列
+  vector<std::uint64_t> mValArray;
+
+  // トポロジカル順に並べた論理ノードの評価方法のリスト
+  vector<NodePlan> mPlanList;
+
+  // 論理ノードのファンインのノード番号を並べた配列
+  vector<SizeType> mFaninIdArray;
+
+  // TvFunc の真理値表のリスト
+  vector<TvPlan> mTvList;
+
+  // BDD の MUX のリストのリスト
+  vector<BddPlan> mBddList;
+
+  // 評価中のノードのファンインの値を入れる作業領域
+  vector<std::uint64_t> mFaninVals;
+
+  // eval_tv() で用いる作業領域
+  vector<std::uint64_t> mTvVals;
+
+  // eval_bdd() で用いる作業領域
+  vector<std::uint64_t> mBddVals;
+
+};
+
+END_NAMESPACE_MAGUS
+
+#endif // BNSIM_H
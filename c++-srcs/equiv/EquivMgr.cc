@@ -9,13 +9,150 @@
 #include "EquivMgr.h"
 #include "FraigMgr.h"
 #include "FraigEnc.h"
+#include "BnSim.h"
+#include "SeqEnc.h"
 #include "ym/BnNetwork.h"
 #include "ym/BnNode.h"
 #include "ym/Range.h"
+#include <random>
+#include <map>
+#include <chrono>
 
 
 BEGIN_NAMESPACE_MAGUS
 
+BEGIN_NONAMESPACE
+
+// DFF の対応を求めるためのシミュレーションの時刻数
+const SizeType kSimFrames = 16;
+
+// 名前で対応を取る．
+// names2 の i 番目の要素に対応する names1 の位置を map2[i] に入れる．
+bool
+match_names(
+  const vector<string>& names1,
+  const vector<string>& names2,
+  vector<SizeType>& map2
+)
+{
+  unordered_map<string, SizeType> pos_map;
+  for ( SizeType i = 0; i < names1.size(); ++ i ) {
+    pos_map.emplace(names1[i], i);
+  }
+  map2.clear();
+  map2.reserve(names2.size());
+  for ( auto& name: names2 ) {
+    if ( pos_map.count(name) == 0 ) {
+      return false;
+    }
+    map2.push_back(pos_map.at(name));
+  }
+  return true;
+}
+
+// 初期状態からのランダムシミュレーションで DFF の対応の候補を求める．
+// 全ての時刻で値の等しい DFF を対応させる．
+// 候補が誤っていても帰納法の中で取り除かれる．
+vector<pair<SizeType, SizeType>>
+match_dff_by_sim(
+  SeqEnc& enc1,
+  SeqEnc& enc2,
+  const vector<SizeType>& pi2_list
+)
+{
+  SizeType npi = enc1.pi_num();
+  SizeType nd1 = enc1.dff_num();
+  SizeType nd2 = enc2.dff_num();
+  vector<std::uint64_t> state1(nd1, 0UL);
+  vector<std::uint64_t> state2(nd2, 0UL);
+  vector<vector<std::uint64_t>> sig1(nd1);
+  vector<vector<std::uint64_t>> sig2(nd2);
+  vector<std::uint64_t> pi1(npi);
+  vector<std::uint64_t> pi2(npi);
+  vector<std::uint64_t> po1;
+  vector<std::uint64_t> po2;
+  vector<std::uint64_t> next1;
+  vector<std::uint64_t> next2;
+  std::mt19937 rand_gen;
+  std::uniform_int_distribution<std::uint64_t> rd;
+  for ( SizeType t = 0; t < kSimFrames; ++ t ) {
+    for ( auto& val: pi1 ) {
+      val = rd(rand_gen);
+    }
+    for ( SizeType i = 0; i < npi; ++ i ) {
+      pi2[i] = pi1[pi2_list[i]];
+    }
+    enc1.simulate(pi1, state1, po1, next1);
+    enc2.simulate(pi2, state2, po2, next2);
+    state1.swap(next1);
+    state2.swap(next2);
+    for ( SizeType i = 0; i < nd1; ++ i ) {
+      sig1[i].push_back(state1[i]);
+    }
+    for ( SizeType i = 0; i < nd2; ++ i ) {
+      sig2[i].push_back(state2[i]);
+    }
+  }
+
+  // シグネチャをキーにして回路1の DFF 番号のリストを格納する辞書
+  std::map<vector<std::uint64_t>, vector<SizeType>> sig_map;
+  for ( SizeType i = 0; i < nd1; ++ i ) {
+    sig_map[sig1[i]].push_back(i);
+  }
+  // 同じシグネチャの DFF が複数ある時は番号順に1対1に対応させる．
+  // 回路1の DFF が足りない場合は最後のものを重複して用いる．
+  std::map<vector<std::uint64_t>, SizeType> used_map;
+  vector<pair<SizeType, SizeType>> cand_list;
+  for ( SizeType i = 0; i < nd2; ++ i ) {
+    auto p = sig_map.find(sig2[i]);
+    if ( p == sig_map.end() ) {
+      continue;
+    }
+    auto& dff_list = p->second;
+    auto& pos = used_map[sig2[i]];
+    cand_list.push_back(make_pair(dff_list[pos], i));
+    if ( pos + 1 < dff_list.size() ) {
+      ++ pos;
+    }
+  }
+  return cand_list;
+}
+
+// 結果が True でない候補を取り除く．
+// 取り除いた候補があれば true を返す．
+bool
+remove_cands(
+  vector<pair<SizeType, SizeType>>& cand_list,
+  const vector<SatBool3>& cand_stats
+)
+{
+  SizeType n = cand_list.size();
+  SizeType wpos = 0;
+  for ( SizeType i = 0; i < n; ++ i ) {
+    if ( cand_stats[i] == SatBool3::True ) {
+      cand_list[wpos] = cand_list[i];
+      ++ wpos;
+    }
+  }
+  cand_list.resize(wpos);
+  return wpos < n;
+}
+
+// 2つのハンドルの XOR を作る．
+FraigHandle
+make_diff(
+  FraigMgr& mgr,
+  FraigHandle handle1,
+  FraigHandle handle2
+)
+{
+  auto tmp1 = mgr.make_and( handle1, ~handle2);
+  auto tmp2 = mgr.make_and(~handle1,  handle2);
+  return ~mgr.make_and(~tmp1, ~tmp2);
+}
+
+END_NONAMESPACE
+
 //////////////////////////////////////////////////////////////////////
 // クラス EquivMgr
 //////////////////////////////////////////////////////////////////////
@@ -31,6 +168,11 @@ EquivMgr::EquivMgr(
 {
 }
 
+// @brief デストラクタ
+EquivMgr::~EquivMgr()
+{
+}
+
 // @brief 2つの回路が等価かどうか調べる．
 EquivResult
 EquivMgr::check(
@@ -48,51 +190,12 @@ EquivMgr::check(
     return SatBool3::False;
   }
 
-  vector<SizeType> input2_list(ni);
-  vector<SizeType> output2_list(no);
-  if ( match_by_name ) {
-    // 名前による対応
-    // 入力名をキーにして network1 の入力位置を格納する辞書
-    unordered_map<string, SizeType> input_map;
-    for ( SizeType i = 0; i < ni; ++ i ) {
-      auto node = network1.input_node(i);
-      input_map.emplace(node.name(), i);
-    }
-    // 入力の対応付を行う．
-    for ( SizeType i = 0; i < ni; ++ i ) {
-      auto node = network2.input_node(i);
-      auto name = node.name();
-      if ( input_map.count(name) == 0 ) {
-	// 入力名が未対応
-	return EquivResult{SatBool3::False, vector<SatBool3>(no, SatBool3::False)};
-      }
-      input2_list[i] = input_map.at(name);
-    }
-    // 出力名をキーにして network1 の出力位置を格納する辞書
-    unordered_map<string, SizeType> output_map;
-    for ( SizeType i = 0; i < no; ++ i ) {
-      auto node = network1.output_node(i);
-      output_map.emplace(node.name(), i);
-    }
-    // 出力の対応付を行う．
-    for ( SizeType i = 0; i < no; ++ i ) {
-      auto node = network2.output_node(i);
-      auto name = node.name();
-      if ( output_map.count(name) == 0 ) {
-	// 出力名が未対応
-	return EquivResult{SatBool3::False, vector<SatBool3>(no, SatBool3::False)};
-      }
-      output2_list[i] = output_map.at(name);
-    }
-  }
-  else {
-    // 順序による対応
-    for ( SizeType i: Range(ni) ) {
-      input2_list[i] = i;
-    }
-    for ( SizeType i: Range(no) ) {
-      output2_list[i] = i;
-    }
+  vector<SizeType> input2_list;
+  vector<SizeType> output2_list;
+  if ( !match_io(network1, network2, match_by_name,
+		 input2_list, output2_list) ) {
+    // 入出力名が未対応
+    return EquivResult{SatBool3::False, vector<SatBool3>(no, SatBool3::False)};
   }
 
   return check(network1, network2, input2_list, output2_list);
@@ -118,6 +221,9 @@ EquivMgr::check(
 
   // FraigMgr を初期化する．
   FraigMgr fraig_mgr{mSigSize, mInitParam};
+  fraig_mgr.set_sweep_mode(mSweepMode);
+  fraig_mgr.set_sat_budget(mConflictBudget, mPropagationBudget);
+  fraig_mgr.set_time_limit(mTimeLimit);
 
   // 外部入力に対応する FraigHandle を作る．
   vector<FraigHandle> input1_handles(ni);
@@ -138,23 +244,197 @@ EquivMgr::check(
   }
   auto output2_handles = enc(network2, input2_handles);
 
+  // 等価なノードをまとめて求める．
+  fraig_mgr.sweep();
+
   // 各出力の等価検証を行う．
-  vector<SatBool3> eq_stats(no);
-  SatBool3 stat = SatBool3::True;
+  vector<pair<FraigHandle, FraigHandle>> pair_list(no);
   for ( auto i: Range(no) ) {
-    if ( log_level() > 2 ) {
-      log_out() << "Checking Output#" << (i + 1) << " / " << no << endl;
-    }
+    pair_list[i] = make_pair(output1_handles[output2_list[i]], output2_handles[i]);
+  }
+  return check_outputs(fraig_mgr, pair_list);
+}
+
+// @brief 参照回路を設定する．
+void
+EquivMgr::set_reference(
+  const BnNetwork& network1
+)
+{
+  clear_reference();
+
+  mRefNetwork = &network1;
+  mRefMgr.reset(new FraigMgr{mSigSize, mInitParam});
+  mRefMgr->set_sweep_mode(mSweepMode);
+  mRefMgr->set_sat_budget(mConflictBudget, mPropagationBudget);
+  mRefMgr->set_time_limit(mTimeLimit);
+
+  SizeType ni = network1.input_num();
+  mRefInputs.resize(ni);
+  for ( auto i: Range(ni) ) {
+    mRefInputs[i] = mRefMgr->make_input();
+  }
+
+  FraigEnc enc{*mRefMgr};
+  mRefOutputs = enc(network1, mRefInputs);
+
+  // 参照回路の等価なノードはここで求めておく．
+  mRefMgr->sweep();
+}
+
+// @brief 参照回路を破棄する．
+void
+EquivMgr::clear_reference()
+{
+  mRefNetwork = nullptr;
+  mRefMgr.reset();
+  mRefInputs.clear();
+  mRefOutputs.clear();
+}
+
+// @brief 参照回路の SATソルバの変数の数を返す．
+SizeType
+EquivMgr::reference_sat_variable_num() const
+{
+  ASSERT_COND( has_reference() );
+
+  return mRefMgr->sat_variable_num();
+}
+
+// @brief 参照回路の SATソルバの有効な節の数を返す．
+SizeType
+EquivMgr::reference_sat_clause_num() const
+{
+  ASSERT_COND( has_reference() );
+
+  return mRefMgr->sat_clause_num();
+}
+
+// @brief 修正後の回路が参照回路と等価かどうか調べる．
+EquivResult
+EquivMgr::check_revision(
+  const BnNetwork& network2,
+  bool match_by_name
+)
+{
+  ASSERT_COND( has_reference() );
+
+  const auto& network1 = *mRefNetwork;
+  SizeType ni = network1.input_num();
+  if ( network2.input_num() != ni ) {
+    return SatBool3::False;
+  }
+  SizeType no = network1.output_num();
+  if ( network2.output_num() != no ) {
+    return SatBool3::False;
+  }
 
-    auto h1 = output1_handles[output2_list[i]];
-    auto h2 = output2_handles[i];
+  vector<SizeType> input2_list;
+  vector<SizeType> output2_list;
+  if ( !match_io(network1, network2, match_by_name,
+		 input2_list, output2_list) ) {
+    // 入出力名が未対応
+    return EquivResult{SatBool3::False, vector<SatBool3>(no, SatBool3::False)};
+  }
+
+  return check_revision(network2, input2_list, output2_list);
+}
+
+// @brief 修正後の回路が参照回路と等価かどうか調べる．
+EquivResult
+EquivMgr::check_revision(
+  const BnNetwork& network2,
+  const vector<SizeType>& input2_list,
+  const vector<SizeType>& output2_list
+)
+{
+  ASSERT_COND( has_reference() );
+
+  SizeType ni = mRefInputs.size();
+  ASSERT_COND( network2.input_num() == ni );
+  ASSERT_COND( input2_list.size() == ni );
+
+  SizeType no = mRefOutputs.size();
+  ASSERT_COND( network2.output_num() == no );
+  ASSERT_COND( output2_list.size() == no );
+
+  auto& fraig_mgr = *mRefMgr;
+  fraig_mgr.set_sat_budget(mConflictBudget, mPropagationBudget);
+  fraig_mgr.set_time_limit(mTimeLimit);
+
+  // 参照回路の入力のハンドルの上に修正後の回路の AIG を作る．
+  // 変更のない部分は構造ハッシュで参照回路のノードになる．
+  vector<FraigHandle> input2_handles(ni);
+  for ( auto i: Range(ni) ) {
+    input2_handles[i] = mRefInputs[input2_list[i]];
+  }
+  SizeType old_num = fraig_mgr.node_num();
+  fraig_mgr.begin_revision();
+  FraigEnc enc{fraig_mgr};
+  auto output2_handles = enc(network2, input2_handles);
+  if ( log_level() > 2 ) {
+    log_out() << "Revision added " << (fraig_mgr.node_num() - old_num)
+	      << " nodes" << endl;
+  }
+
+  // 新たに作られたノードのみが処理される．
+  fraig_mgr.sweep();
+
+  vector<pair<FraigHandle, FraigHandle>> pair_list(no);
+  for ( auto i: Range(no) ) {
+    pair_list[i] = make_pair(mRefOutputs[output2_list[i]], output2_handles[i]);
+  }
+  auto result = check_outputs(fraig_mgr, pair_list);
+
+  // この修正版のノードは次の修正版では使わないので削除しておく．
+  // SATソルバの修正版の節もここで無効になる．
+  // 加えられたシミュレーションパタンは参照回路のノードに残る．
+  fraig_mgr.truncate(old_num);
+
+  return result;
+}
 
-    SatBool3 stat1;
-    if ( h1 == h2 ) {
-      stat1 = SatBool3::True;
+// @brief 各出力の対の等価検証を行う．
+EquivResult
+EquivMgr::check_outputs(
+  FraigMgr& fraig_mgr,
+  const vector<pair<FraigHandle, FraigHandle>>& pair_list
+)
+{
+  SizeType no = pair_list.size();
+  if ( log_level() > 2 ) {
+    log_out() << "Checking " << no << " outputs";
+    if ( mThreadNum > 1 ) {
+      log_out() << " with " << mThreadNum << " threads";
     }
-    else {
-      stat1 = fraig_mgr.check_equiv(h1, h2);
+    log_out() << endl;
+  }
+  vector<vector<bool>> cex_list;
+  auto eq_stats = fraig_mgr.check_equiv_mt(pair_list, mThreadNum, cex_list);
+
+  SatBool3 stat = SatBool3::True;
+  for ( auto i: Range(no) ) {
+    auto stat1 = eq_stats[i];
+    if ( stat1 == SatBool3::X &&
+	 (mConflictBudget > 0 || mPropagationBudget > 0) ) {
+      // 制限を増やしてやり直す．
+      auto h1 = fraig_mgr.rep_handle(pair_list[i].first);
+      auto h2 = fraig_mgr.rep_handle(pair_list[i].second);
+      auto conflict_budget = mConflictBudget;
+      auto propagation_budget = mPropagationBudget;
+      for ( SizeType r = 0; r < mRetryNum && !fraig_mgr.time_over(); ++ r ) {
+	conflict_budget *= kBudgetRatio;
+	propagation_budget *= kBudgetRatio;
+	fraig_mgr.set_sat_budget(conflict_budget, propagation_budget);
+	stat1 = fraig_mgr.check_equiv(h1, h2);
+	if ( stat1 == SatBool3::False ) {
+	  cex_list[i] = fraig_mgr.get_cex(h1, h2);
+	}
+	if ( stat1 != SatBool3::X ) {
+	  break;
+	}
+      }
+      fraig_mgr.set_sat_budget(mConflictBudget, mPropagationBudget);
     }
     eq_stats[i] = stat1;
     if ( stat1 == SatBool3::X ) {
@@ -166,7 +446,7 @@ EquivMgr::check(
       }
     }
     if ( log_level() > 2 ) {
-      log_out() << "  => ";
+      log_out() << "Output#" << (i + 1) << " / " << no << " => ";
       switch ( stat1 ) {
       case SatBool3::True:  log_out() << "Equivalent" << endl; break;
       case SatBool3::False: log_out() << "Not Equivalent" << endl; break;
@@ -179,7 +459,427 @@ EquivMgr::check(
     fraig_mgr.dump_stats(log_out());
   }
 
-  return EquivResult(stat, eq_stats);
+  return EquivResult(stat, eq_stats, cex_list);
+}
+
+// @brief 2つの順序回路が等価かどうか調べる．
+EquivResult
+EquivMgr::check_seq(
+  const BnNetwork& network1,
+  const BnNetwork& network2,
+  bool match_by_name
+)
+{
+  SeqEnc enc1{network1};
+  SeqEnc enc2{network2};
+
+  SizeType npi = enc1.pi_num();
+  SizeType npo = enc1.po_num();
+  if ( enc2.pi_num() != npi || enc2.po_num() != npo ) {
+    return SatBool3::False;
+  }
+  if ( !enc1.is_supported() || !enc2.is_supported() ) {
+    // 扱えない DFF を含んでいる．
+    return EquivResult{SatBool3::X, vector<SatBool3>(npo, SatBool3::X)};
+  }
+
+  // 外部入力と外部出力の対応を取る．
+  vector<SizeType> pi2_list(npi);
+  vector<SizeType> po2_list(npo);
+  if ( match_by_name ) {
+    if ( !match_names(enc1.pi_name_list(), enc2.pi_name_list(), pi2_list) ||
+	 !match_names(enc1.po_name_list(), enc2.po_name_list(), po2_list) ) {
+      // 入出力名が未対応
+      return EquivResult{SatBool3::False, vector<SatBool3>(npo, SatBool3::False)};
+    }
+  }
+  else {
+    for ( SizeType i: Range(npi) ) {
+      pi2_list[i] = i;
+    }
+    for ( SizeType i: Range(npo) ) {
+      po2_list[i] = i;
+    }
+  }
+
+  // DFF の対応の候補を求める．
+  vector<pair<SizeType, SizeType>> cand_list;
+  if ( match_by_name ) {
+    unordered_map<string, SizeType> dff_map;
+    auto name_list1 = enc1.dff_name_list();
+    for ( SizeType i = 0; i < name_list1.size(); ++ i ) {
+      dff_map.emplace(name_list1[i], i);
+    }
+    auto name_list2 = enc2.dff_name_list();
+    for ( SizeType i = 0; i < name_list2.size(); ++ i ) {
+      if ( dff_map.count(name_list2[i]) > 0 ) {
+	cand_list.push_back(make_pair(dff_map.at(name_list2[i]), i));
+      }
+    }
+  }
+  else {
+    cand_list = match_dff_by_sim(enc1, enc2, pi2_list);
+  }
+
+  // 残りの制限時間を求める．
+  // 制限のない時は 0.0 を返す．
+  auto start = std::chrono::steady_clock::now();
+  auto remaining_time = [&]() -> double {
+    if ( mTimeLimit <= 0.0 ) {
+      return 0.0;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return mTimeLimit - elapsed.count();
+  };
+
+  EquivResult abort_result{SatBool3::X, vector<SatBool3>(npo, SatBool3::X)};
+  vector<SatBool3> po_stats;
+  vector<SatBool3> cand_stats;
+  vector<vector<bool>> po_cex_list;
+  for ( SizeType depth = 1; depth <= mInductionDepth; ++ depth ) {
+    for ( ; ; ) {
+      if ( log_level() > 2 ) {
+	log_out() << "depth = " << depth
+		  << ", # of DFF pairs = " << cand_list.size() << endl;
+      }
+
+      // 基底: 初期状態から depth 時刻の間性質が成り立つか調べる．
+      auto time_limit = remaining_time();
+      if ( mTimeLimit > 0.0 && time_limit <= 0.0 ) {
+	return abort_result;
+      }
+      check_frames(enc1, enc2, pi2_list, po2_list, cand_list,
+		   depth, true, time_limit, po_stats, cand_stats, po_cex_list);
+      bool po_false = false;
+      bool po_x = false;
+      for ( auto stat: po_stats ) {
+	if ( stat == SatBool3::False ) {
+	  po_false = true;
+	}
+	else if ( stat == SatBool3::X ) {
+	  po_x = true;
+	}
+      }
+      if ( po_false ) {
+	// 初期状態から到達可能な状態で外部出力が異なる．
+	vector<SatBool3> eq_stats(npo, SatBool3::X);
+	for ( SizeType i: Range(npo) ) {
+	  if ( po_stats[i] == SatBool3::False ) {
+	    eq_stats[i] = SatBool3::False;
+	  }
+	}
+	return EquivResult{SatBool3::False, eq_stats, po_cex_list};
+      }
+      if ( po_x ) {
+	return abort_result;
+      }
+      if ( remove_cands(cand_list, cand_stats) ) {
+	// 対応の誤っていた DFF を除いてやり直す．
+	continue;
+      }
+
+      // 帰納: depth 時刻の間性質が成り立つならば次の時刻でも成り立つか調べる．
+      time_limit = remaining_time();
+      if ( mTimeLimit > 0.0 && time_limit <= 0.0 ) {
+	return abort_result;
+      }
+      check_frames(enc1, enc2, pi2_list, po2_list, cand_list,
+		   depth, false, time_limit, po_stats, cand_stats, po_cex_list);
+      if ( remove_cands(cand_list, cand_stats) ) {
+	// 帰納的でない DFF の対を除いてやり直す．
+	continue;
+      }
+      bool proved = true;
+      for ( auto stat: po_stats ) {
+	if ( stat != SatBool3::True ) {
+	  proved = false;
+	  break;
+	}
+      }
+      if ( proved ) {
+	return EquivResult{SatBool3::True, vector<SatBool3>(npo, SatBool3::True)};
+      }
+      // 深さを増やす．
+      break;
+    }
+  }
+
+  return abort_result;
+}
+
+// @brief 2つの順序回路を展開して性質を調べる．
+void
+EquivMgr::check_frames(
+  SeqEnc& enc1,
+  SeqEnc& enc2,
+  const vector<SizeType>& pi2_list,
+  const vector<SizeType>& po2_list,
+  const vector<pair<SizeType, SizeType>>& cand_list,
+  SizeType depth,
+  bool base,
+  double time_limit,
+  vector<SatBool3>& po_stats,
+  vector<SatBool3>& cand_stats,
+  vector<vector<bool>>& po_cex_list
+)
+{
+  FraigMgr fraig_mgr{mSigSize, mInitParam};
+  fraig_mgr.set_sweep_mode(mSweepMode);
+  fraig_mgr.set_sat_budget(mConflictBudget, mPropagationBudget);
+  fraig_mgr.set_time_limit(time_limit);
+
+  SizeType npi = enc1.pi_num();
+  SizeType npo = enc1.po_num();
+  SizeType ncand = cand_list.size();
+
+  // 最初の時刻の状態
+  // base の時は初期状態(すべて0)，そうでない時は任意の状態とする．
+  vector<FraigHandle> state1(enc1.dff_num());
+  vector<FraigHandle> state2(enc2.dff_num());
+  for ( auto state_p: {&state1, &state2} ) {
+    for ( auto& h: *state_p ) {
+      h = base ? fraig_mgr.make_zero() : fraig_mgr.make_input();
+    }
+  }
+
+  // 時刻ごとに性質の各要素が成り立たない条件を作る．
+  // 最初の npo 個が外部出力，残りが DFF の候補に対応する．
+  SizeType nf = base ? depth : depth + 1;
+  vector<vector<FraigHandle>> diff_list(nf);
+  vector<FraigHandle> pi1(npi);
+  vector<FraigHandle> pi2(npi);
+  vector<FraigHandle> po1;
+  vector<FraigHandle> po2;
+  vector<FraigHandle> next1;
+  vector<FraigHandle> next2;
+  for ( SizeType t = 0; t < nf; ++ t ) {
+    for ( auto& h: pi1 ) {
+      h = fraig_mgr.make_input();
+    }
+    for ( SizeType i = 0; i < npi; ++ i ) {
+      pi2[i] = pi1[pi2_list[i]];
+    }
+    enc1.make_frame(fraig_mgr, pi1, state1, po1, next1);
+    enc2.make_frame(fraig_mgr, pi2, state2, po2, next2);
+    auto& diff = diff_list[t];
+    diff.reserve(npo + ncand);
+    for ( SizeType i = 0; i < npo; ++ i ) {
+      diff.push_back(make_diff(fraig_mgr, po1[po2_list[i]], po2[i]));
+    }
+    for ( auto& p: cand_list ) {
+      diff.push_back(make_diff(fraig_mgr, state1[p.first], state2[p.second]));
+    }
+    state1.swap(next1);
+    state2.swap(next2);
+  }
+
+  // 調べる条件のリスト
+  // 要素は (性質の要素の番号, 条件のハンドル)
+  vector<pair<SizeType, FraigHandle>> target_list;
+  if ( base ) {
+    for ( auto& diff: diff_list ) {
+      for ( SizeType j = 0; j < npo + ncand; ++ j ) {
+	target_list.push_back(make_pair(j, diff[j]));
+      }
+    }
+  }
+  else {
+    // 最初の depth 時刻で性質が成り立つという仮定
+    auto assume = fraig_mgr.make_one();
+    for ( SizeType t = 0; t < depth; ++ t ) {
+      for ( auto h: diff_list[t] ) {
+	assume = fraig_mgr.make_and(assume, ~h);
+      }
+    }
+    auto& diff = diff_list[depth];
+    for ( SizeType j = 0; j < npo + ncand; ++ j ) {
+      target_list.push_back(make_pair(j, fraig_mgr.make_and(assume, diff[j])));
+    }
+  }
+
+  fraig_mgr.sweep();
+
+  // 条件が充足不能なら性質が成り立つ．
+  // base の時は target_list は時刻の順に並んでいるので
+  // 最初に見つかった反例が最短のものとなる．
+  vector<SatBool3> stats(npo + ncand, SatBool3::True);
+  po_cex_list.clear();
+  po_cex_list.resize(npo);
+  for ( SizeType k = 0; k < target_list.size(); ++ k ) {
+    auto& p = target_list[k];
+    auto& stat = stats[p.first];
+    if ( stat == SatBool3::False ) {
+      continue;
+    }
+    auto h = fraig_mgr.rep_handle(p.second);
+    auto stat1 = fraig_mgr.check_equiv(h, fraig_mgr.make_zero());
+    if ( stat1 == SatBool3::False ) {
+      stat = SatBool3::False;
+      if ( base && p.first < npo ) {
+	// base の時は初期状態が定数なので
+	// FraigMgr の入力は時刻ごとの外部入力を順に並べたものとなる．
+	// 性質が成り立たなかった時刻までの値を反例とする．
+	SizeType t = k / (npo + ncand);
+	auto cex = fraig_mgr.get_cex(h, fraig_mgr.make_zero());
+	cex.resize((t + 1) * npi);
+	po_cex_list[p.first] = cex;
+      }
+    }
+    else if ( stat1 == SatBool3::X ) {
+      stat = SatBool3::X;
+    }
+  }
+  po_stats.assign(stats.begin(), stats.begin() + npo);
+  cand_stats.assign(stats.begin() + npo, stats.end());
+}
+
+// @brief 入力ベクタを2つの回路でシミュレーションして出力を比較する．
+vector<vector<SizeType>>
+EquivMgr::replay(
+  const BnNetwork& network1,
+  const BnNetwork& network2,
+  const vector<vector<bool>>& input_vectors,
+  bool match_by_name
+) const
+{
+  if ( network2.input_num() != network1.input_num() ||
+       network2.output_num() != network1.output_num() ) {
+    return {};
+  }
+  vector<SizeType> input2_list;
+  vector<SizeType> output2_list;
+  if ( !match_io(network1, network2, match_by_name,
+		 input2_list, output2_list) ) {
+    return {};
+  }
+  return replay(network1, network2, input2_list, output2_list, input_vectors);
+}
+
+// @brief 入力ベクタを2つの回路でシミュレーションして出力を比較する．
+vector<vector<SizeType>>
+EquivMgr::replay(
+  const BnNetwork& network1,
+  const BnNetwork& network2,
+  const vector<SizeType>& input2_list,
+  const vector<SizeType>& output2_list,
+  const vector<vector<bool>>& input_vectors
+) const
+{
+  SizeType ni = network1.input_num();
+  ASSERT_COND( network2.input_num() == ni );
+  ASSERT_COND( input2_list.size() == ni );
+
+  SizeType no = network1.output_num();
+  ASSERT_COND( network2.output_num() == no );
+  ASSERT_COND( output2_list.size() == no );
+
+  BnSim sim1{network1};
+  BnSim sim2{network2};
+  SizeType nv = input_vectors.size();
+  vector<vector<SizeType>> diff_list(nv);
+  vector<std::uint64_t> input1_vals(ni);
+  vector<std::uint64_t> input2_vals(ni);
+  // 64個ずつまとめてシミュレーションを行う．
+  for ( SizeType base = 0; base < nv; base += 64 ) {
+    SizeType n = std::min(nv - base, static_cast<SizeType>(64));
+    // 有効なビットのマスク
+    std::uint64_t valid = 0UL;
+    for ( auto& val: input1_vals ) {
+      val = 0UL;
+    }
+    for ( SizeType b = 0; b < n; ++ b ) {
+      auto& vect = input_vectors[base + b];
+      if ( vect.empty() ) {
+	continue;
+      }
+      ASSERT_COND( vect.size() == ni );
+      std::uint64_t bit = 1UL << b;
+      valid |= bit;
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	if ( vect[i] ) {
+	  input1_vals[i] |= bit;
+	}
+      }
+    }
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      input2_vals[i] = input1_vals[input2_list[i]];
+    }
+    auto output1_vals = sim1.simulate(input1_vals);
+    auto output2_vals = sim2.simulate(input2_vals);
+    for ( SizeType i = 0; i < no; ++ i ) {
+      auto diff = (output1_vals[output2_list[i]] ^ output2_vals[i]) & valid;
+      for ( SizeType b = 0; diff != 0UL; ++ b, diff >>= 1 ) {
+	if ( diff & 1UL ) {
+	  diff_list[base + b].push_back(i);
+	}
+      }
+    }
+  }
+
+  return diff_list;
+}
+
+// @brief 入出力の対応関係を求める．
+bool
+EquivMgr::match_io(
+  const BnNetwork& network1,
+  const BnNetwork& network2,
+  bool match_by_name,
+  vector<SizeType>& input2_list,
+  vector<SizeType>& output2_list
+)
+{
+  SizeType ni = network1.input_num();
+  SizeType no = network1.output_num();
+  input2_list.clear();
+  input2_list.resize(ni);
+  output2_list.clear();
+  output2_list.resize(no);
+  if ( match_by_name ) {
+    // 名前による対応
+    // 入力名をキーにして network1 の入力位置を格納する辞書
+    unordered_map<string, SizeType> input_map;
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto node = network1.input_node(i);
+      input_map.emplace(node.name(), i);
+    }
+    // 入力の対応付を行う．
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto node = network2.input_node(i);
+      auto name = node.name();
+      if ( input_map.count(name) == 0 ) {
+	// 入力名が未対応
+	return false;
+      }
+      input2_list[i] = input_map.at(name);
+    }
+    // 出力名をキーにして network1 の出力位置を格納する辞書
+    unordered_map<string, SizeType> output_map;
+    for ( SizeType i = 0; i < no; ++ i ) {
+      auto node = network1.output_node(i);
+      output_map.emplace(node.name(), i);
+    }
+    // 出力の対応付を行う．
+    for ( SizeType i = 0; i < no; ++ i ) {
+      auto node = network2.output_node(i);
+      auto name = node.name();
+      if ( output_map.count(name) == 0 ) {
+	// 出力名が未対応
+	return false;
+      }
+      output2_list[i] = output_map.at(name);
+    }
+  }
+  else {
+    // 順序による対応
+    for ( SizeType i: Range(ni) ) {
+      input2_list[i] = i;
+    }
+    for ( SizeType i: Range(no) ) {
+      output2_list[i] = i;
+    }
+  }
+  return true;
 }
 
 END_NAMESPACE_MAGUS
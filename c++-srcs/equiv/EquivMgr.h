@@ -9,9 +9,12 @@
 /// All rights reserved.
 
 #include "magus.h"
+#include "fraig_nsdef.h"
+#include "FraigHandle.h"
 #include "ym/bnet.h"
 #include "ym/SatBool3.h"
 #include "ym/SatInitParam.h"
+#include <memory>
 
 
 BEGIN_NAMESPACE_MAGUS
@@ -25,12 +28,20 @@ class EquivResult
 public:
 
   /// @brief コンストラクタ
+  ///
+  /// cex_list が空の場合は全ての出力の反例が空となる．
   EquivResult(
-    SatBool3 result = SatBool3::X,              ///< [in] 全体の結果
-    const vector<SatBool3>& output_results = {} ///< [in] 各出力ごとの結果のリスト
+    SatBool3 result = SatBool3::X,               ///< [in] 全体の結果
+    const vector<SatBool3>& output_results = {}, ///< [in] 各出力ごとの結果のリスト
+    const vector<vector<bool>>& cex_list = {}    ///< [in] 各出力ごとの反例のリスト
   ) : mResult{result},
-      mOutputResults{output_results}
+      mOutputResults{output_results},
+      mCexList{cex_list}
   {
+    if ( mCexList.empty() ) {
+      mCexList.resize(mOutputResults.size());
+    }
+    ASSERT_COND( mCexList.size() == mOutputResults.size() );
   }
 
   /// @brief デストラクタ
@@ -59,6 +70,26 @@ public:
     return mOutputResults;
   }
 
+  /// @brief 出力の反例を返す．
+  ///
+  /// 反例は network1 の入力番号の順の入力値のリストで表す．
+  /// 結果が SatBool3::False でない出力の場合は空となる．
+  const vector<bool>&
+  counter_example(
+    SizeType pos ///< [in] 出力番号 ( 0 <= pos < output_results().size() )
+  ) const
+  {
+    ASSERT_COND( pos < mCexList.size() );
+    return mCexList[pos];
+  }
+
+  /// @brief 各出力ごとの反例のリストを返す．
+  const vector<vector<bool>>&
+  counter_example_list() const
+  {
+    return mCexList;
+  }
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -71,6 +102,9 @@ private:
   // 各出力ごとの結果のリスト
   vector<SatBool3> mOutputResults;
 
+  // 各出力ごとの反例のリスト
+  vector<vector<bool>> mCexList;
+
 };
 
 
@@ -89,7 +123,7 @@ public:
   );
 
   /// @brief デストラクタ
-  ~EquivMgr() = default;
+  ~EquivMgr();
 
 
 public:
@@ -121,6 +155,131 @@ public:
   );
 
 
+  /// @brief 2つの順序回路が等価かどうか調べる．
+  ///
+  /// DFF の出力を擬似入力，DFF の入力を擬似出力として扱い，
+  /// 外部出力の等価性を k-induction で調べる．
+  /// DFF の初期値はすべて 0 と仮定する．
+  /// - 外部入力と外部出力は順序か名前で対応させる．
+  /// - DFF の対応は match_by_name が true の時は名前で，
+  ///   false の時は初期状態からのランダムシミュレーションの値で推定する．
+  ///   対応する DFF の対の等価性は外部出力の等価性とともに帰納法で証明し，
+  ///   証明できなかった対は候補から除いてやり直す．
+  /// - 帰納法の深さは 1 から set_induction_depth() で設定した値まで増やす．
+  ///
+  /// 結果の出力番号は network2 の外部出力の番号となる．
+  /// 結果が SatBool3::False の外部出力の反例は初期状態からの入力系列で，
+  /// 時刻ごとに network1 の外部入力(DFF の出力を除いた入力)の値を
+  /// 入力番号の順に並べたものを連結して表す．
+  /// 最後の時刻で外部出力の値が異なる．
+  EquivResult
+  check_seq(
+    const BnNetwork& network1, ///< [in] 対象の回路1
+    const BnNetwork& network2, ///< [in] 対象の回路2
+    bool match_by_name = false ///< [in] 対応関係を名前で取る．
+  );
+
+  /// @brief 入力ベクタを2つの回路でシミュレーションして出力を比較する．
+  /// @return 入力ベクタごとに値の異なる出力番号のリストを返す．
+  ///
+  /// 入力ベクタは network1 の入力番号の順の入力値のリストで表す．
+  /// EquivResult::counter_example() をそのまま用いることができる．
+  /// 空の入力ベクタに対する結果は空となる．
+  /// 出力番号は EquivResult::output_results() の番号と同じ．
+  /// 入出力の対応が取れない時は空のリストを返す．
+  /// シミュレーションは64個の入力ベクタ単位でビット並列に行う．
+  vector<vector<SizeType>>
+  replay(
+    const BnNetwork& network1,                 ///< [in] 対象の回路1
+    const BnNetwork& network2,                 ///< [in] 対象の回路2
+    const vector<vector<bool>>& input_vectors, ///< [in] 入力ベクタのリスト
+    bool match_by_name = false                 ///< [in] 対応関係を名前で取る．
+  ) const;
+
+  /// @brief 入力ベクタを2つの回路でシミュレーションして出力を比較する．
+  /// @return 入力ベクタごとに値の異なる出力番号のリストを返す．
+  ///
+  /// input2_list, output2_list の意味は check() と同じ．
+  vector<vector<SizeType>>
+  replay(
+    const BnNetwork& network1,                ///< [in] 対象の回路1
+    const BnNetwork& network2,                ///< [in] 対象の回路2
+    const vector<SizeType>& input2_list,      ///< [in] network2の入力順序を表すリスト
+    const vector<SizeType>& output2_list,     ///< [in] network2の出力順序を表すリスト
+    const vector<vector<bool>>& input_vectors ///< [in] 入力ベクタのリスト
+  ) const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // インクリメンタルな検証を行う関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 参照回路を設定する．
+  ///
+  /// 参照回路の AIG を一度だけ作って保持しておき，
+  /// 以降の check_revision() で共有する．
+  /// 参照回路の構造ハッシュ，等価なノードの情報とシミュレーションパタンは
+  /// check_revision() の呼び出しをまたがって再利用される．
+  /// network1 は clear_reference() を呼ぶまで有効でなければならない．
+  /// 制御パラメータはこの時点の値が用いられる．
+  void
+  set_reference(
+    const BnNetwork& network1 ///< [in] 参照回路
+  );
+
+  /// @brief 参照回路を破棄する．
+  void
+  clear_reference();
+
+  /// @brief 参照回路が設定されている時 true を返す．
+  bool
+  has_reference() const
+  {
+    return mRefNetwork != nullptr;
+  }
+
+  /// @brief 参照回路の SATソルバの変数の数を返す．
+  ///
+  /// 参照回路が設定されている必要がある．
+  SizeType
+  reference_sat_variable_num() const;
+
+  /// @brief 参照回路の SATソルバの有効な節の数を返す．
+  ///
+  /// 参照回路が設定されている必要がある．
+  SizeType
+  reference_sat_clause_num() const;
+
+  /// @brief 修正後の回路が参照回路と等価かどうか調べる．
+  ///
+  /// 修正後の回路は参照回路の AIG に重ねて作られるので，
+  /// 変更のない部分は構造ハッシュで参照回路のノードに一致し，
+  /// 新たに作られたノードのみが等価ノードの探索の対象となる．
+  /// 検証の後で新たに作られたノードは構造ハッシュ，パタンハッシュから取り除かれる．
+  /// SATソルバは作り直さずに，修正版ごとの活性化リテラルで節を有効にし，
+  /// 検証の後でその否定を加えて修正版の節を無効にするので，
+  /// 前の修正版のノードが後の修正版の検証に残ることはない．
+  /// 参照回路の節と学習節はそのまま次の修正版で用いられる．
+  /// 検証中に得られた反例のパタンは参照回路のノードに残る．
+  /// 入出力の対応の取り方は check() と同じ．
+  EquivResult
+  check_revision(
+    const BnNetwork& network2, ///< [in] 修正後の回路
+    bool match_by_name = false ///< [in] 対応関係を名前で取る．
+  );
+
+  /// @brief 修正後の回路が参照回路と等価かどうか調べる．
+  ///
+  /// input2_list, output2_list の意味は check() と同じ．
+  EquivResult
+  check_revision(
+    const BnNetwork& network2,           ///< [in] 修正後の回路
+    const vector<SizeType>& input2_list, ///< [in] network2の入力順序を表すリスト
+    const vector<SizeType>& output2_list ///< [in] network2の出力順序を表すリスト
+  );
+
+
 public:
   //////////////////////////////////////////////////////////////////////
   // 制御パラーメタ関係の関数
@@ -135,6 +294,72 @@ public:
     mSigSize = sig_size;
   }
 
+  /// @brief sweep モードを設定する．
+  ///
+  /// true の時は回路全体を構造ハッシュのみで作った後で
+  /// まとめて等価なノードを求める(FRAIG sweeping)．
+  /// false の時はノードを作るたびに等価なノードを求める．
+  void
+  set_sweep_mode(
+    bool sweep_mode ///< [in] sweep モードの時 true にする．
+  )
+  {
+    mSweepMode = sweep_mode;
+  }
+
+  /// @brief 1回の SAT の呼び出しあたりの制限を設定する．
+  ///
+  /// 0 の場合は制限なしとなる．
+  /// 出力の検証が制限によってアボートした場合は
+  /// 制限を kBudgetRatio 倍しながら最大 retry_num 回までやり直す．
+  /// それでも決まらなかった出力は SatBool3::X となる．
+  void
+  set_sat_budget(
+    SizeType conflict_budget,    ///< [in] コンフリクト数の上限
+    SizeType propagation_budget, ///< [in] implication 数の上限
+    SizeType retry_num = 3       ///< [in] やり直しの回数
+  )
+  {
+    mConflictBudget = conflict_budget;
+    mPropagationBudget = propagation_budget;
+    mRetryNum = retry_num;
+  }
+
+  /// @brief 1回の check() 全体の制限時間を設定する．
+  ///
+  /// 0 の場合は制限なしとなる．
+  /// 制限時間を過ぎた後の出力は SatBool3::X となる．
+  void
+  set_time_limit(
+    double time_limit ///< [in] 制限時間(秒)
+  )
+  {
+    mTimeLimit = time_limit;
+  }
+
+  /// @brief 出力の検証に用いるスレッド数を設定する．
+  ///
+  /// 2以上の時は各出力の検証を複数のスレッドで並列に行う．
+  /// 各スレッドは自分の SATソルバを持ち，
+  /// 等価と証明された関係はスレッド間で共有される．
+  /// 結果の順番はスレッド数によらず出力の順番となる．
+  void
+  set_thread_num(
+    SizeType thread_num ///< [in] スレッド数
+  )
+  {
+    mThreadNum = thread_num;
+  }
+
+  /// @brief check_seq() の帰納法の最大の深さを設定する．
+  void
+  set_induction_depth(
+    SizeType depth ///< [in] 深さ ( >= 1 )
+  )
+  {
+    mInductionDepth = depth;
+  }
+
   /// @brief SATソルバの種類を設定する．
   void
   set_sat_solver_type(
@@ -168,6 +393,54 @@ private:
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 入出力の対応関係を求める．
+  /// @return 対応関係が取れなかった時 false を返す．
+  static
+  bool
+  match_io(
+    const BnNetwork& network1,     ///< [in] 対象の回路1
+    const BnNetwork& network2,     ///< [in] 対象の回路2
+    bool match_by_name,            ///< [in] 対応関係を名前で取る．
+    vector<SizeType>& input2_list, ///< [out] network2の入力順序を表すリスト
+    vector<SizeType>& output2_list ///< [out] network2の出力順序を表すリスト
+  );
+
+  /// @brief 各出力の対の等価検証を行う．
+  ///
+  /// fraig_mgr には2つの回路の AIG が作られている必要がある．
+  EquivResult
+  check_outputs(
+    FraigMgr& fraig_mgr,                                    ///< [in] FraigMgr
+    const vector<pair<FraigHandle, FraigHandle>>& pair_list ///< [in] 出力のハンドルの対のリスト
+  );
+
+  /// @brief 2つの順序回路を展開して性質を調べる．
+  ///
+  /// 性質は各時刻の外部出力の対と DFF の候補の対が等しいことである．
+  /// - base が true の時は初期状態から depth 時刻分展開して，
+  ///   全ての時刻で性質が成り立つか調べる．
+  /// - base が false の時は任意の状態から depth + 1 時刻分展開して，
+  ///   最初の depth 時刻で性質が成り立つという仮定のもとで
+  ///   最後の時刻で性質が成り立つか調べる．
+  ///
+  /// po_cex_list には base が true の時に結果が SatBool3::False となった
+  /// 外部出力の反例を入れる．形式は check_seq() の反例と同じ．
+  /// それ以外の要素は空になる．
+  void
+  check_frames(
+    SeqEnc& enc1,                                      ///< [in] 回路1
+    SeqEnc& enc2,                                      ///< [in] 回路2
+    const vector<SizeType>& pi2_list,                  ///< [in] 回路2の外部入力の対応
+    const vector<SizeType>& po2_list,                  ///< [in] 回路2の外部出力の対応
+    const vector<pair<SizeType, SizeType>>& cand_list, ///< [in] DFF の候補の対のリスト
+    SizeType depth,                                    ///< [in] 深さ
+    bool base,                                         ///< [in] 基底の検査の時 true
+    double time_limit,                                 ///< [in] 制限時間(秒)
+    vector<SatBool3>& po_stats,                        ///< [out] 外部出力ごとの結果
+    vector<SatBool3>& cand_stats,                      ///< [out] 候補ごとの結果
+    vector<vector<bool>>& po_cex_list                  ///< [out] 外部出力ごとの反例
+  );
+
   /// @brief ログレベルを返す．
   int
   log_level() const
@@ -194,6 +467,43 @@ private:
   // SATソルバの初期化パラメータ
   SatInitParam mInitParam;
 
+  // sweep モード
+  bool mSweepMode{true};
+
+  // 1回の SAT の呼び出しあたりのコンフリクト数の上限
+  SizeType mConflictBudget{0};
+
+  // 1回の SAT の呼び出しあたりの implication 数の上限
+  SizeType mPropagationBudget{0};
+
+  // アボートした出力のやり直しの回数
+  SizeType mRetryNum{0};
+
+  // 制限時間(秒)
+  double mTimeLimit{0.0};
+
+  // 出力の検証に用いるスレッド数
+  SizeType mThreadNum{1};
+
+  // check_seq() の帰納法の最大の深さ
+  SizeType mInductionDepth{3};
+
+  // 参照回路
+  const BnNetwork* mRefNetwork{nullptr};
+
+  // 参照回路の AIG を保持する FraigMgr
+  std::unique_ptr<FraigMgr> mRefMgr;
+
+  // 参照回路の入力のハンドルのリスト
+  vector<FraigHandle> mRefInputs;
+
+  // 参照回路の出力のハンドルのリスト
+  vector<FraigHandle> mRefOutputs;
+
+  // やり直すごとに制限を増やす倍率
+  static
+  const SizeType kBudgetRatio = 4;
+
   // ログレベル
   int mLogLevel{0};
 
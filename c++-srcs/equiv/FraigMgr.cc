@@ -10,6 +10,10 @@
 #include "FraigNode.h"
 #include "ym/Range.h"
 #include "ym/Timer.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
 
 
 #if defined(YM_DEBUG)
@@ -27,6 +31,59 @@ BEGIN_NONAMESPACE
 
 const int debug = DEBUG_FLAG;
 
+// 2つのハンドルが等価かどうか solver で調べる．
+SatBool3
+check_equiv_sub(
+  FraigSat& solver,
+  FraigHandle aig1,
+  FraigHandle aig2
+)
+{
+  if ( aig1 == aig2 ) {
+    // もっとも簡単なパタン
+    return SatBool3::True;
+  }
+
+  FraigNode* node1 = aig1.node();
+  FraigNode* node2 = aig2.node();
+
+  if ( node1 == node2 ) {
+    // ということは逆極性なので絶対に等価ではない．
+    return SatBool3::False;
+  }
+
+  bool inv1 = aig1.inv();
+  bool inv2 = aig2.inv();
+
+  if ( aig1.is_zero () ) {
+    // 上のチェックで aig2 は定数でないことは明らか
+    SatBool3 stat = solver.check_const(node2, inv2);
+    return stat;
+  }
+
+  if ( aig1.is_one() ) {
+    // 上のチェックで aig2 は定数でないことは明らか
+    SatBool3 stat = solver.check_const(node2, !inv2);
+    return stat;
+  }
+
+  if ( aig2.is_zero() ) {
+    // 上のチェックで aig1 は定数でないことは明らか
+    SatBool3 stat = solver.check_const(node1, inv1);
+    return stat;
+  }
+
+  if ( aig2.is_one() ) {
+    // 上のチェックで aig1 は定数でないことは明らか
+    SatBool3 stat = solver.check_const(node1, !inv1);
+    return stat;
+  }
+
+  bool inv = inv1 ^ inv2;
+  SatBool3 stat = solver.check_equiv(node1, node2, inv);
+  return stat;
+}
+
 END_NONAMESPACE
 
 //////////////////////////////////////////////////////////////////////
@@ -37,20 +94,19 @@ END_NONAMESPACE
 FraigMgr::FraigMgr(
   SizeType sig_size,
   const SatInitParam& init_param
-) : mSolver{init_param},
+) : mNodes{sig_size * 2},
+    mPatUsed{sig_size},
+    mPatTable{sig_size},
+    mInitParam{init_param},
+    mSolver{new FraigSat{init_param}},
     mLogLevel{0},
     mLogStream{new ofstream("/dev/null")}
 {
-  FraigNode::mPatSize = sig_size * 2;
-  FraigNode::mPatUsed = sig_size;
 }
 
 // @brief デストラクタ
 FraigMgr::~FraigMgr()
 {
-  for ( auto node: mAllNodes ) {
-    delete node;
-  }
   if ( mLogStream != &cout ) {
     delete mLogStream;
   }
@@ -64,16 +120,20 @@ FraigMgr::make_input()
     cout << "make_input ...";
   }
 
-  SizeType id = mAllNodes.size();
+  SizeType id = mNodes.node_num();
   SizeType iid = mInputNodes.size();
-  vector<std::uint64_t> init_pat(FraigNode::mPatUsed);
+  auto node = mNodes.new_input(iid);
+  auto pat = mNodes.pat_row(id);
   std::uniform_int_distribution<std::uint64_t> rd;
-  for ( int i: Range(FraigNode::mPatUsed) ) {
-    init_pat[i] = rd(mRandGen);
+  for ( SizeType i = 0; i < mPatUsed; ++ i ) {
+    pat[i] = rd(mRandGen);
   }
-  auto node = new FraigNode{id, iid, init_pat};
+  mNodes.calc_mark(id, 0, mPatUsed);
   reg_node(node);
   mInputNodes.push_back(node);
+  mPatTable.insert(node);
+  mCexPat.push_back(0UL);
+  mCexKey.push_back(rd(mRandGen));
 
   FraigHandle ans{node, false};
 
@@ -96,101 +156,42 @@ FraigMgr::make_and(
   }
 
   FraigHandle ans;
-
-  // trivial な場合の処理
-  if ( handle1.is_zero() || handle2.is_zero() ) {
-    ans = make_zero();
-  }
-  else if ( handle1.is_one() ) {
-    ans = handle2;
-  }
-  else if ( handle2.is_one() ) {
-    ans = handle1;
-  }
-  else if ( handle1 == handle2 ) {
-    ans = handle1;
-  }
-  else if ( handle1.node() == handle2.node() ) {
-    // handle1.inv != handle2.inv() のはず
-    ans = make_zero();
-  }
-  else {
-    // 順番の正規化
-    if ( handle1.node()->id() < handle2.node()->id() ) {
-      std::swap(handle1, handle2);
-    }
-
+  if ( !simple_and(handle1, handle2, ans) ) {
     if ( debug ) {
       cout << "  after normalize: " << handle1 << ", " << handle2 << endl;
     }
 
     // 同じ構造を持つノードが既にないか調べる．
-    FraigNode key{0, handle1, handle2};
-    auto p = mStructTable.find(&key);
-    if ( p != mStructTable.end() ) {
+    auto node0 = mStructTable.find(handle1, handle2);
+    if ( node0 != nullptr ) {
       // 等価なノードが存在した．
-      auto node = *p;
-      ans = FraigHandle{node, false};
+      ans = rep_handle(FraigHandle{node0, false});
     }
     else {
       // ノードを作る．
-      SizeType id = mAllNodes.size();
-      auto node = new FraigNode{id, handle1, handle2};
+      SizeType id = mNodes.node_num();
+      auto node = mNodes.new_and(handle1, handle2);
       reg_node(node);
+      calc_pat(id, 0, mPatUsed);
 
       // 構造ハッシュに追加する．
       mStructTable.insert(node);
 
       // 入出力の関係を表す CNF を作る．
-      mSolver.make_cnf(node);
+      mSolver->make_cnf(node);
 
       if ( debug ) {
 	cout << "  new node: " << FraigHandle{node, false} << endl;
       }
 
-      // 縮退検査を行う．
-      if ( verify_const(node, ans) == SatBool3::True ) {
-	// 縮退していた．
-	goto exit;
-      }
-
-      // 等価なノードを探す．
-      PatEq eq;
-      while ( true ) {
-	auto range = mPatTable.equal_range(node);
-	bool inv0 = node->pat_hash_inv();
-	bool change{false};
-	auto end = range.second;
-	for ( auto p = range.first; p != end; ++ p ) {
-	  auto node1 = *p;
-	  bool inv = inv0 ^ node1->pat_hash_inv();
-	  if ( eq(node, node1) ) {
-	    // node と node1 が等価かどうか調べる．
-	    auto stat = mSolver.check_equiv(node, node1, inv);
-	    if ( stat == SatBool3::True ) {
-	      // 等価なノードが見つかった．
-	      ans = FraigHandle{node1, inv};
-	      goto exit;
-	    }
-	    else if ( stat == SatBool3::False ) {
-	      // 反例をパタンに加えて再ハッシュする．
-	      add_pat(node);
-
-	      ASSERT_COND( !eq(node, node1) );
-	      change = true;
-	      break;
-	    }
-	  }
-	}
-	if ( !change ) {
-	  ans = FraigHandle{node, false};
-	  break;
-	}
+      if ( !mSweepMode ) {
+	// その場で等価なノードを探す．
+	sweep();
       }
+      ans = rep_handle(FraigHandle{node, false});
     }
   }
 
- exit:
   if ( debug ) {
     cout << "  -> " << ans << endl;
   }
@@ -198,6 +199,77 @@ FraigMgr::make_and(
   return ans;
 }
 
+// @brief 未処理のノードに対して等価なノードを求める．
+void
+FraigMgr::sweep()
+{
+  for ( ; mSweptNum < node_num(); ++ mSweptNum ) {
+    auto node = mNodes.node(mSweptNum);
+    if ( node->is_input() ) {
+      // 入力ノードは作られた時にパタンテーブルに登録されている．
+      continue;
+    }
+
+    // ファンインが置き換えられていたら構造的に簡単化できるか調べる．
+    auto handle1 = rep_handle(node->fanin0_handle());
+    auto handle2 = rep_handle(node->fanin1_handle());
+    FraigHandle ans;
+    if ( simple_and(handle1, handle2, ans) ) {
+      mRepArray[node->id()] = ans;
+      continue;
+    }
+    auto node0 = mStructTable.find(handle1, handle2);
+    if ( node0 != nullptr && node0->id() < node->id() ) {
+      mRepArray[node->id()] = rep_handle(FraigHandle{node0, false});
+      continue;
+    }
+
+    mRepArray[node->id()] = find_equiv(node);
+  }
+}
+
+// @brief 修正版の区間を開始する．
+void
+FraigMgr::begin_revision()
+{
+  mRevisionBase = node_num();
+  mSolver->begin_revision();
+}
+
+// @brief 後から作られたノードを削除する．
+void
+FraigMgr::truncate(
+  SizeType num
+)
+{
+  SizeType n = node_num();
+  ASSERT_COND( num <= n );
+
+  // 修正版の区間の節は活性化リテラルの否定を加えて無効にする．
+  // 区間の外で加えた節は残るが，削除したノードの変数は
+  // 以降のノードには使わないので結果には影響しない．
+  if ( mSolver->in_revision() && num <= mRevisionBase ) {
+    mSolver->end_revision();
+  }
+  if ( num == n ) {
+    return;
+  }
+  ASSERT_COND( mInputNodes.empty() || mInputNodes.back()->id() < num );
+
+  mStructTable.truncate(num);
+  mPatTable.truncate(num);
+  for ( SizeType id = num; id < n; ++ id ) {
+    mSolver->erase_node(id);
+  }
+
+  mNodes.truncate(num);
+  mRepArray.resize(num);
+  mCexValArray.resize(num);
+  mCexTimeArray.resize(num);
+  ++ mCexTime;
+  mSweptNum = std::min(mSweptNum, num);
+}
+
 // @brief コファクターを計算する．
 FraigHandle
 FraigMgr::make_cofactor(
@@ -206,35 +278,55 @@ FraigMgr::make_cofactor(
   bool inv
 )
 {
-  if ( edge.is_const() ) {
-    // edge が定数の時は変更なし
-    return edge;
-  }
+  auto ans_list = make_cofactor(vector<FraigHandle>{edge},
+				{make_pair(static_cast<SizeType>(input_id), !inv)});
+  return ans_list[0];
+}
 
-  auto node = edge.node();
-  FraigHandle ans;
-  if ( node->is_input() ) {
-    // 入力ノード時は番号が input_id どうかで処理が変わる．
-    if ( node->input_id() == input_id ) {
-      if ( inv ) {
-	ans = make_zero();
-      }
-      else {
-	ans = make_one();
-      }
-    }
-    else {
-      ans = FraigHandle{node, false};
-    }
-  }
-  else {
-    // AND ノードの場合
-    // 2つの子供に再帰的な処理を行って結果の AND を計算する．
-    auto tmp0 = make_cofactor(node->fanin0_handle(), input_id, inv);
-    auto tmp1 = make_cofactor(node->fanin1_handle(), input_id, inv);
-    ans = make_and(tmp0, tmp1);
+// @brief 複数の入力の値を固定したコファクターを計算する．
+vector<FraigHandle>
+FraigMgr::make_cofactor(
+  const vector<FraigHandle>& edge_list,
+  const vector<pair<SizeType, bool>>& assign_list
+)
+{
+  auto ans_list = compose(edge_list, {assign_to_map(assign_list)});
+  return ans_list[0];
+}
+
+// @brief 複数の割り当てに対するコファクターを一度にまとめて計算する．
+vector<vector<FraigHandle>>
+FraigMgr::make_cofactor_batch(
+  const vector<FraigHandle>& edge_list,
+  const vector<vector<pair<SizeType, bool>>>& assign_list_list
+)
+{
+  vector<vector<FraigHandle>> input_map_list;
+  input_map_list.reserve(assign_list_list.size());
+  for ( auto& assign_list: assign_list_list ) {
+    input_map_list.push_back(assign_to_map(assign_list));
   }
-  return ans ^ edge.inv();
+  return compose(edge_list, input_map_list);
+}
+
+// @brief 存在量化を行う．
+FraigHandle
+FraigMgr::make_exists(
+  FraigHandle edge,
+  const vector<SizeType>& input_id_list
+)
+{
+  return quantify(edge, input_id_list, true);
+}
+
+// @brief 全称量化を行う．
+FraigHandle
+FraigMgr::make_forall(
+  FraigHandle edge,
+  const vector<SizeType>& input_id_list
+)
+{
+  return quantify(edge, input_id_list, false);
 }
 
 // @brief 2つのハンドルが等価かどうか調べる．
@@ -244,49 +336,342 @@ FraigMgr::check_equiv(
   FraigHandle aig2
 )
 {
-  if ( aig1 == aig2 ) {
-    // もっとも簡単なパタン
-    return SatBool3::True;
+  return check_equiv_sub(*mSolver, aig1, aig2);
+}
+
+// @brief 複数のハンドルの対の等価性を複数のスレッドで調べる．
+vector<SatBool3>
+FraigMgr::check_equiv_mt(
+  const vector<pair<FraigHandle, FraigHandle>>& pair_list,
+  SizeType thread_num,
+  vector<vector<bool>>& cex_list
+)
+{
+  SizeType n = pair_list.size();
+  vector<SatBool3> result_list(n, SatBool3::X);
+  cex_list.clear();
+  cex_list.resize(n);
+  if ( thread_num <= 1 ) {
+    for ( SizeType i = 0; i < n; ++ i ) {
+      auto h1 = rep_handle(pair_list[i].first);
+      auto h2 = rep_handle(pair_list[i].second);
+      result_list[i] = check_equiv(h1, h2);
+      if ( result_list[i] == SatBool3::False ) {
+	cex_list[i] = make_cex(*mSolver, h1, h2);
+      }
+    }
+    return result_list;
   }
 
-  FraigNode* node1 = aig1.node();
-  FraigNode* node2 = aig2.node();
+  // 次に処理する対の番号
+  std::atomic<SizeType> next_pos{0};
 
-  if ( node1 == node2 ) {
-    // ということは逆極性なので絶対に等価ではない．
-    return SatBool3::False;
+  // 等価と証明された対のリスト
+  // 全スレッドで共有する．
+  vector<pair<FraigHandle, FraigHandle>> proven_list;
+  std::mutex proven_mutex;
+
+  auto worker = [&]() {
+    FraigSat solver{mInitParam};
+    solver.copy_limits(*mSolver);
+
+    // proven_list のうち取り込み済みの要素数
+    SizeType read_num = 0;
+    // 取り込んだがノードが未登録のため保留している対のリスト
+    vector<pair<FraigHandle, FraigHandle>> pending_list;
+
+    for ( ; ; ) {
+      SizeType pos = next_pos ++;
+      if ( pos >= n ) {
+	break;
+      }
+      auto h1 = rep_handle(pair_list[pos].first);
+      auto h2 = rep_handle(pair_list[pos].second);
+      if ( h1 == h2 ) {
+	result_list[pos] = SatBool3::True;
+	continue;
+      }
+
+      make_cone_cnf(solver, h1);
+      make_cone_cnf(solver, h2);
+
+      // 他のスレッドで証明された等価関係を取り込む．
+      {
+	std::lock_guard<std::mutex> lock{proven_mutex};
+	for ( ; read_num < proven_list.size(); ++ read_num ) {
+	  pending_list.push_back(proven_list[read_num]);
+	}
+      }
+      SizeType wpos = 0;
+      for ( auto& p: pending_list ) {
+	auto registered = [&](FraigHandle h) {
+	  return h.is_const() || solver.is_registered(h.node());
+	};
+	if ( registered(p.first) && registered(p.second) ) {
+	  solver.add_equiv(p.first, p.second);
+	}
+	else {
+	  pending_list[wpos] = p;
+	  ++ wpos;
+	}
+      }
+      pending_list.erase(pending_list.begin() + wpos, pending_list.end());
+
+      auto stat = check_equiv_sub(solver, h1, h2);
+      // 書き込む位置はスレッドごとに異なるので排他制御は不要
+      result_list[pos] = stat;
+      if ( stat == SatBool3::False ) {
+	cex_list[pos] = make_cex(solver, h1, h2);
+      }
+      if ( stat == SatBool3::True ) {
+	std::lock_guard<std::mutex> lock{proven_mutex};
+	proven_list.push_back({h1, h2});
+      }
+    }
+  };
+
+  vector<std::thread> thread_list;
+  thread_list.reserve(thread_num);
+  for ( SizeType i = 0; i < thread_num; ++ i ) {
+    thread_list.push_back(std::thread{worker});
+  }
+  for ( auto& th: thread_list ) {
+    th.join();
   }
 
-  bool inv1 = aig1.inv();
-  bool inv2 = aig2.inv();
+  return result_list;
+}
 
-  if ( aig1.is_zero () ) {
-    // 上のチェックで aig2 は定数でないことは明らか
-    SatBool3 stat = mSolver.check_const(node2, inv2);
-    return stat;
+// @brief 入力を置き換えた関数をまとめて計算する．
+vector<vector<FraigHandle>>
+FraigMgr::compose(
+  const vector<FraigHandle>& edge_list,
+  const vector<vector<FraigHandle>>& input_map_list
+)
+{
+  SizeType nb = input_map_list.size();
+
+  // edge_list の推移的ファンインを求める．
+  // 途中で make_and() によってノードが追加されるので
+  // 最初のノード数を覚えておく．
+  SizeType n = node_num();
+  vector<bool> mark(n, false);
+  vector<FraigNode*> node_list;
+  vector<FraigNode*> node_stack;
+  auto push = [&](FraigHandle h) {
+    if ( !h.is_const() && !mark[h.node()->id()] ) {
+      mark[h.node()->id()] = true;
+      node_stack.push_back(h.node());
+    }
+  };
+  for ( auto edge: edge_list ) {
+    push(edge);
+  }
+  while ( !node_stack.empty() ) {
+    auto node = node_stack.back();
+    node_stack.pop_back();
+    node_list.push_back(node);
+    if ( !node->is_input() ) {
+      push(node->fanin0_handle());
+      push(node->fanin1_handle());
+    }
+  }
+  // ノード番号の順がトポロジカル順になっている．
+  std::sort(node_list.begin(), node_list.end(),
+	    [](FraigNode* node1, FraigNode* node2) {
+	      return node1->id() < node2->id();
+	    });
+
+  // ノード番号をキーにして node_list 上の位置を格納する配列
+  // mark が true のノードのみ意味を持つ．
+  vector<SizeType> pos_array(n);
+  for ( SizeType i = 0; i < node_list.size(); ++ i ) {
+    pos_array[node_list[i]->id()] = i;
   }
 
-  if ( aig1.is_one() ) {
-    // 上のチェックで aig2 は定数でないことは明らか
-    SatBool3 stat = mSolver.check_const(node2, !inv2);
-    return stat;
+  // (node_list 上の位置 x nb + 置き換えの番号) をキーにして結果を格納する配列
+  vector<FraigHandle> val_array(node_list.size() * nb);
+  auto handle_val = [&](FraigHandle h, SizeType b) {
+    if ( h.is_const() ) {
+      return h;
+    }
+    return val_array[pos_array[h.node()->id()] * nb + b] ^ h.inv();
+  };
+  for ( SizeType i = 0; i < node_list.size(); ++ i ) {
+    auto node = node_list[i];
+    auto base = i * nb;
+    if ( node->is_input() ) {
+      for ( SizeType b = 0; b < nb; ++ b ) {
+	val_array[base + b] = input_map_list[b][node->input_id()];
+      }
+    }
+    else {
+      auto handle1 = node->fanin0_handle();
+      auto handle2 = node->fanin1_handle();
+      for ( SizeType b = 0; b < nb; ++ b ) {
+	auto val1 = handle_val(handle1, b);
+	auto val2 = handle_val(handle2, b);
+	if ( val1 == handle1 && val2 == handle2 ) {
+	  // 置き換えの影響を受けない．
+	  val_array[base + b] = FraigHandle{node, false};
+	}
+	else {
+	  val_array[base + b] = make_and(val1, val2);
+	}
+      }
+    }
   }
 
-  if ( aig2.is_zero() ) {
-    // 上のチェックで aig1 は定数でないことは明らか
-    SatBool3 stat = mSolver.check_const(node1, inv1);
-    return stat;
+  vector<vector<FraigHandle>> ans_list(nb);
+  for ( SizeType b = 0; b < nb; ++ b ) {
+    auto& ans = ans_list[b];
+    ans.reserve(edge_list.size());
+    for ( auto edge: edge_list ) {
+      ans.push_back(handle_val(edge, b));
+    }
   }
+  return ans_list;
+}
 
-  if ( aig2.is_one() ) {
-    // 上のチェックで aig1 は定数でないことは明らか
-    SatBool3 stat = mSolver.check_const(node1, !inv1);
-    return stat;
+// @brief 割り当てを入力の置き換えのリストに変換する．
+vector<FraigHandle>
+FraigMgr::assign_to_map(
+  const vector<pair<SizeType, bool>>& assign_list
+) const
+{
+  vector<FraigHandle> input_map;
+  input_map.reserve(input_num());
+  for ( auto node: mInputNodes ) {
+    input_map.push_back(FraigHandle{node, false});
+  }
+  for ( auto& p: assign_list ) {
+    ASSERT_COND( p.first < input_num() );
+    input_map[p.first] = p.second ? FraigHandle::one() : FraigHandle::zero();
   }
+  return input_map;
+}
 
-  bool inv = inv1 ^ inv2;
-  SatBool3 stat = mSolver.check_equiv(node1, node2, inv);
-  return stat;
+// @brief 量化を行う．
+FraigHandle
+FraigMgr::quantify(
+  FraigHandle edge,
+  const vector<SizeType>& input_id_list,
+  bool exists
+)
+{
+  for ( auto input_id: input_id_list ) {
+    if ( edge.is_const() ) {
+      break;
+    }
+    // 正負のコファクターを1回の走査で求める．
+    vector<vector<pair<SizeType, bool>>> assign_list_list(2);
+    assign_list_list[0].push_back(make_pair(input_id, false));
+    assign_list_list[1].push_back(make_pair(input_id, true));
+    auto ans_list = make_cofactor_batch({edge}, assign_list_list);
+    auto f0 = ans_list[0][0];
+    auto f1 = ans_list[1][0];
+    if ( exists ) {
+      edge = ~make_and(~f0, ~f1);
+    }
+    else {
+      edge = make_and(f0, f1);
+    }
+  }
+  return edge;
+}
+
+// @brief 自明な AND の処理を行う．
+bool
+FraigMgr::simple_and(
+  FraigHandle& handle1,
+  FraigHandle& handle2,
+  FraigHandle& ans
+)
+{
+  if ( handle1.is_zero() || handle2.is_zero() ) {
+    ans = make_zero();
+    return true;
+  }
+  if ( handle1.is_one() ) {
+    ans = handle2;
+    return true;
+  }
+  if ( handle2.is_one() ) {
+    ans = handle1;
+    return true;
+  }
+  if ( handle1 == handle2 ) {
+    ans = handle1;
+    return true;
+  }
+  if ( handle1.node() == handle2.node() ) {
+    // handle1.inv != handle2.inv() のはず
+    ans = make_zero();
+    return true;
+  }
+
+  // 順番の正規化
+  if ( handle1.node()->id() < handle2.node()->id() ) {
+    std::swap(handle1, handle2);
+  }
+  return false;
+}
+
+// @brief 論理的に等価なノードを探す．
+FraigHandle
+FraigMgr::find_equiv(
+  FraigNode* node
+)
+{
+  // 縮退検査を行う．
+  FraigHandle ans;
+  if ( verify_const(node, ans) == SatBool3::True ) {
+    // 縮退していた．
+    return ans;
+  }
+
+  // 同じパタンを持つノードと比較する．
+  while ( true ) {
+    auto node_list = mPatTable.find(node);
+    bool change{false};
+    if ( node_list != nullptr ) {
+      bool inv0 = node->pat_hash_inv();
+      for ( auto node1: *node_list ) {
+	bool inv = inv0 ^ node1->pat_hash_inv();
+	if ( mCexNum > 0 ) {
+	  // 記録中の反例で区別できる場合は SAT を用いない．
+	  auto diff = cex_val(node->id()) ^ cex_val(node1->id());
+	  if ( inv ) {
+	    diff = ~diff;
+	  }
+	  if ( (diff & cex_mask()) != 0UL ) {
+	    continue;
+	  }
+	}
+	// node と node1 が等価かどうか調べる．
+	auto stat = mSolver->check_equiv(node, node1, inv);
+	if ( stat == SatBool3::True ) {
+	  // 等価なノードが見つかった．
+	  return FraigHandle{node1, inv};
+	}
+	else if ( stat == SatBool3::False ) {
+	  // 反例を記録する．
+	  // パタンに加えられた場合はクラスが変わっているので
+	  // 探索をやり直す．
+	  if ( add_cex() ) {
+	    change = true;
+	    break;
+	  }
+	}
+      }
+    }
+    if ( !change ) {
+      break;
+    }
+  }
+
+  mPatTable.insert(node);
+  return FraigHandle{node, false};
 }
 
 // @brief 0縮退検査を行う．
@@ -296,79 +681,187 @@ FraigMgr::verify_const(
   FraigHandle& ans
 )
 {
+  // 記録中の反例で値が 1 になるなら定数0ではなく，
+  // 値が 0 になるなら定数1ではない．
+  std::uint64_t val1 = 0UL;
+  std::uint64_t val0 = 0UL;
+  if ( mCexNum > 0 ) {
+    auto mask = cex_mask();
+    val1 = cex_val(node->id()) & mask;
+    val0 = ~val1 & mask;
+  }
+
   SatBool3 stat = SatBool3::False;
-  if ( !node->check_1mark() ) {
+  if ( !node->check_1mark() && val1 == 0UL ) {
     // 定数0の可能性があるか調べる．
-    stat = mSolver.check_const(node, false);
+    stat = mSolver->check_const(node, false);
     if ( stat == SatBool3::True ) {
       // 定数0と等価だった．
       ans = make_zero();
     }
     else if ( stat == SatBool3::False ) {
-      // 反例をパタンに加えておく．
-      add_pat(node);
-
-      ASSERT_COND( node->check_1mark() );
+      // 反例を記録しておく．
+      add_cex();
     }
   }
-  if ( !node->check_0mark() ) {
+  if ( !node->check_0mark() && val0 == 0UL ) {
     // 定数1の可能性があるか調べる．
-    stat = mSolver.check_const(node, true);
+    stat = mSolver->check_const(node, true);
     if ( stat == SatBool3::True ) {
       // 定数1と等価だった．
       ans = make_one();
     }
     else if ( stat == SatBool3::False ) {
-      // 反例をパタンに加えておく．
-      add_pat(node);
-
-      ASSERT_COND( node->check_0mark() );
+      // 反例を記録しておく．
+      add_cex();
     }
   }
 
   return stat;
 }
 
-// @breif 直前の SAT の反例を加えて再ハッシュする．
-void
-FraigMgr::add_pat(
-  FraigNode* node
-)
+// @brief 直前の SAT の反例を記録する．
+bool
+FraigMgr::add_cex()
 {
-  if ( FraigNode::mPatSize <= FraigNode::mPatUsed ) {
-    resize_pat(FraigNode::mPatSize * 2);
-  }
-  mPatTable.clear();
-
-  // 反例をパタンに加える．
-  std::uniform_int_distribution<int> rd100(0, 99);
-  for ( auto node1: mAllNodes ) {
-    if ( node1->is_input() ) {
-      std::uint64_t pat = 0UL;
-      if ( mSolver.model_val(node1) == SatBool3::True ) {
-	pat = ~0UL;
-      }
-      else {
-	pat = 0UL;
-      }
-      // ただし一度に64個のパタンを加えるので63個は
-      // 適当にばらつかせる．
-      for ( int b = 1; b < 64; ++ b ) {
-	if ( rd100(mRandGen) <= 3 ) {
-	  pat ^= (1UL << b);
-	}
+  // 同じ反例が既に記録されていたら無視する．
+  std::uint64_t hash = 0UL;
+  vector<SizeType> one_list;
+  for ( auto node: mInputNodes ) {
+    if ( mSolver->model_val(node) == SatBool3::True ) {
+      auto iid = node->input_id();
+      hash ^= mCexKey[iid];
+      one_list.push_back(iid);
+    }
+  }
+  for ( SizeType k = 0; k < mCexNum; ++ k ) {
+    if ( mCexHashList[k] != hash ) {
+      continue;
+    }
+    // ハッシュ値が同じでも異なる反例の場合があるので
+    // ビットベクタを比較する．
+    bool same = true;
+    for ( auto node: mInputNodes ) {
+      bool val = mSolver->model_val(node) == SatBool3::True;
+      bool val_k = static_cast<bool>((mCexPat[node->input_id()] >> k) & 1UL);
+      if ( val != val_k ) {
+	same = false;
+	break;
       }
-      node1->add_pat(pat);
+    }
+    if ( same ) {
+      return false;
+    }
+  }
+
+  std::uint64_t bit = 1UL << mCexNum;
+  for ( auto iid: one_list ) {
+    mCexPat[iid] |= bit;
+  }
+  mCexHashList.push_back(hash);
+  ++ mCexNum;
+  ++ mCexTime;
+
+  if ( mCexNum < 64 ) {
+    return false;
+  }
+
+  flush_cex();
+  return true;
+}
+
+// @brief 記録された反例をパタンに加える．
+void
+FraigMgr::flush_cex()
+{
+  if ( mCexNum == 0 ) {
+    return;
+  }
+
+  if ( mNodes.pat_size() <= mPatUsed ) {
+    mNodes.resize_pat(mNodes.pat_size() * 2, mPatUsed);
+  }
+
+  // ノード番号の順はトポロジカル順なので
+  // 前から順に1語分のシミュレーションを行う．
+  // ノードオブジェクトには触れずに配列だけを順に読み書きする．
+  SizeType pos = mPatUsed;
+  SizeType n = node_num();
+  for ( SizeType id = 0; id < n; ++ id ) {
+    auto lit0 = mNodes.fanin_lit(id, 0);
+    if ( mNodes.is_input(id) ) {
+      mNodes.pat_row(id)[pos] = mCexPat[lit0];
     }
     else {
-      node1->calc_pat(FraigNode::mPatUsed, FraigNode::mPatUsed + 1);
+      auto lit1 = mNodes.fanin_lit(id, 1);
+      auto mask0 = (lit0 & 1) ? ~0UL : 0UL;
+      auto mask1 = (lit1 & 1) ? ~0UL : 0UL;
+      auto val0 = mNodes.pat(lit0 >> 1)[pos] ^ mask0;
+      auto val1 = mNodes.pat(lit1 >> 1)[pos] ^ mask1;
+      mNodes.pat_row(id)[pos] = val0 & val1;
     }
+    mNodes.calc_mark(id, pos, pos + 1);
+  }
+  ++ mPatUsed;
+
+  // 追加された語で区別されるクラスのみが分割される．
+  mPatTable.refine(pos);
+
+  for ( auto& pat: mCexPat ) {
+    pat = 0UL;
+  }
+  mCexHashList.clear();
+  mCexNum = 0;
+  ++ mCexTime;
+}
 
-    if ( node1 != node ) {
-      mPatTable.insert(node1);
+// @brief 記録中の反例に対するノードの値を返す．
+std::uint64_t
+FraigMgr::cex_val(
+  SizeType id
+)
+{
+  if ( mCexTimeArray[id] == mCexTime ) {
+    return mCexValArray[id];
+  }
+
+  // 値の求まっていないファンインを先に処理する．
+  // 再帰を用いると深い AIG でスタックが溢れるので
+  // 明示的なスタックを用いる．
+  mCexStack.clear();
+  mCexStack.push_back(id);
+  while ( !mCexStack.empty() ) {
+    auto id1 = mCexStack.back();
+    if ( mCexTimeArray[id1] == mCexTime ) {
+      mCexStack.pop_back();
+      continue;
+    }
+    auto lit0 = mNodes.fanin_lit(id1, 0);
+    if ( mNodes.is_input(id1) ) {
+      mCexValArray[id1] = mCexPat[lit0];
     }
+    else {
+      auto lit1 = mNodes.fanin_lit(id1, 1);
+      auto src0 = lit0 >> 1;
+      auto src1 = lit1 >> 1;
+      bool ready = true;
+      for ( auto src: {src0, src1} ) {
+	if ( mCexTimeArray[src] != mCexTime ) {
+	  mCexStack.push_back(src);
+	  ready = false;
+	}
+      }
+      if ( !ready ) {
+	continue;
+      }
+      auto mask0 = (lit0 & 1) ? ~0UL : 0UL;
+      auto mask1 = (lit1 & 1) ? ~0UL : 0UL;
+      mCexValArray[id1] = (mCexValArray[src0] ^ mask0) & (mCexValArray[src1] ^ mask1);
+    }
+    mCexTimeArray[id1] = mCexTime;
+    mCexStack.pop_back();
   }
-  ++ FraigNode::mPatUsed;
+  return mCexValArray[id];
 }
 
 // @brief ノードを登録する．
@@ -377,8 +870,10 @@ FraigMgr::reg_node(
   FraigNode* node
 )
 {
-  mSolver.reg_node(node);
-  mAllNodes.push_back(node);
+  mSolver->reg_node(node);
+  mRepArray.push_back(FraigHandle{node, false});
+  mCexValArray.push_back(0UL);
+  mCexTimeArray.push_back(0);
 }
 
 // @brief ログレベルを設定する．
@@ -402,16 +897,90 @@ FraigMgr::set_logstream(
   mLogStream = out;
 }
 
-// @brief 全ノードのシミュレーションパタン用配列を拡大する．
+// @brief ハンドルの推移的ファンインの CNF を作る．
+void
+FraigMgr::make_cone_cnf(
+  FraigSat& solver,
+  FraigHandle handle
+) const
+{
+  if ( handle.is_const() ) {
+    return;
+  }
+
+  // 深いネットワークでもスタックを溢れさせないように
+  // 再帰を用いずに帰りがけ順にたどる．
+  vector<FraigNode*> node_stack{handle.node()};
+  while ( !node_stack.empty() ) {
+    auto node = node_stack.back();
+    if ( solver.is_registered(node) ) {
+      node_stack.pop_back();
+      continue;
+    }
+    if ( node->is_input() ) {
+      solver.reg_node(node);
+      node_stack.pop_back();
+      continue;
+    }
+    auto handle1 = rep_handle(node->fanin0_handle());
+    auto handle2 = rep_handle(node->fanin1_handle());
+    bool ready = true;
+    for ( auto h: {handle1, handle2} ) {
+      if ( !h.is_const() && !solver.is_registered(h.node()) ) {
+	node_stack.push_back(h.node());
+	ready = false;
+      }
+    }
+    if ( ready ) {
+      solver.reg_node(node);
+      solver.make_cnf(node, handle1, handle2);
+      node_stack.pop_back();
+    }
+  }
+}
+
+// @brief solver の直前の SAT の結果から反例を作る．
+vector<bool>
+FraigMgr::make_cex(
+  FraigSat& solver,
+  FraigHandle aig1,
+  FraigHandle aig2
+) const
+{
+  vector<bool> cex(input_num(), false);
+  if ( aig1.node() == aig2.node() ) {
+    // 互いに否定の関係なのでどの入力値でも反例となる．
+    // この場合は SAT を解いていない．
+    return cex;
+  }
+  for ( auto node: mInputNodes ) {
+    if ( solver.is_registered(node) &&
+	 solver.model_val(node) == SatBool3::True ) {
+      cex[node->input_id()] = true;
+    }
+  }
+  return cex;
+}
+
+// @brief AND ノードのパタンを計算する．
 void
-FraigMgr::resize_pat(
-  SizeType size
+FraigMgr::calc_pat(
+  SizeType id,
+  SizeType start,
+  SizeType end
 )
 {
-  for ( auto node: mAllNodes ) {
-    node->resize_pat(size);
+  auto lit0 = mNodes.fanin_lit(id, 0);
+  auto lit1 = mNodes.fanin_lit(id, 1);
+  auto mask0 = (lit0 & 1) ? ~0UL : 0UL;
+  auto mask1 = (lit1 & 1) ? ~0UL : 0UL;
+  auto src0 = mNodes.pat(lit0 >> 1);
+  auto src1 = mNodes.pat(lit1 >> 1);
+  auto dst = mNodes.pat_row(id);
+  for ( SizeType i = start; i < end; ++ i ) {
+    dst[i] = (src0[i] ^ mask0) & (src1[i] ^ mask1);
   }
-  FraigNode::mPatSize = size;
+  mNodes.calc_mark(id, start, end);
 }
 
 // @brief 内部の統計情報を出力する．
@@ -420,7 +989,7 @@ FraigMgr::dump_stats(
   ostream& s
 )
 {
-  mSolver.dump_stats(s);
+  mSolver->dump_stats(s);
 }
 
 END_NAMESPACE_FRAIG
@@ -10,10 +10,12 @@
 
 #include "fraig_nsdef.h"
 #include "FraigHandle.h"
+#include "FraigNode.h"
 #include "StructTable.h"
 #include "PatTable.h"
 #include "FraigSat.h"
 #include <random>
+#include <memory>
 
 #include "ym/SatBool3.h"
 #include "ym/SatInitParam.h"
@@ -66,7 +68,7 @@ public:
   SizeType
   node_num() const
   {
-    return mAllNodes.size();
+    return mNodes.node_num();
   }
 
   /// @brief ノードを取り出す．
@@ -79,7 +81,7 @@ public:
   {
     ASSERT_COND( pos >= 0 && pos < node_num() );
 
-    return mAllNodes[pos];
+    return mNodes.node(pos);
   }
 
 
@@ -113,7 +115,24 @@ public:
     FraigHandle edge2  ///< [in] 入力2のハンドル
   );
 
+  /// @brief 代表のハンドルを返す．
+  ///
+  /// 等価なノードが見つかっている場合にはそのノードのハンドルを返す．
+  /// sweep() で処理されていないノードの場合はそのまま返す．
+  FraigHandle
+  rep_handle(
+    FraigHandle handle ///< [in] 対象のハンドル
+  ) const
+  {
+    if ( handle.is_const() ) {
+      return handle;
+    }
+    return mRepArray[handle.node()->id()] ^ handle.inv();
+  }
+
   /// @brief コファクターを計算する．
+  ///
+  /// inv が true の時は入力を 0 に，false の時は 1 に固定する．
   FraigHandle
   make_cofactor(
     FraigHandle edge, ///< [in] 対象のハンドル
@@ -121,6 +140,111 @@ public:
     bool inv          ///< [in] 反転フラグ
   );
 
+  /// @brief 複数の入力の値を固定したコファクターを計算する．
+  /// @return edge_list と同じ順に結果を返す．
+  ///
+  /// assign_list の各要素は (入力番号, 値) の対
+  vector<FraigHandle>
+  make_cofactor(
+    const vector<FraigHandle>& edge_list,           ///< [in] 対象のハンドルのリスト
+    const vector<pair<SizeType, bool>>& assign_list ///< [in] 割り当てのリスト
+  );
+
+  /// @brief 複数の割り当てに対するコファクターを一度にまとめて計算する．
+  /// @return 割り当てごとの結果のリストを返す．
+  ///
+  /// 推移的ファンインを1回たどるだけで全ての割り当てに対する結果を求める．
+  /// 例えばある入力の正負のコファクターを同時に求めることができる．
+  vector<vector<FraigHandle>>
+  make_cofactor_batch(
+    const vector<FraigHandle>& edge_list,                        ///< [in] 対象のハンドルのリスト
+    const vector<vector<pair<SizeType, bool>>>& assign_list_list ///< [in] 割り当てのリストのリスト
+  );
+
+  /// @brief 存在量化を行う．
+  ///
+  /// input_id_list の入力について順に f = f|x=0 + f|x=1 を計算する．
+  FraigHandle
+  make_exists(
+    FraigHandle edge,                     ///< [in] 対象のハンドル
+    const vector<SizeType>& input_id_list ///< [in] 量化する入力番号のリスト
+  );
+
+  /// @brief 全称量化を行う．
+  ///
+  /// input_id_list の入力について順に f = f|x=0 & f|x=1 を計算する．
+  FraigHandle
+  make_forall(
+    FraigHandle edge,                     ///< [in] 対象のハンドル
+    const vector<SizeType>& input_id_list ///< [in] 量化する入力番号のリスト
+  );
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // FRAIG sweeping 用の関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief sweep モードを設定する．
+  ///
+  /// sweep モードでは make_and() は構造ハッシュのみを用いてノードを作り，
+  /// 論理的に等価なノードの検出は sweep() でまとめて行う．
+  /// sweep モードでない時は make_and() の中で sweep() が呼ばれる．
+  void
+  set_sweep_mode(
+    bool sweep_mode ///< [in] sweep モードの時 true にする．
+  )
+  {
+    mSweepMode = sweep_mode;
+  }
+
+  /// @brief 未処理のノードに対して等価なノードを求める．
+  ///
+  /// ノード番号の順(トポロジカル順)に処理する．
+  /// 各ノードはパタンが等しいクラスのノードとのみ SAT で比較し，
+  /// 得られた反例は64個まとめてシミュレーションして全クラスを一度に分割する．
+  /// 結果は rep_handle() で参照できる．
+  void
+  sweep();
+
+  /// @brief 修正版の区間を開始する．
+  ///
+  /// これ以降に SATソルバに加えられる節(CNF と証明された等価関係)は
+  /// この区間の活性化リテラルで有効になり，
+  /// 区間の開始時のノード数以下への truncate() でまとめて無効になる．
+  void
+  begin_revision();
+
+  /// @brief 後から作られたノードを削除する．
+  ///
+  /// node_num() が num だった時点の状態に戻す．
+  /// 削除されたノードのハンドルはそれ以降使ってはいけない．
+  /// それまでに加えられたシミュレーションパタンは残したまま，
+  /// 構造ハッシュとパタンハッシュからノードを取り除く．
+  /// SATソルバは作り直さない．削除されたノードの番号は後で別のノードに使われるが，
+  /// SATソルバではそのノードに新しい変数を割り当てる．
+  /// num が begin_revision() の時点のノード数以下なら修正版の区間を終了し，
+  /// 区間中の節を無効にしてその変数を後で作るノードに使い回す．
+  /// 削除するノードに入力ノードが含まれていてはいけない．
+  void
+  truncate(
+    SizeType num ///< [in] 残すノード数
+  );
+
+  /// @brief SATソルバの変数の数を返す．
+  SizeType
+  sat_variable_num() const
+  {
+    return mSolver->variable_num();
+  }
+
+  /// @brief SATソルバの有効な節の数を返す．
+  SizeType
+  sat_clause_num() const
+  {
+    return mSolver->clause_num();
+  }
+
 
 public:
   //////////////////////////////////////////////////////////////////////
@@ -134,6 +258,67 @@ public:
     FraigHandle aig2  ///< [in] 入力2のハンドル
   );
 
+  /// @brief 複数のハンドルの対の等価性を複数のスレッドで調べる．
+  /// @return pair_list と同じ順番で結果を返す．
+  ///
+  /// sweep() を行った後の AIG を読み出し専用として共有し，
+  /// スレッドごとに自分の SATソルバを持って対を1つずつ取り出して調べる．
+  /// CNF は取り出した対の推移的ファンインのみをその都度加えるので
+  /// 同じスレッドが続けて調べる対の間では節と学習節が再利用される．
+  /// あるスレッドで等価と証明された対は他のスレッドのソルバにも加えられる．
+  /// thread_num が 1 以下の時は check_equiv() を順に呼ぶ．
+  /// 結果が SatBool3::False の対については cex_list に反例を入れる．
+  /// それ以外の対の cex_list の要素は空になる．
+  vector<SatBool3>
+  check_equiv_mt(
+    const vector<pair<FraigHandle, FraigHandle>>& pair_list, ///< [in] 対象のハンドルの対のリスト
+    SizeType thread_num,                                     ///< [in] スレッド数
+    vector<vector<bool>>& cex_list                           ///< [out] 反例のリスト
+  );
+
+  /// @brief 直前の check_equiv() の反例を返す．
+  ///
+  /// check_equiv(aig1, aig2) が SatBool3::False を返した直後に呼ぶ．
+  /// 反例は入力番号の順の入力値のリストで表す．
+  vector<bool>
+  get_cex(
+    FraigHandle aig1, ///< [in] 入力1のハンドル
+    FraigHandle aig2  ///< [in] 入力2のハンドル
+  )
+  {
+    return make_cex(*mSolver, aig1, aig2);
+  }
+
+  /// @brief 1回の SAT の呼び出しあたりの制限を設定する．
+  ///
+  /// 0 の場合は制限なしとなる．
+  void
+  set_sat_budget(
+    SizeType conflict_budget,   ///< [in] コンフリクト数の上限
+    SizeType propagation_budget ///< [in] implication 数の上限
+  )
+  {
+    mSolver->set_budget(conflict_budget, propagation_budget);
+  }
+
+  /// @brief 全体の制限時間を設定する．
+  ///
+  /// 0 の場合は制限なしとなる．
+  void
+  set_time_limit(
+    double time_limit ///< [in] 制限時間(秒)
+  )
+  {
+    mSolver->set_time_limit(time_limit);
+  }
+
+  /// @brief 制限時間を過ぎていたら true を返す．
+  bool
+  time_over() const
+  {
+    return mSolver->time_over();
+  }
+
   /// @brief ログレベルを設定する．
   void
   set_loglevel(
@@ -158,6 +343,53 @@ private:
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 自明な AND の処理を行う．
+  /// @return 結果が自明な場合は ans に結果を入れて true を返す．
+  ///
+  /// 自明でない場合は handle1, handle2 の順番を正規化して false を返す．
+  bool
+  simple_and(
+    FraigHandle& handle1, ///< [inout] 入力1のハンドル
+    FraigHandle& handle2, ///< [inout] 入力2のハンドル
+    FraigHandle& ans      ///< [out] 結果
+  );
+
+  /// @brief 入力を置き換えた関数をまとめて計算する．
+  /// @return 置き換えのリストごとの結果のリストを返す．
+  ///
+  /// input_map_list の各要素は入力番号をキーにして置き換え先のハンドルを
+  /// 格納した配列である．
+  /// edge_list の推移的ファンインをノード番号の順(トポロジカル順)に
+  /// 1回だけ処理するので計算量は推移的ファンインのサイズに比例する．
+  vector<vector<FraigHandle>>
+  compose(
+    const vector<FraigHandle>& edge_list,             ///< [in] 対象のハンドルのリスト
+    const vector<vector<FraigHandle>>& input_map_list ///< [in] 置き換えのリストのリスト
+  );
+
+  /// @brief 割り当てを入力の置き換えのリストに変換する．
+  vector<FraigHandle>
+  assign_to_map(
+    const vector<pair<SizeType, bool>>& assign_list ///< [in] 割り当てのリスト
+  ) const;
+
+  /// @brief 量化を行う．
+  FraigHandle
+  quantify(
+    FraigHandle edge,                      ///< [in] 対象のハンドル
+    const vector<SizeType>& input_id_list, ///< [in] 量化する入力番号のリスト
+    bool exists                            ///< [in] 存在量化の時 true
+  );
+
+  /// @brief 論理的に等価なノードを探す．
+  /// @return 等価なハンドルを返す．
+  ///
+  /// 見つからなかった場合は node をパタンテーブルに登録して node 自身を返す．
+  FraigHandle
+  find_equiv(
+    FraigNode* node ///< [in] 対象のノード
+  );
+
   /// @brief 縮退検査を行う．
   /// @retval SatBool3::True 定数に縮退していた．
   /// @retval SatBool3::False 定数ではなかった．
@@ -177,18 +409,65 @@ private:
     FraigNode* node ///< [in] 対象のノード
   );
 
-  /// @brief 全ノードのシミュレーションパタン用配列を拡大する．
+  /// @brief ハンドルの推移的ファンインの CNF を作る．
+  ///
+  /// ファンインは代表のハンドルに置き換える．
+  /// solver に登録済みのノードはたどらない．
+  void
+  make_cone_cnf(
+    FraigSat& solver,  ///< [in] 対象のソルバ
+    FraigHandle handle ///< [in] 対象のハンドル
+  ) const;
+
+  /// @brief solver の直前の SAT の結果から反例を作る．
+  ///
+  /// solver に登録されていない入力の値は 0 とする．
+  vector<bool>
+  make_cex(
+    FraigSat& solver, ///< [in] 対象のソルバ
+    FraigHandle aig1, ///< [in] 入力1のハンドル
+    FraigHandle aig2  ///< [in] 入力2のハンドル
+  ) const;
+
+  /// @brief AND ノードのパタンを計算する．
   void
-  resize_pat(
-    SizeType size ///< [in] サイズ
+  calc_pat(
+    SizeType id,    ///< [in] ノード番号
+    SizeType start, ///< [in] 開始位置
+    SizeType end    ///< [in] 終了位置
   );
 
-  /// @breif 直前の SAT の反例を加えて再ハッシュする．
+  /// @brief 直前の SAT の反例を記録する．
+  /// @return 反例がまとまってパタンに加えられた時 true を返す．
+  ///
+  /// 反例は1語(64個)たまるまでパタンに加えない．
+  /// true が返された時はパタンテーブルのクラスも更新されている．
+  bool
+  add_cex();
+
+  /// @brief 記録された反例をパタンに加える．
+  ///
+  /// 全ノードについて1語分のシミュレーションを行い，
+  /// パタンテーブルのクラスを分割する．
   void
-  add_pat(
-    FraigNode* node ///< [in] 対象のノード
+  flush_cex();
+
+  /// @brief 記録中の反例に対するノードの値を返す．
+  ///
+  /// k 番目のビットが k 番目の反例に対する値を表す．
+  /// 値が求まっていない推移的ファンインのみをたどって計算する．
+  std::uint64_t
+  cex_val(
+    SizeType id ///< [in] ノード番号
   );
 
+  /// @brief 記録中の反例の有効なビットのマスクを返す．
+  std::uint64_t
+  cex_mask() const
+  {
+    return (1UL << mCexNum) - 1UL;
+  }
+
   /// @brief ノードを登録する．
   void
   reg_node(
@@ -201,23 +480,68 @@ private:
   // データメンバ
   //////////////////////////////////////////////////////////////////////
 
-  // ID 番号をキーにしたノードの配列
-  vector<FraigNode*> mAllNodes;
+  // ノードの本体を格納する配列
+  // ファンインやパタンはノード番号をキーにした配列で持つ．
+  FraigNodeArray mNodes;
 
   // 入力ノードの配列
   vector<FraigNode*> mInputNodes;
 
+  // 使用中の語数
+  SizeType mPatUsed;
+
   // 構造ハッシュ
   StructTable mStructTable;
 
   // パタンハッシュ
   PatTable mPatTable;
 
+  // ノード番号をキーにして代表のハンドルを格納する配列
+  vector<FraigHandle> mRepArray;
+
+  // sweep モード
+  bool mSweepMode{false};
+
+  // sweep() で処理済みのノード数
+  SizeType mSweptNum{0};
+
+  // 入力番号をキーにして記録中の反例を格納する配列
+  // k 番目のビットが k 番目の反例の値を表す．
+  vector<std::uint64_t> mCexPat;
+
+  // 記録中の反例の数
+  SizeType mCexNum{0};
+
+  // 入力番号をキーにして反例のハッシュ用の乱数を格納する配列
+  vector<std::uint64_t> mCexKey;
+
+  // 記録中の反例のハッシュ値のリスト
+  // 重複した反例を除くために用いる．
+  vector<std::uint64_t> mCexHashList;
+
+  // ノード番号をキーにして記録中の反例に対する値を格納する配列
+  vector<std::uint64_t> mCexValArray;
+
+  // ノード番号をキーにして mCexValArray の値を求めた時刻を格納する配列
+  vector<SizeType> mCexTimeArray;
+
+  // 記録中の反例が変わるたびに増やす時刻
+  SizeType mCexTime{1};
+
+  // cex_val() で用いる作業領域
+  vector<SizeType> mCexStack;
+
   // 乱数発生器
   std::mt19937 mRandGen;
 
+  // SATソルバの初期化パラメータ
+  SatInitParam mInitParam;
+
   // SATソルバ
-  FraigSat mSolver;
+  std::unique_ptr<FraigSat> mSolver;
+
+  // 修正版の区間の開始時のノード数
+  SizeType mRevisionBase{0};
 
   // recsolver 用のストリーム
   ostream* mOutP;
@@ -10,34 +10,37 @@
 
 #include "fraig_nsdef.h"
 #include "FraigHandle.h"
+#include <deque>
+#include <algorithm>
 
 
 BEGIN_NAMESPACE_FRAIG
 
+class FraigNodeArray;
+
 //////////////////////////////////////////////////////////////////////
 /// @class FraigNode FraigNode.h "FraigNode.h"
 /// @brief Fraig のノードを表すクラス
+///
+/// ノードの情報は FraigNodeArray の配列にノード番号をキーにして
+/// 格納されており，このクラスはそれをノード番号で参照するだけである．
+/// FraigHandle がポインタを保持するためにオブジェクトとして存在する．
 //////////////////////////////////////////////////////////////////////
 class FraigNode
 {
 public:
 
-  /// @brief 入力用のコンストラクタ
-  FraigNode(
-    SizeType id,                     ///< [in] ノード番号
-    SizeType input_id,               ///< [in] 入力番号
-    const vector<std::uint64_t>& init_pat ///< [in] 初期パタン
-  );
-
-  /// @brief AND用のコンストラクタ
+  /// @brief コンストラクタ
   FraigNode(
-    SizeType id,         ///< [in] ノード番号
-    FraigHandle handle1, ///< [in] 入力1のハンドル
-    FraigHandle handle2  ///< [in] 入力2のハンドル
-  );
+    SizeType id,                ///< [in] ノード番号
+    const FraigNodeArray* array ///< [in] 本体の配列
+  ) : mId{id},
+      mArray{array}
+  {
+  }
 
   /// @brief デストラクタ
-  ~FraigNode();
+  ~FraigNode() = default;
 
 
 public:
@@ -60,17 +63,11 @@ public:
 
   /// @brief 入力ノードの時に true を返す．
   bool
-  is_input() const
-  {
-    return mFlags[BIT_I];
-  }
+  is_input() const;
 
   /// @brief 入力番号を返す．
   SizeType
-  input_id() const
-  {
-    return reinterpret_cast<PtrIntType>(mFanins[0]);
-  }
+  input_id() const;
 
 
 public:
@@ -91,23 +88,21 @@ public:
     SizeType pos ///< [in] 位置 ( 0 or 1 )
   ) const
   {
-    // 安全のため pos の値を補正しておく．
-    pos &= 1;
-    return mFanins[pos];
+    return fanin_handle(pos).node();
   }
 
   /// @brief 1番めのファンインを得る．
   FraigNode*
   fanin0() const
   {
-    return mFanins[0];
+    return fanin(0);
   }
 
   /// @brief 2番めのファンインを得る．
   FraigNode*
   fanin1() const
   {
-    return mFanins[1];
+    return fanin(1);
   }
 
   /// @brief ファンインの極性を得る．
@@ -116,46 +111,41 @@ public:
     SizeType pos ///< [in] 位置 ( 0 or 1 )
   ) const
   {
-    // 安全のため pos の値を補正しておく．
-    pos &= 1;
-    return mFlags[BIT_INV0 + pos];
+    return fanin_handle(pos).inv();
   }
 
   /// @brief 1番めのファンインの極性を得る．
   bool
   fanin0_inv() const
   {
-    return mFlags[BIT_INV0];
+    return fanin_inv(0);
   }
 
   /// @brief 2番めのファンインの極性を得る．
   bool
   fanin1_inv() const
   {
-    return mFlags[BIT_INV1];
+    return fanin_inv(1);
   }
 
   /// @brief ファンインのハンドルを得る．
   FraigHandle
   fanin_handle(
     SizeType pos ///< [in] 位置 ( 0 or 1 )
-  ) const
-  {
-    return FraigHandle(fanin(pos), fanin_inv(pos));
-  }
+  ) const;
 
   /// @brief 1番め初のファンインのハンドルを得る．
   FraigHandle
   fanin0_handle() const
   {
-    return FraigHandle(fanin0(), fanin0_inv());
+    return fanin_handle(0);
   }
 
   /// @brief 2番めのファンインのハンドルを得る．
   FraigHandle
   fanin1_handle() const
   {
-    return FraigHandle(fanin1(), fanin1_inv());
+    return fanin_handle(1);
   }
 
 
@@ -164,173 +154,370 @@ public:
   // シミュレーション・パタンに関するアクセス関数
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief パタンを初期化する．
-  void
-  resize_pat(
-    SizeType size ///< [in] サイズ
-  );
+  /// @brief パタンの先頭を返す．
+  ///
+  /// 有効な語数は FraigMgr が管理する．
+  const std::uint64_t*
+  pat() const;
 
-  /// @brief パタンを追加する．
-  void
-  add_pat(
-    std::uint64_t pat ///< [in] 追加するパタン
-  );
+  /// @brief 0 の値を取るとき true を返す．
+  bool
+  check_0mark() const;
 
-  /// @brief パタンを計算する．
+  /// @brief 1 の値を取るとき true を返す．
+  bool
+  check_1mark() const;
+
+  /// @brief パタンの極性を返す．
   ///
-  /// ANDノード用
-  void
-  calc_pat(
-    SizeType start, ///< [in] 開始位置
-    SizeType end    ///< [in] 終了位置
-  );
+  /// 先頭のビットが 1 の時 true となる．
+  /// PatTable では極性を正規化したパタンで比較する．
+  bool
+  pat_hash_inv() const;
 
-  /// @brief パタンの先頭を返す．
-  const std::uint64_t*
-  pat() const
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ID番号
+  SizeType mId;
+
+  // 本体の配列
+  const FraigNodeArray* mArray;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class FraigNodeArray FraigNode.h "FraigNode.h"
+/// @brief FraigNode の本体を格納する配列
+///
+/// ファンイン，フラグ，シミュレーションパタンを
+/// ノード番号をキーにした配列で持つ．
+/// パタンの領域の先頭は 64 バイト境界に揃え，
+/// ノードごとには詰めて並べる．
+//////////////////////////////////////////////////////////////////////
+class FraigNodeArray
+{
+public:
+
+  /// @brief コンストラクタ
+  FraigNodeArray(
+    SizeType pat_size ///< [in] 1ノードあたりの語数の初期値
+  ) : mPatSize{std::max<SizeType>(pat_size, 1)}
   {
-    return mPat;
   }
 
-  /// @brief パタンの末尾を返す．
-  const std::uint64_t*
-  pat_end() const
+  /// @brief コピーコンストラクタは禁止
+  ///
+  /// FraigNode が自身へのポインタを持つため．
+  FraigNodeArray(
+    const FraigNodeArray& src
+  ) = delete;
+
+  /// @brief 代入演算子は禁止
+  FraigNodeArray&
+  operator=(
+    const FraigNodeArray& src
+  ) = delete;
+
+  /// @brief デストラクタ
+  ~FraigNodeArray() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 内容を取得する関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ノード数を返す．
+  SizeType
+  node_num() const
   {
-    return mPat + mPatUsed;
+    return mNodeList.size();
   }
 
-  /// @brief 0 の値を取るとき true を返す．
-  bool
-  check_0mark() const
+  /// @brief ノードを返す．
+  FraigNode*
+  node(
+    SizeType id ///< [in] ノード番号 ( 0 <= id < node_num() )
+  ) const
   {
-    return mFlags[BIT_0];
+    return mNodeList[id];
   }
 
-  /// @brief 1 の値を取るとき true を返す．
+  /// @brief 入力ノードの時 true を返す．
   bool
-  check_1mark() const
+  is_input(
+    SizeType id ///< [in] ノード番号
+  ) const
   {
-    return mFlags[BIT_1];
+    return static_cast<bool>(mFlagArray[id] & FLAG_I);
   }
 
-  /// @brief パタンのハッシュ値を返す．
+  /// @brief 入力番号を返す．
   SizeType
-  pat_hash() const
+  input_id(
+    SizeType id ///< [in] ノード番号
+  ) const
   {
-    return mHash;
+    return mFaninArray[id * 2 + 0];
   }
 
-  /// @brief ハッシュ値の極性を返す．
-  bool
-  pat_hash_inv() const
+  /// @brief ファンインのリテラルを返す．
+  ///
+  /// リテラルはノード番号 x 2 + 極性で表す．
+  SizeType
+  fanin_lit(
+    SizeType id, ///< [in] ノード番号
+    SizeType pos ///< [in] 位置 ( 0 or 1 )
+  ) const
   {
-    return mFlags[BIT_H];
+    return mFaninArray[id * 2 + (pos & 1)];
   }
 
+  /// @brief ファンインのハンドルを返す．
+  FraigHandle
+  fanin_handle(
+    SizeType id, ///< [in] ノード番号
+    SizeType pos ///< [in] 位置 ( 0 or 1 )
+  ) const
+  {
+    auto lit = fanin_lit(id, pos);
+    return FraigHandle{mNodeList[lit >> 1], static_cast<bool>(lit & 1)};
+  }
 
-private:
-  //////////////////////////////////////////////////////////////////////
-  // 下請け関数
-  //////////////////////////////////////////////////////////////////////
+  /// @brief フラグを返す．
+  bool
+  check_flag(
+    SizeType id,      ///< [in] ノード番号
+    std::uint8_t flag ///< [in] フラグ
+  ) const
+  {
+    return static_cast<bool>(mFlagArray[id] & flag);
+  }
 
-  /// @brief ハッシュ値を計算する．
-  void
-  calc_hash(
-    SizeType start, ///< [in] 開始位置
-    SizeType end    ///< [in] 終了位置
-  );
+  /// @brief パタンの先頭を返す．
+  const std::uint64_t*
+  pat(
+    SizeType id ///< [in] ノード番号
+  ) const
+  {
+    return mPatPool.data() + mPatOffset + id * mPatSize;
+  }
 
-  /// @brief 0 の値を取ったことを記録する．
-  void
-  set_0mark()
+  /// @brief 書き込み用にパタンの先頭を返す．
+  std::uint64_t*
+  pat_row(
+    SizeType id ///< [in] ノード番号
+  )
   {
-    mFlags[BIT_0] = true;
+    return mPatPool.data() + mPatOffset + id * mPatSize;
   }
 
-  /// @brief 1 の値を取ったことを記録する．
-  void
-  set_1mark()
+  /// @brief 1ノードあたりの語数を返す．
+  SizeType
+  pat_size() const
   {
-    mFlags[BIT_1] = true;
+    return mPatSize;
   }
 
 
-private:
+public:
   //////////////////////////////////////////////////////////////////////
-  // データメンバ
+  // 内容を変更する関数
   //////////////////////////////////////////////////////////////////////
 
-  // ID番号
-  SizeType mId;
+  /// @brief 入力ノードを作る．
+  ///
+  /// ノード番号は node_num() となる．
+  /// パタンの内容は呼び出し側で設定する．
+  FraigNode*
+  new_input(
+    SizeType input_id ///< [in] 入力番号
+  );
 
-  // ファンインのノード
-  FraigNode* mFanins[2]{nullptr, nullptr};
+  /// @brief AND ノードを作る．
+  ///
+  /// ノード番号は node_num() となる．
+  /// パタンの内容は呼び出し側で設定する．
+  FraigNode*
+  new_and(
+    FraigHandle handle1, ///< [in] 入力1のハンドル
+    FraigHandle handle2  ///< [in] 入力2のハンドル
+  );
 
-  // 0/1マーク，極性などの情報をパックしたもの
-  bitset<7> mFlags{0};
+  /// @brief 0/1マークとパタンの極性を更新する．
+  ///
+  /// [start, end) の語を書き込んだ後で呼ぶ．
+  void
+  calc_mark(
+    SizeType id,    ///< [in] ノード番号
+    SizeType start, ///< [in] 開始位置
+    SizeType end    ///< [in] 終了位置
+  );
 
-  // シミュレーションパタン
-  std::uint64_t* mPat{nullptr};
+  /// @brief 1ノードあたりの語数を変更する．
+  ///
+  /// 既存のノードのパタンは先頭の used 語のみコピーされる．
+  void
+  resize_pat(
+    SizeType size, ///< [in] 新しい語数
+    SizeType used  ///< [in] 使用中の語数
+  );
 
-  // mPat のハッシュ値
-  SizeType mHash{0UL};
+  /// @brief ノード番号が num 以上のノードを削除する．
+  void
+  truncate(
+    SizeType num ///< [in] 残すノード数
+  );
 
 
-private:
+public:
   //////////////////////////////////////////////////////////////////////
-  // クラスメンバ
+  // フラグの定数
   //////////////////////////////////////////////////////////////////////
 
-  // ハッシュ用の素数配列
+  // 入力フラグ
+  static
+  const std::uint8_t FLAG_I = 1U;
+
+  // 0 になったことがあるかどうか
+  static
+  const std::uint8_t FLAG_0 = 2U;
+
+  // 1 になったことがあるかどうか
   static
-  std::uint64_t mPrimes[];
+  const std::uint8_t FLAG_1 = 4U;
 
+  // パタンの極性
+  static
+  const std::uint8_t FLAG_H = 8U;
 
-public:
+
+private:
   //////////////////////////////////////////////////////////////////////
-  // クラスメンバ
+  // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
-  // 実際のパタンサイズ
-  static
-  SizeType mPatSize;
+  /// @brief ノードを追加する．
+  FraigNode*
+  new_node(
+    SizeType lit0,    ///< [in] ファンイン0のリテラル(入力の場合は入力番号)
+    SizeType lit1,    ///< [in] ファンイン1のリテラル
+    std::uint8_t flag ///< [in] フラグ
+  );
 
-  // 使用中のパタンサイズ
-  static
-  SizeType mPatUsed;
+  /// @brief パタンの領域を確保し直す．
+  void
+  realloc_pat(
+    SizeType node_cap, ///< [in] ノード数
+    SizeType size,     ///< [in] 1ノードあたりの語数
+    SizeType used      ///< [in] コピーする語数
+  );
 
 
 private:
   //////////////////////////////////////////////////////////////////////
-  // mFlags で用いるシフト定数
+  // データメンバ
   //////////////////////////////////////////////////////////////////////
 
-  // 入力フラグ
-  static
-  const int BIT_I  = 0;
+  // ノードの本体(ビュー)を格納する配列
+  // FraigHandle がポインタを保持するので
+  // 要素が移動しない std::deque を用いる．
+  std::deque<FraigNode> mNodeArray;
 
-  // ファンイン0 の極性
-  static
-  const int BIT_INV0 = 1;
+  // ノード番号をキーにしてノードを格納する配列
+  vector<FraigNode*> mNodeList;
 
-  // ファンイン1 の極性
-  static
-  const int BIT_INV1 = 2;
+  // ノード番号 x 2 + ファンイン番号をキーにして
+  // ファンインのリテラル(ノード番号 x 2 + 極性)を格納する配列
+  // 入力ノードの場合は先頭に入力番号を格納する．
+  vector<SizeType> mFaninArray;
 
-  // 0 になったことがあるかどうか
-  static
-  const int BIT_0  = 3;
+  // ノード番号をキーにしてフラグを格納する配列
+  vector<std::uint8_t> mFlagArray;
 
-  // 1 になったことがあるかどうか
-  static
-  const int BIT_1  = 4;
+  // シミュレーションパタンの領域
+  // mPatOffset + ノード番号 x mPatSize + 語の位置で参照する．
+  vector<std::uint64_t> mPatPool;
 
-  // ハッシュパタンの極性
-  static
-  const int BIT_H  = 5;
+  // mPatPool 上の先頭の位置
+  SizeType mPatOffset{0};
+
+  // mPatPool に確保されているノード数
+  SizeType mPatCapacity{0};
+
+  // 1ノードあたりの語数
+  SizeType mPatSize;
 
 };
 
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 入力ノードの時に true を返す．
+inline
+bool
+FraigNode::is_input() const
+{
+  return mArray->is_input(mId);
+}
+
+// @brief 入力番号を返す．
+inline
+SizeType
+FraigNode::input_id() const
+{
+  return mArray->input_id(mId);
+}
+
+// @brief ファンインのハンドルを得る．
+inline
+FraigHandle
+FraigNode::fanin_handle(
+  SizeType pos
+) const
+{
+  return mArray->fanin_handle(mId, pos);
+}
+
+// @brief パタンの先頭を返す．
+inline
+const std::uint64_t*
+FraigNode::pat() const
+{
+  return mArray->pat(mId);
+}
+
+// @brief 0 の値を取るとき true を返す．
+inline
+bool
+FraigNode::check_0mark() const
+{
+  return mArray->check_flag(mId, FraigNodeArray::FLAG_0);
+}
+
+// @brief 1 の値を取るとき true を返す．
+inline
+bool
+FraigNode::check_1mark() const
+{
+  return mArray->check_flag(mId, FraigNodeArray::FLAG_1);
+}
+
+// @brief パタンの極性を返す．
+inline
+bool
+FraigNode::pat_hash_inv() const
+{
+  return mArray->check_flag(mId, FraigNodeArray::FLAG_H);
+}
+
 END_NAMESPACE_FRAIG
 
 #endif // FRAIGNODE_H
@@ -56,24 +56,142 @@ FraigSat::reg_node(
   FraigNode* node
 )
 {
-  auto var = mSolver.new_variable(true);
+  SatLiteral var;
+  if ( mFreeVarList.empty() ) {
+    var = mSolver.new_variable(true);
+  }
+  else {
+    var = mFreeVarList.back();
+    mFreeVarList.pop_back();
+  }
+  if ( mHasActLit ) {
+    mActVarList.push_back(var);
+  }
   mLiteralDict.emplace(node->id(), var);
 }
 
+// @brief 修正版の区間を開始する．
+void
+FraigSat::begin_revision()
+{
+  ASSERT_COND( !mHasActLit );
+
+  mActLit = mSolver.new_variable(true);
+  mHasActLit = true;
+  mActClauseNum = 0;
+}
+
+// @brief 修正版の区間を終了する．
+void
+FraigSat::end_revision()
+{
+  ASSERT_COND( mHasActLit );
+
+  mHasActLit = false;
+  mSolver.add_clause(~mActLit);
+  mClauseNum -= mActClauseNum;
+  mActClauseNum = 0;
+
+  // 区間中の変数を含む節はすべて ~mActLit を含んでいて
+  // 充足されているのでこれらの変数は制約を持たない．
+  mFreeVarList.insert(mFreeVarList.end(),
+		      mActVarList.begin(), mActVarList.end());
+  mActVarList.clear();
+}
+
 // @brief ノードの入出力の関係を表す CNF 式を作る．
 void
 FraigSat::make_cnf(
   FraigNode* node
 )
 {
-  auto handle1 = node->fanin0_handle();
-  auto handle2 = node->fanin1_handle();
+  make_cnf(node, node->fanin0_handle(), node->fanin1_handle());
+}
+
+// @brief ファンインを指定してノードの入出力の関係を表す CNF 式を作る．
+void
+FraigSat::make_cnf(
+  FraigNode* node,
+  FraigHandle handle1,
+  FraigHandle handle2
+)
+{
   auto lito = node_lit(node);
+  if ( handle1.is_zero() || handle2.is_zero() ) {
+    add_clause({~lito});
+    return;
+  }
+  if ( handle1.is_one() ) {
+    std::swap(handle1, handle2);
+  }
+  if ( handle2.is_one() ) {
+    if ( handle1.is_one() ) {
+      add_clause({lito});
+    }
+    else {
+      auto lit1 = handle_lit(handle1);
+      add_clause({~lit1,  lito});
+      add_clause({ lit1, ~lito});
+    }
+    return;
+  }
   auto lit1 = handle_lit(handle1);
   auto lit2 = handle_lit(handle2);
-  mSolver.add_clause(~lit1, ~lit2, lito);
-  mSolver.add_clause( lit1, ~lito);
-  mSolver.add_clause( lit2, ~lito);
+  add_clause({~lit1, ~lit2, lito});
+  add_clause({ lit1, ~lito});
+  add_clause({ lit2, ~lito});
+}
+
+// @brief 2つのハンドルが等価であるという条件を加える．
+void
+FraigSat::add_equiv(
+  FraigHandle handle1,
+  FraigHandle handle2
+)
+{
+  if ( handle1.is_const() ) {
+    std::swap(handle1, handle2);
+  }
+  if ( handle1.is_const() ) {
+    // 両方とも定数なら何もしない．
+    return;
+  }
+  auto lit1 = handle_lit(handle1);
+  if ( handle2.is_zero() ) {
+    add_clause({~lit1});
+  }
+  else if ( handle2.is_one() ) {
+    add_clause({ lit1});
+  }
+  else {
+    auto lit2 = handle_lit(handle2);
+    add_clause({~lit1,  lit2});
+    add_clause({ lit1, ~lit2});
+  }
+}
+
+// @brief 全体の制限時間を設定する．
+void
+FraigSat::set_time_limit(
+  double time_limit
+)
+{
+  if ( time_limit > 0.0 ) {
+    auto d = std::chrono::duration<double>{time_limit};
+    mDeadline = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(d);
+    mHasDeadline = true;
+  }
+  else {
+    mHasDeadline = false;
+  }
+}
+
+// @brief 制限時間を過ぎていたら true を返す．
+bool
+FraigSat::time_over() const
+{
+  return mHasDeadline && std::chrono::steady_clock::now() >= mDeadline;
 }
 
 // @brief ログレベルを設定する．
@@ -119,6 +237,7 @@ FraigSat::check_const(
 
   Timer timer;
   timer.start();
+  mLastConflictNum = 0;
 
   auto lit = node_lit(node) * inv;
 
@@ -129,7 +248,7 @@ FraigSat::check_const(
   auto stat = check_condition(lit);
   if ( stat == SatBool3::False ) {
     // 成り立たないということは lit = 0
-    mSolver.add_clause(~lit);
+    add_clause({~lit});
     if ( debug ) {
       cout << "\tSUCCEED" << endl;
     }
@@ -148,7 +267,7 @@ FraigSat::check_const(
       cout << "\tABORTED" << endl;
     }
   }
-  mCheckConstInfo.set_result(code, timer.get_time());
+  mCheckConstInfo.set_result(code, timer.get_time(), mLastConflictNum);
   return code;
 }
 
@@ -175,6 +294,7 @@ FraigSat::check_equiv(
 
   Timer timer;
   timer.start();
+  mLastConflictNum = 0;
 
   auto lit1 = id1;
   auto lit2 = id2 * inv;
@@ -190,8 +310,8 @@ FraigSat::check_equiv(
     stat = check_condition( lit1, ~lit2);
     if ( stat == SatBool3::False ) {
       // どの条件も成り立たなかったので等しい
-      mSolver.add_clause(~lit1,  lit2);
-      mSolver.add_clause( lit1, ~lit2);
+      add_clause({~lit1,  lit2});
+      add_clause({ lit1, ~lit2});
 
       if ( debug ) {
 	cout << "\tSUCCEED" << endl;
@@ -213,7 +333,7 @@ FraigSat::check_equiv(
   }
 
  end:
-  mCheckEquivInfo.set_result(code, timer.get_time());
+  mCheckEquivInfo.set_result(code, timer.get_time(), mLastConflictNum);
   return code;
 }
 
@@ -238,6 +358,22 @@ FraigSat::handle_lit(
   return lit * handle.inv();
 }
 
+// @brief 節を加える．
+void
+FraigSat::add_clause(
+  std::initializer_list<SatLiteral> lits
+)
+{
+  mTmpLits.clear();
+  mTmpLits.insert(mTmpLits.end(), lits.begin(), lits.end());
+  if ( mHasActLit ) {
+    mTmpLits.push_back(~mActLit);
+    ++ mActClauseNum;
+  }
+  mSolver.add_clause(mTmpLits);
+  ++ mClauseNum;
+}
+
 // lit1 が成り立つか調べる．
 SatBool3
 FraigSat::check_condition(
@@ -245,7 +381,7 @@ FraigSat::check_condition(
 )
 {
   vector<SatLiteral> assumptions{lit1};
-  auto ans1 = mSolver.solve(assumptions);
+  auto ans1 = solve(assumptions);
 
 #if defined(VERIFY_SATSOLVER)
   SatSolver solver{SatInitParam{"minisat2"}};
@@ -291,7 +427,7 @@ FraigSat::check_condition(
 )
 {
   vector<SatLiteral> assumptions{lit1, lit2};
-  auto ans1 = mSolver.solve(assumptions);
+  auto ans1 = solve(assumptions);
 
 #if defined(VERIFY_SATSOLVER)
   SatSolver solver{SatInitParam{"minisat2"}};
@@ -330,6 +466,29 @@ FraigSat::check_condition(
   return ans1;
 }
 
+// @brief 制限を設定して SAT 問題を解く．
+SatBool3
+FraigSat::solve(
+  vector<SatLiteral> assumptions
+)
+{
+  if ( time_over() ) {
+    // 制限時間を過ぎていたら解かずにアボートする．
+    return SatBool3::X;
+  }
+
+  if ( mHasActLit ) {
+    assumptions.push_back(mActLit);
+  }
+
+  mSolver.set_conflict_budget(mConflictBudget);
+  mSolver.set_propagation_budget(mPropagationBudget);
+  auto conflict_num0 = mSolver.get_stats().mConflictNum;
+  auto ans = mSolver.solve(assumptions);
+  mLastConflictNum += mSolver.get_stats().mConflictNum - conflict_num0;
+  return ans;
+}
+
 // @brief 直前の sat_sweep に関する統計情報を出力する．
 void
 FraigSat::dump_stats(
@@ -362,14 +521,66 @@ FraigSat::SatStat::SatStat()
     mTimeStat[i].mTotalTime = 0.0;
     mTimeStat[i].mMaxTime = 0.0;
   }
+  for ( SizeType i = 0; i < kHistSize; ++ i ) {
+    mTimeHist[i] = 0;
+    mConflictHist[i] = 0;
+  }
 }
 
+BEGIN_NONAMESPACE
+
+// ヒストグラムの位置を求める．
+// 0 なら 0, それ以外は 2^(i-1) <= val < 2^i となる i を返す．
+SizeType
+hist_pos(
+  double val,
+  SizeType size
+)
+{
+  SizeType pos = 0;
+  for ( double b = 1.0; b <= val && pos < size - 1; b *= 2.0 ) {
+    ++ pos;
+  }
+  return pos;
+}
+
+// ヒストグラムを出力する．
+void
+dump_hist(
+  ostream& s,
+  const char* title,
+  const SizeType* hist,
+  SizeType size
+)
+{
+  s << " " << title << ":" << endl;
+  for ( SizeType i = 0; i < size; ++ i ) {
+    if ( hist[i] == 0 ) {
+      continue;
+    }
+    s << "   ";
+    if ( i == 0 ) {
+      s << "< 1";
+    }
+    else {
+      s << "< " << (1UL << i);
+    }
+    s << ": " << hist[i] << endl;
+  }
+}
+
+END_NONAMESPACE
+
 void
 FraigSat::SatStat::set_result(
   SatBool3 code,
-  double t
+  double t,
+  SizeType conflict_num
 )
 {
+  ++ mTimeHist[hist_pos(t, kHistSize)];
+  ++ mConflictHist[hist_pos(static_cast<double>(conflict_num), kHistSize)];
+
   ++ mTotalCount;
 
   int idx = 0;
@@ -411,6 +622,10 @@ FraigSat::SatStat::dump(
       << mTimeStat[0].mTotalTime / mTimeStat[0].mCount << " / "
       << mTimeStat[0].mMaxTime << endl;
   }
+  if ( mTotalCount > 0 ) {
+    dump_hist(s, "time histogram(ms)", mTimeHist, kHistSize);
+    dump_hist(s, "conflict histogram", mConflictHist, kHistSize);
+  }
 }
 
 END_NAMESPACE_FRAIG
@@ -14,6 +14,9 @@
 #include "ym/SatInitParam.h"
 #include "ym/SatSolver.h"
 #include "ym/SatModel.h"
+#include "ym/SatStats.h"
+#include <chrono>
+#include <initializer_list>
 
 
 BEGIN_NAMESPACE_FRAIG
@@ -46,12 +49,92 @@ public:
     FraigNode* node ///< [in] 対象のノード
   );
 
+  /// @brief ノードが登録されている時 true を返す．
+  bool
+  is_registered(
+    FraigNode* node ///< [in] 対象のノード
+  ) const
+  {
+    return mLiteralDict.count(node->id()) > 0;
+  }
+
+  /// @brief ノードの登録を取り消す．
+  ///
+  /// 削除されたノードの番号が後で別のノードに使われた時に
+  /// 前の変数が使われないようにする．
+  void
+  erase_node(
+    SizeType id ///< [in] ノード番号
+  )
+  {
+    mLiteralDict.erase(id);
+  }
+
+  /// @brief 修正版の区間を開始する．
+  ///
+  /// 新たな活性化リテラルを作り，end_revision() までに加えられる節には
+  /// すべてその否定を加える．活性化リテラルは SAT の呼び出し時に仮定として与える．
+  void
+  begin_revision();
+
+  /// @brief 修正版の区間を終了する．
+  ///
+  /// 活性化リテラルの否定を単位節として加えて区間中の節をすべて無効にする．
+  /// 区間中に登録したノードはすべて削除されていなければならない．
+  /// それらの変数は区間中の節にしか現れないので後で作るノードに使い回す．
+  void
+  end_revision();
+
+  /// @brief 修正版の区間中の時 true を返す．
+  bool
+  in_revision() const
+  {
+    return mHasActLit;
+  }
+
+  /// @brief SATソルバの変数の数を返す．
+  SizeType
+  variable_num()
+  {
+    return mSolver.get_stats().mVarNum;
+  }
+
+  /// @brief 有効な節の数を返す．
+  ///
+  /// end_revision() で無効にされた節と活性化リテラルの単位節は数えない．
+  SizeType
+  clause_num() const
+  {
+    return mClauseNum;
+  }
+
   /// @brief ノードの入出力の関係を表す CNF 式を作る．
   void
   make_cnf(
     FraigNode* node ///< [in] 対象のノード
   );
 
+  /// @brief ファンインを指定してノードの入出力の関係を表す CNF 式を作る．
+  ///
+  /// ファンインを代表のハンドルに置き換えた CNF を作る時に用いる．
+  /// ファンインは定数でもよい．
+  void
+  make_cnf(
+    FraigNode* node,     ///< [in] 対象のノード
+    FraigHandle handle1, ///< [in] ファンイン0のハンドル
+    FraigHandle handle2  ///< [in] ファンイン1のハンドル
+  );
+
+  /// @brief 2つのハンドルが等価であるという条件を加える．
+  ///
+  /// 他のソルバで証明された等価関係を取り込む時に用いる．
+  /// 定数でないハンドルのノードは登録されている必要がある．
+  void
+  add_equiv(
+    FraigHandle handle1, ///< [in] ハンドル1
+    FraigHandle handle2  ///< [in] ハンドル2
+  );
+
   /// @brief 2つのノードが等価かどうか調べる．
   SatBool3
   check_equiv(
@@ -76,6 +159,46 @@ public:
     return mSolver.model()[node_lit(node)];
   }
 
+  /// @brief 1回の SAT の呼び出しあたりの制限を設定する．
+  ///
+  /// 0 の場合は制限なしとなる．
+  /// 制限を越えた場合は SatBool3::X が返される．
+  void
+  set_budget(
+    SizeType conflict_budget,   ///< [in] コンフリクト数の上限
+    SizeType propagation_budget ///< [in] implication 数の上限
+  )
+  {
+    mConflictBudget = conflict_budget;
+    mPropagationBudget = propagation_budget;
+  }
+
+  /// @brief 全体の制限時間を設定する．
+  ///
+  /// この関数を呼んだ時点から time_limit 秒を過ぎると
+  /// 以降の SAT の呼び出しはすべて SatBool3::X を返す．
+  /// 0 の場合は制限なしとなる．
+  void
+  set_time_limit(
+    double time_limit ///< [in] 制限時間(秒)
+  );
+
+  /// @brief 制限時間を過ぎていたら true を返す．
+  bool
+  time_over() const;
+
+  /// @brief 別のソルバの制限(budget と制限時刻)をコピーする．
+  void
+  copy_limits(
+    const FraigSat& src ///< [in] コピー元のソルバ
+  )
+  {
+    mConflictBudget = src.mConflictBudget;
+    mPropagationBudget = src.mPropagationBudget;
+    mHasDeadline = src.mHasDeadline;
+    mDeadline = src.mDeadline;
+  }
+
   /// @brief ログレベルを設定する．
   void
   set_loglevel(
@@ -112,6 +235,14 @@ private:
     const FraigHandle& handle ///< [in] 対象のハンドル
   );
 
+  /// @brief 節を加える．
+  ///
+  /// 修正版の区間中は活性化リテラルの否定を加える．
+  void
+  add_clause(
+    std::initializer_list<SatLiteral> lits ///< [in] リテラルのリスト
+  );
+
   /// @brief lit1 が成り立つか調べる．
   SatBool3
   check_condition(
@@ -125,12 +256,22 @@ private:
     SatLiteral lit2
   );
 
+  /// @brief 制限を設定して SAT 問題を解く．
+  SatBool3
+  solve(
+    vector<SatLiteral> assumptions ///< [in] 仮定
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
   // 内部で用いられるデータ構造
   //////////////////////////////////////////////////////////////////////
 
+  // ヒストグラムの要素数
+  static
+  const SizeType kHistSize = 24;
+
   // SatSolver の統計情報
   struct SatStat
   {
@@ -169,6 +310,14 @@ private:
     // コンストラクタ
     SatStat();
 
+    // 計算時間のヒストグラム
+    // i 番目の要素は 2^(i-1) <= t < 2^i (ミリ秒)の回数
+    SizeType mTimeHist[kHistSize];
+
+    // コンフリクト数のヒストグラム
+    // i 番目の要素は 2^(i-1) <= n < 2^i の回数
+    SizeType mConflictHist[kHistSize];
+
     // 結果をセットする．
     // code = SatBool3::True 検証成功
     //      = SatBool3::3False 検証失敗
@@ -176,7 +325,8 @@ private:
     void
     set_result(
       SatBool3 code,
-      double t
+      double t,
+      SizeType conflict_num
     );
 
     // 内容をダンプする．
@@ -199,6 +349,42 @@ private:
   // ノード番号をキーにしてリテラルを格納する辞書
   unordered_map<SizeType, SatLiteral> mLiteralDict;
 
+  // 修正版の区間の活性化リテラル
+  SatLiteral mActLit;
+
+  // 修正版の区間中の時 true
+  bool mHasActLit{false};
+
+  // 修正版の区間中に登録したノードの変数のリスト
+  vector<SatLiteral> mActVarList;
+
+  // 使い回せる変数のリスト
+  vector<SatLiteral> mFreeVarList;
+
+  // 有効な節の数
+  SizeType mClauseNum{0};
+
+  // 修正版の区間中に加えた節の数
+  SizeType mActClauseNum{0};
+
+  // add_clause() で用いる作業領域
+  vector<SatLiteral> mTmpLits;
+
+  // 1回の呼び出しあたりのコンフリクト数の上限(0 で制限なし)
+  SizeType mConflictBudget{0};
+
+  // 1回の呼び出しあたりの implication 数の上限(0 で制限なし)
+  SizeType mPropagationBudget{0};
+
+  // 制限時間が設定されている時 true
+  bool mHasDeadline{false};
+
+  // 制限時刻
+  std::chrono::steady_clock::time_point mDeadline;
+
+  // 直前の solve() のコンフリクト数
+  SizeType mLastConflictNum{0};
+
   // check_const の統計情報
   SatStat mCheckConstInfo;
 
@@ -9,74 +9,488 @@
 /// All rights reserved.
 
 #include "FraigNode.h"
+#include <unordered_map>
 
 
 BEGIN_NAMESPACE_FRAIG
 
 //////////////////////////////////////////////////////////////////////
-/// @class PatHash PatTable.h "PatTable.h"
-/// @brief FraigNode のパタンハッシュ関数
+/// @class PatTable PatTable.h "PatTable.h"
+/// @brief FraigNode のパタンハッシュテーブル
+///
+/// 同じパタン(極性の違いは同一視する)を持つノードを
+/// 1つのクラスにまとめて保持する．
+/// クラス内のノードは互いに非等価であることがわかっていても
+/// そのことを示すパタンがまだ加えられていない場合がある．
+/// パタンが1語追加されたら refine() でクラスを分割する．
+///
+/// クラスは木構造をなす．
+/// 根のクラスは初期パタンの値で，それ以外のクラスは
+/// 親のクラスの分岐位置の語の値で区別される．
+/// 分割されたクラスは分岐位置を持つ中間のクラスとなり，
+/// ノードは葉のクラスのみが持つ．
+/// ハッシュ表のキーは (親のクラス番号, 分岐位置の語の値) から作るので
+/// 語が追加されても分割されないクラスのキーは変わらない．
 //////////////////////////////////////////////////////////////////////
-class PatHash
+class PatTable
 {
+public:
+
+  /// @brief コンストラクタ
+  PatTable(
+    SizeType pat_used ///< [in] 初期パタンの語数
+  ) : mInitUsed{pat_used},
+      mPatUsed{pat_used}
+  {
+  }
+
+  /// @brief デストラクタ
+  ~PatTable() = default;
+
+
 public:
   //////////////////////////////////////////////////////////////////////
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief FraigNode のパタンハッシュ関数
+  /// @brief クラス数を返す．
+  ///
+  /// ノードを持つ葉のクラスのみを数える．
   SizeType
-  operator()(
+  class_num() const
+  {
+    return mLeafNum;
+  }
+
+  /// @brief node と同じパタンを持つクラスを探す．
+  /// @return クラスのノードのリストを返す．
+  ///
+  /// 見つからなかった場合は nullptr を返す．
+  const vector<FraigNode*>*
+  find(
     const FraigNode* node ///< [in] 対象のノード
   ) const
   {
-    return node->pat_hash();
+    auto pos = find_class(node);
+    if ( pos.mClass == NO_CLASS ) {
+      return nullptr;
+    }
+    return &mClassArray[pos.mClass].mNodeList;
   }
-};
 
+  /// @brief ノードを追加する．
+  ///
+  /// 同じパタンを持つクラスがあればそこに，
+  /// なければ新しいクラスを作って追加する．
+  void
+  insert(
+    FraigNode* node ///< [in] 対象のノード
+  )
+  {
+    auto pos = find_class(node);
+    if ( pos.mClass != NO_CLASS ) {
+      mClassArray[pos.mClass].mNodeList.push_back(node);
+      return;
+    }
+
+    if ( pos.mSplitClass == NO_CLASS ) {
+      new_leaf(pos.mParent, pos.mKey, node);
+      return;
+    }
 
-//////////////////////////////////////////////////////////////////////
-/// @class PatEq PatTable.h "PatTable.h"
-/// @brief FraigNode のパタンハッシュ用等価比較関数
-//////////////////////////////////////////////////////////////////////
-class PatEq
-{
-public:
+    // mSplitClass のパタンとは mSplitPos の語で初めて異なるので
+    // mSplitClass の位置に mSplitPos で分岐するクラスを挟む．
+    SizeType cid = pos.mSplitClass;
+    SizeType split_pos = pos.mSplitPos;
+    SizeType parent = mClassArray[cid].mParent;
+    SizeType key = mClassArray[cid].mKey;
+    auto rep = mClassArray[cid].mRep;
+    erase_key(key, cid);
+    SizeType mid = new_class(parent, key, rep);
+    mClassArray[mid].mSplitPos = split_pos;
+    SizeType key1 = child_key(mid, word(rep, split_pos));
+    mClassArray[cid].mParent = mid;
+    mClassArray[cid].mKey = key1;
+    mHashMap.emplace(key1, cid);
+    new_leaf(mid, child_key(mid, word(node, split_pos)), node);
+  }
+
+  /// @brief ノード番号が num 以上のノードを削除する．
+  ///
+  /// 代表ノードが削除されたクラスは取り除く．
+  /// クラスの中ではノードは登録順に並んでおり，
+  /// あるノードより後に登録されたノードは全て削除されるので
+  /// 代表ノードが削除されたクラスの子孫のクラスも全て取り除かれる．
+  void
+  truncate(
+    SizeType num ///< [in] 残すノードの番号の上限
+  )
+  {
+    for ( SizeType cid = 0; cid < mClassArray.size(); ++ cid ) {
+      auto& cls = mClassArray[cid];
+      if ( cls.mRep == nullptr ) {
+	continue;
+      }
+      if ( cls.mRep->id() >= num ) {
+	erase_key(cls.mKey, cid);
+	if ( cls.is_leaf() ) {
+	  -- mLeafNum;
+	}
+	vector<FraigNode*>{}.swap(cls.mNodeList);
+	cls.mRep = nullptr;
+	mFreeList.push_back(cid);
+	continue;
+      }
+      if ( cls.is_leaf() ) {
+	auto& node_list = cls.mNodeList;
+	while ( node_list.back()->id() >= num ) {
+	  node_list.pop_back();
+	}
+      }
+    }
+  }
+
+  /// @brief パタンが1語追加された後でクラスを更新する．
+  ///
+  /// 要素が複数あり，追加された語の値が異なるクラスのみ分割する．
+  /// それ以外のクラスとハッシュ表の索引はそのまま残す．
+  void
+  refine(
+    SizeType pos ///< [in] 追加された語の位置
+  )
+  {
+    ASSERT_COND( pos == mPatUsed );
+    ++ mPatUsed;
+
+    // 分割で作られたクラスは調べなくてよい．
+    SizeType n = mClassArray.size();
+    for ( SizeType cid = 0; cid < n; ++ cid ) {
+      auto& cls = mClassArray[cid];
+      if ( cls.mRep == nullptr || !cls.is_leaf() || cls.mNodeList.size() == 1 ) {
+	continue;
+      }
+      auto val0 = word(cls.mNodeList[0], pos);
+      bool split = false;
+      for ( auto node: cls.mNodeList ) {
+	if ( word(node, pos) != val0 ) {
+	  split = true;
+	  break;
+	}
+      }
+      if ( !split ) {
+	continue;
+      }
+
+      // pos 番目の語の値(極性を正規化したもの)ごとに子のクラスに分ける．
+      vector<FraigNode*> node_list;
+      node_list.swap(cls.mNodeList);
+      cls.mSplitPos = pos;
+      -- mLeafNum;
+      mBucketMap.clear();
+      for ( auto node: node_list ) {
+	auto val = word(node, pos);
+	auto p = mBucketMap.find(val);
+	if ( p == mBucketMap.end() ) {
+	  SizeType child = new_leaf(cid, child_key(cid, val), node);
+	  mBucketMap.emplace(val, child);
+	}
+	else {
+	  mClassArray[p->second].mNodeList.push_back(node);
+	}
+      }
+    }
+  }
+
+
+private:
   //////////////////////////////////////////////////////////////////////
-  // 外部インターフェイス
+  // 内部で用いられるデータ構造
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief FraigNode のパタン比較関数
-  bool
-  operator()(
-    const FraigNode* node1, ///< [in] ノード1
-    const FraigNode* node2  ///< [in] ノード2
+  // クラスを表す構造体
+  struct Class
+  {
+    /// @brief 葉のクラスの時 true を返す．
+    bool
+    is_leaf() const
+    {
+      return mSplitPos == NO_POS;
+    }
+
+    // 親のクラス番号
+    // 根のクラスの場合は NO_CLASS
+    SizeType mParent;
+
+    // ハッシュ表のキー
+    SizeType mKey;
+
+    // 代表ノード
+    // クラス(とその子孫)で最初に登録されたノード
+    // 削除されたクラスの場合は nullptr
+    const FraigNode* mRep;
+
+    // 子のクラスを区別する語の位置
+    // 葉のクラスの場合は NO_POS
+    SizeType mSplitPos;
+
+    // ノードのリスト
+    // 葉のクラスのみ意味を持つ．
+    vector<FraigNode*> mNodeList;
+  };
+
+  // find_class() の結果を表す構造体
+  struct FindResult
+  {
+    // 見つかった葉のクラス番号
+    // 見つからなかった場合は NO_CLASS
+    SizeType mClass{NO_CLASS};
+
+    // 新しいクラスの親のクラス番号
+    SizeType mParent{NO_CLASS};
+
+    // 新しいクラスのキー
+    SizeType mKey{0};
+
+    // 途中の語でパタンが異なったクラス番号
+    // そのようなクラスがない場合は NO_CLASS
+    SizeType mSplitClass{NO_CLASS};
+
+    // mSplitClass とパタンが初めて異なる語の位置
+    SizeType mSplitPos{0};
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief node と同じパタンを持つクラスを探す．
+  ///
+  /// 根のクラスから順に分岐位置の語の値で子のクラスをたどる．
+  /// 比較済みの語は比べ直さない．
+  FindResult
+  find_class(
+    const FraigNode* node ///< [in] 対象のノード
   ) const
   {
-    bool inv = node1->pat_hash_inv() ^ node2->pat_hash_inv();
-    auto p1 = node1->pat();
-    auto e1 = node1->pat_end();
-    auto p2 = node2->pat();
-    if ( inv ) {
-      for ( ; p1 != e1; ++ p1, ++ p2 ) {
-	if ( *p1 != ~(*p2) ) {
-	  return false;
+    FindResult ans;
+    SizeType key = root_key(node);
+    SizeType cid = NO_CLASS;
+    auto range = mHashMap.equal_range(key);
+    for ( auto p = range.first; p != range.second; ++ p ) {
+      auto& cls = mClassArray[p->second];
+      if ( cls.mParent == NO_CLASS &&
+	   first_diff(node, cls.mRep, 0, mInitUsed) == mInitUsed ) {
+	cid = p->second;
+	break;
+      }
+    }
+    SizeType parent = NO_CLASS;
+    SizeType start = mInitUsed;
+    while ( cid != NO_CLASS ) {
+      auto& cls = mClassArray[cid];
+      SizeType end = cls.is_leaf() ? mPatUsed : cls.mSplitPos;
+      SizeType diff = first_diff(node, cls.mRep, start, end);
+      if ( diff < end ) {
+	ans.mSplitClass = cid;
+	ans.mSplitPos = diff;
+	return ans;
+      }
+      if ( cls.is_leaf() ) {
+	ans.mClass = cid;
+	return ans;
+      }
+      // 分岐位置の語の値で子のクラスを探す．
+      parent = cid;
+      start = end + 1;
+      auto val = word(node, end);
+      key = child_key(parent, val);
+      cid = NO_CLASS;
+      auto range1 = mHashMap.equal_range(key);
+      for ( auto p = range1.first; p != range1.second; ++ p ) {
+	auto& cls1 = mClassArray[p->second];
+	if ( cls1.mParent == parent && word(cls1.mRep, end) == val ) {
+	  cid = p->second;
+	  break;
 	}
       }
     }
+    ans.mParent = parent;
+    ans.mKey = key;
+    return ans;
+  }
+
+  /// @brief クラスを作る．
+  /// @return クラス番号を返す．
+  ///
+  /// 作られたクラスは葉のクラスで，ノードを持たない．
+  SizeType
+  new_class(
+    SizeType parent,     ///< [in] 親のクラス番号
+    SizeType key,        ///< [in] ハッシュ表のキー
+    const FraigNode* rep ///< [in] 代表ノード
+  )
+  {
+    SizeType cid;
+    if ( mFreeList.empty() ) {
+      cid = mClassArray.size();
+      mClassArray.push_back({});
+    }
     else {
-      for ( ; p1 != e1; ++ p1, ++ p2 ) {
-	if ( *p1 != *p2 ) {
-	  return false;
-	}
+      cid = mFreeList.back();
+      mFreeList.pop_back();
+    }
+    auto& cls = mClassArray[cid];
+    cls.mParent = parent;
+    cls.mKey = key;
+    cls.mRep = rep;
+    cls.mSplitPos = NO_POS;
+    mHashMap.emplace(key, cid);
+    return cid;
+  }
+
+  /// @brief node のみを要素とする葉のクラスを作る．
+  /// @return クラス番号を返す．
+  SizeType
+  new_leaf(
+    SizeType parent, ///< [in] 親のクラス番号
+    SizeType key,    ///< [in] ハッシュ表のキー
+    FraigNode* node  ///< [in] ノード
+  )
+  {
+    SizeType cid = new_class(parent, key, node);
+    mClassArray[cid].mNodeList.push_back(node);
+    ++ mLeafNum;
+    return cid;
+  }
+
+  /// @brief ハッシュ表からクラスの索引を取り除く．
+  void
+  erase_key(
+    SizeType key, ///< [in] キー
+    SizeType cid  ///< [in] クラス番号
+  )
+  {
+    auto range = mHashMap.equal_range(key);
+    for ( auto p = range.first; p != range.second; ++ p ) {
+      if ( p->second == cid ) {
+	mHashMap.erase(p);
+	return;
       }
     }
-    return true;
+    ASSERT_NOT_REACHED;
   }
-};
 
-/// @brief FraigNode のパタンハッシュテーブル
-using PatTable = std::unordered_multiset<FraigNode*, PatHash, PatEq>;
+  /// @brief 根のクラスのキーを求める．
+  SizeType
+  root_key(
+    const FraigNode* node ///< [in] 対象のノード
+  ) const
+  {
+    std::uint64_t val = 0UL;
+    for ( SizeType i = 0; i < mInitUsed; ++ i ) {
+      val = child_key(val, word(node, i));
+    }
+    return child_key(NO_CLASS, val);
+  }
+
+  /// @brief 子のクラスのキーを求める．
+  static
+  SizeType
+  child_key(
+    SizeType parent,  ///< [in] 親のクラス番号
+    std::uint64_t val ///< [in] 分岐位置の語の値
+  )
+  {
+    std::uint64_t h = val ^ (static_cast<std::uint64_t>(parent) * 0x9E3779B97F4A7C15UL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDUL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  /// @brief 極性を正規化した語の値を返す．
+  static
+  std::uint64_t
+  word(
+    const FraigNode* node, ///< [in] 対象のノード
+    SizeType pos           ///< [in] 語の位置
+  )
+  {
+    auto val = node->pat()[pos];
+    if ( node->pat_hash_inv() ) {
+      val = ~val;
+    }
+    return val;
+  }
+
+  /// @brief [start, end) の範囲で2つのノードのパタンが初めて異なる位置を返す．
+  ///
+  /// 極性は正規化して比較する．
+  /// 異ならない場合は end を返す．
+  static
+  SizeType
+  first_diff(
+    const FraigNode* node1, ///< [in] ノード1
+    const FraigNode* node2, ///< [in] ノード2
+    SizeType start,         ///< [in] 開始位置
+    SizeType end            ///< [in] 終了位置
+  )
+  {
+    auto mask = (node1->pat_hash_inv() ^ node2->pat_hash_inv()) ? ~0UL : 0UL;
+    auto p1 = node1->pat();
+    auto p2 = node2->pat();
+    for ( SizeType i = start; i < end; ++ i ) {
+      if ( p1[i] != (p2[i] ^ mask) ) {
+	return i;
+      }
+    }
+    return end;
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 定数
+  //////////////////////////////////////////////////////////////////////
+
+  // クラスが見つからなかったことを表す値
+  static
+  const SizeType NO_CLASS = static_cast<SizeType>(-1);
+
+  // 分岐位置がないことを表す値
+  static
+  const SizeType NO_POS = static_cast<SizeType>(-1);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 初期パタンの語数
+  SizeType mInitUsed;
+
+  // 有効なパタンの語数
+  SizeType mPatUsed;
+
+  // クラス番号をキーにしてクラスを格納する配列
+  vector<Class> mClassArray;
+
+  // 削除されたクラス番号のリスト
+  vector<SizeType> mFreeList;
+
+  // 葉のクラスの数
+  SizeType mLeafNum{0};
+
+  // クラスのキーをキーにしてクラス番号を格納するハッシュ表
+  std::unordered_multimap<SizeType, SizeType> mHashMap;
+
+  // refine() で語の値をキーにして子のクラス番号を格納するハッシュ表
+  std::unordered_map<std::uint64_t, SizeType> mBucketMap;
+
+};
 
 END_NAMESPACE_FRAIG
 
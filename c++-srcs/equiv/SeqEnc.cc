@@ -0,0 +1,196 @@
+
+/// @file SeqEnc.cc
+/// @brief SeqEnc の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "SeqEnc.h"
+#include "FraigEnc.h"
+#include "ym/BnNetwork.h"
+#include "ym/BnNode.h"
+#include "ym/BnDff.h"
+#include "ym/Range.h"
+
+
+BEGIN_NAMESPACE_FRAIG
+
+//////////////////////////////////////////////////////////////////////
+// クラス SeqEnc
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+SeqEnc::SeqEnc(
+  const BnNetwork& network
+) : mNetwork{network},
+    mSim{network}
+{
+  // ノード番号をキーにして入力番号を格納する辞書
+  unordered_map<SizeType, SizeType> input_pos_map;
+  {
+    SizeType pos = 0;
+    for ( auto node: network.input_list() ) {
+      input_pos_map.emplace(node.id(), pos);
+      ++ pos;
+    }
+  }
+  // ノード番号をキーにして出力番号を格納する辞書
+  unordered_map<SizeType, SizeType> output_pos_map;
+  {
+    SizeType pos = 0;
+    for ( auto node: network.output_list() ) {
+      output_pos_map.emplace(node.id(), pos);
+      ++ pos;
+    }
+  }
+
+  SizeType ni = network.input_num();
+  SizeType no = network.output_num();
+  vector<bool> dff_input_mark(ni, false);
+  vector<bool> dff_output_mark(no, false);
+  auto mark_output = [&](SizeType id) {
+    if ( id != BNET_NULLID && output_pos_map.count(id) > 0 ) {
+      dff_output_mark[output_pos_map.at(id)] = true;
+    }
+  };
+  for ( auto dff: network.dff_list() ) {
+    if ( dff.is_cell() || !dff.is_dff() ) {
+      // セルタイプの DFF とラッチは扱えない．
+      mSupported = false;
+      continue;
+    }
+    if ( dff.clear().id() != BNET_NULLID || dff.preset().id() != BNET_NULLID ) {
+      // クリアとプリセットは1時刻分の AIG で表せないので扱えない．
+      mSupported = false;
+    }
+    auto opos = input_pos_map.at(dff.data_out().id());
+    auto ipos = output_pos_map.at(dff.data_in().id());
+    mDffOutPosList.push_back(opos);
+    mDffInPosList.push_back(ipos);
+    dff_input_mark[opos] = true;
+    mark_output(dff.data_in().id());
+    mark_output(dff.clock().id());
+    mark_output(dff.clear().id());
+    mark_output(dff.preset().id());
+  }
+
+  for ( SizeType i: Range(ni) ) {
+    if ( !dff_input_mark[i] ) {
+      mPiPosList.push_back(i);
+    }
+  }
+  for ( SizeType i: Range(no) ) {
+    if ( !dff_output_mark[i] ) {
+      mPoPosList.push_back(i);
+    }
+  }
+}
+
+// @brief 外部入力の名前のリストを返す．
+vector<string>
+SeqEnc::pi_name_list() const
+{
+  vector<string> name_list;
+  name_list.reserve(pi_num());
+  for ( auto pos: mPiPosList ) {
+    name_list.push_back(mNetwork.input_node(pos).name());
+  }
+  return name_list;
+}
+
+// @brief 外部出力の名前のリストを返す．
+vector<string>
+SeqEnc::po_name_list() const
+{
+  vector<string> name_list;
+  name_list.reserve(po_num());
+  for ( auto pos: mPoPosList ) {
+    name_list.push_back(mNetwork.output_node(pos).name());
+  }
+  return name_list;
+}
+
+// @brief DFF の名前のリストを返す．
+vector<string>
+SeqEnc::dff_name_list() const
+{
+  vector<string> name_list;
+  name_list.reserve(dff_num());
+  for ( auto pos: mDffOutPosList ) {
+    name_list.push_back(mNetwork.input_node(pos).name());
+  }
+  return name_list;
+}
+
+// @brief 1時刻分の AIG を作る．
+void
+SeqEnc::make_frame(
+  FraigMgr& mgr,
+  const vector<FraigHandle>& pi_handles,
+  const vector<FraigHandle>& state_handles,
+  vector<FraigHandle>& po_handles,
+  vector<FraigHandle>& next_handles
+) const
+{
+  ASSERT_COND( pi_handles.size() == pi_num() );
+  ASSERT_COND( state_handles.size() == dff_num() );
+
+  vector<FraigHandle> input_handles(mNetwork.input_num());
+  for ( SizeType i: Range(pi_num()) ) {
+    input_handles[mPiPosList[i]] = pi_handles[i];
+  }
+  for ( SizeType i: Range(dff_num()) ) {
+    input_handles[mDffOutPosList[i]] = state_handles[i];
+  }
+
+  FraigEnc enc{mgr};
+  auto output_handles = enc(mNetwork, input_handles);
+
+  po_handles.clear();
+  po_handles.reserve(po_num());
+  for ( auto pos: mPoPosList ) {
+    po_handles.push_back(output_handles[pos]);
+  }
+  next_handles.clear();
+  next_handles.reserve(dff_num());
+  for ( auto pos: mDffInPosList ) {
+    next_handles.push_back(output_handles[pos]);
+  }
+}
+
+// @brief 1時刻分のシミュレーションを行う．
+void
+SeqEnc::simulate(
+  const vector<std::uint64_t>& pi_vals,
+  const vector<std::uint64_t>& state_vals,
+  vector<std::uint64_t>& po_vals,
+  vector<std::uint64_t>& next_vals
+)
+{
+  ASSERT_COND( pi_vals.size() == pi_num() );
+  ASSERT_COND( state_vals.size() == dff_num() );
+
+  vector<std::uint64_t> input_vals(mNetwork.input_num(), 0UL);
+  for ( SizeType i: Range(pi_num()) ) {
+    input_vals[mPiPosList[i]] = pi_vals[i];
+  }
+  for ( SizeType i: Range(dff_num()) ) {
+    input_vals[mDffOutPosList[i]] = state_vals[i];
+  }
+
+  auto output_vals = mSim.simulate(input_vals);
+
+  po_vals.clear();
+  po_vals.reserve(po_num());
+  for ( auto pos: mPoPosList ) {
+    po_vals.push_back(output_vals[pos]);
+  }
+  next_vals.clear();
+  next_vals.reserve(dff_num());
+  for ( auto pos: mDffInPosList ) {
+    next_vals.push_back(output_vals[pos]);
+  }
+}
+
+END_NAMESPACE_FRAIG
@@ -0,0 +1,151 @@
+#ifndef SEQENC_H
+#define SEQENC_H
+
+/// @file SeqEnc.h
+/// @brief SeqEnc のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "fraig_nsdef.h"
+#include "FraigMgr.h"
+#include "BnSim.h"
+#include "ym/bnet.h"
+
+
+BEGIN_NAMESPACE_FRAIG
+
+//////////////////////////////////////////////////////////////////////
+/// @class SeqEnc SeqEnc.h "SeqEnc.h"
+/// @brief 順序回路の1時刻分の AIG を作るクラス
+///
+/// BnNetwork の入力(出力)を外部入力(外部出力)と DFF の出力(入力)に分けて，
+/// DFF の出力を擬似入力，DFF の入力を擬似出力として扱う．
+/// DFF のクロック，クリア，プリセットに対応する出力は外部出力に含めない．
+/// 外部入力，外部出力，DFF はそれぞれ BnNetwork 上の順番で番号づけする．
+///
+/// BnDff は初期値を持たないので，初期状態はすべての DFF の値が 0 の状態とする．
+/// (blif の .latch の初期値の指定は用いない)
+/// クリアやプリセットの付いた DFF はこの初期状態と1時刻分の遷移で表せないので，
+/// セルタイプの DFF やラッチとともに扱えない回路とする．
+//////////////////////////////////////////////////////////////////////
+class SeqEnc
+{
+public:
+
+  /// @brief コンストラクタ
+  SeqEnc(
+    const BnNetwork& network ///< [in] 対象のネットワーク
+  );
+
+  /// @brief デストラクタ
+  ~SeqEnc() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 情報を取得するメンバ関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 扱える回路の時 true を返す．
+  ///
+  /// セルタイプの DFF とラッチ，クリアかプリセットの付いた DFF は扱えない．
+  bool
+  is_supported() const
+  {
+    return mSupported;
+  }
+
+  /// @brief 外部入力数を返す．
+  SizeType
+  pi_num() const
+  {
+    return mPiPosList.size();
+  }
+
+  /// @brief 外部出力数を返す．
+  SizeType
+  po_num() const
+  {
+    return mPoPosList.size();
+  }
+
+  /// @brief DFF数を返す．
+  SizeType
+  dff_num() const
+  {
+    return mDffOutPosList.size();
+  }
+
+  /// @brief 外部入力の名前のリストを返す．
+  vector<string>
+  pi_name_list() const;
+
+  /// @brief 外部出力の名前のリストを返す．
+  vector<string>
+  po_name_list() const;
+
+  /// @brief DFF の名前のリストを返す．
+  ///
+  /// DFF の出力のノード名を用いる．
+  vector<string>
+  dff_name_list() const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 1時刻分の AIG を作る．
+  void
+  make_frame(
+    FraigMgr& mgr,                            ///< [in] FraigMgr
+    const vector<FraigHandle>& pi_handles,    ///< [in] 外部入力のハンドルのリスト
+    const vector<FraigHandle>& state_handles, ///< [in] 現状態(DFFの出力)のハンドルのリスト
+    vector<FraigHandle>& po_handles,          ///< [out] 外部出力のハンドルのリスト
+    vector<FraigHandle>& next_handles         ///< [out] 次状態(DFFの入力)のハンドルのリスト
+  ) const;
+
+  /// @brief 1時刻分のシミュレーションを行う．
+  void
+  simulate(
+    const vector<std::uint64_t>& pi_vals,    ///< [in] 外部入力の値のリスト
+    const vector<std::uint64_t>& state_vals, ///< [in] 現状態の値のリスト
+    vector<std::uint64_t>& po_vals,          ///< [out] 外部出力の値のリスト
+    vector<std::uint64_t>& next_vals         ///< [out] 次状態の値のリスト
+  );
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 対象のネットワーク
+  const BnNetwork& mNetwork;
+
+  // 扱える回路の時 true
+  bool mSupported{true};
+
+  // 外部入力番号をキーにして入力番号を格納する配列
+  vector<SizeType> mPiPosList;
+
+  // 外部出力番号をキーにして出力番号を格納する配列
+  vector<SizeType> mPoPosList;
+
+  // DFF番号をキーにして DFF の出力の入力番号を格納する配列
+  vector<SizeType> mDffOutPosList;
+
+  // DFF番号をキーにして DFF の入力の出力番号を格納する配列
+  vector<SizeType> mDffInPosList;
+
+  // シミュレータ
+  BnSim mSim;
+
+};
+
+END_NAMESPACE_FRAIG
+
+#endif // SEQENC_H
@@ -14,57 +14,190 @@
 BEGIN_NAMESPACE_FRAIG
 
 //////////////////////////////////////////////////////////////////////
-/// @class StructHash StructTable.h "StructTable.h"
-/// @brief FraigNode の構造ハッシュ関数
+/// @class StructTable StructTable.h "StructTable.h"
+/// @brief FraigNode の構造ハッシュテーブル
+///
+/// 2つのファンインのハンドルをキーとしてANDノードを登録する．
+/// 検索のたびにキー用のノードを作らなくてもよいように
+/// find() はハンドルを直接受け取る．
+/// 実装はオープンアドレス法(線形探索)で，
+/// 各要素にハンドルも持たせているので検索中にノードを参照することはない．
+/// 要素の削除は truncate() でまとめて行う．
 //////////////////////////////////////////////////////////////////////
-class StructHash
+class StructTable
 {
+public:
+
+  /// @brief コンストラクタ
+  StructTable(
+    SizeType size = 1024 ///< [in] 表の初期サイズ(2のべき乗)
+  )
+  {
+    resize(size);
+  }
+
+  /// @brief デストラクタ
+  ~StructTable() = default;
+
+
 public:
   //////////////////////////////////////////////////////////////////////
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief FraigNode のハッシュ関数
+  /// @brief 登録されている要素数を返す．
   SizeType
-  operator()(
-    const FraigNode* node ///< [in] 対象のノード
+  size() const
+  {
+    return mNum;
+  }
+
+  /// @brief 同じ構造を持つノードを探す．
+  /// @return 見つからなかった場合は nullptr を返す．
+  ///
+  /// handle1, handle2 は正規化されているものとする．
+  FraigNode*
+  find(
+    FraigHandle handle1, ///< [in] 入力1のハンドル
+    FraigHandle handle2  ///< [in] 入力2のハンドル
   ) const
   {
-    auto handle1 = node->fanin0_handle();
-    auto handle2 = node->fanin1_handle();
-    return handle1.hash() + handle2.hash() * 13;
+    for ( SizeType pos = hash(handle1, handle2) & mMask; ;
+	  pos = (pos + 1) & mMask ) {
+      auto& cell = mTable[pos];
+      if ( cell.mNode == nullptr ) {
+	return nullptr;
+      }
+      if ( cell.mHandle1 == handle1 && cell.mHandle2 == handle2 ) {
+	return cell.mNode;
+      }
+    }
   }
-};
 
+  /// @brief ノードを登録する．
+  ///
+  /// 同じ構造のノードが登録されていないことは呼び出し側で保証する．
+  void
+  insert(
+    FraigNode* node ///< [in] 対象のノード
+  )
+  {
+    if ( (mNum + 1) * 2 > mTable.size() ) {
+      resize(mTable.size() * 2);
+    }
+    put(node->fanin0_handle(), node->fanin1_handle(), node);
+    ++ mNum;
+  }
 
-//////////////////////////////////////////////////////////////////////
-/// @class StructEq StructTable.h "StructTable.h"
-/// @brief FraigNode の構造ハッシュ用等価比較関数
-//////////////////////////////////////////////////////////////////////
-class StructEq
-{
-public:
+  /// @brief ノード番号が num 以上の要素を削除する．
+  ///
+  /// 線形探索の列が途切れないように残りの要素で表を作り直す．
+  void
+  truncate(
+    SizeType num ///< [in] 残すノードの番号の上限
+  )
+  {
+    vector<Cell> old_table;
+    old_table.swap(mTable);
+    mTable.resize(old_table.size());
+    mNum = 0;
+    for ( auto& cell: old_table ) {
+      if ( cell.mNode != nullptr && cell.mNode->id() < num ) {
+	put(cell.mHandle1, cell.mHandle2, cell.mNode);
+	++ mNum;
+      }
+    }
+  }
+
+
+private:
   //////////////////////////////////////////////////////////////////////
-  // 外部インターフェイス
+  // 内部で用いられるデータ構造
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief FraigNode の構造比較関数
-  bool
-  operator()(
-    const FraigNode* node1, ///< [in] ノード1
-    const FraigNode* node2  ///< [in] ノード2
-  ) const
+  // 表の要素
+  struct Cell
   {
-    auto handle1_0 = node1->fanin0_handle();
-    auto handle1_1 = node1->fanin1_handle();
-    auto handle2_0 = node2->fanin0_handle();
-    auto handle2_1 = node2->fanin1_handle();
-    return handle1_0 == handle2_0 && handle1_1 == handle2_1;
+    // 入力1のハンドル
+    FraigHandle mHandle1;
+
+    // 入力2のハンドル
+    FraigHandle mHandle2;
+
+    // ノード(nullptr の場合は空き)
+    FraigNode* mNode{nullptr};
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ハッシュ関数
+  static
+  SizeType
+  hash(
+    FraigHandle handle1, ///< [in] 入力1のハンドル
+    FraigHandle handle2  ///< [in] 入力2のハンドル
+  )
+  {
+    return handle1.hash() + handle2.hash() * 13;
   }
-};
 
-/// @brief FraigNode の構造ハッシュテーブル
-using StructTable = unordered_set<FraigNode*, StructHash, StructEq>;
+  /// @brief 空き位置に要素を書き込む．
+  void
+  put(
+    FraigHandle handle1, ///< [in] 入力1のハンドル
+    FraigHandle handle2, ///< [in] 入力2のハンドル
+    FraigNode* node      ///< [in] ノード
+  )
+  {
+    SizeType pos = hash(handle1, handle2) & mMask;
+    while ( mTable[pos].mNode != nullptr ) {
+      pos = (pos + 1) & mMask;
+    }
+    auto& cell = mTable[pos];
+    cell.mHandle1 = handle1;
+    cell.mHandle2 = handle2;
+    cell.mNode = node;
+  }
+
+  /// @brief 表を拡大する．
+  void
+  resize(
+    SizeType size ///< [in] 新しいサイズ(2のべき乗)
+  )
+  {
+    ASSERT_COND( (size & (size - 1)) == 0 );
+
+    vector<Cell> old_table;
+    old_table.swap(mTable);
+    mTable.resize(size);
+    mMask = size - 1;
+    for ( auto& cell: old_table ) {
+      if ( cell.mNode != nullptr ) {
+	put(cell.mHandle1, cell.mHandle2, cell.mNode);
+      }
+    }
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 表の本体
+  vector<Cell> mTable;
+
+  // ハッシュ値から位置を求めるためのマスク
+  SizeType mMask;
+
+  // 要素数
+  SizeType mNum{0};
+
+};
 
 END_NAMESPACE_FRAIG
 
@@ -32,6 +32,8 @@ equiv_cmd(
     "match_by_name",
     "signature_size",
     "loglevel",
+    "thread_num",
+    "sequential",
     nullptr
   };
   PyObject* net1_obj = nullptr;
@@ -39,11 +41,14 @@ equiv_cmd(
   int match_by_name = false;
   int sig_size = -1;
   int loglevel = -1;
-  if ( !PyArg_ParseTupleAndKeywords(args, kwds, "O!O!|$pii",
+  int thread_num = -1;
+  int sequential = false;
+  if ( !PyArg_ParseTupleAndKeywords(args, kwds, "O!O!|$piiip",
 				    const_cast<char**>(kwlist),
 				    PyBnNetwork::_typeobject(), &net1_obj,
 				    PyBnNetwork::_typeobject(), &net2_obj,
-				    &match_by_name, &sig_size, &loglevel) ) {
+				    &match_by_name, &sig_size, &loglevel,
+				    &thread_num, &sequential) ) {
     return nullptr;
   }
 
@@ -54,9 +59,14 @@ equiv_cmd(
   if ( loglevel != -1 ) {
     mgr.set_loglevel(loglevel);
   }
+  if ( thread_num != -1 ) {
+    mgr.set_thread_num(thread_num);
+  }
   auto net1 = PyBnNetwork::Get(net1_obj);
   auto net2 = PyBnNetwork::Get(net2_obj);
-  auto result = mgr.check(net1, net2, match_by_name);
+  auto result = sequential ?
+    mgr.check_seq(net1, net2, match_by_name) :
+    mgr.check(net1, net2, match_by_name);
   const auto& oresults = result.output_results();
   SizeType no = oresults.size();
   auto oresults_obj = PyTuple_New(no);
@@ -64,8 +74,107 @@ equiv_cmd(
     auto obj1 = PySatBool3::ToPyObject(oresults[i]);
     PyTuple_SetItem(oresults_obj, i, obj1);
   }
+  // 反例は False の出力のみ入力値のタプル，それ以外は None となる．
+  auto cex_obj = PyTuple_New(no);
+  for ( SizeType i = 0; i < no; ++ i ) {
+    const auto& cex = result.counter_example(i);
+    PyObject* obj1 = nullptr;
+    if ( cex.empty() ) {
+      Py_INCREF(Py_None);
+      obj1 = Py_None;
+    }
+    else {
+      SizeType ni = cex.size();
+      obj1 = PyTuple_New(ni);
+      for ( SizeType j = 0; j < ni; ++ j ) {
+	PyTuple_SetItem(obj1, j, PyBool_FromLong(cex[j]));
+      }
+    }
+    PyTuple_SetItem(cex_obj, i, obj1);
+  }
   auto obj2 = PySatBool3::ToPyObject(result.result());
-  return Py_BuildValue("OO", obj2, oresults_obj);
+  return Py_BuildValue("NNN", obj2, oresults_obj, cex_obj);
+}
+
+PyObject*
+replay_cmd(
+  PyObject* Py_UNUSED(self),
+  PyObject* args,
+  PyObject* kwds
+)
+{
+  static const char* kwlist[] = {
+    "",
+    "",
+    "",
+    "match_by_name",
+    nullptr
+  };
+  PyObject* net1_obj = nullptr;
+  PyObject* net2_obj = nullptr;
+  PyObject* vect_list_obj = nullptr;
+  int match_by_name = false;
+  if ( !PyArg_ParseTupleAndKeywords(args, kwds, "O!O!O|$p",
+				    const_cast<char**>(kwlist),
+				    PyBnNetwork::_typeobject(), &net1_obj,
+				    PyBnNetwork::_typeobject(), &net2_obj,
+				    &vect_list_obj,
+				    &match_by_name) ) {
+    return nullptr;
+  }
+
+  // 入力ベクタのリストを読み込む．
+  // 各入力ベクタは真理値のシーケンスか None で表す．
+  auto seq_obj = PySequence_Fast(vect_list_obj, "3rd argument should be a sequence");
+  if ( seq_obj == nullptr ) {
+    return nullptr;
+  }
+  SizeType nv = PySequence_Fast_GET_SIZE(seq_obj);
+  vector<vector<bool>> input_vectors(nv);
+  for ( SizeType k = 0; k < nv; ++ k ) {
+    auto vect_obj = PySequence_Fast_GET_ITEM(seq_obj, k);
+    if ( vect_obj == Py_None ) {
+      continue;
+    }
+    auto seq1_obj = PySequence_Fast(vect_obj, "input vector should be a sequence");
+    if ( seq1_obj == nullptr ) {
+      Py_DECREF(seq_obj);
+      return nullptr;
+    }
+    SizeType ni = PySequence_Fast_GET_SIZE(seq1_obj);
+    auto& vect = input_vectors[k];
+    vect.resize(ni);
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      vect[i] = PyObject_IsTrue(PySequence_Fast_GET_ITEM(seq1_obj, i));
+    }
+    Py_DECREF(seq1_obj);
+  }
+  Py_DECREF(seq_obj);
+
+  auto net1 = PyBnNetwork::Get(net1_obj);
+  auto net2 = PyBnNetwork::Get(net2_obj);
+  SizeType ni = net1.input_num();
+  for ( auto& vect: input_vectors ) {
+    if ( !vect.empty() && vect.size() != ni ) {
+      PyErr_SetString(PyExc_ValueError, "input vector size mismatch");
+      return nullptr;
+    }
+  }
+
+  EquivMgr mgr;
+  auto diff_list = mgr.replay(net1, net2, input_vectors, match_by_name);
+  SizeType n = diff_list.size();
+  auto ans_obj = PyTuple_New(n);
+  for ( SizeType k = 0; k < n; ++ k ) {
+    const auto& diff = diff_list[k];
+    SizeType no = diff.size();
+    auto obj1 = PyTuple_New(no);
+    for ( SizeType i = 0; i < no; ++ i ) {
+      PyTuple_SetItem(obj1, i, PyLong_FromLong(diff[i]));
+    }
+    PyTuple_SetItem(ans_obj, k, obj1);
+  }
+  return ans_obj;
 }
 
 // メソッド定義構造体
@@ -73,6 +182,9 @@ PyMethodDef equiv_methods[] = {
   {"equiv", reinterpret_cast<PyCFunction>(equiv_cmd),
    METH_VARARGS | METH_KEYWORDS,
    PyDoc_STR("check if the two networks are equivalent")},
+  {"replay", reinterpret_cast<PyCFunction>(replay_cmd),
+   METH_VARARGS | METH_KEYWORDS,
+   PyDoc_STR("simulate the two networks and return the mismatched outputs")},
   {nullptr, nullptr, 0, nullptr},
 };
 
@@ -26,6 +26,7 @@ BEGIN_NAMESPACE_FRAIG
 class FraigEnc;
 class FraigMgr;
 class FraigHandle;
+class SeqEnc;
 
 END_NAMESPACE_FRAIG
 
@@ -34,6 +35,7 @@ BEGIN_NAMESPACE_MAGUS
 using nsFraig::FraigEnc;
 using nsFraig::FraigMgr;
 using nsFraig::FraigHandle;
+using nsFraig::SeqEnc;
 
 END_NAMESPACE_MAGUS
 
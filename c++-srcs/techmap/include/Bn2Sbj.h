@@ -25,7 +25,11 @@ class Bn2Sbj
 public:
 
   /// @brief コンストラクタ
-  Bn2Sbj() = default;
+  Bn2Sbj(
+    bool strash = false ///< [in] 構造ハッシュを行う時 true にするフラグ
+  ) : mStrash{strash}
+  {
+  }
 
   /// @brief デストラクタ
   ~Bn2Sbj() = default;
@@ -43,6 +47,15 @@ public:
     SbjGraph& dst_network         ///< [out] 変換されたネットワーク
   );
 
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 構造ハッシュを行う時 true にするフラグ
+  bool mStrash;
+
 };
 
 END_NAMESPACE_SBJ
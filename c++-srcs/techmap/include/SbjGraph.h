@@ -542,9 +542,29 @@ public:
   /// @{
 
   /// @brief 空にする．
+  ///
+  /// 構造ハッシュモードは変更されない．
   void
   clear();
 
+  /// @brief 構造ハッシュモードを設定する．
+  ///
+  /// 構造ハッシュモードでは new_and()/new_xor() で
+  /// 同じタイプ，同じファンインを持つノードがすでに存在していた場合，
+  /// 新たにノードを作らずに既存のノードを返す．
+  /// すでに論理ノードが存在している場合にはそれらもハッシュに登録される．
+  void
+  set_strash(
+    bool flag ///< [in] 構造ハッシュを行う時 true にするフラグ
+  );
+
+  /// @brief 構造ハッシュモードの時 true を返す．
+  bool
+  is_strash() const
+  {
+    return mStrash;
+  }
+
   /// @}
   //////////////////////////////////////////////////////////////////////
 
@@ -588,6 +608,8 @@ private:
   );
 
   /// @brief 新しい論理ノードを作る．
+  ///
+  /// 構造ハッシュモードの時には同じ構造を持つ既存のノードを返す．
   SbjNode*
   _new_logic_node(
     SbjNodeType type,   ///< [in] ノードのタイプ
@@ -595,6 +617,31 @@ private:
     SbjHandle ihandle2  ///< [in] 2番めのファンインのハンドル
   );
 
+  /// @brief 構造ハッシュ表から同じ構造のノードを探す．
+  /// @return 見つかったノードを返す．
+  ///
+  /// 見つからなかった場合には nullptr を返す．
+  /// pos には登録すべき位置が設定される．
+  SbjNode*
+  _strash_find(
+    SbjNodeType type,   ///< [in] ノードのタイプ
+    SbjHandle ihandle1, ///< [in] 1番めのファンインのハンドル
+    SbjHandle ihandle2, ///< [in] 2番めのファンインのハンドル
+    SizeType& pos       ///< [out] 探索が終了した位置
+  ) const;
+
+  /// @brief 構造ハッシュ表にノードを登録する．
+  void
+  _strash_reg(
+    SbjNode* node ///< [in] 対象のノード
+  );
+
+  /// @brief 構造ハッシュ表を拡大する．
+  void
+  _strash_resize(
+    SizeType size ///< [in] 新しいサイズ(2のべき乗)
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -637,6 +684,16 @@ private:
   // 最大レベル
   SizeType mLevel{0};
 
+  // 構造ハッシュモード
+  bool mStrash{false};
+
+  // 構造ハッシュ表(オープンアドレス法)
+  // サイズは常に2のべき乗で空きは nullptr
+  vector<SbjNode*> mStrashTable;
+
+  // 構造ハッシュ表に登録されているノード数
+  SizeType mStrashNum{0};
+
 };
 
 END_NAMESPACE_SBJ
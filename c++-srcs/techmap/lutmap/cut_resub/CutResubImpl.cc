@@ -46,6 +46,15 @@ CutResub::operator()(
   mImpl->resub(sbjgraph, cut_holder, maprec, slack);
 }
 
+// @brief 遅延モデルを設定する．
+void
+CutResub::set_delay_model(
+  const DelayModel& model
+)
+{
+  mImpl->set_delay_model(model);
+}
+
 
 //////////////////////////////////////////////////////////////////////
 // クラス CutResubImpl
@@ -64,6 +73,15 @@ CutResubImpl::~CutResubImpl()
   }
 }
 
+// @brief 遅延モデルを設定する．
+void
+CutResubImpl::set_delay_model(
+  const DelayModel& model
+)
+{
+  mDelayModel = model;
+}
+
 // @brief カットの置き換えを行って LUT 数の削減を行う．
 void
 CutResubImpl::resub(
@@ -121,18 +139,8 @@ CutResubImpl::resub(
       root_list.push_back(crnode);
 
       // crnode のレベルを求める．
-      SizeType level = 0;
       auto cut = crnode->cut();
-      SizeType ni = cut->input_num();
-      for ( SizeType i = 0; i < ni; ++ i ) {
-	auto inode = cut_input(cut, i);
-	if ( inode->is_input() ) continue;
-	SizeType level1 = inode->level();
-	if ( level < level1 ) {
-	  level = level1;
-	}
-      }
-      ++ level;
+      SizeType level = cut_level(cut);
       crnode->set_level(level);
       if ( max_level < level ) {
 	max_level = level;
@@ -168,24 +176,11 @@ CutResubImpl::resub(
 
     if ( mHasLevelConstr ) {
       // 要求レベルの計算を行う．
-      SizeType poreq = max_level + slack;
-      for ( auto node: root_list ) {
-	if ( node->fanout_list().empty() ) {
-	  if ( node->is_output() ) {
-	    node->set_req_level(poreq);
-	  }
-	}
-	else {
-	  const vector<CrNode*>& folist = node->fanout_list();
-	  SizeType req = folist.front()->req_level();
-	  for ( auto fonode: folist ) {
-	    SizeType r1 = fonode->req_level();
-	    if ( req > r1 ) {
-	      req = r1;
-	    }
-	  }
-	  node->set_req_level(req - 1);
-	}
+      // ファンアウトが先に計算されるように出力側から処理する．
+      mPoReqLevel = max_level + slack;
+      for ( SizeType i = root_list.size(); i -- > 0; ) {
+	auto node = root_list[i];
+	node->set_req_level(calc_req_level(node));
       }
     }
   }
@@ -414,7 +409,7 @@ CutResubImpl::find_subst2(
     for ( auto cut: cut_list ) {
       SizeType ni = cut->input_num();
       bool ok = true;
-      SizeType level = 0;
+      mLevelList.resize(ni);
       for ( SizeType i = 0; i < ni; ++ i ) {
 	auto inode = cut_input(cut, i);
 	if ( inode == nullptr || inode == node ) {
@@ -422,13 +417,20 @@ CutResubImpl::find_subst2(
 	  break;
 	}
 	// 現在処理中のノードの場合 level() は使えない．
-	SizeType level1 = inode->is_locked() ? inode->mTmpLevel : inode->level();
+	mLevelList[i] = inode->is_locked() ? inode->mTmpLevel : inode->level();
+      }
+      if ( !ok ) {
+	continue;
+      }
+      calc_edge_delay(cut);
+      SizeType level = 0;
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	SizeType level1 = mLevelList[i] + mEdgeDelay[i];
 	if ( level < level1 ) {
 	  level = level1;
 	}
       }
-      level += 1;
-      if ( !ok || level > fo->req_level() ) {
+      if ( level > fo->req_level() ) {
 	continue;
       }
 
@@ -553,17 +555,7 @@ CutResubImpl::update(
     // レベルの再計算
     while ( mLQ.num() > 0 ) {
       auto node = get_lq();
-      auto cut = node->cut();
-      SizeType max_level = 0;
-      SizeType ni = cut->input_num();
-      for ( SizeType i = 0; i < ni; ++ i ) {
-	auto inode = cut_input(cut, i);
-	SizeType level = inode->level();
-	if ( max_level < level ) {
-	  max_level = level;
-	}
-      }
-      max_level += 1;
+      SizeType max_level = cut_level(node->cut());
       if ( node->level() != max_level ) {
 	node->set_level(max_level);
 	auto& fo_list = node->fanout_list();
@@ -579,18 +571,7 @@ CutResubImpl::update(
       if ( node->deleted() ) {
 	continue;
       }
-      auto& fo_list = node->fanout_list();
-#if 0
-      if ( fo_list.empty() ) continue;
-#endif
-      SizeType min_req = fo_list.front()->req_level();
-      for ( auto fo: fo_list ) {
-	SizeType req = fo->req_level();
-	if ( min_req > req ) {
-	  min_req = req;
-	}
-      }
-      min_req -= 1;
+      SizeType min_req = calc_req_level(node);
       if ( node->req_level() != min_req ) {
 	node->set_req_level(min_req);
 	auto cut = node->cut();
@@ -735,6 +716,75 @@ CutResubImpl::get_rq()
   return node;
 }
 
+// カットのレベル(根の到着時刻)を求める．
+SizeType
+CutResubImpl::cut_level(
+  const Cut* cut
+)
+{
+  SizeType ni = cut->input_num();
+  mLevelList.resize(ni);
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    mLevelList[i] = cut_input(cut, i)->level();
+  }
+  calc_edge_delay(cut);
+  SizeType level = 0;
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    SizeType level1 = mLevelList[i] + mEdgeDelay[i];
+    if ( level < level1 ) {
+      level = level1;
+    }
+  }
+  return level;
+}
+
+// ファンアウトの要求レベルから node の要求レベルを求める．
+SizeType
+CutResubImpl::calc_req_level(
+  CrNode* node
+)
+{
+  SizeType req = std::numeric_limits<SizeType>::max();
+  if ( node->is_output() ) {
+    req = mPoReqLevel;
+  }
+  for ( auto fo: node->fanout_list() ) {
+    // fo のカットの中の node の位置を探す．
+    auto cut = fo->cut();
+    SizeType ni = cut->input_num();
+    SizeType pos = ni;
+    mLevelList.resize(ni);
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto inode = cut_input(cut, i);
+      if ( inode == node ) {
+	pos = i;
+      }
+      mLevelList[i] = inode->level();
+    }
+    ASSERT_COND( pos < ni );
+    calc_edge_delay(cut);
+    SizeType req1 = fo->req_level() - mEdgeDelay[pos];
+    if ( req > req1 ) {
+      req = req1;
+    }
+  }
+  return req;
+}
+
+// カットの各入力から根までの遅延を mEdgeDelay に求める．
+void
+CutResubImpl::calc_edge_delay(
+  const Cut* cut
+)
+{
+  SizeType ni = cut->input_num();
+  mDelayModel.assign_pins(cut, mLevelList, mPinList);
+  mEdgeDelay.resize(ni);
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    mEdgeDelay[i] = mDelayModel.edge_delay(cut, i, mPinList[i]);
+  }
+}
+
 // カットの根に対応するノードを取り出す．
 CrNode*
 CutResubImpl::cut_root(
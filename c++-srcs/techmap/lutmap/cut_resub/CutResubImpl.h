@@ -11,6 +11,7 @@
 #include "lutmap.h"
 #include "CrHeap.h"
 #include "CrLevelQ.h"
+#include "DelayModel.h"
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -20,6 +21,8 @@ class CrNode;
 //////////////////////////////////////////////////////////////////////
 /// @class CutResubImpl CutResubImpl.h "CutResubImpl.h"
 /// @brief カットの置き換えを行うクラス
+///
+/// レベルと要求レベルは DelayModel の遅延で表す．
 //////////////////////////////////////////////////////////////////////
 class CutResubImpl
 {
@@ -38,6 +41,12 @@ public:
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 遅延モデルを設定する．
+  void
+  set_delay_model(
+    const DelayModel& model ///< [in] 遅延モデル
+  );
+
   /// @brief カットの置き換えを行って LUT 数の削減を行う．
   void
   resub(
@@ -139,6 +148,27 @@ private:
   CrNode*
   get_rq();
 
+  // カットのレベル(根の到着時刻)を求める．
+  SizeType
+  cut_level(
+    const Cut* cut
+  );
+
+  // ファンアウトの要求レベルから node の要求レベルを求める．
+  SizeType
+  calc_req_level(
+    CrNode* node
+  );
+
+  // カットの各入力から根までの遅延を mEdgeDelay に求める．
+  //
+  // 各入力のレベルを mLevelList に入れておく．
+  // ピンはそのレベルをもとに DelayModel::assign_pins() で割り当てる．
+  void
+  calc_edge_delay(
+    const Cut* cut
+  );
+
   // カットの根に対応するノードを取り出す．
   CrNode*
   cut_root(
@@ -177,6 +207,21 @@ private:
   // レベル制約がある時 true となるフラグ
   bool mHasLevelConstr;
 
+  // 外部出力の要求レベル
+  SizeType mPoReqLevel{0};
+
+  // 遅延モデル
+  DelayModel mDelayModel;
+
+  // カットの入力のレベルを入れる作業領域
+  vector<SizeType> mLevelList;
+
+  // カットの入力を割り当てたピン番号を入れる作業領域
+  vector<SizeType> mPinList;
+
+  // カットの入力から根までの遅延を入れる作業領域
+  vector<SizeType> mEdgeDelay;
+
   // ゲインをキーとしたヒープ
   CrHeap mHeap;
 
@@ -12,77 +12,9 @@
 
 BEGIN_NAMESPACE_LUTMAP
 
-BEGIN_NONAMESPACE
-
-// valmap に終端のノード番号をキーとしてビットベクタ値を登録する．
-// その時の node の値を計算する．
-std::uint64_t
-eval_node(
-  const SbjNode* node,
-  unordered_map<SizeType, std::uint64_t>& valmap
-)
-{
-  if ( node == nullptr ) {
-    return 0ULL;
-  }
-
-  // まずすでに評価済みかどうか調べる．
-  // 葉のノードの場合もここに登録されている．
-  std::uint64_t ans;
-  if ( valmap.count(node->id()) == 0 ) {
-    // 未登録の場合は必ず論理ノード
-    ASSERT_COND( node->is_logic() );
-
-    // 子供の値を評価する．
-    std::uint64_t val0 = eval_node(node->fanin(0), valmap);
-    if ( node->fanin_inv(0) ) {
-      val0 ^= 0xFFFFFFFFFFFFFFFFULL;
-    }
-
-    std::uint64_t val1 = eval_node(node->fanin(1), valmap);
-    if ( node->fanin_inv(0) ) {
-      val1 ^= 0xFFFFFFFFFFFFFFFFULL;
-    }
-
-    // 自分の値を計算する．
-    if ( node->is_xor() ) {
-      ans = val0 ^ val1;
-    }
-    else {
-      ans = val0 & val1;
-    }
-
-    // 登録しておく．
-    valmap.emplace(node->id(), ans);
-  }
-  else {
-    ans = valmap.at(node->id());
-  }
-
-  return ans;
-}
-
-// カットの表している論理関数を評価する．
-std::uint64_t
-eval_cut(
-  const Cut* cut,
-  const vector<std::uint64_t>& vals
-)
-{
-  SizeType ni = cut->input_num();
-  ASSERT_COND( ni == vals.size() );
-
-  unordered_map<SizeType, std::uint64_t> valmap;
-  for ( SizeType i = 0; i < ni; ++ i ) {
-    auto inode = cut->input(i);
-    valmap.emplace(inode->id(), vals[i]);
-  }
-  return eval_node(cut->root(), valmap);
-}
-
-END_NONAMESPACE
-
 // @brief 論理シミュレーションを行う．
+//
+// 64個のパタンごとに入力の値から真理値表の位置を求める．
 std::uint64_t
 Cut::eval(
   const vector<std::uint64_t>& vals
@@ -91,15 +23,20 @@ Cut::eval(
   SizeType ni = input_num();
   ASSERT_COND( ni == vals.size() );
 
-  // ノードの ID 番号をキーにして値を保持するハッシュ表
-  unordered_map<SizeType, std::uint64_t> valmap;
-  // 葉のノードの値を登録する．
-  for ( SizeType i = 0; i < ni; ++ i ) {
-    valmap.emplace(input(i)->id(), vals[i]);
+  auto tv = tv_words();
+  std::uint64_t ans = 0ULL;
+  for ( SizeType b = 0; b < 64; ++ b ) {
+    SizeType p = 0;
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      if ( (vals[i] >> b) & 1ULL ) {
+	p |= (1ULL << i);
+      }
+    }
+    if ( (tv[p / 64] >> (p % 64)) & 1ULL ) {
+      ans |= (1ULL << b);
+    }
   }
-
-  // 評価を行う．
-  return eval_node(root(), valmap);
+  return ans;
 }
 
 // @brief 論理関数を表す真理値表を得る．
@@ -112,6 +49,9 @@ Cut::make_tv(
 }
 
 // @brief 論理関数を表す真理値表を得る．
+//
+// 真理値表は tv_words() で得られるので
+// ここでは極性の変換のみを行う．
 TvFunc
 Cut::make_tv(
   bool oinv,
@@ -121,60 +61,73 @@ Cut::make_tv(
   SizeType ni = input_num();
   SizeType np = 1 << ni;
 
+  vector<std::uint64_t> words;
+  make_tv_words(oinv, iinv, words);
+
   vector<int> tv(np);
+  for ( SizeType p = 0; p < np; ++ p ) {
+    tv[p] = (words[p / 64] >> (p % 64)) & 1ULL;
+  }
+
+  return TvFunc(ni, tv);
+}
+
+// @brief 極性を変換した真理値表のワードの配列を得る．
+//
+// 入力の反転は真理値表の該当する変数の半分どうしの入れ替えとなるので
+// 6未満の変数はワード内のビットシフトで，
+// 6以上の変数はワードの入れ替えで行う．
+void
+Cut::make_tv_words(
+  bool oinv,
+  const vector<bool>& iinv,
+  vector<std::uint64_t>& words
+) const
+{
+  // ワード内の変数ごとのマスク
+  static const std::uint64_t kVarMask[] = {
+    0x5555555555555555ULL,
+    0x3333333333333333ULL,
+    0x0F0F0F0F0F0F0F0FULL,
+    0x00FF00FF00FF00FFULL,
+    0x0000FFFF0000FFFFULL,
+    0x00000000FFFFFFFFULL
+  };
 
-  // 1 の値と 0 の値
-  // inv == true の時には逆にする．
-  int v1 = oinv ? 0 : 1;
-  int v0 = oinv ? 1 : 0;
-
-  // 真理値表の各変数の値を表すビットベクタ
-  // 6入力以上の場合には1語に収まらないので複数回にわけて処理する．
-  vector<std::uint64_t> vals(ni, 0ULL);
-
-  std::uint64_t s = 1ULL;
-  int p0 = 0;
-  for ( int p = 0; p < np; ++ p ) {
-    for ( int i = 0; i < ni; ++ i ) {
-      std::uint64_t mask = 1U << i;
-      std::uint64_t mask1 = iinv[i] ? 0U : mask;
-      if ( (p & mask) == mask1 ) {
-	vals[i] |= s;
+  SizeType ni = input_num();
+  SizeType nw = tv_word_num(ni);
+  auto tv_body = tv_words();
+  words.assign(tv_body, tv_body + nw);
+
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    if ( !iinv[i] ) {
+      continue;
+    }
+    if ( i < 6 ) {
+      auto mask = kVarMask[i];
+      SizeType shift = 1 << i;
+      for ( auto& w: words ) {
+	w = ((w & mask) << shift) | ((w >> shift) & mask);
       }
     }
-    s <<= 1;
-    if ( s == 0ULL ) {
-      // 64 パタン目
-      std::uint64_t tmp = eval_cut(this, vals);
-      for ( int p1 = p0; p1 < p; ++ p1 ) {
-	if ( tmp & (1ULL << (p1 - p0)) ) {
-	  tv[p1] = v1;
-	}
-	else {
-	  tv[p1] = v0;
+    else {
+      SizeType bit = 1 << (i - 6);
+      for ( SizeType j = 0; j < nw; ++ j ) {
+	if ( (j & bit) == 0 ) {
+	  std::swap(words[j], words[j ^ bit]);
 	}
       }
-      s = 1ULL;
-      p0 = p + 1;
-      for ( int i = 0; i < ni; ++ i ) {
-	vals[i] = 0ULL;
-      }
     }
   }
-  if ( s != 1ULL ) {
-    // 処理されていない残りがあった．
-    std::uint64_t tmp = eval_cut(this, vals);
-    for ( int p1 = p0; p1 < np; ++ p1 ) {
-      if ( tmp & (1ULL << (p1 - p0)) ) {
-	tv[p1] = v1;
-      }
-      else {
-	tv[p1] = v0;
-      }
+
+  if ( oinv ) {
+    for ( auto& w: words ) {
+      w = ~w;
     }
   }
 
-  return TvFunc(ni, tv);
+  // 未使用のビットを落としておく．
+  words[0] &= tv_mask(ni);
 }
 
 // デバッグ用の表示関数
@@ -9,6 +9,7 @@
 #include "CutHolder.h"
 #include "Cut.h"
 #include "CutList.h"
+#include "EnumCutMt.h"
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -25,12 +26,48 @@ CutHolder::~CutHolder()
   clear();
 }
 
+// @brief 保持しているカット数を返す．
+SizeType
+CutHolder::cut_num() const
+{
+  SizeType n = mMgr.cut_num();
+  for ( auto& mgr: mSubMgrList ) {
+    n += mgr->cut_num();
+  }
+  return n;
+}
+
+// @brief カット用に確保しているメモリ量(バイト)を返す．
+SizeType
+CutHolder::bytes_used() const
+{
+  SizeType n = mMgr.bytes_used();
+  for ( auto& mgr: mSubMgrList ) {
+    n += mgr->bytes_used();
+  }
+  return n;
+}
+
 // @brief 保持しているカットのリストを削除する．
 void
 CutHolder::clear()
 {
   delete [] mCutList;
+  mCutList = nullptr;
   mMgr.clear();
+  mSubMgrList.clear();
+}
+
+// @brief 複数のスレッドを用いてカットの列挙を行う．
+SizeType
+CutHolder::enum_cut_mt(
+  const SbjGraph& sbjgraph,
+  SizeType limit,
+  SizeType thread_num
+)
+{
+  EnumCutMt ec{thread_num};
+  return ec(sbjgraph, limit, *this);
 }
 
 // 最初に呼ばれる関数
@@ -65,10 +102,11 @@ void
 CutHolder::found(
   const SbjNode* root,
   SizeType ni,
-  const SbjNode* inputs[]
+  const SbjNode* inputs[],
+  const std::uint64_t* tv_words
 )
 {
-  auto cut = mMgr.new_cut(root, ni, inputs);
+  auto cut = mMgr.new_cut(root, ni, inputs, tv_words);
   mCutList[root->id()].push_back(cut);
 }
 
@@ -88,6 +126,11 @@ CutHolder::all_end(
   SizeType limit
 )
 {
+  // enum_cut_mt() では複数の CutMgr にまたがるのでここで合計する．
+  auto n = cut_num();
+  if ( mPeakCutNum < n ) {
+    mPeakCutNum = n;
+  }
 }
 
 END_NAMESPACE_LUTMAP
@@ -0,0 +1,81 @@
+
+/// @file CutMgr.cc
+/// @brief CutMgr の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "CutMgr.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+BEGIN_NONAMESPACE
+
+// チャンクのサイズ
+const SizeType kChunkSize = 64 * 1024;
+
+END_NONAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+// クラス CutMgr
+//////////////////////////////////////////////////////////////////////
+
+// @brief カットを生成する．
+Cut*
+CutMgr::new_cut(
+  const SbjNode* root,
+  SizeType ni,
+  const SbjNode* inputs[],
+  const std::uint64_t* tv_words
+)
+{
+  auto p = alloc_cut(ni);
+  return new (p) Cut(root, ni, inputs, tv_words);
+}
+
+// @brief このオブジェクトが管理しているすべてのカットを削除する．
+void
+CutMgr::clear()
+{
+  for ( auto p: mChunkList ) {
+    delete [] p;
+  }
+  mChunkList.clear();
+  mChunkPos = nullptr;
+  mChunkEnd = nullptr;
+  mCutNum = 0;
+  mBytesUsed = 0;
+}
+
+// @brief 入力数 ni のカット用のメモリ領域を確保する．
+char*
+CutMgr::alloc_cut(
+  SizeType ni
+)
+{
+  SizeType size = Cut::alloc_size(ni);
+
+  if ( mChunkPos == nullptr || mChunkPos + size > mChunkEnd ) {
+    // 新しいチャンクを確保する．
+    // 残りの領域は捨てる．
+    SizeType chunk_size = std::max(kChunkSize, size);
+    auto chunk = new char[chunk_size];
+    mChunkList.push_back(chunk);
+    mChunkPos = chunk;
+    mChunkEnd = chunk + chunk_size;
+    mBytesUsed += chunk_size;
+  }
+  auto p = mChunkPos;
+  mChunkPos += size;
+
+  ++ mCutNum;
+  if ( mPeakCutNum < mCutNum ) {
+    mPeakCutNum = mCutNum;
+  }
+
+  return p;
+}
+
+END_NAMESPACE_LUTMAP
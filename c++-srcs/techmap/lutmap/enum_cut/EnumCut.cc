@@ -7,6 +7,7 @@
 /// All rights reserved.
 
 #include "EnumCut.h"
+#include "Cut.h"
 
 //#define DEBUG_ENUM_RECUR
 
@@ -38,6 +39,40 @@ EnumCut::operator()(
   SizeType limit,
   EnumCutOp* op
 )
+{
+  mMyCnodeListArray.clear();
+  mMyCnodeListArray.resize(sbjgraph.node_num());
+  init(sbjgraph, limit, op, mMyCnodeListArray);
+
+  mOp->all_init(sbjgraph, limit);
+
+  // 外部入力用の(ダミーの)クラスタを作る．
+  SizeType nc_all = 0;
+  SizeType cur_pos = 0;
+  for ( auto node: sbjgraph.input_list() ) {
+    nc_all += enum_input(node, cur_pos);
+    ++ cur_pos;
+  }
+
+  // 入力側から内部ノード用のクラスタを作る．
+  for ( auto node: sbjgraph.logic_list() ) {
+    nc_all += enum_logic(node, cur_pos);
+    ++ cur_pos;
+  }
+
+  mOp->all_end(sbjgraph, limit);
+
+  return nc_all;
+}
+
+// @brief ノード単位で列挙を行うための初期化を行う．
+void
+EnumCut::init(
+  const SbjGraph& sbjgraph,
+  SizeType limit,
+  EnumCutOp* op,
+  vector<vector<const SbjNode*>>& cnode_list_array
+)
 {
   SizeType n = sbjgraph.node_num();
   mNodeTemp.clear();
@@ -45,110 +80,111 @@ EnumCut::operator()(
 
   mMarkedNodes.resize(n);
 
+  mTvPos.clear();
+  mTvPos.resize(n, 0);
+
+  mCnodeListArray = &cnode_list_array;
+
   mLimit = limit;
   mOp = op;
 
-  mOp->all_init(sbjgraph, limit);
+  mInputs.clear();
+  mInputs.resize(limit);
+  mFsPos = &mFrontierStack[0];
+}
 
-  mInputs = new const SbjNode*[limit];
+// @brief 外部入力のカットを列挙する．
+SizeType
+EnumCut::enum_input(
+  const SbjNode* node,
+  SizeType pos
+)
+{
+  mNcCur = 0;
 
-  SizeType ni = sbjgraph.input_num();
-  SizeType nl = sbjgraph.logic_num();
+  mOp->node_init(node, pos);
 
-  mInodeStack = new SizeType[nl];
-  mIsPos = &mInodeStack[0];
+  // 自分自身のみからなるクラスタを登録する．
+  mOp->found(node);
+  ++ mNcCur;
 
-  // 外部入力用の(ダミーの)クラスタを作る．
-  mNall = ni + nl;
-  mNcAll = 0;
-  mCurPos = 0;
-  for ( auto node: sbjgraph.input_list() ) {
-    mNcCur = 0;
+  // 今の列挙で用いたノードを cut_node_list に格納しておく
+  auto& clist = cnode_list(node);
+  clist.clear();
+  clist.push_back(node);
 
-    mOp->node_init(node, mCurPos);
+  mOp->node_end(node, pos, mNcCur);
 
-    // 自分自身のみからなるクラスタを登録する．
-    mOp->found(node);
-    ++ mNcAll;
-    ++ mNcCur;
-
-    // 今の列挙で用いたノードを cut_node_list に格納しておく
-    cnode_list(node).push_back(node);
+  return mNcCur;
+}
 
-    mOp->node_end(node, mCurPos, mNcCur);
+// @brief 論理ノードのカットを列挙する．
+SizeType
+EnumCut::enum_logic(
+  const SbjNode* node,
+  SizeType pos
+)
+{
+  mMarkedNodesLast = 0;
 
-    ++ mCurPos;
+  for ( int i: {0, 1} ) {
+    // ファンインの cut に含まれるノードに c1mark をつける．
+    const SbjNode* inode = node->fanin(i);
+    mark_cnode(inode);
   }
 
-  // 入力側から内部ノード用のクラスタを作る．
-  for ( auto node: sbjgraph.logic_list() ) {
-    mMarkedNodesLast = 0;
-
-    for ( int i: {0, 1} ) {
-      // ファンインの cut に含まれるノードに c1mark をつける．
-      const SbjNode* inode = node->fanin(i);
-      mark_cnode(inode);
-    }
-
-    // 自分に c1mark がついており，ファンインには c1mark がついていない
-    // ノードに c2mark をつける．
-    // c2mark のついたノードが境界ノードとなる．
-    for ( int i = 0; i < mMarkedNodesLast; ++ i ) {
-      const SbjNode* node = mMarkedNodes[i];
-      if ( temp1mark(node) ) {
-	if ( node->is_logic() ) {
-	  for ( int i: {0, 1} ) {
-	    const SbjNode* inode = node->fanin(i);
-	    if ( !temp1mark(inode) ) {
-	      set_temp2mark(node);
-	      break;
-	    }
+  // 自分に c1mark がついており，ファンインには c1mark がついていない
+  // ノードに c2mark をつける．
+  // c2mark のついたノードが境界ノードとなる．
+  for ( int i = 0; i < mMarkedNodesLast; ++ i ) {
+    const SbjNode* node = mMarkedNodes[i];
+    if ( temp1mark(node) ) {
+      if ( node->is_logic() ) {
+	for ( int i: {0, 1} ) {
+	  const SbjNode* inode = node->fanin(i);
+	  if ( !temp1mark(inode) ) {
+	    set_temp2mark(node);
+	    break;
 	  }
 	}
-	else { // is_ppi() == true
-	  set_temp2mark(node);
-	}
+      }
+      else { // is_ppi() == true
+	set_temp2mark(node);
       }
     }
+  }
 
-    // クラスタの列挙を行う．
-    // ただし c2mark にぶつかったらそれ以上，入力側にはいかない．
-    mNcCur = 0;
-
-    mOp->node_init(node, mCurPos);
+  // クラスタの列挙を行う．
+  // ただし c2mark にぶつかったらそれ以上，入力側にはいかない．
+  mNcCur = 0;
 
-    mInputPos = 0;
-    mRoot = node;
+  mOp->node_init(node, pos);
 
-    push_node(node);
-    enum_recur();
-    pop_node();
-    clear_state(node);
-    ASSERT_COND(frontier_is_empty() );
-    ASSERT_COND(mInputPos == 0 );
+  mInputPos = 0;
+  mRoot = node;
 
-    // 今の列挙で用いたノードを cut_node_list に格納しておく
-    vector<const SbjNode*>& clist = cnode_list(node);
-    clist.reserve(mMarkedNodesLast);
-    set_cut_node_list_recur(node, clist);
+  push_node(node);
+  enum_recur();
+  pop_node();
+  clear_state(node);
+  ASSERT_COND(frontier_is_empty() );
+  ASSERT_COND(mInputPos == 0 );
 
-    mOp->node_end(node, mCurPos, mNcCur);
+  // 今の列挙で用いたノードを cut_node_list に格納しておく
+  vector<const SbjNode*>& clist = cnode_list(node);
+  clist.clear();
+  clist.reserve(mMarkedNodesLast);
+  set_cut_node_list_recur(node, clist);
 
-    ++ mCurPos;
+  mOp->node_end(node, pos, mNcCur);
 
-    // マークを消しておく
-    for ( int i = 0; i < mMarkedNodesLast; ++ i ) {
-      const SbjNode* node = mMarkedNodes[i];
-      clear_tempmark(node);
-    }
+  // マークを消しておく
+  for ( int i = 0; i < mMarkedNodesLast; ++ i ) {
+    const SbjNode* node = mMarkedNodes[i];
+    clear_tempmark(node);
   }
 
-  mOp->all_end(sbjgraph, limit);
-
-  delete [] mInputs;
-  delete [] mInodeStack;
-
-  return mNcAll;
+  return mNcCur;
 }
 
 // node のカットになったノードに c1mark を付け，mMarkedNodes に入れる．
@@ -300,12 +336,12 @@ EnumCut::enum_recur()
       set_cmark(mInputs[i]);
     }
     if ( mInputPos > 1 ) {
-      mOp->found(mRoot, mInputPos, mInputs);
+      auto tv_words = calc_tv();
+      mOp->found(mRoot, mInputPos, mInputs.data(), tv_words);
     }
     else {
       mOp->found(mRoot);
     }
-    ++ mNcAll;
     ++ mNcCur;
     return true;
   }
@@ -437,6 +473,98 @@ EnumCut::enum_recur()
   }
 }
 
+// 現在のカットの真理値表を求める．
+//
+// カットの内部のノードは根から入力に到達するまでのノードなので
+// 根から DFS でたどってトポロジカル順に並べ，
+// 全入力パタンをビット並列にシミュレーションする．
+// 各ノードの値の位置はノード番号をキーにした配列で管理する．
+const std::uint64_t*
+EnumCut::calc_tv()
+{
+  SizeType ni = mInputPos;
+  SizeType nw = Cut::tv_word_num(ni);
+
+  // 葉のノードの値は 0 〜 ni - 1 番目に置く．
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    mTvPos[mInputs[i]->id()] = i + 1;
+  }
+
+  // 内部のノードをトポロジカル順に並べる．
+  mTvNodeList.clear();
+  mTvStack.clear();
+  mTvStack.push_back(mRoot);
+  while ( !mTvStack.empty() ) {
+    auto node = mTvStack.back();
+    if ( mTvPos[node->id()] > 0 ) {
+      // 別の経路ですでに処理された．
+      mTvStack.pop_back();
+      continue;
+    }
+    ASSERT_COND( node->is_logic() );
+    bool ready = true;
+    for ( int i: {0, 1} ) {
+      auto inode = node->fanin(i);
+      if ( mTvPos[inode->id()] == 0 ) {
+	mTvStack.push_back(inode);
+	ready = false;
+      }
+    }
+    if ( ready ) {
+      mTvStack.pop_back();
+      mTvNodeList.push_back(node);
+      mTvPos[node->id()] = ni + mTvNodeList.size();
+    }
+  }
+
+  SizeType nv = ni + mTvNodeList.size();
+  if ( mTvVal.size() < nv * nw ) {
+    mTvVal.resize(nv * nw);
+  }
+
+  // 葉のノードに変数のパタンを設定する．
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    auto dst = &mTvVal[i * nw];
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      dst[w] = Cut::var_word(i, w);
+    }
+  }
+
+  // 内部のノードの値をトポロジカル順に計算する．
+  for ( auto node: mTvNodeList ) {
+    auto dst = &mTvVal[(mTvPos[node->id()] - 1) * nw];
+    auto src0 = &mTvVal[(mTvPos[node->fanin(0)->id()] - 1) * nw];
+    auto src1 = &mTvVal[(mTvPos[node->fanin(1)->id()] - 1) * nw];
+    std::uint64_t inv0 = node->fanin_inv(0) ? ~0ULL : 0ULL;
+    std::uint64_t inv1 = node->fanin_inv(1) ? ~0ULL : 0ULL;
+    if ( node->is_xor() ) {
+      for ( SizeType w = 0; w < nw; ++ w ) {
+	dst[w] = (src0[w] ^ inv0) ^ (src1[w] ^ inv1);
+      }
+    }
+    else {
+      for ( SizeType w = 0; w < nw; ++ w ) {
+	dst[w] = (src0[w] ^ inv0) & (src1[w] ^ inv1);
+      }
+    }
+  }
+
+  // 根のノードの値が結果となる．
+  // 根は最後に処理されている．
+  auto ans = &mTvVal[(nv - 1) * nw];
+  ans[0] &= Cut::tv_mask(ni);
+
+  // 位置の情報を消しておく．
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    mTvPos[mInputs[i]->id()] = 0;
+  }
+  for ( auto node: mTvNodeList ) {
+    mTvPos[node->id()] = 0;
+  }
+
+  return ans;
+}
+
 // cmark の付いているノードを cnode_list に入れて cmark を消す．
 void
 EnumCut::set_cut_node_list_recur(
@@ -41,6 +41,38 @@ public:
     EnumCutOp* op             ///< [in] カットが列挙される時に呼ばれるクラス
   );
 
+  /// @brief ノード単位で列挙を行うための初期化を行う．
+  ///
+  /// cnode_list_array は各ノードのカットのフットプリントを格納する配列で
+  /// 複数の EnumCut で共有することができる．
+  /// 論理ノードのカットを列挙する時にはファンインのフットプリントが
+  /// 求められている必要がある．
+  /// op->all_init() および op->all_end() は呼ばれない．
+  void
+  init(
+    const SbjGraph& sbjgraph,  ///< [in] 対象のサブジェクトグラフ
+    SizeType limit,            ///< [in] 入力数の制限
+    EnumCutOp* op,             ///< [in] カットが列挙される時に呼ばれるクラス
+    vector<vector<const SbjNode*>>& cnode_list_array
+                               ///< [in] フットプリントを格納する配列
+  );
+
+  /// @brief 外部入力のカットを列挙する．
+  /// @return 列挙されたカット数を返す．
+  SizeType
+  enum_input(
+    const SbjNode* node, ///< [in] 対象の外部入力
+    SizeType pos         ///< [in] node の処理順
+  );
+
+  /// @brief 論理ノードのカットを列挙する．
+  /// @return 列挙されたカット数を返す．
+  SizeType
+  enum_logic(
+    const SbjNode* node, ///< [in] 対象の論理ノード
+    SizeType pos         ///< [in] node の処理順
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -84,6 +116,12 @@ private:
   );
 #endif
 
+  // 現在のカットの真理値表を求める．
+  //
+  // 結果は mTvVal 上の領域を指すので次の呼び出しまで有効
+  const std::uint64_t*
+  calc_tv();
+
   // cmark の付いているノードを cnode_list に入れて
   // cmark を消す．
   void
@@ -250,7 +288,7 @@ private:
     const SbjNode* node
   )
   {
-    return node_temp(node).cnode_list();
+    return (*mCnodeListArray)[node->id()];
   }
 
   const vector<const SbjNode*>&
@@ -258,7 +296,7 @@ private:
     const SbjNode* node
   ) const
   {
-    return node_temp(node).cnode_list();
+    return (*mCnodeListArray)[node->id()];
   }
 
 
@@ -389,29 +427,12 @@ private:
       mMarks &= ~(32U << pos);
     }
 
-    /// @brief クラスタノードのリストを返す．
-    vector<const SbjNode*>&
-    cnode_list()
-    {
-      return mCnodeList;
-    }
-
-    /// @brief クラスタノードのリストを返す．
-    const vector<const SbjNode*>&
-    cnode_list() const
-    {
-      return mCnodeList;
-    }
-
 
   private:
     //////////////////////////////////////////////////////////////////////
     // データメンバ
     //////////////////////////////////////////////////////////////////////
 
-    // このノードを根とする全カットのフットプリント
-    vector<const SbjNode*> mCnodeList;
-
     // 種々のマーク
     std::uint32_t mMarks{0U};
 
@@ -426,15 +447,6 @@ private:
   // 入力数の最大値
   SizeType mLimit;
 
-  // 全ノード数
-  SizeType mNall;
-
-  // 現在処理中のノード番号
-  SizeType mCurPos;
-
-  // 全 cut 数
-  SizeType mNcAll;
-
   // 現在処理中のノードの cut 数
   SizeType mNcCur;
 
@@ -451,20 +463,20 @@ private:
   const SbjNode** mFsPos;
 
   // 確定した境界ノードを入れるベクタ
-  const SbjNode** mInputs;
+  vector<const SbjNode*> mInputs;
 
   // mInputs の次の書き込み位置
   SizeType mInputPos;
 
-  // 内部ノードのスタック
-  SizeType* mInodeStack;
-
-  // 内部ノードスタックのスタックポインタ
-  SizeType* mIsPos;
-
   // 各ノードごとの作業領域
   vector<NodeTemp> mNodeTemp;
 
+  // 各ノードのカットのフットプリントを格納する配列
+  vector<vector<const SbjNode*>>* mCnodeListArray;
+
+  // operator() で用いるフットプリントの配列
+  vector<vector<const SbjNode*>> mMyCnodeListArray;
+
   // マークの付いたノードを入れておく配列
   vector<const SbjNode*> mMarkedNodes;
 
@@ -474,6 +486,21 @@ private:
   // カットが列挙されたときに呼ばれるクラス
   EnumCutOp* mOp;
 
+  // calc_tv() で用いるノード番号をキーにして mTvVal 上の位置 + 1 を
+  // 格納する配列
+  // 0 の時は未処理を表す．
+  vector<SizeType> mTvPos;
+
+  // calc_tv() で用いるカットの内部のノードのリスト
+  // トポロジカル順に並んでいる．
+  vector<const SbjNode*> mTvNodeList;
+
+  // calc_tv() で用いる DFS 用のスタック
+  vector<const SbjNode*> mTvStack;
+
+  // calc_tv() で用いる各ノードの値を格納する配列
+  vector<std::uint64_t> mTvVal;
+
 };
 
 END_NAMESPACE_LUTMAP
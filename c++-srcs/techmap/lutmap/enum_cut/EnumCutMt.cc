@@ -0,0 +1,181 @@
+
+/// @file EnumCutMt.cc
+/// @brief EnumCutMt の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "EnumCutMt.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+//////////////////////////////////////////////////////////////////////
+// クラス EnumCutMt
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+EnumCutMt::EnumCutMt(
+  SizeType thread_num
+) : mThreadNum{thread_num}
+{
+  if ( mThreadNum == 0 ) {
+    mThreadNum = std::thread::hardware_concurrency();
+    if ( mThreadNum == 0 ) {
+      mThreadNum = 1;
+    }
+  }
+}
+
+// @brief 入力数が limit 以下のカットを列挙して cut_holder に格納する．
+SizeType
+EnumCutMt::operator()(
+  const SbjGraph& sbjgraph,
+  SizeType limit,
+  CutHolder& cut_holder
+)
+{
+  cut_holder.all_init(sbjgraph, limit);
+
+  SizeType n = sbjgraph.node_num();
+  mCnodeListArray.clear();
+  mCnodeListArray.resize(n);
+  mPosArray.clear();
+  mPosArray.resize(n, 0);
+
+  // 論理ノードをレベルごとに分ける．
+  // 同じレベル内では logic_list() の順番を保つ．
+  mLevelList.clear();
+  SizeType pos = sbjgraph.input_num();
+  for ( auto node: sbjgraph.logic_list() ) {
+    SizeType lv = node->level();
+    ASSERT_COND( lv > 0 );
+    if ( mLevelList.size() < lv ) {
+      mLevelList.resize(lv);
+    }
+    mLevelList[lv - 1].push_back(node);
+    mPosArray[node->id()] = pos;
+    ++ pos;
+  }
+
+  // スレッドごとの作業領域を用意する．
+  // 0 番目のスレッドは cut_holder 自身の CutMgr を用いる．
+  cut_holder.mSubMgrList.clear();
+  mEnumCutList.clear();
+  mCollectorList.clear();
+  mNcArray.clear();
+  mNcArray.resize(mThreadNum, 0);
+  for ( SizeType tid = 0; tid < mThreadNum; ++ tid ) {
+    CutMgr* mgr = &cut_holder.mMgr;
+    if ( tid > 0 ) {
+      cut_holder.mSubMgrList.emplace_back(new CutMgr);
+      mgr = cut_holder.mSubMgrList.back().get();
+    }
+    auto op = new Collector{*mgr, cut_holder.mCutList};
+    mCollectorList.emplace_back(op);
+    auto ec = new EnumCut;
+    ec->init(sbjgraph, limit, op, mCnodeListArray);
+    mEnumCutList.emplace_back(ec);
+  }
+
+  // 外部入力の処理は軽いので逐次的に行う．
+  SizeType nc_all = 0;
+  {
+    auto ec = mEnumCutList[0].get();
+    SizeType pos = 0;
+    for ( auto node: sbjgraph.input_list() ) {
+      nc_all += ec->enum_input(node, pos);
+      ++ pos;
+    }
+  }
+
+  // 論理ノードの処理
+  mNextPos = 0;
+  mSyncCount = 0;
+  vector<std::thread> thread_list;
+  thread_list.reserve(mThreadNum - 1);
+  for ( SizeType tid = 1; tid < mThreadNum; ++ tid ) {
+    thread_list.push_back(std::thread{[this, tid]{ worker(tid); }});
+  }
+  worker(0);
+  for ( auto& th: thread_list ) {
+    th.join();
+  }
+
+  for ( auto nc: mNcArray ) {
+    nc_all += nc;
+  }
+
+  cut_holder.all_end(sbjgraph, limit);
+
+  mEnumCutList.clear();
+  mCollectorList.clear();
+  mCnodeListArray.clear();
+
+  return nc_all;
+}
+
+// @brief 各スレッドで実行される関数
+void
+EnumCutMt::worker(
+  SizeType tid
+)
+{
+  auto ec = mEnumCutList[tid].get();
+  SizeType nc = 0;
+  for ( auto& node_list: mLevelList ) {
+    SizeType n = node_list.size();
+    for ( ; ; ) {
+      SizeType i = mNextPos.fetch_add(1);
+      if ( i >= n ) {
+	break;
+      }
+      auto node = node_list[i];
+      nc += ec->enum_logic(node, mPosArray[node->id()]);
+    }
+    // 次のレベルのノードはこのレベルのフットプリントを参照するので
+    // すべてのスレッドの処理が終わるのを待つ．
+    sync();
+  }
+  mNcArray[tid] = nc;
+}
+
+// @brief すべてのスレッドがここに到達するまで待つ．
+void
+EnumCutMt::sync()
+{
+  std::unique_lock<std::mutex> lck{mMutex};
+  SizeType gen = mSyncGen;
+  ++ mSyncCount;
+  if ( mSyncCount == mThreadNum ) {
+    mSyncCount = 0;
+    mNextPos = 0;
+    ++ mSyncGen;
+    mCond.notify_all();
+  }
+  else {
+    mCond.wait(lck, [&]{ return mSyncGen != gen; });
+  }
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス EnumCutMt::Collector
+//////////////////////////////////////////////////////////////////////
+
+// @brief cut が一つ見つかったときに呼ばれる関数(non-trivial cut)
+void
+EnumCutMt::Collector::found(
+  const SbjNode* root,
+  SizeType ni,
+  const SbjNode* inputs[],
+  const std::uint64_t* tv_words
+)
+{
+  // root を処理するスレッドはただ一つなのでロックは不要
+  auto cut = mMgr.new_cut(root, ni, inputs, tv_words);
+  mCutListArray[root->id()].push_back(cut);
+}
+
+END_NAMESPACE_LUTMAP
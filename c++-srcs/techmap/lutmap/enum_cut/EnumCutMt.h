@@ -0,0 +1,168 @@
+#ifndef ENUMCUTMT_H
+#define ENUMCUTMT_H
+
+/// @file EnumCutMt.h
+/// @brief EnumCutMt のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "lutmap.h"
+#include "EnumCut.h"
+#include "CutHolder.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+//////////////////////////////////////////////////////////////////////
+/// @class EnumCutMt EnumCutMt.h "EnumCutMt.h"
+/// @brief 複数のスレッドを用いてカットの列挙を行うクラス
+///
+/// あるノードのカットはファンインのノードのカット(のフットプリント)
+/// のみに依存するので，同じレベルのノードは独立に処理できる．
+/// そこで論理ノードをレベルごとにまとめ，レベルの低い順に
+/// 各レベルのノードを複数のスレッドで分担して処理する．
+///
+/// 各スレッドは自分用の EnumCut(作業用のマーク)と CutMgr を持つ．
+/// 各ノードのカットの列挙順は逐次版と同一なので，
+/// 結果はスレッド数や実行順によらず EnumCut を用いた場合と同じになる．
+//////////////////////////////////////////////////////////////////////
+class EnumCutMt
+{
+public:
+
+  /// @brief コンストラクタ
+  EnumCutMt(
+    SizeType thread_num ///< [in] スレッド数(0 の時はハードウェアの並列度)
+  );
+
+  /// @brief デストラクタ
+  ~EnumCutMt() = default;
+
+  /// @brief 入力数が limit 以下のカットを列挙して cut_holder に格納する．
+  /// @return 全 cut 数を返す．
+  SizeType
+  operator()(
+    const SbjGraph& sbjgraph, ///< [in] 対象のサブジェクトグラフ
+    SizeType limit,           ///< [in] 入力数の制限
+    CutHolder& cut_holder     ///< [in] 結果を格納するオブジェクト
+  );
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるクラス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 見つかったカットを各スレッドの CutMgr で生成するクラス
+  class Collector :
+    public EnumCutOp
+  {
+  public:
+
+    /// @brief コンストラクタ
+    Collector(
+      CutMgr& mgr,             ///< [in] カットを生成するオブジェクト
+      CutList* cut_list_array  ///< [in] 各ノードのカットのリストの配列
+    ) : mMgr{mgr},
+	mCutListArray{cut_list_array}
+    {
+    }
+
+    /// @brief デストラクタ
+    ~Collector() = default;
+
+
+  private:
+
+    /// @brief cut が一つ見つかったときに呼ばれる関数(non-trivial cut)
+    void
+    found(
+      const SbjNode* root,          ///< [in] 根のノード
+      SizeType ni,                  ///< [in] 入力数
+      const SbjNode* inputs[],      ///< [in] 入力ノードの配列
+      const std::uint64_t* tv_words ///< [in] カットの真理値表のワードの配列
+    ) override;
+
+
+  private:
+
+    // カットを生成するオブジェクト
+    CutMgr& mMgr;
+
+    // 各ノードのカットのリストの配列
+    CutList* mCutListArray;
+
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 各スレッドで実行される関数
+  void
+  worker(
+    SizeType tid ///< [in] スレッド番号
+  );
+
+  /// @brief すべてのスレッドがここに到達するまで待つ．
+  ///
+  /// 最後に到達したスレッドが次のレベル用に mNextPos を 0 に戻す．
+  void
+  sync();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // スレッド数
+  SizeType mThreadNum;
+
+  // レベルごとの論理ノードのリスト
+  vector<vector<const SbjNode*>> mLevelList;
+
+  // ノード番号をキーにして逐次処理の場合の処理順を格納する配列
+  vector<SizeType> mPosArray;
+
+  // 各ノードのカットのフットプリントを格納する配列
+  vector<vector<const SbjNode*>> mCnodeListArray;
+
+  // スレッドごとの列挙用のオブジェクト
+  vector<std::unique_ptr<EnumCut>> mEnumCutList;
+
+  // スレッドごとのカットを生成するオブジェクト
+  vector<std::unique_ptr<Collector>> mCollectorList;
+
+  // スレッドごとの列挙したカット数
+  vector<SizeType> mNcArray;
+
+  // 現在のレベルで次に処理するノードの位置
+  std::atomic<SizeType> mNextPos{0};
+
+  // sync() 用の mutex
+  std::mutex mMutex;
+
+  // sync() 用の条件変数
+  std::condition_variable mCond;
+
+  // sync() に到達したスレッド数
+  SizeType mSyncCount{0};
+
+  // sync() の世代番号
+  SizeType mSyncGen{0};
+
+};
+
+END_NAMESPACE_LUTMAP
+
+#endif // ENUMCUTMT_H
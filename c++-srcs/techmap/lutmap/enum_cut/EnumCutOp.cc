@@ -8,6 +8,7 @@
 
 #include "EnumCutOp.h"
 #include "EnumCut.h"
+#include "PriorityCut.h"
 
 //#define DEBUG_ENUM_RECUR
 
@@ -39,6 +40,18 @@ EnumCutOp::enum_cut(
   return ec(sbjgraph, limit, this);
 }
 
+// @brief 優先カットの列挙を行う．
+SizeType
+EnumCutOp::enum_priority_cut(
+  const SbjGraph& sbjgraph,
+  SizeType limit,
+  SizeType cut_num
+)
+{
+  PriorityCut pc{cut_num};
+  return pc(sbjgraph, limit, this);
+}
+
 // @brief 処理の最初に呼ばれる関数
 void
 EnumCutOp::all_init(
@@ -70,7 +83,8 @@ void
 EnumCutOp::found(
   const SbjNode* root,
   SizeType ni,
-  const SbjNode* inputs[]
+  const SbjNode* inputs[],
+  const std::uint64_t* tv_words
 )
 {
 }
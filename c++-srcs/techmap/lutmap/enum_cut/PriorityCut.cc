@@ -0,0 +1,436 @@
+
+/// @file PriorityCut.cc
+/// @brief PriorityCut の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "PriorityCut.h"
+#include "Cut.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+BEGIN_NONAMESPACE
+
+// 真理値表の i 番目と j 番目の変数を入れ替える．
+//
+// i < j でなければならない．
+// 6未満の変数はワード内のビットシフトで，
+// 6以上の変数はワードの入れ替えで行う．
+void
+swap_var(
+  std::uint64_t* words,
+  SizeType nw,
+  SizeType i,
+  SizeType j
+)
+{
+  ASSERT_COND( i < j );
+
+  if ( j < 6 ) {
+    // x_i = 1, x_j = 0 のビットと x_i = 0, x_j = 1 のビットを入れ替える．
+    auto pi = Cut::var_word(i, 0);
+    auto pj = Cut::var_word(j, 0);
+    auto mask_a = pi & ~pj;
+    auto mask_b = ~pi & pj;
+    auto mask_c = ~(mask_a | mask_b);
+    SizeType shift = (1 << j) - (1 << i);
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      auto v = words[w];
+      words[w] = (v & mask_c) | ((v & mask_a) << shift) | ((v & mask_b) >> shift);
+    }
+  }
+  else if ( i < 6 ) {
+    // x_j = 0 のワードの x_i = 1 のビットと
+    // x_j = 1 のワードの x_i = 0 のビットを入れ替える．
+    auto pi = Cut::var_word(i, 0);
+    SizeType shift = 1 << i;
+    SizeType bit = 1 << (j - 6);
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      if ( (w & bit) == 0 ) {
+	auto v0 = words[w];
+	auto v1 = words[w | bit];
+	words[w] = (v0 & ~pi) | ((v1 & ~pi) << shift);
+	words[w | bit] = ((v0 & pi) >> shift) | (v1 & pi);
+      }
+    }
+  }
+  else {
+    // x_i = 1, x_j = 0 のワードと x_i = 0, x_j = 1 のワードを入れ替える．
+    SizeType bit_i = 1 << (i - 6);
+    SizeType bit_j = 1 << (j - 6);
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      if ( (w & bit_i) != 0 && (w & bit_j) == 0 ) {
+	std::swap(words[w], words[w ^ bit_i ^ bit_j]);
+      }
+    }
+  }
+}
+
+END_NONAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+// クラス PriorityCut
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+PriorityCut::PriorityCut(
+  SizeType cut_num
+) : mCutNum{cut_num}
+{
+  ASSERT_COND( mCutNum > 0 );
+}
+
+// @brief 入力数が limit 以下のカットを列挙する．
+SizeType
+PriorityCut::operator()(
+  const SbjGraph& sbjgraph,
+  SizeType limit,
+  EnumCutOp* op
+)
+{
+  mSbjGraph = &sbjgraph;
+  mLimit = limit;
+
+  SizeType n = sbjgraph.node_num();
+  mNumArray.clear();
+  mNumArray.resize(n, 0);
+  mInfoArray.clear();
+  mInfoArray.resize(n * mCutNum);
+  mLeafArray.clear();
+  mLeafArray.resize(n * mCutNum * mLimit);
+  mDepthArray.clear();
+  mDepthArray.resize(n, 0);
+  mFlowArray.clear();
+  mFlowArray.resize(n, 0.0);
+
+  // 候補数の最大値は (ファンイン0のカット数 + 1) x (ファンイン1のカット数 + 1)
+  SizeType max_cand = (mCutNum + 1) * (mCutNum + 1);
+  mCandInfoArray.clear();
+  mCandInfoArray.resize(max_cand);
+  mCandLeafArray.clear();
+  mCandLeafArray.resize(max_cand * mLimit);
+  mCandList.clear();
+  mCandList.reserve(max_cand);
+
+  mTvSize = Cut::tv_word_num(mLimit);
+  mTvArray.clear();
+  mTvArray.resize(n * mCutNum * mTvSize);
+  mTmpTv0.clear();
+  mTmpTv0.resize(mTvSize);
+  mTmpTv1.clear();
+  mTmpTv1.resize(mTvSize);
+
+  mInputs.clear();
+  mInputs.resize(mLimit);
+
+  op->all_init(sbjgraph, limit);
+
+  SizeType nc_all = 0;
+  SizeType cur_pos = 0;
+
+  // 外部入力は自分自身のみからなるカットを持つ．
+  for ( auto node: sbjgraph.input_list() ) {
+    op->node_init(node, cur_pos);
+    op->found(node);
+    ++ nc_all;
+    op->node_end(node, cur_pos, 1);
+    ++ cur_pos;
+  }
+
+  // 入力側から論理ノードのカットを求める．
+  for ( auto node: sbjgraph.logic_list() ) {
+    op->node_init(node, cur_pos);
+
+    // 自分自身のみからなるカット
+    op->found(node);
+
+    SizeType nc = enum_node(node);
+    auto id = node->id();
+    for ( SizeType i = 0; i < nc; ++ i ) {
+      auto& info = mInfoArray[id * mCutNum + i];
+      auto src = leaves(id, i);
+      for ( SizeType j = 0; j < info.mNi; ++ j ) {
+	mInputs[j] = sbjgraph.node(src[j]);
+      }
+      op->found(node, info.mNi, mInputs.data(), tv(id, i));
+    }
+    nc_all += nc + 1;
+
+    op->node_end(node, cur_pos, nc + 1);
+    ++ cur_pos;
+  }
+
+  op->all_end(sbjgraph, limit);
+
+  return nc_all;
+}
+
+// @brief 論理ノードのカットを求める．
+SizeType
+PriorityCut::enum_node(
+  const SbjNode* node
+)
+{
+  auto id0 = node->fanin(0)->id();
+  auto id1 = node->fanin(1)->id();
+  SizeType n0 = mNumArray[id0];
+  SizeType n1 = mNumArray[id1];
+
+  // ファンインのカットの組み合わせをマージして候補を作る．
+  // 番号が n0 (n1) のものはファンインノードそのものからなる自明なカット
+  mCandList.clear();
+  SizeType ncand = 0;
+  for ( SizeType i0 = 0; i0 <= n0; ++ i0 ) {
+    const SizeType* leaves0 = &id0;
+    SizeType ni0 = 1;
+    if ( i0 < n0 ) {
+      leaves0 = leaves(id0, i0);
+      ni0 = mInfoArray[id0 * mCutNum + i0].mNi;
+    }
+    for ( SizeType i1 = 0; i1 <= n1; ++ i1 ) {
+      const SizeType* leaves1 = &id1;
+      SizeType ni1 = 1;
+      if ( i1 < n1 ) {
+	leaves1 = leaves(id1, i1);
+	ni1 = mInfoArray[id1 * mCutNum + i1].mNi;
+      }
+      auto& info = mCandInfoArray[ncand];
+      auto dst = cand_leaves(ncand);
+      if ( !merge_leaves(leaves0, ni0, leaves1, ni1, dst, info.mNi) ) {
+	continue;
+      }
+      info.mSrc0 = i0;
+      info.mSrc1 = i1;
+      eval_cut(dst, info);
+      add_cand(ncand);
+      ++ ncand;
+    }
+  }
+
+  // 評価値の順に並べる．
+  std::stable_sort(mCandList.begin(), mCandList.end(),
+		   [&](SizeType pos1, SizeType pos2) {
+		     auto& info1 = mCandInfoArray[pos1];
+		     auto& info2 = mCandInfoArray[pos2];
+		     if ( info1.mDepth != info2.mDepth ) {
+		       return info1.mDepth < info2.mDepth;
+		     }
+		     if ( info1.mFlow != info2.mFlow ) {
+		       return info1.mFlow < info2.mFlow;
+		     }
+		     return info1.mNi < info2.mNi;
+		   });
+
+  // 上位 mCutNum 個を記録する．
+  auto id = node->id();
+  SizeType nc = std::min(mCandList.size(), mCutNum);
+  for ( SizeType i = 0; i < nc; ++ i ) {
+    auto pos = mCandList[i];
+    auto& info = mCandInfoArray[pos];
+    mInfoArray[id * mCutNum + i] = info;
+    auto src = cand_leaves(pos);
+    auto dst = leaves(id, i);
+    for ( SizeType j = 0; j < info.mNi; ++ j ) {
+      dst[j] = src[j];
+    }
+    // 真理値表は残ったカットについてのみ求める．
+    make_tv(node, info, dst, tv(id, i));
+  }
+  mNumArray[id] = nc;
+
+  // 最良カットの値をこのノードの値とする．
+  ASSERT_COND( nc > 0 );
+  mDepthArray[id] = mInfoArray[id * mCutNum].mDepth;
+  mFlowArray[id] = mInfoArray[id * mCutNum].mFlow;
+
+  return nc;
+}
+
+// @brief 2つの葉の集合をマージする．
+bool
+PriorityCut::merge_leaves(
+  const SizeType* leaves1,
+  SizeType ni1,
+  const SizeType* leaves2,
+  SizeType ni2,
+  SizeType* dst,
+  SizeType& ni
+) const
+{
+  // どちらも昇順に並んでいるのでマージソートの要領で処理する．
+  SizeType i1 = 0;
+  SizeType i2 = 0;
+  ni = 0;
+  while ( i1 < ni1 || i2 < ni2 ) {
+    SizeType id;
+    if ( i2 == ni2 || (i1 < ni1 && leaves1[i1] < leaves2[i2]) ) {
+      id = leaves1[i1];
+      ++ i1;
+    }
+    else if ( i1 == ni1 || leaves2[i2] < leaves1[i1] ) {
+      id = leaves2[i2];
+      ++ i2;
+    }
+    else {
+      id = leaves1[i1];
+      ++ i1;
+      ++ i2;
+    }
+    if ( ni == mLimit ) {
+      return false;
+    }
+    dst[ni] = id;
+    ++ ni;
+  }
+  return true;
+}
+
+// @brief ファンインのカットの真理値表から真理値表を合成する．
+void
+PriorityCut::make_tv(
+  const SbjNode* node,
+  const CutInfo& info,
+  const SizeType* dst_leaves,
+  std::uint64_t* dst
+)
+{
+  SizeType ni = info.mNi;
+  SizeType nw = Cut::tv_word_num(ni);
+  fanin_tv(node->fanin(0), info.mSrc0, dst_leaves, ni, mTmpTv0.data());
+  fanin_tv(node->fanin(1), info.mSrc1, dst_leaves, ni, mTmpTv1.data());
+  std::uint64_t inv0 = node->fanin_inv(0) ? ~0ULL : 0ULL;
+  std::uint64_t inv1 = node->fanin_inv(1) ? ~0ULL : 0ULL;
+  if ( node->is_xor() ) {
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      dst[w] = (mTmpTv0[w] ^ inv0) ^ (mTmpTv1[w] ^ inv1);
+    }
+  }
+  else {
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      dst[w] = (mTmpTv0[w] ^ inv0) & (mTmpTv1[w] ^ inv1);
+    }
+  }
+  dst[0] &= Cut::tv_mask(ni);
+}
+
+// @brief ファンインのカットの真理値表を dst_leaves 上の関数に拡張する．
+//
+// ファンインのカットの葉は dst_leaves の部分集合で，どちらも昇順に
+// 並んでいるので，上位の変数から順に本来の位置に移動すればよい．
+// 移動先の変数はそれまで関数が依存していない変数なので
+// 入れ替えで移動できる．
+void
+PriorityCut::fanin_tv(
+  const SbjNode* inode,
+  SizeType pos,
+  const SizeType* dst_leaves,
+  SizeType dst_ni,
+  std::uint64_t* dst
+)
+{
+  auto id = inode->id();
+  const SizeType* src_leaves = &id;
+  SizeType src_ni = 1;
+  // ファンインそのものからなる自明なカットの真理値表
+  std::uint64_t trivial_tv = Cut::var_word(0, 0) & Cut::tv_mask(1);
+  const std::uint64_t* src = &trivial_tv;
+  if ( pos < mNumArray[id] ) {
+    src_leaves = leaves(id, pos);
+    src_ni = mInfoArray[id * mCutNum + pos].mNi;
+    src = tv(id, pos);
+  }
+
+  // 元の関数を拡張後の大きさに複製する．
+  SizeType src_nw = Cut::tv_word_num(src_ni);
+  SizeType dst_nw = Cut::tv_word_num(dst_ni);
+  if ( src_ni < 6 ) {
+    auto w = src[0] & Cut::tv_mask(src_ni);
+    for ( SizeType i = src_ni; i < 6; ++ i ) {
+      w |= (w << (1 << i));
+    }
+    for ( SizeType j = 0; j < dst_nw; ++ j ) {
+      dst[j] = w;
+    }
+  }
+  else {
+    for ( SizeType j = 0; j < dst_nw; ++ j ) {
+      dst[j] = src[j % src_nw];
+    }
+  }
+
+  // 上位の変数から本来の位置に移動する．
+  SizeType j = dst_ni;
+  for ( SizeType i = src_ni; i -- > 0; ) {
+    do {
+      ASSERT_COND( j > 0 );
+      -- j;
+    } while ( dst_leaves[j] != src_leaves[i] );
+    if ( j != i ) {
+      swap_var(dst, dst_nw, i, j);
+    }
+  }
+}
+
+// @brief 候補のカットを追加する．
+void
+PriorityCut::add_cand(
+  SizeType pos
+)
+{
+  auto& info = mCandInfoArray[pos];
+  auto l = cand_leaves(pos);
+
+  // 既存の候補の部分集合になっていないか調べる．
+  for ( auto pos1: mCandList ) {
+    auto& info1 = mCandInfoArray[pos1];
+    if ( info1.mNi > info.mNi ) {
+      continue;
+    }
+    auto l1 = cand_leaves(pos1);
+    if ( std::includes(l, l + info.mNi, l1, l1 + info1.mNi) ) {
+      // pos1 の方が良い(か同じ)
+      return;
+    }
+  }
+
+  // pos に支配される候補を削除する．
+  SizeType wpos = 0;
+  for ( auto pos1: mCandList ) {
+    auto& info1 = mCandInfoArray[pos1];
+    auto l1 = cand_leaves(pos1);
+    if ( info1.mNi > info.mNi &&
+	 std::includes(l1, l1 + info1.mNi, l, l + info.mNi) ) {
+      continue;
+    }
+    mCandList[wpos] = pos1;
+    ++ wpos;
+  }
+  mCandList.resize(wpos);
+
+  mCandList.push_back(pos);
+}
+
+// @brief カットの評価値を求める．
+void
+PriorityCut::eval_cut(
+  const SizeType* leaves,
+  CutInfo& info
+) const
+{
+  SizeType depth = 0;
+  double flow = 1.0;
+  for ( SizeType i = 0; i < info.mNi; ++ i ) {
+    auto id = leaves[i];
+    depth = std::max(depth, mDepthArray[id]);
+    auto node = mSbjGraph->node(id);
+    SizeType nfo = std::max(node->fanout_num(), static_cast<SizeType>(1));
+    flow += mFlowArray[id] / nfo;
+  }
+  info.mDepth = depth + 1;
+  info.mFlow = flow;
+}
+
+END_NAMESPACE_LUTMAP
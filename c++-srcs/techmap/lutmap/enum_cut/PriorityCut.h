@@ -0,0 +1,230 @@
+#ifndef PRIORITYCUT_H
+#define PRIORITYCUT_H
+
+/// @file PriorityCut.h
+/// @brief PriorityCut のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "lutmap.h"
+#include "EnumCutOp.h"
+#include "SbjNode.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+//////////////////////////////////////////////////////////////////////
+/// @class PriorityCut PriorityCut.h "PriorityCut.h"
+/// @brief 優先カット(priority cut)の列挙を行うクラス
+///
+/// EnumCut がすべての k-feasible カットを列挙するのに対して，
+/// こちらは各ノードごとに評価値の良い上位 cut_num 個のカットのみを保持する．
+/// 各ノードのカットはファンインのカット集合をマージすることで
+/// 入力側から順に求める．
+/// 評価値は以下の順で比較する．
+/// - 段数(LUT 段数の最小値)
+/// - area flow
+/// - 入力数
+///
+/// そのため必要なメモリ量は O(cut_num・N) となる．
+///
+/// カットの真理値表もマージの際にファンインのカットの真理値表から
+/// 合成して求める．
+//////////////////////////////////////////////////////////////////////
+class PriorityCut
+{
+public:
+
+  /// @brief コンストラクタ
+  PriorityCut(
+    SizeType cut_num ///< [in] 各ノードで保持するカット数の上限
+  );
+
+  /// @brief デストラクタ
+  ~PriorityCut() = default;
+
+  /// @brief 入力数が limit 以下のカットを列挙する．
+  /// @return 全 cut 数を返す．
+  SizeType
+  operator()(
+    const SbjGraph& sbjgraph, ///< [in] 対象のサブジェクトグラフ
+    SizeType limit,           ///< [in] 入力数の制限
+    EnumCutOp* op             ///< [in] カットが列挙される時に呼ばれるクラス
+  );
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // カットの情報
+  // 葉のノード番号は別の配列に昇順で格納する．
+  struct CutInfo
+  {
+    // 入力数
+    SizeType mNi;
+
+    // 段数
+    SizeType mDepth;
+
+    // area flow
+    double mFlow;
+
+    // 元になったファンイン0のカット番号
+    // ファンイン0 のカット数に等しい時はファンインそのもの
+    SizeType mSrc0;
+
+    // 元になったファンイン1のカット番号
+    // ファンイン1 のカット数に等しい時はファンインそのもの
+    SizeType mSrc1;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 論理ノードのカットを求める．
+  /// @return 求まったカット数を返す．
+  SizeType
+  enum_node(
+    const SbjNode* node ///< [in] 対象のノード
+  );
+
+  /// @brief 2つの葉の集合をマージする．
+  /// @return 入力数が mLimit 以下の時 true を返す．
+  bool
+  merge_leaves(
+    const SizeType* leaves1, ///< [in] 1つめの葉の配列
+    SizeType ni1,            ///< [in] leaves1 の要素数
+    const SizeType* leaves2, ///< [in] 2つめの葉の配列
+    SizeType ni2,            ///< [in] leaves2 の要素数
+    SizeType* dst,           ///< [out] 結果を格納する配列
+    SizeType& ni             ///< [out] 結果の要素数
+  ) const;
+
+  /// @brief ファンインのカットの真理値表から真理値表を合成する．
+  void
+  make_tv(
+    const SbjNode* node,        ///< [in] 対象のノード
+    const CutInfo& info,        ///< [in] カットの情報
+    const SizeType* dst_leaves, ///< [in] カットの葉の配列
+    std::uint64_t* dst          ///< [out] 結果を格納する配列
+  );
+
+  /// @brief ファンインのカットの真理値表を dst_leaves 上の関数に拡張する．
+  void
+  fanin_tv(
+    const SbjNode* inode,       ///< [in] ファンインのノード
+    SizeType pos,               ///< [in] inode のカット番号
+    const SizeType* dst_leaves, ///< [in] 拡張後の葉の配列
+    SizeType dst_ni,            ///< [in] 拡張後の入力数
+    std::uint64_t* dst          ///< [out] 結果を格納する配列
+  );
+
+  /// @brief 候補のカットを追加する．
+  ///
+  /// 既存の候補に支配される場合には追加しない．
+  /// 逆に既存の候補を支配する場合にはそれらを削除する．
+  void
+  add_cand(
+    SizeType pos ///< [in] 追加するカットの候補番号
+  );
+
+  /// @brief カットの評価値を求める．
+  void
+  eval_cut(
+    const SizeType* leaves, ///< [in] 葉の配列
+    CutInfo& info           ///< [inout] 結果を格納するオブジェクト
+  ) const;
+
+  /// @brief ノードの pos 番目のカットの葉の配列を返す．
+  SizeType*
+  leaves(
+    SizeType id, ///< [in] ノード番号
+    SizeType pos ///< [in] カット番号
+  )
+  {
+    return &mLeafArray[(id * mCutNum + pos) * mLimit];
+  }
+
+  /// @brief ノードの pos 番目のカットの真理値表を返す．
+  std::uint64_t*
+  tv(
+    SizeType id, ///< [in] ノード番号
+    SizeType pos ///< [in] カット番号
+  )
+  {
+    return &mTvArray[(id * mCutNum + pos) * mTvSize];
+  }
+
+  /// @brief 候補の pos 番目のカットの葉の配列を返す．
+  SizeType*
+  cand_leaves(
+    SizeType pos ///< [in] 候補番号
+  )
+  {
+    return &mCandLeafArray[pos * mLimit];
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 各ノードで保持するカット数の上限
+  SizeType mCutNum;
+
+  // 入力数の最大値
+  SizeType mLimit;
+
+  // 対象のサブジェクトグラフ
+  const SbjGraph* mSbjGraph;
+
+  // ノード番号をキーにしてカット数を格納する配列
+  vector<SizeType> mNumArray;
+
+  // ノード番号 x mCutNum + カット番号をキーにしてカットの情報を格納する配列
+  vector<CutInfo> mInfoArray;
+
+  // カットの葉のノード番号を格納する配列
+  vector<SizeType> mLeafArray;
+
+  // 真理値表1つあたりのワード数
+  SizeType mTvSize;
+
+  // カットの真理値表を格納する配列
+  vector<std::uint64_t> mTvArray;
+
+  // make_tv() で用いるファンインの真理値表を格納する配列
+  vector<std::uint64_t> mTmpTv0;
+  vector<std::uint64_t> mTmpTv1;
+
+  // ノード番号をキーにして最良カットの段数を格納する配列
+  vector<SizeType> mDepthArray;
+
+  // ノード番号をキーにして最良カットの area flow を格納する配列
+  vector<double> mFlowArray;
+
+  // 候補カットの情報を格納する配列
+  vector<CutInfo> mCandInfoArray;
+
+  // 候補カットの葉を格納する配列
+  vector<SizeType> mCandLeafArray;
+
+  // 有効な候補番号のリスト
+  vector<SizeType> mCandList;
+
+  // found() に渡す入力ノードの配列
+  vector<const SbjNode*> mInputs;
+
+};
+
+END_NAMESPACE_LUTMAP
+
+#endif // PRIORITYCUT_H
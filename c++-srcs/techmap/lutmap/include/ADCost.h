@@ -281,6 +281,9 @@ private:
 //////////////////////////////////////////////////////////////////////
 /// @class ADCostList ADCost.h "ADCost.h"
 /// @brief ADCost のリストを表すクラス
+///
+/// 要素は深さの降順(面積の昇順)に並んでいる．
+/// 先頭が深さ最大(面積最小)，末尾が深さ最小(面積最大)の要素となる．
 //////////////////////////////////////////////////////////////////////
 template <typename AreaT>
 class ADCostList
@@ -321,6 +324,32 @@ public:
     return ADCostIterator<AreaT>(nullptr);
   }
 
+  /// @brief 要素数を返す．
+  SizeType
+  size() const
+  {
+    SizeType n = 0;
+    for ( auto cur = mTop.mLink; cur; cur = cur->mLink ) {
+      ++ n;
+    }
+    return n;
+  }
+
+  /// @brief 全ての要素を削除する．
+  ///
+  /// 削除した要素は ADCostMgr で再利用される．
+  void
+  clear()
+  {
+    for ( auto cur = mTop.mLink; cur; ) {
+      auto next = cur->mLink;
+      cur->mLink = nullptr;
+      mMgr->delete_cost(cur);
+      cur = next;
+    }
+    mTop.mLink = nullptr;
+  }
+
   /// @brief 要素を追加する．
   ///
   /// 適当な位置に挿入される．
@@ -386,6 +415,93 @@ public:
     }
   }
 
+  /// @brief 要素を間引く．
+  ///
+  /// 末尾(深さ最小)の要素は常に残す．
+  /// - epsilon > 0.0 の時，一つ浅い(残した)要素の面積が
+  ///   (1 + epsilon) 倍以内に収まる要素を削除する．
+  /// - max_num > 0 の時，要素数が max_num 以下になるように
+  ///   先頭と末尾を含めてほぼ等間隔に残す．
+  ///   max_num が 1 の時は末尾のみを残す．
+  void
+  prune(
+    SizeType max_num, ///< [in] 要素数の上限(0 の時は制限なし)
+    double epsilon    ///< [in] 面積の許容誤差の比率
+  )
+  {
+    if ( mTop.mLink == nullptr ) {
+      return;
+    }
+
+    // 深さの小さい順にたどれるように一旦逆順にする．
+    reverse();
+
+    if ( epsilon > 0.0 ) {
+      auto kept = mTop.mLink;
+      ADCost<AreaT>* cur;
+      while ( (cur = kept->mLink) ) {
+	// cur は kept よりも深く，面積が小さい．
+	if ( kept->mArea <= cur->mArea * (1.0 + epsilon) ) {
+	  // cur は kept でほぼ支配されている．
+	  kept->mLink = cur->mLink;
+	  cur->mLink = nullptr;
+	  mMgr->delete_cost(cur);
+	}
+	else {
+	  kept = cur;
+	}
+      }
+    }
+
+    if ( max_num > 0 ) {
+      SizeType n = size();
+      if ( n > max_num ) {
+	ADCost<AreaT>* prev = &mTop;
+	ADCost<AreaT>* cur;
+	SizeType pos = 0;
+	SizeType k = 0;
+	while ( (cur = prev->mLink) ) {
+	  // k 番目に残す要素の位置
+	  SizeType target = max_num > 1 ? (k * (n - 1)) / (max_num - 1) : 0;
+	  if ( k < max_num && pos == target ) {
+	    ++ k;
+	    prev = cur;
+	  }
+	  else {
+	    prev->mLink = cur->mLink;
+	    cur->mLink = nullptr;
+	    mMgr->delete_cost(cur);
+	  }
+	  ++ pos;
+	}
+      }
+    }
+
+    // 元の順番に戻す．
+    reverse();
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief リストの順番を逆にする．
+  void
+  reverse()
+  {
+    ADCost<AreaT>* prev = nullptr;
+    auto cur = mTop.mLink;
+    while ( cur ) {
+      auto next = cur->mLink;
+      cur->mLink = prev;
+      prev = cur;
+      cur = next;
+    }
+    mTop.mLink = prev;
+  }
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -396,7 +512,7 @@ private:
   ADCost<AreaT> mTop;
 
   // メモリ管理オブジェクト
-  ADCostMgr<AreaT>* mMgr;
+  ADCostMgr<AreaT>* mMgr{nullptr};
 
 };
 
@@ -18,6 +18,21 @@ class Cut;
 //////////////////////////////////////////////////////////////////////
 /// @class AreaCover AreaCover.h "AreaCover.h"
 /// @brief 面積モードの DAG covering のヒューリスティック
+///
+/// set_recovery() で面積回復の繰り返し回数を指定すると
+/// record_cuts(sbjgraph, cut_holder, maprec) で最初の解を求めたあとで
+/// 以下の処理を行う．
+/// - 直前の解の参照回数から見積もったファンアウト数を用いた area flow
+///   による回復
+/// - MFFC の参照/参照解除による正確な面積(exact area)による回復
+///
+/// slack に非負の値を指定した場合には最小段数 + slack を超えないように
+/// カットを選ぶ．この場合の最初の解は段数最小のものとなる．
+///
+/// init_incr() で初期化したあとは flip_boundary() で境界ノードを
+/// 1つずつ変更しながら解を差分更新することができる．
+/// この場合，コストを計算し直すのは境界ノードをカットの入力とするノード
+/// から始めて，コストの変わったノードの推移的ファンアウトのみとなる．
 //////////////////////////////////////////////////////////////////////
 class AreaCover :
   public DagCover
@@ -41,7 +56,23 @@ public:
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 面積回復の設定を行う．
+  void
+  set_recovery(
+    SizeType flow_iter,  ///< [in] area flow による回復の繰り返し回数
+    SizeType exact_iter, ///< [in] exact area による回復の繰り返し回数
+    int slack = -1       ///< [in] 最小段数に対するスラック
+                         ///<      負の値の時は段数の制約を考えない．
+  )
+  {
+    mFlowIter = flow_iter;
+    mExactIter = exact_iter;
+    mSlack = slack;
+  }
+
   /// @brief best cut の記録を行う．
+  ///
+  /// set_recovery() で指定された面積回復も行う．
   void
   record_cuts(
     const SbjGraph& sbjgraph,    ///< [in] サブジェクトグラフ
@@ -69,11 +100,78 @@ public:
   );
 
 
+  /// @brief 差分更新用の初期化を行う．
+  ///
+  /// record_cuts(sbjgraph, cut_holder, boundary_list, maprec) と同じ解を求める．
+  /// sbjgraph, cut_holder, maprec は以降の flip_boundary() と undo() でも
+  /// 用いられるので，それまで内容を保持している必要がある．
+  void
+  init_incr(
+    const SbjGraph& sbjgraph,                    ///< [in] サブジェクトグラフ
+    const CutHolder& cut_holder,                 ///< [in] 各ノードのカットを保持するオブジェクト
+    const vector<const SbjNode*>& boundary_list, ///< [in] 境界ノードのリスト
+    MapRecord& maprec                            ///< [out] マッピング結果を記録するオブジェクト
+  );
+
+  /// @brief 境界ノードかどうかを反転させて解を差分更新する．
+  ///
+  /// 結果は init_incr() で指定した maprec に反映される．
+  void
+  flip_boundary(
+    const SbjNode* node ///< [in] 対象のノード
+  );
+
+  /// @brief 直前の flip_boundary() を取り消す．
+  void
+  undo();
+
+  /// @brief 直前の flip_boundary() でカットの変わったノードのリストを返す．
+  const vector<const SbjNode*>&
+  changed_node_list() const
+  {
+    return mChangedNodeList;
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 差分更新で変更した内容を元に戻すための情報
+  struct Change
+  {
+    // 対象のノード
+    const SbjNode* mNode;
+
+    // 変更前のコスト
+    double mCost;
+
+    // 変更前のカット
+    const Cut* mCut;
+  };
+
+
 private:
   //////////////////////////////////////////////////////////////////////
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 論理ノードの最良カットを求める．
+  void
+  eval_node(
+    const SbjNode* node,         ///< [in] 対象のノード
+    const CutHolder& cut_holder, ///< [in] 各ノードのカットを保持するオブジェクト
+    double& min_cost,            ///< [out] 最良カットのコスト
+    const Cut*& best_cut         ///< [out] 最良カット
+  );
+
+  /// @brief node をカットの入力とするノードをキューに積む．
+  void
+  put_leaf_fanouts(
+    const SbjNode* node ///< [in] 対象のノード
+  );
+
   // node から各入力にいたる経路の重みを計算する．
   void
   calc_weight(
@@ -82,6 +180,72 @@ private:
     double cur_weight    ///< [in] 現在の重み
   );
 
+  /// @brief 段数最小の解を求める．
+  ///
+  /// 段数が同じ場合には area flow の小さいカットを選ぶ．
+  void
+  record_depth(
+    const SbjGraph& sbjgraph,    ///< [in] サブジェクトグラフ
+    const CutHolder& cut_holder, ///< [in] 各ノードのカットを保持するオブジェクト
+    MapRecord& maprec            ///< [out] マッピング結果を記録するオブジェクト
+  );
+
+  /// @brief area flow による面積回復を行う．
+  void
+  flow_recovery(
+    const SbjGraph& sbjgraph,    ///< [in] サブジェクトグラフ
+    const CutHolder& cut_holder, ///< [in] 各ノードのカットを保持するオブジェクト
+    MapRecord& maprec            ///< [inout] マッピング結果を記録するオブジェクト
+  );
+
+  /// @brief exact area による面積回復を行う．
+  void
+  exact_recovery(
+    const SbjGraph& sbjgraph,    ///< [in] サブジェクトグラフ
+    const CutHolder& cut_holder, ///< [in] 各ノードのカットを保持するオブジェクト
+    MapRecord& maprec            ///< [inout] マッピング結果を記録するオブジェクト
+  );
+
+  /// @brief 現在の解の各ノードの参照回数を求める．
+  void
+  calc_refs(
+    const SbjGraph& sbjgraph,  ///< [in] サブジェクトグラフ
+    const MapRecord& maprec    ///< [in] マッピング結果
+  );
+
+  /// @brief 現在の解から各ノードの要求段数を求める．
+  void
+  calc_req(
+    const SbjGraph& sbjgraph,  ///< [in] サブジェクトグラフ
+    const MapRecord& maprec    ///< [in] マッピング結果
+  );
+
+  /// @brief カットの到着段数を求める．
+  SizeType
+  cut_arrival(
+    const Cut* cut ///< [in] 対象のカット
+  ) const;
+
+  /// @brief カットを参照する．
+  /// @return 新たに参照されるようになった LUT 数を返す．
+  ///
+  /// 再帰を用いずに mCutStack 上で処理する．
+  SizeType
+  cut_ref(
+    const Cut* cut,         ///< [in] 対象のカット
+    const MapRecord& maprec ///< [in] マッピング結果
+  );
+
+  /// @brief カットの参照を解除する．
+  /// @return 参照されなくなった LUT 数を返す．
+  ///
+  /// 再帰を用いずに mCutStack 上で処理する．
+  SizeType
+  cut_deref(
+    const Cut* cut,         ///< [in] 対象のカット
+    const MapRecord& maprec ///< [in] マッピング結果
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -97,6 +261,65 @@ private:
   // 各入力から根の出力に抜ける経路上の重みを入れる配列
   vector<double> mWeight;
 
+  // area flow による回復の繰り返し回数
+  SizeType mFlowIter{0};
+
+  // exact area による回復の繰り返し回数
+  SizeType mExactIter{0};
+
+  // 最小段数に対するスラック
+  int mSlack{-1};
+
+  // 段数の上限
+  SizeType mReqDepth{0};
+
+  // 各ノードの到着段数
+  vector<SizeType> mArrival;
+
+  // 各ノードの要求段数
+  vector<SizeType> mReqTime;
+
+  // 各ノードのファンアウト数の見積もり値
+  vector<double> mEstRefs;
+
+  // 現在の解における各ノードの参照回数
+  vector<SizeType> mRefCount;
+
+  // cut_ref()/cut_deref() で用いる未処理のカットのスタック
+  vector<const Cut*> mCutStack;
+
+  // 以下は差分更新用のデータ
+
+  // 対象のサブジェクトグラフ
+  const SbjGraph* mIncrGraph{nullptr};
+
+  // カットを保持するオブジェクト
+  const CutHolder* mIncrCutHolder{nullptr};
+
+  // マッピング結果
+  MapRecord* mIncrRecord{nullptr};
+
+  // ノード番号をキーにしてそのノードをカットの入力とするノードのリストを格納する配列
+  vector<vector<const SbjNode*>> mLeafFanoutArray;
+
+  // ノード番号をキーにして logic_list() 中の位置を格納する配列
+  vector<SizeType> mLogicPosArray;
+
+  // 処理待ちのノードの logic_list() 中の位置のヒープ
+  vector<SizeType> mQueue;
+
+  // ノード番号をキーにしてキューに入っている時 true となる配列
+  vector<bool> mInQueue;
+
+  // 直前の flip_boundary() で反転させたノード
+  const SbjNode* mFlipNode{nullptr};
+
+  // 直前の flip_boundary() での変更内容のリスト
+  vector<Change> mChangeList;
+
+  // 直前の flip_boundary() でカットの変わったノードのリスト
+  vector<const SbjNode*> mChangedNodeList;
+
 };
 
 END_NAMESPACE_LUTMAP
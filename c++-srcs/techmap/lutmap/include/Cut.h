@@ -31,6 +31,15 @@ BEGIN_NAMESPACE_LUTMAP
 ///
 /// また，Cut のリストを内部のリンクポインタで実装しているので
 /// CutList および CutListIterator を friend class にしている．
+///
+/// カットの表す論理関数の真理値表は葉のノードの配列の直後に
+/// 64ビットのワードの配列として格納する．
+/// 真理値表はカットの列挙時に求められ，生成時に書き込まれるので
+/// 生成後は変更されない．
+/// 6入力以下の場合は1ワード，それ以上の場合は 2^(ni - 6) ワードとなる．
+/// 真理値表の p 番目のビットは i 番目の入力の値が p の i ビット目
+/// となる入力パタンに対する出力値を表す．
+/// 6入力未満の場合の未使用のビットは 0 となる．
 //////////////////////////////////////////////////////////////////////
 class Cut
 {
@@ -42,9 +51,10 @@ private:
 
   /// @brief コンストラクタ
   Cut(
-    const SbjNode* root,    ///< [in] カットの根のノード
-    SizeType ni,            ///< [in] カットの入力数
-    const SbjNode* inputs[] ///< [in] カットの入力のノードの配列
+    const SbjNode* root,          ///< [in] カットの根のノード
+    SizeType ni,                  ///< [in] カットの入力数
+    const SbjNode* inputs[],      ///< [in] カットの入力のノードの配列
+    const std::uint64_t* tv_words ///< [in] 真理値表のワードの配列
   ) : mRoot{root},
       mLink{nullptr},
       mNi{ni}
@@ -52,6 +62,11 @@ private:
     for ( SizeType i = 0; i < ni; ++ i ) {
       mInputs[i] = inputs[i];
     }
+    auto dst = reinterpret_cast<std::uint64_t*>(&mInputs[ni]);
+    SizeType nw = tv_word_num(ni);
+    for ( SizeType w = 0; w < nw; ++ w ) {
+      dst[w] = tv_words[w];
+    }
   }
 
   /// @brief デストラクタ
@@ -87,11 +102,77 @@ public:
     return mInputs[pos];
   }
 
+  /// @brief 真理値表のワード数を返す．
+  static
+  SizeType
+  tv_word_num(
+    SizeType ni ///< [in] 入力数
+  )
+  {
+    return ni <= 6 ? 1 : (1ULL << (ni - 6));
+  }
+
+  /// @brief 変数の真理値表の1ワードを返す．
+  ///
+  /// var 番目の変数そのものを表す関数の真理値表の
+  /// w 番目のワードとなる．
+  static
+  std::uint64_t
+  var_word(
+    SizeType var, ///< [in] 変数番号
+    SizeType w    ///< [in] ワード番号
+  )
+  {
+    static const std::uint64_t kVarPat[] = {
+      0xAAAAAAAAAAAAAAAAULL,
+      0xCCCCCCCCCCCCCCCCULL,
+      0xF0F0F0F0F0F0F0F0ULL,
+      0xFF00FF00FF00FF00ULL,
+      0xFFFF0000FFFF0000ULL,
+      0xFFFFFFFF00000000ULL
+    };
+    if ( var < 6 ) {
+      return kVarPat[var];
+    }
+    return ((w >> (var - 6)) & 1) ? ~0ULL : 0ULL;
+  }
+
+  /// @brief 6入力未満の真理値表の有効なビットのマスクを返す．
+  static
+  std::uint64_t
+  tv_mask(
+    SizeType ni ///< [in] 入力数
+  )
+  {
+    return ni < 6 ? (1ULL << (1 << ni)) - 1ULL : ~0ULL;
+  }
+
+  /// @brief 入力数 ni のカットに必要なメモリサイズを返す．
+  static
+  SizeType
+  alloc_size(
+    SizeType ni ///< [in] 入力数
+  )
+  {
+    return sizeof(Cut) + (ni - 1) * sizeof(const SbjNode*)
+      + tv_word_num(ni) * sizeof(std::uint64_t);
+  }
+
+  /// @brief 真理値表のワードの配列を返す．
+  ///
+  /// サイズは tv_word_num(input_num()) となる．
+  const std::uint64_t*
+  tv_words() const
+  {
+    return reinterpret_cast<const std::uint64_t*>(&mInputs[mNi]);
+  }
+
   /// @brief 論理シミュレーションを行う．
   /// @return 値のノードの値を返す．
   ///
   /// vals[i] が input(i) の葉の値に対応する．
   /// 値は64ビットのビットベクタで表す．
+  /// 値は真理値表を引いて求める．
   std::uint64_t
   eval(
     const vector<std::uint64_t>& vals ///< [in] 葉のノードの値
@@ -110,6 +191,17 @@ public:
     const vector<bool>& iinv ///< [in] 入力の反転極性の配列
   ) const;
 
+  /// @brief 極性を変換した真理値表のワードの配列を得る．
+  ///
+  /// ワードの並びは tv_words() と同じで，
+  /// 6入力未満の場合の未使用のビットは 0 となる．
+  void
+  make_tv_words(
+    bool oinv,                   ///< [in] 出力を反転する時 true にするフラグ
+    const vector<bool>& iinv,    ///< [in] 入力の反転極性の配列
+    vector<std::uint64_t>& words ///< [out] 真理値表のワードの配列
+  ) const;
+
   /// @brief デバッグ用の表示ルーティン
   ///
   /// 根のノード番号と葉のノード番号を1行で表示する．
@@ -134,6 +226,7 @@ private:
   SizeType mNi;
 
   // 入力のノード配列
+  // 実際にはこの後ろに真理値表のワードが続く．
   const SbjNode* mInputs[1];
 
 };
@@ -13,6 +13,7 @@
 #include "CutList.h"
 #include "CutMgr.h"
 #include "SbjNode.h"
+#include <memory>
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -24,6 +25,8 @@ BEGIN_NAMESPACE_LUTMAP
 class CutHolder :
   public EnumCutOp
 {
+  friend class EnumCutMt;
+
 public:
 
   /// @brief コンストラクタ
@@ -52,10 +55,40 @@ public:
     return mLimit;
   }
 
+  /// @brief 保持しているカット数を返す．
+  SizeType
+  cut_num() const;
+
+  /// @brief これまでに同時に保持したカット数の最大値を返す．
+  ///
+  /// clear() ではリセットされない．
+  SizeType
+  peak_cut_num() const
+  {
+    return mPeakCutNum;
+  }
+
+  /// @brief カット用に確保しているメモリ量(バイト)を返す．
+  ///
+  /// enum_cut_mt() の場合は全スレッドの合計となる．
+  SizeType
+  bytes_used() const;
+
   /// @brief 保持しているカットのリストを削除する．
   void
   clear();
 
+  /// @brief 複数のスレッドを用いてカットの列挙を行う．
+  /// @return 全 cut 数を返す．
+  ///
+  /// 結果は enum_cut() と同一になる．
+  SizeType
+  enum_cut_mt(
+    const SbjGraph& sbjgraph, ///< [in] 対象のサブジェクトグラフ
+    SizeType limit,           ///< [in] 入力数の制限
+    SizeType thread_num = 0   ///< [in] スレッド数(0 の時は自動で決める)
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -85,9 +118,10 @@ private:
   /// @brief cut が一つ見つかったときに呼ばれる関数(non-trivial cut)
   void
   found(
-    const SbjNode* root,     ///< [in] 根のノード
-    SizeType ni,             ///< [in] 入力数
-    const SbjNode* inputs[]  ///< [in] 入力ノードの配列
+    const SbjNode* root,          ///< [in] 根のノード
+    SizeType ni,                  ///< [in] 入力数
+    const SbjNode* inputs[],      ///< [in] 入力ノードの配列
+    const std::uint64_t* tv_words ///< [in] カットの真理値表のワードの配列
   ) override;
 
   /// @brief node を根とするカットを列挙し終わった直後に呼ばれる関数
@@ -117,9 +151,15 @@ private:
   // カットを管理するオブジェクト
   CutMgr mMgr;
 
+  // enum_cut_mt() で2番目以降のスレッドがカットを管理するオブジェクト
+  vector<std::unique_ptr<CutMgr>> mSubMgrList;
+
   // カットサイズ
   SizeType mLimit;
 
+  // カット数の最大値
+  SizeType mPeakCutNum{0};
+
   // 各ノードのカットのリスト
   CutList* mCutList;
 
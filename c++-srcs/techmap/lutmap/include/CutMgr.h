@@ -9,6 +9,8 @@
 /// All rights reserved.
 
 #include "lutmap.h"
+#include "Cut.h"
+#include "SbjNode.h"
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -16,6 +18,15 @@ BEGIN_NAMESPACE_LUTMAP
 //////////////////////////////////////////////////////////////////////
 /// @class CutMgr CutMgr.h "CutMgr.h"
 /// @brief カットを管理するクラス
+///
+/// カットの表す論理関数の真理値表の領域もカットと同じメモリ領域に確保する．
+/// 真理値表はカットの列挙時に求められたものを受け取って書き込む．
+///
+/// カットのメモリはまとめて確保したチャンクから順に切り出して用いる．
+/// 個々のカットのメモリは解放されず，clear() でまとめて解放される．
+///
+/// 実行規模の見積もりのために，保持しているカット数と確保したメモリ量，
+/// およびカット数の最大値を記録している．
 //////////////////////////////////////////////////////////////////////
 class CutMgr
 {
@@ -39,35 +50,76 @@ public:
   /// @brief カットを生成する．
   Cut*
   new_cut(
-    const SbjNode* root,    ///< [in] カットの根のノード
-    SizeType ni,            ///< [in] カットの入力数
-    const SbjNode* inputs[] ///< [in] カットの入力のノードの配列
-  )
-  {
-    SizeType size = sizeof(Cut) + (ni - 1) * sizeof(const SbjNode*);
-    char* p = new char[size];
-    mMemList.push_back(p);
-    return new (p) Cut(root, ni, inputs);
-  }
+    const SbjNode* root,          ///< [in] カットの根のノード
+    SizeType ni,                  ///< [in] カットの入力数
+    const SbjNode* inputs[],      ///< [in] カットの入力のノードの配列
+    const std::uint64_t* tv_words ///< [in] 真理値表のワードの配列
+  );
 
   /// @brief このオブジェクトが管理しているすべてのカットを削除する．
+  ///
+  /// peak_cut_num() の値はリセットされない．
   void
-  clear()
+  clear();
+
+  /// @brief 現在保持しているカット数を返す．
+  SizeType
+  cut_num() const
+  {
+    return mCutNum;
+  }
+
+  /// @brief これまでに同時に保持したカット数の最大値を返す．
+  SizeType
+  peak_cut_num() const
+  {
+    return mPeakCutNum;
+  }
+
+  /// @brief カット用に確保しているメモリ量(バイト)を返す．
+  ///
+  /// チャンク単位で確保した量なので，未使用の領域も含む．
+  SizeType
+  bytes_used() const
   {
-    for ( auto p: mMemList ) {
-      delete [] p;
-    }
-    mMemList.clear();
+    return mBytesUsed;
   }
 
 
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 入力数 ni のカット用のメモリ領域を確保する．
+  char*
+  alloc_cut(
+    SizeType ni ///< [in] 入力数
+  );
+
+
 private:
   //////////////////////////////////////////////////////////////////////
   // データメンバ
   //////////////////////////////////////////////////////////////////////
 
   // ここで確保したメモリチャンクのリスト
-  vector<char*> mMemList;
+  vector<char*> mChunkList;
+
+  // 現在のチャンクの未使用領域の先頭
+  char* mChunkPos{nullptr};
+
+  // 現在のチャンクの末尾
+  char* mChunkEnd{nullptr};
+
+  // 現在保持しているカット数
+  SizeType mCutNum{0};
+
+  // カット数の最大値
+  SizeType mPeakCutNum{0};
+
+  // 確保しているメモリ量(バイト)
+  SizeType mBytesUsed{0};
 
 };
 
@@ -18,6 +18,7 @@ class Cut;
 class CutHolder;
 class MapRecord;
 class CutResubImpl;
+class DelayModel;
 
 //////////////////////////////////////////////////////////////////////
 /// @class CutResub CutResub.h "CutResub.h"
@@ -39,13 +40,21 @@ public:
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 遅延モデルを設定する．
+  ///
+  /// 設定しなければ単位遅延(=段数)となる．
+  void
+  set_delay_model(
+    const DelayModel& model ///< [in] 遅延モデル
+  );
+
   /// @brief カットの置き換えを行って LUT 数の削減を行う．
   void
   operator()(
     const SbjGraph& sbjgraph,    ///< [in] サブジェクトグラフ
     const CutHolder& cut_holder, ///< [in] サブジェクトグラフ上のカット集合
     MapRecord& maprec,           ///< [inout] マッピング結果
-    int slack = -1               ///< [in] 段数のスラック(-1 で段数制約なし)
+    int slack = -1               ///< [in] 遅延のスラック(-1 で遅延制約なし)
   );
 
 
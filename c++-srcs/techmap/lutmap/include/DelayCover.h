@@ -10,6 +10,7 @@
 
 #include "DagCover.h"
 #include "ADCost.h"
+#include "DelayModel.h"
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -19,6 +20,19 @@ class Cut;
 //////////////////////////////////////////////////////////////////////
 /// @class DelayCover DelayCover.h "DelayCover.h"
 /// @brief depth/area optimal cover を求めるためのクラス
+///
+/// 段数の代わりに DelayModel で求めた到着時刻と要求時刻を用いる．
+/// 遅延モデルを設定しなければ単位遅延(=段数)となる．
+/// slack も遅延モデルの単位で表す．
+///
+/// 各ノードの (遅延, 面積) のパレート解のリストは
+/// set_cost_limit() で要素数の上限と面積の許容誤差を指定して間引ける．
+/// 指定しなければ間引かない．
+///
+/// リストはそのノードを入力とするカットを持つ最後のノードを処理した時点で
+/// select() で用いる (遅延, カット) の組の表に写して解放し，
+/// 要素は後のノードのリストで再利用する．
+/// そのため同時に保持するリストはトポロジカル順の処理の境界付近のものに限られる．
 //////////////////////////////////////////////////////////////////////
 class DelayCover :
   public DagCover
@@ -43,6 +57,19 @@ public:
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 遅延モデルを設定する．
+  void
+  set_delay_model(
+    const DelayModel& model ///< [in] 遅延モデル
+  );
+
+  /// @brief 各ノードのコストリストの上限を設定する．
+  void
+  set_cost_limit(
+    SizeType max_num, ///< [in] 要素数の上限(0 の時は制限なし)
+    double epsilon    ///< [in] 面積の許容誤差の比率
+  );
+
   /// @brief best cut の記録を行う．
   void
   record_cuts(
@@ -79,6 +106,21 @@ private:
     double cur_weight
   );
 
+  // ノードのコストリストを mSelTable に写して解放する．
+  void
+  release(
+    SizeType id
+  );
+
+  // カットの各入力から根までの遅延を mEdgeDelay に求める．
+  //
+  // 入力の到着時刻には最小到着時刻を用いてピンを割り当てるので
+  // record() と select() で同じ割り当てとなる．
+  void
+  calc_edge_delay(
+    const Cut* cut
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -86,11 +128,16 @@ private:
   //////////////////////////////////////////////////////////////////////
 
   // ノードごとの作業領域
+  //
+  // mCostList の段数と mMinDepth, mReqDepth は遅延モデルの単位で表す．
+  // mCostList は release() で mSelTable の [mSelBegin, mSelEnd) に写される．
   struct NodeInfo
   {
     ADCostList<double> mCostList;
     int mMinDepth{0};
     int mReqDepth{0};
+    SizeType mSelBegin{0};
+    SizeType mSelEnd{0};
   };
 
 
@@ -102,12 +149,41 @@ private:
   // スラックの値
   int mSlack;
 
+  // 遅延モデル
+  DelayModel mDelayModel;
+
+  // 各ノードのコストリストの要素数の上限
+  SizeType mMaxCostNum{0};
+
+  // コストリストを間引く時の面積の許容誤差の比率
+  double mCostEpsilon{0.0};
+
   // マッピング用の作業領域
   vector<NodeInfo> mNodeInfo;
 
+  // 解放したコストリストの (段数, カット) の組を並べた表
+  // 各ノードの要素はコストリストと同じく段数の降順に並ぶ．
+  vector<pair<int, const Cut*>> mSelTable;
+
+  // 論理ノードの処理順の位置 p の後で解放するノード番号を
+  // mReleaseList[mReleaseBegin[p]] から mReleaseList[mReleaseBegin[p + 1] - 1] に格納する．
+  vector<SizeType> mReleaseBegin;
+
+  // 解放するノード番号のリスト
+  vector<SizeType> mReleaseList;
+
   // カットの葉の重みを入れる作業領域
   vector<double> mWeight;
 
+  // カットの葉から根までの遅延を入れる作業領域
+  vector<SizeType> mEdgeDelay;
+
+  // カットの葉の最小到着時刻を入れる作業領域
+  vector<SizeType> mLevelList;
+
+  // カットの葉を割り当てたピン番号を入れる作業領域
+  vector<SizeType> mPinList;
+
   // ADCost のメモリ管理用オブジェクト
   ADCostMgr<double> mCostMgr;
 
@@ -0,0 +1,163 @@
+#ifndef DELAYMODEL_H
+#define DELAYMODEL_H
+
+/// @file DelayModel.h
+/// @brief DelayModel のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "lutmap.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class Cut;
+
+//////////////////////////////////////////////////////////////////////
+/// @class DelayModel DelayModel.h "DelayModel.h"
+/// @brief LUT ネットワークの遅延モデルを表すクラス
+///
+/// カットの入力から根までの遅延(枝の遅延)を
+/// - LUT の入力数と入力ピンごとのピン遅延
+/// - ドライバのファンアウト数に比例する配線遅延
+/// の和で表す．
+/// カットの入力は assign_pins() で到着の遅いものほど遅延の小さいピンに割り当てる．
+/// DelayCover, CutResub, MapGen はいずれもこの割り当てを用いる．
+/// ファンアウト数はサブジェクトグラフ上の値を見積もりとして用いる．
+///
+/// 遅延は整数で表す(単位は任意)．
+/// ピン遅延を1つも設定しなければすべての LUT の遅延は 1 となり，
+/// 従来の段数(単位遅延)と同じになる．
+/// ピン遅延を設定した場合は，設定していない入力数の LUT を用いてはならない．
+//////////////////////////////////////////////////////////////////////
+class DelayModel
+{
+public:
+
+  /// @brief コンストラクタ
+  ///
+  /// 単位遅延モデルとなる．
+  DelayModel() = default;
+
+  /// @brief デストラクタ
+  ~DelayModel() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 内容を設定する関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief LUT のピン遅延を設定する．
+  ///
+  /// delay_list のサイズは lut_size に等しくなければならない．
+  /// 遅延は 1 以上でなければならない．
+  void
+  set_pin_delay(
+    SizeType lut_size,                 ///< [in] LUT の入力数
+    const vector<SizeType>& delay_list ///< [in] ピンごとの遅延のリスト
+  );
+
+  /// @brief 配線遅延を設定する．
+  ///
+  /// 配線遅延は base + per_fanout x ファンアウト数となる．
+  ///
+  /// ここでのファンアウト数はカットの入力となるサブジェクトグラフの
+  /// ノードのファンアウト数(SbjNode::fanout_num())である．
+  /// マッピング後の LUT ネットワークのファンアウト数はカットを選ぶまで
+  /// 決まらないので，その見積もりとして用いている．
+  /// 1つのノードが複数のカットに吸収される場合や外部出力へのファンアウトも
+  /// 数えるため，実際の LUT のファンアウト数とは一致しない．
+  void
+  set_wire_delay(
+    SizeType base,      ///< [in] 基本の遅延
+    SizeType per_fanout ///< [in] ファンアウトあたりの遅延
+  );
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 遅延を求める関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ピン遅延を返す．
+  SizeType
+  pin_delay(
+    SizeType lut_size, ///< [in] LUT の入力数
+    SizeType pos       ///< [in] ピン番号 ( 0 <= pos < lut_size )
+  ) const
+  {
+    ASSERT_COND( pos < lut_size );
+
+    if ( mPinDelayTable.empty() ) {
+      // 単位遅延
+      return 1;
+    }
+    ASSERT_COND( lut_size < mPinDelayTable.size() );
+    auto& delay_list = mPinDelayTable[lut_size];
+    ASSERT_COND( !delay_list.empty() );
+    return delay_list[pos];
+  }
+
+  /// @brief 配線遅延を返す．
+  SizeType
+  wire_delay(
+    SizeType fanout_num ///< [in] ドライバのファンアウト数
+  ) const
+  {
+    return mWireBase + mWirePerFanout * fanout_num;
+  }
+
+  /// @brief カットの入力を LUT のピンに割り当てる．
+  ///
+  /// 各入力の到着時刻(ドライバの到着時刻 + 配線遅延)の遅いものから順に
+  /// 遅延の小さいピンに割り当てる．これで根の到着時刻が最小になる．
+  /// 到着時刻やピン遅延が等しい場合は番号の小さいもの同士を組にする．
+  /// 単位遅延の時は i 番目の入力を i 番目のピンに割り当てる．
+  void
+  assign_pins(
+    const Cut* cut,                      ///< [in] カット
+    const vector<SizeType>& level_list,  ///< [in] 各入力のドライバの到着時刻のリスト
+    vector<SizeType>& pin_list           ///< [out] 各入力を割り当てたピン番号のリスト
+  ) const;
+
+  /// @brief カットの入力から根までの遅延を返す．
+  SizeType
+  edge_delay(
+    const Cut* cut, ///< [in] カット
+    SizeType pos,   ///< [in] 入力番号
+    SizeType pin    ///< [in] 割り当てたピン番号
+  ) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // LUT の入力数をキーにしてピンごとの遅延のリストを格納する配列
+  // 配列が空の時は単位遅延を表す．
+  vector<vector<SizeType>> mPinDelayTable;
+
+  // LUT の入力数をキーにしてピン遅延の小さい順に並べたピン番号のリストを格納する配列
+  vector<vector<SizeType>> mPinOrderTable;
+
+  // assign_pins() で用いる作業領域
+  mutable vector<SizeType> mTmpOrder;
+
+  // assign_pins() で用いる作業領域
+  mutable vector<SizeType> mTmpArrival;
+
+  // 配線遅延の基本値
+  SizeType mWireBase{0};
+
+  // ファンアウトあたりの配線遅延
+  SizeType mWirePerFanout{0};
+
+};
+
+END_NAMESPACE_LUTMAP
+
+#endif // DELAYMODEL_H
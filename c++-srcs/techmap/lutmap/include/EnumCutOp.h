@@ -15,6 +15,7 @@
 BEGIN_NAMESPACE_LUTMAP
 
 class EnumCut;
+class PriorityCut;
 
 //////////////////////////////////////////////////////////////////////
 /// @class EnumCutOp
@@ -24,6 +25,7 @@ class EnumCut;
 class EnumCutOp
 {
   friend class EnumCut;
+  friend class PriorityCut;
 
 protected:
 
@@ -50,6 +52,18 @@ public:
     SizeType limit            ///< [in] 入力数の制限
   );
 
+  /// @brief 優先カットの列挙を行う．
+  /// @return 全 cut 数を返す．
+  ///
+  /// 各ノードごとに評価値の良い上位 cut_num 個のカットのみを列挙する．
+  /// 内部で下の仮想関数が呼び出される．
+  SizeType
+  enum_priority_cut(
+    const SbjGraph& sbjgraph, ///< [in] 対象のサブジェクトグラフ
+    SizeType limit,           ///< [in] 入力数の制限
+    SizeType cut_num          ///< [in] 各ノードで保持するカット数の上限
+  );
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -87,13 +101,16 @@ private:
 
   /// @brief cut が一つ見つかったときに呼ばれる関数(non-trivial cut)
   ///
+  /// tv_words の形式は Cut::tv_words() と同じで，
+  /// この関数の中でのみ有効である．
   /// デフォルトの実装ではなにもしない．
   virtual
   void
   found(
-    const SbjNode* root,    ///< [in] 根のノード
-    SizeType ni,            ///< [in] 入力数
-    const SbjNode* inputs[] ///< [in] 入力ノードの配列
+    const SbjNode* root,          ///< [in] 根のノード
+    SizeType ni,                  ///< [in] 入力数
+    const SbjNode* inputs[],      ///< [in] 入力ノードの配列
+    const std::uint64_t* tv_words ///< [in] カットの真理値表のワードの配列
   );
 
   /// @brief node を根とするカットを列挙し終わった直後に呼ばれる関数
@@ -0,0 +1,251 @@
+﻿#ifndef LUTMAPMGR_H
+#define LUTMAPMGR_H
+
+/// @file LutmapMgr.h
+/// @brief LutmapMgr のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2005-2011, 2016, 2018, 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "magus.h"
+#include "ym/bnet.h"
+
+
+BEGIN_NAMESPACE_MAGUS
+
+//////////////////////////////////////////////////////////////////////
+/// @class LutmapMgr LutmapMgr.h "LutmapMgr.h"
+/// @brief LUT用のテクノロジマッパー
+//////////////////////////////////////////////////////////////////////
+class LutmapMgr
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] lut_size LUTの入力数
+  /// @param[in] option オプション文字列
+  LutmapMgr(
+    SizeType lut_size = 5,
+    const string& option = string()
+  );
+
+  /// @brief デストラクタ
+  ~LutmapMgr();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // メンバ関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief LUTの入力数を設定する
+  /// @param[in] lut_size LUTの入力数
+  void
+  set_lut_size(
+    SizeType lut_size
+  )
+  {
+    mLutSize = lut_size;
+  }
+
+  /// @brief オプション文字列を設定する．
+  /// @param[in] option オプション文字列
+  ///
+  /// オプション文字列は "key[=value]" を ',' で区切ったもの．
+  /// 解釈できないキーワードは無視する．
+  /// 値が不正な場合は std::invalid_argument 例外を送出する．
+  ///
+  /// サブジェクトグラフの生成に関しては以下のキーワードを解釈する．
+  /// - strash       構造ハッシュを行い，同じ構造のノードを併合する．
+  /// - no_strash    構造ハッシュを行わない(デフォルト)．
+  ///
+  /// 被覆に関しては以下のキーワードを解釈する．
+  /// - fanout       ファンアウトモード(デフォルト)
+  /// - flow         area flow モード
+  /// - cut_resub    cut resubstitution を行う(デフォルト)．
+  /// - no_cut_resub cut resubstitution を行わない．
+  ///
+  /// カットの列挙に関しては以下のキーワードを解釈する．
+  /// - priority_cut 各ノードで上位のカットのみを列挙する．
+  ///                値としてカット数(1 以上)を指定できる(省略時は 8)．
+  /// - all_cut      すべてのカットを列挙する(デフォルト)．
+  /// - cut_thread   全カットの列挙を複数のスレッドで行う．
+  ///                値としてスレッド数を指定できる(省略時は自動)．
+  ///
+  /// area_map() の面積回復に関しては以下のキーワードを解釈する．
+  /// - flow_recovery  area flow による回復を行う．
+  ///                  値として繰り返し回数を指定できる(省略時は 1)．
+  /// - exact_recovery exact area による回復を行う．
+  ///                  値として繰り返し回数を指定できる(省略時は 1)．
+  ///
+  /// area_map() の探索アルゴリズムに関しては以下のキーワードを解釈する．
+  /// - algorithm    "sa" の時は焼きなまし法で境界ノードを探索する．
+  ///                "mct" の時はモンテカルロ木探索で境界ノードを探索する．
+  ///                値を省略した時は area cover のみを行う(デフォルト)．
+  /// - sa_count     焼きなまし法の1つの温度での試行回数(省略時は 100)
+  /// - sa_chain     焼きなまし法の連鎖数(省略時は 1)．
+  ///                2 以上の時は連鎖ごとに別のスレッドで探索する．
+  /// - sa_exchange  連鎖の間で温度の交換(replica exchange)を行う．
+  /// - no_sa_exchange 温度の交換を行わない(デフォルト)．
+  /// - mct_count    モンテカルロ木探索の試行回数(省略時は 1000)
+  /// - mct_thread   モンテカルロ木探索のスレッド数(省略時は 1)
+  /// - seed         乱数の種
+  ///
+  /// delay_map() の遅延モデルに関しては以下のキーワードを解釈する．
+  /// 指定しなければ単位遅延(=段数)となる．
+  /// - pin_delay  LUT の入力ピンごとの遅延を ':' で区切って指定する．
+  ///              (例: pin_delay=1:1:2:3)
+  ///              値は 1 以上で，値の数は LUT の入力数以上でなければならない．
+  ///              k 入力のカットには先頭の k 個の値を用いる．
+  ///              各 LUT では到着の遅い入力ほど遅延の小さいピンにつなぐ．
+  /// - wire_delay 配線遅延を "基本値:ファンアウトあたりの値" で指定する．
+  ///              (例: wire_delay=0:1)
+  ///              値は 0 以上でなければならない．
+  ///
+  /// delay_map() の各ノードの (遅延, 面積) の解のリストに関しては
+  /// 以下のキーワードを解釈する．
+  /// - cost_limit   各ノードで残す解の数の上限(省略時は 0 で制限なし)
+  ///                最小遅延の解は常に残る．
+  /// - cost_epsilon 面積の差がこの値(パーセント)以内の解を間引く(省略時は 0)．
+  void
+  set_option(
+    const string& option
+  );
+
+  /// @brief 面積最小化 DAG covering のヒューリスティック関数
+  /// @param[in] src_network もとのネットワーク
+  /// @param[out] dat_network マッピング結果
+  BnNetwork
+  area_map(
+    const BnNetwork& src_network
+  );
+
+  /// @brief 段数最小化 DAG covering のヒューリスティック関数
+  /// @param[in] src_network もとのネットワーク
+  /// @param[in] slack 最小段数に対するスラック
+  /// @param[out] dat_network マッピング結果
+  BnNetwork
+  delay_map(
+    const BnNetwork& src_network,
+    int slack
+  );
+
+  /// @brief 直前のマッピング結果のLUT数を返す．
+  SizeType
+  lut_num()
+  {
+    return mLutNum;
+  }
+
+  /// @brief 直前のマッピング結果の段数を返す．
+  SizeType
+  depth()
+  {
+    return mDepth;
+  }
+
+  /// @brief 直前のマッピングで列挙したカット数を返す．
+  SizeType
+  peak_cut_num()
+  {
+    return mPeakCutNum;
+  }
+
+  /// @brief 直前のマッピングでカット用に確保したメモリ量(バイト)を返す．
+  SizeType
+  cut_bytes_used()
+  {
+    return mCutBytesUsed;
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // LUTの入力数
+  SizeType mLutSize;
+
+  // オプション文字列
+  string mOption;
+
+  // アルゴリズムを表す文字列
+  string mAlgorithm;
+
+  // 構造ハッシュを行う時 true にするフラグ
+  bool mStrash;
+
+  // ファンアウトモード
+  bool mFanoutMode;
+
+  // cut_resubstitution を行う時に true にするフラグ
+  bool mDoCutResub;
+
+  // 優先カットモードで各ノードが保持するカット数
+  // 0 の時はすべてのカットを列挙する．
+  SizeType mCutNum;
+
+  // 全カット列挙に用いるスレッド数
+  // 0 の時はハードウェアの並列度に合わせる．
+  SizeType mCutThreadNum;
+
+  // area flow による面積回復の繰り返し回数
+  SizeType mFlowIter;
+
+  // exact area による面積回復の繰り返し回数
+  SizeType mExactIter;
+
+  // 焼きなまし法の1つの温度での試行回数
+  SizeType mSaCount;
+
+  // 焼きなまし法の連鎖数
+  SizeType mSaChainNum;
+
+  // 焼きなまし法で温度の交換を行う時 true にするフラグ
+  bool mSaExchange;
+
+  // モンテカルロ木探索の試行回数
+  SizeType mMctCount;
+
+  // モンテカルロ木探索のスレッド数
+  SizeType mMctThreadNum;
+
+  // 乱数の種
+  SizeType mSeed;
+
+  // 入力ピンごとの遅延のリスト
+  // 空の時は単位遅延となる．
+  vector<SizeType> mPinDelayList;
+
+  // 配線遅延の基本値
+  SizeType mWireBase;
+
+  // ファンアウトあたりの配線遅延
+  SizeType mWirePerFanout;
+
+  // delay_map() で各ノードに残す解の数の上限
+  // 0 の時は制限なし．
+  SizeType mCostLimit;
+
+  // delay_map() で解を間引く時の面積の許容誤差(パーセント)
+  SizeType mCostEpsilon;
+
+  // 直前のマッピング結果のLUT数
+  SizeType mLutNum;
+
+  // 直前のマッピング結果の段数
+  SizeType mDepth;
+
+  // 直前のマッピングで列挙したカット数
+  SizeType mPeakCutNum;
+
+  // 直前のマッピングでカット用に確保したメモリ量(バイト)
+  SizeType mCutBytesUsed;
+
+};
+
+END_NAMESPACE_MAGUS
+
+#endif // LUTMAPMGR_H
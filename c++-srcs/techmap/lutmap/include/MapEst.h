@@ -10,6 +10,7 @@
 
 #include "lutmap.h"
 #include "sbj_nsdef.h"
+#include "MapTrace.h"
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -45,6 +46,36 @@ public:
     SizeType& depth           ///< [out] 最大段数
   );
 
+  /// @brief 差分更新用の初期化を行う．
+  ///
+  /// 以降は update() でカットの変更を反映させることで
+  /// incr_lut_num() が estimate() の LUT 数と同じ値を返す．
+  /// 段数は計算しない．
+  void
+  init_incr(
+    const SbjGraph& sbjgraph, ///< [in] サブジェクトグラフ
+    const MapRecord& record   ///< [in] マッピング結果
+  );
+
+  /// @brief カットの変更を反映させる．
+  ///
+  /// node_list 中のノードのうち，現在の解で使われており，
+  /// かつ record 中のカットが変わったものについて
+  /// 古いカットの参照を解除して新しいカットを参照する．
+  /// 変更を取り消した場合も同じノードのリストで呼べばよい．
+  void
+  update(
+    const MapRecord& record,                ///< [in] 更新後のマッピング結果
+    const vector<const SbjNode*>& node_list ///< [in] カットの変わったノードのリスト
+  );
+
+  /// @brief 差分更新で求めた LUT 数を返す．
+  SizeType
+  incr_lut_num() const
+  {
+    return mIncrLutNum;
+  }
+
   /// @brief 直前の estimate() の結果ファンアウトポイントになったノードのリストを得る．
   const vector<const SbjNode*>&
   fanoutpoint_list() const
@@ -53,112 +84,35 @@ public:
   }
 
 
-private:
-  //////////////////////////////////////////////////////////////////////
-  // 内部で用いられるデータ構造
-  //////////////////////////////////////////////////////////////////////
-
-  /// @brief ノードごとの情報
-  class NodeInfo
-  {
-  public:
-
-    /// @brief 参照回数を増やす．
-    void
-    inc_ref(
-      bool inv = false ///< [in] 反転フラグ
-    )
-    {
-      int idx = inv ? 1 : 0;
-      ++ mRefCount[idx];
-    }
-
-    /// @brief マップ結果を設定する．
-    void
-    set_map(
-      SizeType depth,  ///< [in] 段数
-      bool inv = false ///< [in] 反転フラグ
-    )
-    {
-      int idx = inv ? 1 : 0;
-      mMapNode[idx] = true;
-      mDepth[idx] = depth;
-    }
-
-    /// @brief 参照回数を返す．
-    SizeType
-    ref_count(
-      bool inv = false ///< [in] 反転フラグ
-    ) const
-    {
-      int idx = inv ? 1 : 0;
-      return mRefCount[idx];
-    }
-
-    /// @brief 負極性しか作らないときに true を返す．
-    bool
-    inv_req() const
-    {
-      return (mRefCount[1] > 0) && (mRefCount[0] == 0);
-    }
-
-    /// @brief マップ結果を返す．
-    bool
-    is_mapped(
-      bool inv = false ///< [in] 反転フラグ
-    ) const
-    {
-      int idx = inv ? 1 : 0;
-      return mMapNode[idx];
-    }
-
-    /// @brief 段数を返す．
-    SizeType
-    depth(
-      bool inv = false ///< [in] 反転フラグ
-    ) const
-    {
-      int idx = inv ? 1 : 0;
-      return mDepth[idx];
-    }
-
-
-  private:
-    //////////////////////////////////////////////////////////////////////
-    // データメンバ
-    //////////////////////////////////////////////////////////////////////
-
-    // 使われている回数
-    // 正極性と負極性の2通りを保持する．
-    SizeType mRefCount[2]{0, 0};
-
-    // マッピングされているかを示すフラグ
-    // 正極性と負極性の2通りを保持する．
-    bitset<2> mMapNode{0};
-
-    // 段数
-    // 正極性と負極性の2通りを保持する．
-    SizeType mDepth[2]{0, 0};
-
-  };
-
-
 private:
   //////////////////////////////////////////////////////////////////////
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief 作業領域の初期化を行う．
+  /// @brief 差分更新用にノードの LUT 数を返す．
+  SizeType
+  incr_lut(
+    SizeType id ///< [in] ノード番号
+  ) const;
+
+  /// @brief 差分更新用に mIncrStack に積まれたノードの参照回数を増やす．
+  ///
+  /// 新たに使用中になったノードのカットの入力も続けて参照する．
   void
-  init(
-    SizeType node_num ///< [in] ノード数
+  incr_ref(
+    const MapRecord& record ///< [in] マッピング結果
   );
 
-  /// @brief estimate 用のバックトレースを行う．
+  /// @brief 差分更新用に mIncrStack に積まれたノードの参照回数を減らす．
+  ///
+  /// 使われなくなったノードのカットの入力も続けて参照を解除する．
+  void
+  incr_deref();
+
+  /// @brief 差分更新用にノードを使用中にしてカットの入力を mIncrStack に積む．
   void
-  est_back_trace(
+  incr_activate(
     const SbjNode* node,    ///< [in] 対象のノード
-    bool inv,               ///< [in] 極性を表すフラグ．inv = true の時，反転を表す．
     const MapRecord& record ///< [in] マッピング結果
   );
 
@@ -168,20 +122,30 @@ private:
   // データメンバ
   //////////////////////////////////////////////////////////////////////
 
-  // ノードごとの情報を持つ配列
-  vector<NodeInfo> mNodeInfo;
+  // マッピング結果のバックトレースを行うオブジェクト
+  MapTrace mTrace;
 
-  // 定数0のノードが生成されているとき true
-  bool mConst0{false};
+  // ファンアウトポイントのリスト
+  vector<const SbjNode*> mFanoutPointList;
 
-  // 定数1のノードが生成されているとき true
-  bool mConst1{false};
+  // 以下は差分更新用のデータ
 
-  // LUT数の見積もりに使う作業領域
-  SizeType mLutNum;
+  // ノード番号をキーにして外部出力から要求されている極性を格納する配列
+  // 1 ビット目が正極性，2 ビット目が負極性を表す．
+  vector<std::uint8_t> mOutPolArray;
 
-  // ファンアウトポイントのリスト
-  vector<const SbjNode*> mFanoutPointList;
+  // ノード番号をキーにして使用中のノードのカットの入力となっている回数を格納する配列
+  vector<SizeType> mIncrRefArray;
+
+  // ノード番号をキーにして使用中のノードが参照しているカットを格納する配列
+  vector<const Cut*> mIncrCutArray;
+
+  // 差分更新で求めた LUT 数
+  SizeType mIncrLutNum{0};
+
+  // 参照/参照解除を行うノードを積む作業用のスタック
+  // 深い回路でもスタックを溢れさせないように再帰は用いない．
+  vector<const SbjNode*> mIncrStack;
 
 };
 
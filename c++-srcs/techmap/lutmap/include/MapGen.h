@@ -12,11 +12,15 @@
 #include "sbj_nsdef.h"
 #include "ym/bnet.h"
 #include "ym/BnNode.h"
+#include "ym/TvFunc.h"
+#include "MapTrace.h"
+#include "DelayModel.h"
 
 
 BEGIN_NAMESPACE_LUTMAP
 
 class MapRecord;
+class Cut;
 
 //////////////////////////////////////////////////////////////////////
 /// @class MapGen MapGen.h "MapGen.h"
@@ -38,6 +42,19 @@ public:
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 遅延モデルを設定する．
+  ///
+  /// 各 LUT の入力は DelayModel::assign_pins() で決まるピンにつなぐ．
+  /// 入力の到着時刻にはこの遅延モデルで求めたマッピング結果の到着時刻を用いる．
+  /// 設定しなければ単位遅延となり，カットの入力の順にピンにつなぐ．
+  void
+  set_delay_model(
+    const DelayModel& model ///< [in] 遅延モデル
+  )
+  {
+    mDelayModel = model;
+  }
+
   /// @brief マッピング結果を BnNetwork に変換する．
   BnNetwork
   generate(
@@ -53,89 +70,20 @@ private:
   // 内部で用いられるデータ構造
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief ノードごとの情報
-  class NodeInfo
+  /// @brief 真理値表のワードの配列用のハッシュ関数
+  struct TvWordsHash
   {
-  public:
-
-    /// @brief 参照回数を増やす．
-    void
-    inc_ref(
-      bool inv = false ///< [in] 反転フラグ
-    )
-    {
-      int idx = inv ? 1 : 0;
-      ++ mRefCount[idx];
-    }
-
-    /// @brief マップ結果を設定する．
-    void
-    set_map(
-      BnNode node,     ///< [in] ノード
-      SizeType depth,  ///< [in] 段数
-      bool inv = false ///< [in] 反転フラグ
-    )
-    {
-      int idx = inv ? 1 : 0;
-      mMapNode[idx] = node;
-      mDepth[idx] = depth;
-    }
-
-    /// @brief 参照回数を返す．
     SizeType
-    ref_count(
-      bool inv = false ///< [in] 反転フラグ
+    operator()(
+      const vector<std::uint64_t>& words
     ) const
     {
-      int idx = inv ? 1 : 0;
-      return mRefCount[idx];
+      SizeType h = 0;
+      for ( auto w: words ) {
+	h = h * 1048573 + static_cast<SizeType>(w ^ (w >> 32));
+      }
+      return h;
     }
-
-    /// @brief 負極性しか作らないときに true を返す．
-    bool
-    inv_req() const
-    {
-      return (mRefCount[1] > 0) && (mRefCount[0] == 0);
-    }
-
-    /// @brief マップ結果を返す．
-    BnNode
-    map_node(
-      bool inv = false ///< [in] 反転フラグ
-    ) const
-    {
-      int idx = inv ? 1 : 0;
-      return mMapNode[idx];
-    }
-
-    /// @brief 段数を返す．
-    SizeType
-    depth(
-      bool inv = false ///< [in] 反転フラグ
-    ) const
-    {
-      int idx = inv ? 1 : 0;
-      return mDepth[idx];
-    }
-
-
-  private:
-    //////////////////////////////////////////////////////////////////////
-    // データメンバ
-    //////////////////////////////////////////////////////////////////////
-
-    // 使われている回数
-    // 正極性と負極性の2通りを保持する．
-    SizeType mRefCount[2]{0, 0};
-
-    // マップ結果のノード
-    // 正極性と負極性の2通りを保持する．
-    BnNode mMapNode[2]{{}, {}};
-
-    // 段数
-    // 正極性と負極性の2通りを保持する．
-    SizeType mDepth[2]{0, 0};
-
   };
 
 
@@ -150,10 +98,43 @@ private:
     SizeType node_num ///< [in] ノード数
   );
 
-  /// @brief generate 用のバックトレースを行う．
-  /// @return (node, inv) を実現するノードを返す．
+  /// @brief カットの実現する関数を返す．
+  ///
+  /// i 番目の入力は pin_list[i] 番目の変数となる．
+  /// 同じ関数の TvFunc は mTvCache に登録されたものを共有する．
+  const TvFunc&
+  get_tv(
+    const Cut* cut,                   ///< [in] カット
+    bool output_inv,                  ///< [in] 出力の反転フラグ
+    const vector<bool>& input_inv,    ///< [in] 入力の反転フラグの配列
+    const vector<SizeType>& pin_list  ///< [in] 各入力のピン番号の配列
+  );
+
+  /// @brief マップ結果を設定する．
+  void
+  set_map(
+    const SbjNode* node, ///< [in] 対象のノード
+    bool inv,            ///< [in] 反転フラグ
+    BnNode map_node      ///< [in] マップ結果のノード
+  )
+  {
+    mMapNodeArray[node->id() * 2 + (inv ? 1 : 0)] = map_node;
+  }
+
+  /// @brief マップ結果を返す．
   BnNode
-  gen_back_trace(
+  map_node(
+    const SbjNode* node, ///< [in] 対象のノード
+    bool inv = false     ///< [in] 反転フラグ
+  ) const
+  {
+    return mMapNodeArray[node->id() * 2 + (inv ? 1 : 0)];
+  }
+
+  /// @brief LUT を作る．
+  /// @return 作られたノードを返す．
+  BnNode
+  gen_lut(
     const SbjNode* node,     ///< [in] 対象のノード
     bool inv,                ///< [in] 極性を表すフラグ．inv = true の時，反転を表す．
     const MapRecord& record, ///< [in] マッピング結果
@@ -166,8 +147,17 @@ private:
   // データメンバ
   //////////////////////////////////////////////////////////////////////
 
-  // ノードごとの情報を持つ配列
-  vector<NodeInfo> mNodeInfo;
+  // マッピング結果のバックトレースを行うオブジェクト
+  MapTrace mTrace;
+
+  // 遅延モデル
+  DelayModel mDelayModel;
+
+  // ノード番号 x 2 + 極性をキーにしてマップ結果のノードを格納する配列
+  vector<BnNode> mMapNodeArray;
+
+  // ノード番号 x 2 + 極性をキーにしてマップ結果の到着時刻を格納する配列
+  vector<SizeType> mArrivalArray;
 
   // 定数0のノード
   BnNode mConst0;
@@ -178,6 +168,28 @@ private:
   // LUT数の見積もりに使う作業領域
   SizeType mLutNum;
 
+  // 真理値表のワードの配列(末尾に入力数を付加したもの)をキーにして
+  // TvFunc を格納するハッシュ表
+  unordered_map<vector<std::uint64_t>, TvFunc, TvWordsHash> mTvCache;
+
+  // get_tv() の作業領域
+  vector<std::uint64_t> mTvWords;
+
+  // get_tv() の作業領域
+  vector<std::uint64_t> mTvWords0;
+
+  // gen_lut() の作業領域
+  vector<bool> mInputInv;
+
+  // gen_lut() の作業領域
+  vector<BnNode> mFaninList;
+
+  // gen_lut() の作業領域
+  vector<SizeType> mLevelList;
+
+  // gen_lut() の作業領域
+  vector<SizeType> mPinList;
+
 };
 
 END_NAMESPACE_LUTMAP
@@ -0,0 +1,168 @@
+#ifndef MAPTRACE_H
+#define MAPTRACE_H
+
+/// @file MapTrace.h
+/// @brief MapTrace のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "lutmap.h"
+#include "sbj_nsdef.h"
+#include "SbjNode.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class MapRecord;
+
+//////////////////////////////////////////////////////////////////////
+/// @class MapTrace MapTrace.h "MapTrace.h"
+/// @brief マッピング結果をバックトレースして実際に使われる LUT を求めるクラス
+///
+/// 外部出力から MapRecord のカットをたどり，
+/// 実現する (ノード, 極性) の対をファンインが先に来る順に求める．
+/// 同時に極性ごとの参照回数と段数も求める．
+/// MapGen と MapEst で共通に用いる．
+///
+/// 深い回路でもスタックを溢れさせないように再帰は用いず，
+/// 作業用のスタックは呼び出しをまたがって再利用する．
+//////////////////////////////////////////////////////////////////////
+class MapTrace
+{
+public:
+
+  /// @brief コンストラクタ
+  MapTrace() = default;
+
+  /// @brief デストラクタ
+  ~MapTrace() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief バックトレースを行う．
+  void
+  trace(
+    const SbjGraph& sbjgraph, ///< [in] サブジェクトグラフ
+    const MapRecord& record   ///< [in] マッピング結果
+  );
+
+  /// @brief LUT で実現する (ノード, 極性) のリストを返す．
+  ///
+  /// ファンインのノードが先に来る順(帰りがけ順)に並んでいる．
+  /// 外部入力の NOT ゲートと定数は含まない．
+  const vector<pair<const SbjNode*, bool>>&
+  lut_list() const
+  {
+    return mLutList;
+  }
+
+  /// @brief 参照回数を返す．
+  SizeType
+  ref_count(
+    const SbjNode* node, ///< [in] 対象のノード
+    bool inv             ///< [in] 反転フラグ
+  ) const
+  {
+    return mRefCount[index(node, inv)];
+  }
+
+  /// @brief 負極性しか作らないときに true を返す．
+  ///
+  /// 内部のノードからはこの極性で参照される．
+  bool
+  inv_req(
+    const SbjNode* node ///< [in] 対象のノード
+  ) const
+  {
+    return ref_count(node, true) > 0 && ref_count(node, false) == 0;
+  }
+
+  /// @brief 段数を返す．
+  SizeType
+  depth(
+    const SbjNode* node, ///< [in] 対象のノード
+    bool inv             ///< [in] 反転フラグ
+  ) const
+  {
+    return mDepth[index(node, inv)];
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 外部出力から (node, inv) のバックトレースを行う．
+  void
+  back_trace(
+    const SbjNode* node,    ///< [in] 対象のノード
+    bool inv,               ///< [in] 反転フラグ
+    const MapRecord& record ///< [in] マッピング結果
+  );
+
+  /// @brief 配列のインデックスを返す．
+  static
+  SizeType
+  index(
+    const SbjNode* node, ///< [in] 対象のノード
+    bool inv             ///< [in] 反転フラグ
+  )
+  {
+    return node->id() * 2 + (inv ? 1 : 0);
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief バックトレース用のスタックの要素
+  struct Frame
+  {
+    // 対象のノード
+    const SbjNode* mNode;
+
+    // 反転フラグ
+    bool mInv;
+
+    // 次に処理するカットの入力の位置
+    SizeType mPos;
+
+    // 処理済みの入力の段数の最大値
+    SizeType mDepth;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ノード番号 x 2 + 極性をキーにして参照回数を格納する配列
+  vector<SizeType> mRefCount;
+
+  // ノード番号 x 2 + 極性をキーにして段数を格納する配列
+  vector<SizeType> mDepth;
+
+  // ノード番号 x 2 + 極性をキーにして処理済みの時 1 を格納する配列
+  vector<std::uint8_t> mMapped;
+
+  // LUT で実現する (ノード, 極性) のリスト
+  vector<pair<const SbjNode*, bool>> mLutList;
+
+  // バックトレース用のスタック
+  vector<Frame> mStack;
+
+};
+
+END_NAMESPACE_LUTMAP
+
+#endif // MAPTRACE_H
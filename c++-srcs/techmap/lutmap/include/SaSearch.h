@@ -11,7 +11,11 @@
 #include "lutmap.h"
 #include "AreaCover.h"
 #include "MapRecord.h"
+#include "MapEst.h"
 #include <random>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -22,7 +26,7 @@ class MctNode;
 
 //////////////////////////////////////////////////////////////////////
 /// @class SaSearch SaSearch.h "SaSearch.h"
-/// @brief MCT 探索を行うクラス
+/// @brief 焼きなまし法による探索を行うクラス
 //////////////////////////////////////////////////////////////////////
 class SaSearch
 {
@@ -45,6 +49,17 @@ public:
   // 外部インターフェイス
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 乱数の種を設定する．
+  ///
+  /// search_mt() の各連鎖の種もこの値から決定的に導かれる．
+  void
+  set_seed(
+    SizeType seed ///< [in] 乱数の種
+  )
+  {
+    mSeed = seed;
+  }
+
   /// @brief 探索を行う．
   /// @return 最良解を返す．
   const MapRecord&
@@ -53,16 +68,114 @@ public:
     bool verbose           ///< [in] verbose フラグ
   );
 
+  /// @brief 複数の連鎖を用いて探索を行う．
+  /// @return 最良解を返す．
+  ///
+  /// chain_num 個の連鎖をそれぞれ別のスレッドで実行する．
+  /// exchange が false の時は同じ温度スケジュールの独立な連鎖となる．
+  /// exchange が true の時は連鎖ごとに異なる温度を用い，
+  /// 温度を下げるごとに隣接する温度の連鎖の間で温度の交換を試みる(replica exchange)．
+  /// 最良解は全連鎖で共有され，同じ値の場合には番号の小さい連鎖の解を採る．
+  /// そのため結果はスレッドの実行順によらない．
+  const MapRecord&
+  search_mt(
+    SizeType search_limit, ///< [in] 1つの温度での各連鎖の試行回数
+    SizeType chain_num,    ///< [in] 連鎖数
+    bool exchange,         ///< [in] replica exchange を行う時 true
+    bool verbose           ///< [in] verbose フラグ
+  );
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 1つの連鎖の状態
+  struct Chain
+  {
+    // コンストラクタ
+    Chain(
+      bool flow_mode,
+      std::uint32_t seed
+    ) : mAreaCover{flow_mode},
+	mRandGen{seed}
+    {
+    }
+
+    // マッパー
+    AreaCover mAreaCover;
+
+    // 現在の解
+    MapRecord mRecord;
+
+    // 現在の解の LUT 数を差分で求めるオブジェクト
+    MapEst mMapEst;
+
+    // 乱数発生器
+    std::mt19937 mRandGen;
+
+    // 各ファンアウトポイントを境界とするかどうかを表す状態
+    vector<bool> mState;
+
+    // 現在の状態の評価値
+    SizeType mVal;
+
+    // 温度の倍率
+    double mTempScale{1.0};
+
+  };
+
 
 private:
   //////////////////////////////////////////////////////////////////////
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
-  /// @brief 現在の割り当てのもとで評価を行う．
+  /// @brief 連鎖の初期状態を設定する．
+  void
+  init_chain(
+    Chain& chain, ///< [in] 対象の連鎖
+    SizeType id   ///< [in] 連鎖番号
+  );
+
+  /// @brief 温度 T で search_limit 回の試行を行う．
+  void
+  anneal(
+    Chain& chain,         ///< [in] 対象の連鎖
+    SizeType id,          ///< [in] 連鎖番号
+    double T,             ///< [in] 温度
+    SizeType search_limit ///< [in] 試行回数
+  );
+
+  /// @brief search_mt() で各スレッドが実行する関数
+  void
+  run_chain(
+    SizeType id,          ///< [in] 連鎖番号
+    SizeType search_limit ///< [in] 1つの温度での試行回数
+  );
+
+  /// @brief すべての連鎖が温度 T の試行を終えるまで待つ．
+  ///
+  /// 最後に到達したスレッドが exchange() を行う．
+  void
+  sync(
+    double T ///< [in] 基準となる温度
+  );
+
+  /// @brief 隣接する温度の連鎖の間で温度の交換を試みる．
+  void
+  exchange(
+    double T ///< [in] 基準となる温度
+  );
+
+  /// @brief 連鎖の現在の解を評価する．
+  ///
+  /// 最良解よりも良ければ最良解を更新する．
   SizeType
   evaluate(
-    const vector<bool>& state
+    Chain& chain, ///< [in] 対象の連鎖
+    SizeType id   ///< [in] 連鎖番号
   );
 
 
@@ -95,8 +208,8 @@ private:
   // 減衰率
   double mDecrement;
 
-  // マッパー
-  AreaCover mAreaCover;
+  // area_cover のモード
+  bool mFlowMode;
 
   // 上界
   SizeType mUpperBound;
@@ -107,17 +220,48 @@ private:
   // 上界と下界の幅
   double mWidth;
 
-  // トータルの試行回数
-  SizeType mNumAll;
-
   // 最良値
   SizeType mMinimumLutNum;
 
+  // 最良解を見つけた連鎖番号
+  SizeType mBestChain;
+
   // 最良解
   MapRecord mBestRecord;
 
-  // 乱数発生器
-  std::mt19937 mRandGen;
+  // 最良解を保護する mutex
+  std::mutex mBestMutex;
+
+  // 乱数の種
+  SizeType mSeed;
+
+  // search_mt() で用いる連鎖のリスト
+  vector<std::unique_ptr<Chain>> mChainList;
+
+  // replica exchange を行う時 true
+  bool mExchange;
+
+  // 温度の高い順に連鎖番号を並べたリスト
+  // 交換は状態ではなく温度を入れ替えることで行う．
+  vector<SizeType> mLadder;
+
+  // 交換の判定に用いる乱数発生器
+  std::mt19937 mExchangeRandGen;
+
+  // 交換を試みた回数
+  SizeType mExchangeStep;
+
+  // sync() 用の mutex
+  std::mutex mSyncMutex;
+
+  // sync() 用の条件変数
+  std::condition_variable mSyncCond;
+
+  // sync() に到達したスレッド数
+  SizeType mSyncCount;
+
+  // sync() の世代番号
+  SizeType mSyncGen;
 
   // verbose フラグ
   bool mVerbose;
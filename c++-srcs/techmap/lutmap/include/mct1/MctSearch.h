@@ -0,0 +1,258 @@
+#ifndef MCT1_MCTSEARCH_H
+#define MCT1_MCTSEARCH_H
+
+/// @file MctSearch.h
+/// @brief MctSearch のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2016 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "mct1_nsdef.h"
+#include "mct1/MctState.h"
+#include "MapRecord.h"
+#include <random>
+#include <memory>
+#include <mutex>
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class CutHolder;
+
+END_NAMESPACE_LUTMAP
+
+BEGIN_NAMESPACE_LUTMAP_MCT1
+
+class MctNode;
+class MctNodePool;
+
+//////////////////////////////////////////////////////////////////////
+/// @class MctSearch MctSearch.h "MctSearch.h"
+/// @brief MCT 探索を行うクラス
+//////////////////////////////////////////////////////////////////////
+class MctSearch
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] sbjgraph サブジェクトグラフ
+  /// @param[in] cut_holder カットホルダー
+  /// @param[in] cut_size カットサイズ
+  MctSearch(const SbjGraph& sbjgraph,
+	    const CutHolder& cut_holder,
+	    SizeType cut_size);
+
+  /// @brief デストラクタ
+  ~MctSearch();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 探索を行う．
+  /// @param[in] search_limit 試行回数
+  /// @param[in] verbose verbose フラグ
+  /// @return 最良解を返す．
+  const MapRecord&
+  search(SizeType search_limit,
+	 bool verbose);
+
+  /// @brief 複数のスレッドで探索を行う．
+  /// @param[in] search_limit 全スレッドの試行回数の合計
+  /// @param[in] thread_num スレッド数
+  /// @param[in] verbose verbose フラグ
+  /// @return 最良解を返す．
+  ///
+  /// mct2::MctSearch::search_mt() と同様に探索木は全スレッドで共有し，
+  /// ランダムサンプリングはスレッドごとの状態を用いて並列に行う．
+  /// 評価中の経路には仮想損失(virtual loss)を加える．
+  /// thread_num が 1 の時は search() と同じ結果となる．
+  const MapRecord&
+  search_mt(SizeType search_limit,
+	    SizeType thread_num,
+	    bool verbose);
+
+  /// @brief 乱数の種を設定する．
+  /// @param[in] seed 乱数の種
+  ///
+  /// search_mt() の各スレッドの種もこの値から決定的に導かれる．
+  void
+  set_seed(SizeType seed);
+
+  /// @brief 最良解を返す．
+  const MapRecord&
+  best_record() const;
+
+  /// @brief 最良解の LUT 数を返す．
+  SizeType
+  best_lut_num() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 1つのスレッドの状態
+  struct Worker
+  {
+    // コンストラクタ
+    Worker(const SbjGraph& sbjgraph,
+	   SizeType cut_size,
+	   std::uint32_t seed) :
+      mState{sbjgraph, cut_size},
+      mRandGen{seed}
+    {
+    }
+
+    // マッピングの状態
+    MctState mState;
+
+    // 乱数発生器
+    std::mt19937 mRandGen;
+
+    // このスレッドでの最良値
+    SizeType mMinimumLutNum;
+
+    // このスレッドでの最良解
+    MapRecord mBestRecord;
+
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 探索を行う．
+  /// @param[in] search_limit 全スレッドの試行回数の合計
+  /// @param[in] seed_list 各スレッドの乱数の種のリスト
+  const MapRecord&
+  search_sub(SizeType search_limit,
+	     const vector<std::uint32_t>& seed_list);
+
+  /// @brief 1つのスレッドの探索を行う．
+  /// @param[in] id スレッド番号
+  /// @param[in] search_limit 全スレッドの試行回数の合計
+  void
+  run_worker(SizeType id,
+	     SizeType search_limit);
+
+  /// @brief 評価値の良い子ノードを見つける．
+  /// @param[in] worker 対象のスレッドの状態
+  /// @param[in] node 根のノード
+  ///
+  /// mTreeMutex を獲得した状態で呼ばれる．
+  /// 選ばれた経路上のノードには仮想損失が加えられる．
+  MctNode*
+  tree_policy(Worker& worker,
+	      MctNode* node);
+
+  /// @brief ランダムサンプリングを行って LUT 数を求める．
+  /// @param[in] worker 対象のスレッドの状態
+  SizeType
+  default_policy(Worker& worker);
+
+  /// @brief 評価値の更新を行う．
+  ///
+  /// mTreeMutex を獲得した状態で呼ばれる．
+  /// 経路上のノードの仮想損失も取り除く．
+  void
+  back_up(MctNode* node,
+	  double val);
+
+  /// @brief 状態を遷移させる．
+  /// @param[in] state 対象の状態
+  /// @param[in] cut_root カットの根のノード
+  static
+  void
+  move(MctState& state,
+       const SbjNode* cut_root);
+
+  /// @brief trivial な選択を行う．
+  /// @param[in] state 対象の状態
+  static
+  void
+  trivial_move(MctState& state);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 対象のサブジェクトグラフ
+  const SbjGraph& mSbjGraph;
+
+  // カットサイズ
+  SizeType mCutSize;
+
+  // 基準値
+  double mBaseline;
+
+  // トータルの試行回数
+  SizeType mNumAll;
+
+  // 全スレッドを通した最良値
+  SizeType mMinimumLutNum;
+
+  // 最良解
+  MapRecord mBestRecord;
+
+  // 探索木のノードを確保するオブジェクト
+  std::unique_ptr<MctNodePool> mNodePool;
+
+  // 根のノード
+  MctNode* mRootNode;
+
+  // 探索木を保護する mutex
+  std::mutex mTreeMutex;
+
+  // スレッドごとの状態のリスト
+  vector<std::unique_ptr<Worker>> mWorkerList;
+
+  // 乱数の種
+  SizeType mSeed;
+
+  // verbose フラグ
+  bool mVerbose;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 乱数の種を設定する．
+inline
+void
+MctSearch::set_seed(SizeType seed)
+{
+  mSeed = seed;
+}
+
+// @brief 最良解を返す．
+inline
+const MapRecord&
+MctSearch::best_record() const
+{
+  return mBestRecord;
+}
+
+// @brief 最良解の LUT 数を返す．
+inline
+SizeType
+MctSearch::best_lut_num() const
+{
+  return mMinimumLutNum;
+}
+
+END_NAMESPACE_LUTMAP_MCT1
+
+#endif // MCT1_MCTSEARCH_H
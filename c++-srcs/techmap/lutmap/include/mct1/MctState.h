@@ -1,5 +1,5 @@
-﻿#ifndef MCTSTATE_H
-#define MCTSTATE_H
+﻿#ifndef MCT1_MCTSTATE_H
+#define MCT1_MCTSTATE_H
 
 /// @file MctState.h
 /// @brief MctState のヘッダファイル
@@ -351,4 +351,4 @@ MctState::qmark(const SbjNode* node) const
 
 END_NAMESPACE_LUTMAP_MCT1
 
-#endif // MCTSTATE_H
+#endif // MCT1_MCTSTATE_H
@@ -14,6 +14,8 @@
 #include "AreaCover.h"
 #include "MapRecord.h"
 #include <random>
+#include <memory>
+#include <mutex>
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -25,6 +27,7 @@ END_NAMESPACE_LUTMAP
 BEGIN_NAMESPACE_LUTMAP_MCT2
 
 class MctNode;
+class MctNodePool;
 
 //////////////////////////////////////////////////////////////////////
 /// @class MctSearch MctSearch.h "MctSearch.h"
@@ -61,21 +64,109 @@ public:
   search(SizeType search_limit,
 	 bool verbose);
 
+  /// @brief 複数のスレッドで探索を行う．
+  /// @param[in] search_limit 全スレッドの試行回数の合計
+  /// @param[in] thread_num スレッド数
+  /// @param[in] verbose verbose フラグ
+  /// @return 最良解を返す．
+  ///
+  /// 探索木は全スレッドで共有する．
+  /// 木の選択・展開と評価値の更新は排他的に行うが，
+  /// ランダムサンプリング(マッピングと LUT 数の見積もり)は
+  /// スレッドごとの状態を用いて並列に行う．
+  /// 評価中の経路には仮想損失(virtual loss)を加えて
+  /// スレッドごとに異なる経路が選ばれるようにしている．
+  /// 各スレッドの最良解は最後にまとめて，
+  /// 同じ値の場合にはスレッド番号の小さい方を採る．
+  /// ただし，探索木の形はスレッドの実行順に依存する．
+  /// thread_num が 1 の時は search() と同じ結果となる．
+  const MapRecord&
+  search_mt(SizeType search_limit,
+	    SizeType thread_num,
+	    bool verbose);
+
+  /// @brief 乱数の種を設定する．
+  /// @param[in] seed 乱数の種
+  ///
+  /// search_mt() の各スレッドの種もこの値から決定的に導かれる．
+  void
+  set_seed(SizeType seed);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 1つのスレッドの状態
+  struct Worker
+  {
+    // コンストラクタ
+    Worker(const SbjGraph& sbjgraph,
+	   bool flow_mode,
+	   std::uint32_t seed) :
+      mAreaCover{flow_mode},
+      mState{sbjgraph},
+      mRandGen{seed}
+    {
+    }
+
+    // マッパー
+    AreaCover mAreaCover;
+
+    // 状態
+    MctState mState;
+
+    // 乱数発生器
+    std::mt19937 mRandGen;
+
+    // このスレッドでの最良値
+    SizeType mMinimumLutNum;
+
+    // このスレッドでの最良解
+    MapRecord mBestRecord;
+
+  };
+
 
 private:
   //////////////////////////////////////////////////////////////////////
   // 内部で用いられる関数
   //////////////////////////////////////////////////////////////////////
 
+  /// @brief 探索を行う．
+  /// @param[in] search_limit 全スレッドの試行回数の合計
+  /// @param[in] seed_list 各スレッドの乱数の種のリスト
+  const MapRecord&
+  search_sub(SizeType search_limit,
+	     const vector<std::uint32_t>& seed_list);
+
+  /// @brief 1つのスレッドの探索を行う．
+  /// @param[in] id スレッド番号
+  /// @param[in] search_limit 全スレッドの試行回数の合計
+  void
+  run_worker(SizeType id,
+	     SizeType search_limit);
+
   /// @brief 評価値の良い子ノードを見つける．
+  /// @param[in] worker 対象のスレッドの状態
+  /// @param[in] node 根のノード
+  ///
+  /// mTreeMutex を獲得した状態で呼ばれる．
+  /// 選ばれた経路上のノードには仮想損失が加えられる．
   MctNode*
-  tree_policy(MctNode* node);
+  tree_policy(Worker& worker,
+	      MctNode* node);
 
-  /// @brief ランダムサンプリングを行って評価値を求める．
-  double
-  default_policy(MctNode* node);
+  /// @brief ランダムサンプリングを行って LUT 数を求める．
+  /// @param[in] worker 対象のスレッドの状態
+  SizeType
+  default_policy(Worker& worker);
 
   /// @brief 評価値の更新を行う．
+  ///
+  /// mTreeMutex を獲得した状態で呼ばれる．
+  /// 経路上のノードの仮想損失も取り除く．
   void
   back_up(MctNode* node,
 	  double val);
@@ -101,11 +192,8 @@ private:
   // ファンアウトポイントの入力サイズのリスト
   vector<SizeType> mInputSizeList;
 
-  // マッパー
-  AreaCover mAreaCover;
-
-  // 状態
-  MctState mState;
+  // area_cover のモード
+  bool mFlowMode;
 
   // 上界
   SizeType mUpperBound;
@@ -119,17 +207,26 @@ private:
   // トータルの試行回数
   SizeType mNumAll;
 
-  // 最良値
+  // 全スレッドを通した最良値
   SizeType mMinimumLutNum;
 
   // 最良解
   MapRecord mBestRecord;
 
+  // 探索木のノードを確保するオブジェクト
+  std::unique_ptr<MctNodePool> mNodePool;
+
   // 根のノード
   MctNode* mRootNode;
 
-  // 乱数発生器
-  std::mt19937 mRandGen;
+  // 探索木を保護する mutex
+  std::mutex mTreeMutex;
+
+  // スレッドごとの状態のリスト
+  vector<std::unique_ptr<Worker>> mWorkerList;
+
+  // 乱数の種
+  SizeType mSeed;
 
   // verbose フラグ
   bool mVerbose;
@@ -141,6 +238,14 @@ private:
 // インライン関数の定義
 //////////////////////////////////////////////////////////////////////
 
+// @brief 乱数の種を設定する．
+inline
+void
+MctSearch::set_seed(SizeType seed)
+{
+  mSeed = seed;
+}
+
 END_NAMESPACE_LUTMAP_MCT2
 
-#endif // MCTSEARCH_H
+#endif // MCT2_MCTSEARCH_H
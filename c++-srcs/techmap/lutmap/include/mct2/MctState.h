@@ -1,5 +1,5 @@
-#ifndef MCTSTATE_H
-#define MCTSTATE_H
+#ifndef MCT2_MCTSTATE_H
+#define MCT2_MCTSTATE_H
 
 /// @file MctState.h
 /// @brief MctState のヘッダファイル
@@ -148,4 +148,4 @@ MctState::next_index()
 
 END_NAMESPACE_LUTMAP_MCT2
 
-#endif // MCTSTATE_H
+#endif // MCT2_MCTSTATE_H
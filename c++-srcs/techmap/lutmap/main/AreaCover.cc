@@ -16,6 +16,13 @@
 
 BEGIN_NAMESPACE_LUTMAP
 
+BEGIN_NONAMESPACE
+
+// 要求段数が設定されていないことを表す値
+const SizeType kNoReq = std::numeric_limits<SizeType>::max();
+
+END_NONAMESPACE
+
 // コンストラクタ
 AreaCover::AreaCover(
   bool fanout_mode
@@ -36,10 +43,56 @@ AreaCover::record_cuts(
   MapRecord& maprec
 )
 {
-  record_cuts(sbjgraph, cut_holder,
-	      {},
-	      {},
-	      maprec);
+  if ( mSlack < 0 ) {
+    record_cuts(sbjgraph, cut_holder,
+		{},
+		{},
+		maprec);
+  }
+  else {
+    // 段数制約がある場合は段数最小の解から始める．
+    record_depth(sbjgraph, cut_holder, maprec);
+  }
+
+  if ( mFlowIter == 0 && mExactIter == 0 ) {
+    return;
+  }
+
+  SizeType n = sbjgraph.node_num();
+  mArrival.clear();
+  mArrival.resize(n, 0);
+  mReqTime.clear();
+  mReqTime.resize(n, kNoReq);
+  mRefCount.clear();
+  mRefCount.resize(n, 0);
+
+  // ファンアウト数の見積もり値の初期値は実際のファンアウト数
+  mEstRefs.clear();
+  mEstRefs.resize(n, 1.0);
+  for ( auto node: sbjgraph.logic_list() ) {
+    mEstRefs[node->id()] = std::max(1.0, static_cast<double>(node->fanout_num()));
+  }
+  for ( auto node: sbjgraph.input_list() ) {
+    mEstRefs[node->id()] = std::max(1.0, static_cast<double>(node->fanout_num()));
+  }
+
+  for ( SizeType i = 0; i < mFlowIter; ++ i ) {
+    calc_refs(sbjgraph, maprec);
+    calc_req(sbjgraph, maprec);
+    // 前回の見積もりと今回の参照回数を混ぜて見積もり値を更新する．
+    for ( auto node: sbjgraph.logic_list() ) {
+      auto id = node->id();
+      double refs = std::max(1.0, static_cast<double>(mRefCount[id]));
+      mEstRefs[id] = (mEstRefs[id] + 2.0 * refs) / 3.0;
+    }
+    flow_recovery(sbjgraph, cut_holder, maprec);
+  }
+
+  for ( SizeType i = 0; i < mExactIter; ++ i ) {
+    calc_refs(sbjgraph, maprec);
+    calc_req(sbjgraph, maprec);
+    exact_recovery(sbjgraph, cut_holder, maprec);
+  }
 }
 
 // @brief best cut の記録を行う．
@@ -102,75 +155,217 @@ AreaCover::record_cuts(
   for ( SizeType i = 0; i < nl; ++ i ) {
     auto node = sbjgraph.logic(i);
 
-    double min_cost = DBL_MAX;
-    const Cut* best_cut = nullptr;
-    for ( auto cut: cut_holder.cut_list(node) ) {
-      SizeType ni = cut->input_num();
-      bool ng = false;
-      for ( SizeType i = 0; i < ni; ++ i ) {
+    double min_cost;
+    const Cut* best_cut;
+    eval_node(node, cut_holder, min_cost, best_cut);
+    ASSERT_COND( min_cost != DBL_MAX );
+    maprec.set_cut(node, best_cut);
+    mBestCost[node->id()] = min_cost;
+  }
+}
+
+// @brief 論理ノードの最良カットを求める．
+void
+AreaCover::eval_node(
+  const SbjNode* node,
+  const CutHolder& cut_holder,
+  double& min_cost,
+  const Cut*& best_cut
+)
+{
+  min_cost = DBL_MAX;
+  best_cut = nullptr;
+  for ( auto cut: cut_holder.cut_list(node) ) {
+    SizeType ni = cut->input_num();
+    bool ng = false;
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto inode = cut->input(i);
+      if ( mBestCost[inode->id()] == DBL_MAX ) {
+	ng = true;
+	break;
+      }
+    }
+    if ( ng ) continue;
+
+    if ( fanout_mode() ) {
+      // ファンアウトモード
+      for ( SizeType i = 0; i < ni; ++ i)  {
 	auto inode = cut->input(i);
-	if ( mBestCost[inode->id()] == DBL_MAX ) {
-	  ng = true;
+	switch ( mBoundaryMark[inode->id()] ) {
+	case 0:
+	  mWeight[i] = 1.0 / inode->fanout_num();
+	  break;
+
+	case 1:
+	  mWeight[i] = 0.0;
+	  break;
+
+	case 2:
+	  mWeight[i] = 1.0;
 	  break;
 	}
       }
-      if ( ng ) continue;
-
-      if ( fanout_mode() ) {
-	// ファンアウトモード
-	for ( SizeType i = 0; i < ni; ++ i)  {
-	  auto inode = cut->input(i);
-	  switch ( mBoundaryMark[inode->id()] ) {
-	  case 0:
-	    mWeight[i] = 1.0 / inode->fanout_num();
-	    break;
-
-	  case 1:
-	    mWeight[i] = 0.0;
-	    break;
-
-	  case 2:
-	    mWeight[i] = 1.0;
-	    break;
-	  }
-	}
+    }
+    else {
+      // フローモード
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	mWeight[i] = 0.0;
       }
-      else {
-	// フローモード
-	for ( SizeType i = 0; i < ni; ++ i ) {
+      calc_weight(node, cut, 1.0);
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	auto inode = cut->input(i);
+	switch ( mBoundaryMark[inode->id()] ) {
+	case 0:
+	  break;
+
+	case 1:
 	  mWeight[i] = 0.0;
-	}
-	calc_weight(node, cut, 1.0);
-	for ( SizeType i = 0; i < ni; ++ i ) {
-	  auto inode = cut->input(i);
-	  switch ( mBoundaryMark[inode->id()] ) {
-	  case 0:
-	    break;
-
-	  case 1:
-	    mWeight[i] = 0.0;
-	    break;
-
-	  case 2:
-	    mWeight[i] = 1.0;
-	    break;
-	  }
+	  break;
+
+	case 2:
+	  mWeight[i] = 1.0;
+	  break;
 	}
       }
+    }
 
-      double cur_cost = 1.0;
-      for ( SizeType i = 0; i < ni; ++ i ) {
-	auto inode = cut->input(i);
-	cur_cost += mBestCost[inode->id()] * mWeight[i];
-      }
-      if ( min_cost > cur_cost ) {
-	min_cost = cur_cost;
-	best_cut = cut;
+    double cur_cost = 1.0;
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto inode = cut->input(i);
+      cur_cost += mBestCost[inode->id()] * mWeight[i];
+    }
+    if ( min_cost > cur_cost ) {
+      min_cost = cur_cost;
+      best_cut = cut;
+    }
+  }
+}
+
+// @brief 差分更新用の初期化を行う．
+void
+AreaCover::init_incr(
+  const SbjGraph& sbjgraph,
+  const CutHolder& cut_holder,
+  const vector<const SbjNode*>& boundary_list,
+  MapRecord& maprec
+)
+{
+  record_cuts(sbjgraph, cut_holder, boundary_list, {}, maprec);
+
+  mIncrGraph = &sbjgraph;
+  mIncrCutHolder = &cut_holder;
+  mIncrRecord = &maprec;
+
+  SizeType n = sbjgraph.node_num();
+  mLogicPosArray.clear();
+  mLogicPosArray.resize(n, 0);
+  mLeafFanoutArray.clear();
+  mLeafFanoutArray.resize(n);
+  SizeType nl = sbjgraph.logic_num();
+  for ( SizeType i = 0; i < nl; ++ i ) {
+    auto node = sbjgraph.logic(i);
+    mLogicPosArray[node->id()] = i;
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      SizeType ni = cut->input_num();
+      for ( SizeType j = 0; j < ni; ++ j ) {
+	auto& fo_list = mLeafFanoutArray[cut->input(j)->id()];
+	// 同じ根のカットは続けて現れるので末尾だけ調べればよい．
+	if ( fo_list.empty() || fo_list.back() != node ) {
+	  fo_list.push_back(node);
+	}
       }
     }
+  }
+
+  mQueue.clear();
+  mInQueue.clear();
+  mInQueue.resize(n, false);
+  mFlipNode = nullptr;
+  mChangeList.clear();
+  mChangedNodeList.clear();
+}
+
+// @brief 境界ノードかどうかを反転させて解を差分更新する．
+void
+AreaCover::flip_boundary(
+  const SbjNode* node
+)
+{
+  ASSERT_COND( mIncrRecord != nullptr );
+
+  mFlipNode = node;
+  mChangeList.clear();
+  mChangedNodeList.clear();
+
+  auto& mark = mBoundaryMark[node->id()];
+  mark = (mark == 1) ? 0 : 1;
+
+  // node をカットの入力とするノードから始めて，
+  // コストの変わったノードをカットの入力とするノードを
+  // トポロジカル順に処理する．
+  put_leaf_fanouts(node);
+  while ( !mQueue.empty() ) {
+    std::pop_heap(mQueue.begin(), mQueue.end(), std::greater<SizeType>{});
+    auto pos = mQueue.back();
+    mQueue.pop_back();
+    auto node1 = mIncrGraph->logic(pos);
+    auto id = node1->id();
+    mInQueue[id] = false;
+
+    double min_cost;
+    const Cut* best_cut;
+    eval_node(node1, *mIncrCutHolder, min_cost, best_cut);
     ASSERT_COND( min_cost != DBL_MAX );
-    maprec.set_cut(node, best_cut);
-    mBestCost[node->id()] = min_cost;
+    double old_cost = mBestCost[id];
+    auto old_cut = mIncrRecord->get_cut(node1);
+    if ( min_cost == old_cost && best_cut == old_cut ) {
+      continue;
+    }
+    mChangeList.push_back(Change{node1, old_cost, old_cut});
+    mBestCost[id] = min_cost;
+    if ( best_cut != old_cut ) {
+      mIncrRecord->set_cut(node1, best_cut);
+      mChangedNodeList.push_back(node1);
+    }
+    if ( min_cost != old_cost ) {
+      put_leaf_fanouts(node1);
+    }
+  }
+}
+
+// @brief 直前の flip_boundary() を取り消す．
+void
+AreaCover::undo()
+{
+  if ( mFlipNode == nullptr ) {
+    return;
+  }
+
+  for ( SizeType i = mChangeList.size(); i -- > 0; ) {
+    auto& change = mChangeList[i];
+    mBestCost[change.mNode->id()] = change.mCost;
+    mIncrRecord->set_cut(change.mNode, change.mCut);
+  }
+  mChangeList.clear();
+
+  auto& mark = mBoundaryMark[mFlipNode->id()];
+  mark = (mark == 1) ? 0 : 1;
+  mFlipNode = nullptr;
+}
+
+// @brief node をカットの入力とするノードをキューに積む．
+void
+AreaCover::put_leaf_fanouts(
+  const SbjNode* node
+)
+{
+  for ( auto onode: mLeafFanoutArray[node->id()] ) {
+    auto id = onode->id();
+    if ( !mInQueue[id] ) {
+      mInQueue[id] = true;
+      mQueue.push_back(mLogicPosArray[id]);
+      std::push_heap(mQueue.begin(), mQueue.end(), std::greater<SizeType>{});
+    }
   }
 }
 
@@ -200,4 +395,290 @@ AreaCover::calc_weight(
   }
 }
 
+// @brief 段数最小の解を求める．
+void
+AreaCover::record_depth(
+  const SbjGraph& sbjgraph,
+  const CutHolder& cut_holder,
+  MapRecord& maprec
+)
+{
+  SizeType n = sbjgraph.node_num();
+  mArrival.clear();
+  mArrival.resize(n, 0);
+  mBestCost.clear();
+  mBestCost.resize(n, 0.0);
+
+  maprec.init(sbjgraph);
+  for ( auto node: sbjgraph.input_list() ) {
+    maprec.set_cut(node, nullptr);
+  }
+
+  for ( auto node: sbjgraph.logic_list() ) {
+    SizeType min_depth = kNoReq;
+    double min_cost = DBL_MAX;
+    const Cut* best_cut = nullptr;
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      SizeType depth = cut_arrival(cut);
+      double cost = 1.0;
+      SizeType ni = cut->input_num();
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	auto inode = cut->input(i);
+	SizeType nfo = std::max(inode->fanout_num(), static_cast<SizeType>(1));
+	cost += mBestCost[inode->id()] / nfo;
+      }
+      if ( min_depth > depth || (min_depth == depth && min_cost > cost) ) {
+	min_depth = depth;
+	min_cost = cost;
+	best_cut = cut;
+      }
+    }
+    ASSERT_COND( best_cut != nullptr );
+    maprec.set_cut(node, best_cut);
+    mArrival[node->id()] = min_depth;
+    mBestCost[node->id()] = min_cost;
+  }
+
+  // 出力の最大段数に slack を足したものを段数の上限とする．
+  SizeType max_depth = 0;
+  for ( auto onode: sbjgraph.output_list() ) {
+    auto inode = onode->output_fanin();
+    if ( inode != nullptr ) {
+      max_depth = std::max(max_depth, mArrival[inode->id()]);
+    }
+  }
+  mReqDepth = max_depth + mSlack;
+}
+
+// @brief area flow による面積回復を行う．
+void
+AreaCover::flow_recovery(
+  const SbjGraph& sbjgraph,
+  const CutHolder& cut_holder,
+  MapRecord& maprec
+)
+{
+  SizeType n = sbjgraph.node_num();
+  mBestCost.clear();
+  mBestCost.resize(n, 0.0);
+
+  for ( auto node: sbjgraph.input_list() ) {
+    mArrival[node->id()] = 0;
+  }
+
+  for ( auto node: sbjgraph.logic_list() ) {
+    auto req = mReqTime[node->id()];
+    double min_cost = DBL_MAX;
+    SizeType min_depth = kNoReq;
+    const Cut* best_cut = nullptr;
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      SizeType depth = cut_arrival(cut);
+      if ( depth > req ) {
+	continue;
+      }
+      double cost = 1.0;
+      SizeType ni = cut->input_num();
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	auto inode = cut->input(i);
+	cost += mBestCost[inode->id()] / mEstRefs[inode->id()];
+      }
+      if ( min_cost > cost || (min_cost == cost && min_depth > depth) ) {
+	min_cost = cost;
+	min_depth = depth;
+	best_cut = cut;
+      }
+    }
+    // 直前の解のカットは必ず要求段数を満たしている．
+    ASSERT_COND( best_cut != nullptr );
+    maprec.set_cut(node, best_cut);
+    mArrival[node->id()] = min_depth;
+    mBestCost[node->id()] = min_cost;
+  }
+}
+
+// @brief exact area による面積回復を行う．
+void
+AreaCover::exact_recovery(
+  const SbjGraph& sbjgraph,
+  const CutHolder& cut_holder,
+  MapRecord& maprec
+)
+{
+  for ( auto node: sbjgraph.input_list() ) {
+    mArrival[node->id()] = 0;
+  }
+
+  for ( auto node: sbjgraph.logic_list() ) {
+    auto id = node->id();
+    auto req = mReqTime[id];
+
+    // 現在の解で使われているノードの場合，一旦参照を解除する．
+    bool mapped = mRefCount[id] > 0;
+    if ( mapped ) {
+      cut_deref(maprec.get_cut(node), maprec);
+    }
+
+    SizeType min_area = kNoReq;
+    SizeType min_depth = kNoReq;
+    const Cut* best_cut = nullptr;
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      SizeType depth = cut_arrival(cut);
+      if ( depth > req ) {
+	continue;
+      }
+      // 参照してから解除することで MFFC のサイズを求める．
+      SizeType area = cut_ref(cut, maprec);
+      cut_deref(cut, maprec);
+      if ( min_area > area || (min_area == area && min_depth > depth) ) {
+	min_area = area;
+	min_depth = depth;
+	best_cut = cut;
+      }
+    }
+    ASSERT_COND( best_cut != nullptr );
+    maprec.set_cut(node, best_cut);
+    mArrival[id] = min_depth;
+
+    if ( mapped ) {
+      cut_ref(best_cut, maprec);
+    }
+  }
+}
+
+// @brief 現在の解の各ノードの参照回数を求める．
+void
+AreaCover::calc_refs(
+  const SbjGraph& sbjgraph,
+  const MapRecord& maprec
+)
+{
+  std::fill(mRefCount.begin(), mRefCount.end(), 0);
+  for ( auto onode: sbjgraph.output_list() ) {
+    auto inode = onode->output_fanin();
+    if ( inode == nullptr || !inode->is_logic() ) {
+      continue;
+    }
+    if ( mRefCount[inode->id()] == 0 ) {
+      cut_ref(maprec.get_cut(inode), maprec);
+    }
+    ++ mRefCount[inode->id()];
+  }
+}
+
+// @brief 現在の解から各ノードの要求段数を求める．
+void
+AreaCover::calc_req(
+  const SbjGraph& sbjgraph,
+  const MapRecord& maprec
+)
+{
+  std::fill(mReqTime.begin(), mReqTime.end(), kNoReq);
+  if ( mSlack < 0 ) {
+    return;
+  }
+
+  for ( auto onode: sbjgraph.output_list() ) {
+    auto inode = onode->output_fanin();
+    if ( inode != nullptr ) {
+      mReqTime[inode->id()] = mReqDepth;
+    }
+  }
+
+  // 出力側から解に含まれるノードの要求段数を伝搬する．
+  SizeType nl = sbjgraph.logic_num();
+  for ( SizeType i = nl; i -- > 0; ) {
+    auto node = sbjgraph.logic(i);
+    auto req = mReqTime[node->id()];
+    if ( req == kNoReq ) {
+      continue;
+    }
+    ASSERT_COND( req > 0 );
+    auto cut = maprec.get_cut(node);
+    SizeType ni = cut->input_num();
+    for ( SizeType j = 0; j < ni; ++ j ) {
+      auto id = cut->input(j)->id();
+      mReqTime[id] = std::min(mReqTime[id], req - 1);
+    }
+  }
+}
+
+// @brief カットの到着段数を求める．
+SizeType
+AreaCover::cut_arrival(
+  const Cut* cut
+) const
+{
+  SizeType depth = 0;
+  SizeType ni = cut->input_num();
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    depth = std::max(depth, mArrival[cut->input(i)->id()]);
+  }
+  return depth + 1;
+}
+
+// @brief カットを参照する．
+//
+// 参照回数が 0 から 1 になったノードのカットをスタックに積んで
+// その入力を順に参照する．
+SizeType
+AreaCover::cut_ref(
+  const Cut* cut,
+  const MapRecord& maprec
+)
+{
+  SizeType area = 0;
+  mCutStack.clear();
+  mCutStack.push_back(cut);
+  while ( !mCutStack.empty() ) {
+    auto cut1 = mCutStack.back();
+    mCutStack.pop_back();
+    ++ area;
+    SizeType ni = cut1->input_num();
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto inode = cut1->input(i);
+      if ( !inode->is_logic() ) {
+	continue;
+      }
+      if ( mRefCount[inode->id()] == 0 ) {
+	mCutStack.push_back(maprec.get_cut(inode));
+      }
+      ++ mRefCount[inode->id()];
+    }
+  }
+  return area;
+}
+
+// @brief カットの参照を解除する．
+//
+// 参照回数が 0 になったノードのカットをスタックに積んで
+// その入力の参照を順に解除する．
+SizeType
+AreaCover::cut_deref(
+  const Cut* cut,
+  const MapRecord& maprec
+)
+{
+  SizeType area = 0;
+  mCutStack.clear();
+  mCutStack.push_back(cut);
+  while ( !mCutStack.empty() ) {
+    auto cut1 = mCutStack.back();
+    mCutStack.pop_back();
+    ++ area;
+    SizeType ni = cut1->input_num();
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      auto inode = cut1->input(i);
+      if ( !inode->is_logic() ) {
+	continue;
+      }
+      ASSERT_COND( mRefCount[inode->id()] > 0 );
+      -- mRefCount[inode->id()];
+      if ( mRefCount[inode->id()] == 0 ) {
+	mCutStack.push_back(maprec.get_cut(inode));
+      }
+    }
+  }
+  return area;
+}
+
 END_NAMESPACE_LUTMAP
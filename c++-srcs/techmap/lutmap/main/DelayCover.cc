@@ -28,6 +28,26 @@ DelayCover::~DelayCover()
 {
 }
 
+// @brief 遅延モデルを設定する．
+void
+DelayCover::set_delay_model(
+  const DelayModel& model
+)
+{
+  mDelayModel = model;
+}
+
+// @brief 各ノードのコストリストの上限を設定する．
+void
+DelayCover::set_cost_limit(
+  SizeType max_num,
+  double epsilon
+)
+{
+  mMaxCostNum = max_num;
+  mCostEpsilon = epsilon;
+}
+
 // @brief best cut の記録を行う．
 void
 DelayCover::record_cuts(
@@ -41,6 +61,10 @@ DelayCover::record_cuts(
   maprec.init(sbjgraph);
 
   // 作業領域の初期化
+  // 前回のコストは mCostMgr に戻して再利用する．
+  for ( auto& t: mNodeInfo ) {
+    t.mCostList.clear();
+  }
   mNodeInfo.clear();
   mNodeInfo.resize(n);
   for ( int i = 0; i < n; ++ i ) {
@@ -48,6 +72,8 @@ DelayCover::record_cuts(
   }
   SizeType limit = cut_holder.limit();
   mWeight.resize(limit);
+  mEdgeDelay.resize(limit);
+  mLevelList.resize(limit);
   mIcostLists.resize(limit);
   mIcostListEnds.resize(limit);
 
@@ -60,14 +86,54 @@ DelayCover::record_cuts(
     t.mMinDepth = 0;
   }
 
-  // 各ノードごとにカットを記録
+  // 各ノードのコストリストを最後に参照する論理ノードの位置を求めて
+  // その位置ごとに解放するノードをまとめておく．
   int nl = sbjgraph.logic_num();
+  if ( nl == 0 ) {
+    // 論理ノードがなければ選ぶカットもない．
+    return;
+  }
+  vector<SizeType> last_pos(n, 0);
+  for ( int i = 0; i < nl; ++ i ) {
+    last_pos[sbjgraph.logic(i)->id()] = i;
+  }
+  for ( int i = 0; i < nl; ++ i ) {
+    auto node = sbjgraph.logic(i);
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      for ( int j = 0; j < cut->input_num(); ++ j ) {
+	last_pos[cut->input(j)->id()] = i;
+      }
+    }
+  }
+  mReleaseBegin.clear();
+  mReleaseBegin.resize(nl + 1, 0);
+  for ( SizeType id = 0; id < n; ++ id ) {
+    ++ mReleaseBegin[last_pos[id] + 1];
+  }
+  for ( int i = 0; i < nl; ++ i ) {
+    mReleaseBegin[i + 1] += mReleaseBegin[i];
+  }
+  mReleaseList.resize(n);
+  {
+    vector<SizeType> wpos(mReleaseBegin.begin(), mReleaseBegin.end() - 1);
+    for ( SizeType id = 0; id < n; ++ id ) {
+      mReleaseList[wpos[last_pos[id]]] = id;
+      ++ wpos[last_pos[id]];
+    }
+  }
+  mSelTable.clear();
+
+  // 各ノードごとにカットを記録
+  // 以降で参照されないコストリストはその都度解放する．
   for ( int i = 0; i < nl; ++ i ) {
     const SbjNode* node = sbjgraph.logic(i);
     record(node, cut_holder);
+    for ( SizeType k = mReleaseBegin[i]; k < mReleaseBegin[i + 1]; ++ k ) {
+      release(mReleaseList[k]);
+    }
   }
 
-  // 最小段数の最大値をもとめる．
+  // 最小到着時刻の最大値をもとめる．
   SizeType no = sbjgraph.output_num();
   vector<const SbjNode*> onode_list;
   onode_list.reserve(no);
@@ -86,13 +152,13 @@ DelayCover::record_cuts(
     }
   }
 
-  // それに slack を足したものが制約となる．
+  // それに slack を足したものが要求時刻となる．
   min_depth += mSlack;
   for ( auto node: onode_list ) {
     mNodeInfo[node->id()].mReqDepth = min_depth;
   }
 
-  // 要求された段数制約を満たす中でコスト最小の解を選ぶ．
+  // 要求時刻を満たす中でコスト最小の解を選ぶ．
   for ( int i = 0; i < nl; ++ i ) {
     auto node = sbjgraph.logic(nl - i - 1);
     select(node, maprec);
@@ -126,26 +192,28 @@ DelayCover::record(
       calc_weight(node, cut, 1.0);
     }
 
-    SizeType max_input_depth = 0;
+    // 各入力から根までの遅延はカットごとに一度だけ求めておく．
+    calc_edge_delay(cut);
+    SizeType cur_depth = 0;
     for ( int i = 0; i < ni; ++ i ) {
       auto inode = cut->input(i);
       auto& u = mNodeInfo[inode->id()];
-      if ( max_input_depth < u.mMinDepth ) {
-	max_input_depth = u.mMinDepth;
+      SizeType arrival = u.mMinDepth + mEdgeDelay[i];
+      if ( cur_depth < arrival ) {
+	cur_depth = arrival;
       }
       mIcostLists[i] = u.mCostList.begin();
       mIcostListEnds[i] = u.mCostList.end();
     }
 
-    SizeType cur_depth = max_input_depth + 1;
     if ( min_depth > cur_depth ) {
       min_depth = cur_depth;
     }
 
     // mIcostLists から解を作る．
     for ( ; ; ) {
-      // 各入力のなかでもっとも深い値を求める．
-      SizeType idepth = 0;
+      // 各入力を経由した到着時刻の最大値を求める．
+      SizeType depth = 0;
       double area = 1.0;
       bool empty = false;
       for ( int i = 0; i < ni; ++ i ) {
@@ -154,29 +222,47 @@ DelayCover::record(
 	  break;
 	}
 	auto cost = *mIcostLists[i];
-	if ( idepth < cost->depth() ) {
-	  idepth = cost->depth();
+	SizeType arrival = cost->depth() + mEdgeDelay[i];
+	if ( depth < arrival ) {
+	  depth = arrival;
 	}
 	area += cost->area() * mWeight[i];
       }
       if ( empty ) {
 	break;
       }
-      SizeType depth = idepth + 1;
 
       // (depth, area) を登録
       t.mCostList.insert(cut, depth, area);
 
-      // 深さが idepth に等しい解を次に進める．
+      // 到着時刻を決めている入力の解を次に進める．
       for ( int i = 0; i < ni; ++ i ) {
 	auto cost = *mIcostLists[i];
-	if ( cost->depth() == idepth ) {
+	if ( cost->depth() + mEdgeDelay[i] == depth ) {
 	  ++ mIcostLists[i];
 	}
       }
     }
   }
   t.mMinDepth = min_depth;
+
+  // ファンアウトで組み合わせる前に間引いておく．
+  t.mCostList.prune(mMaxCostNum, mCostEpsilon);
+}
+
+// ノードのコストリストを mSelTable に写して解放する．
+void
+DelayCover::release(
+  SizeType id
+)
+{
+  auto& t = mNodeInfo[id];
+  t.mSelBegin = mSelTable.size();
+  for ( auto cost: t.mCostList ) {
+    mSelTable.push_back(make_pair(cost->depth(), cost->cut()));
+  }
+  t.mSelEnd = mSelTable.size();
+  t.mCostList.clear();
 }
 
 // node から各入力にいたる経路の重みを計算する．
@@ -203,6 +289,23 @@ DelayCover::calc_weight(
   }
 }
 
+// カットの各入力から根までの遅延を mEdgeDelay に求める．
+void
+DelayCover::calc_edge_delay(
+  const Cut* cut
+)
+{
+  SizeType ni = cut->input_num();
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    auto inode = cut->input(i);
+    mLevelList[i] = mNodeInfo[inode->id()].mMinDepth;
+  }
+  mDelayModel.assign_pins(cut, mLevelList, mPinList);
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    mEdgeDelay[i] = mDelayModel.edge_delay(cut, i, mPinList[i]);
+  }
+}
+
 // node のカットを選択する．
 void
 DelayCover::select(
@@ -218,20 +321,22 @@ DelayCover::select(
   }
 
   const Cut* cut = nullptr;
-  for ( auto cost: t.mCostList ) {
-    if ( cost->depth() <= rd ) {
-      cut = cost->cut();
+  for ( SizeType k = t.mSelBegin; k < t.mSelEnd; ++ k ) {
+    auto& p = mSelTable[k];
+    if ( p.first <= rd ) {
+      cut = p.second;
       break;
     }
   }
   ASSERT_COND( cut );
   maprec.set_cut(node, cut);
-  -- rd;
+  calc_edge_delay(cut);
   for ( int i = 0; i < cut->input_num(); ++ i ) {
     auto inode = cut->input(i);
     auto& u = mNodeInfo[inode->id()];
-    if ( u.mReqDepth == 0 || u.mReqDepth > rd ) {
-      u.mReqDepth = rd;
+    int rd1 = static_cast<int>(rd - mEdgeDelay[i]);
+    if ( u.mReqDepth == 0 || u.mReqDepth > rd1 ) {
+      u.mReqDepth = rd1;
     }
   }
 }
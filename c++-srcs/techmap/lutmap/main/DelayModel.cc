@@ -0,0 +1,114 @@
+
+/// @file DelayModel.cc
+/// @brief DelayModel の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "DelayModel.h"
+#include "Cut.h"
+#include "SbjNode.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+//////////////////////////////////////////////////////////////////////
+// クラス DelayModel
+//////////////////////////////////////////////////////////////////////
+
+// @brief LUT のピン遅延を設定する．
+void
+DelayModel::set_pin_delay(
+  SizeType lut_size,
+  const vector<SizeType>& delay_list
+)
+{
+  ASSERT_COND( delay_list.size() == lut_size );
+  for ( auto delay: delay_list ) {
+    ASSERT_COND( delay >= 1 );
+  }
+
+  if ( mPinDelayTable.size() <= lut_size ) {
+    mPinDelayTable.resize(lut_size + 1);
+    mPinOrderTable.resize(lut_size + 1);
+  }
+  mPinDelayTable[lut_size] = delay_list;
+
+  auto& pin_order = mPinOrderTable[lut_size];
+  pin_order.resize(lut_size);
+  for ( SizeType i = 0; i < lut_size; ++ i ) {
+    pin_order[i] = i;
+  }
+  std::stable_sort(pin_order.begin(), pin_order.end(),
+		   [&](SizeType a, SizeType b) {
+		     return delay_list[a] < delay_list[b];
+		   });
+}
+
+// @brief 配線遅延を設定する．
+void
+DelayModel::set_wire_delay(
+  SizeType base,
+  SizeType per_fanout
+)
+{
+  mWireBase = base;
+  mWirePerFanout = per_fanout;
+}
+
+// @brief カットの入力を LUT のピンに割り当てる．
+void
+DelayModel::assign_pins(
+  const Cut* cut,
+  const vector<SizeType>& level_list,
+  vector<SizeType>& pin_list
+) const
+{
+  SizeType ni = cut->input_num();
+  ASSERT_COND( level_list.size() >= ni );
+
+  pin_list.resize(ni);
+  if ( mPinDelayTable.empty() ) {
+    // 単位遅延ならどのピンでも同じ．
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      pin_list[i] = i;
+    }
+    return;
+  }
+
+  ASSERT_COND( ni < mPinOrderTable.size() );
+  auto& pin_order = mPinOrderTable[ni];
+  ASSERT_COND( pin_order.size() == ni );
+
+  // 到着時刻の遅い順に入力を並べる．
+  mTmpArrival.resize(ni);
+  mTmpOrder.resize(ni);
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    auto inode = cut->input(i);
+    mTmpArrival[i] = level_list[i] + wire_delay(inode->fanout_num());
+    mTmpOrder[i] = i;
+  }
+  std::stable_sort(mTmpOrder.begin(), mTmpOrder.end(),
+		   [&](SizeType a, SizeType b) {
+		     return mTmpArrival[a] > mTmpArrival[b];
+		   });
+  for ( SizeType k = 0; k < ni; ++ k ) {
+    pin_list[mTmpOrder[k]] = pin_order[k];
+  }
+}
+
+// @brief カットの入力から根までの遅延を返す．
+SizeType
+DelayModel::edge_delay(
+  const Cut* cut,
+  SizeType pos,
+  SizeType pin
+) const
+{
+  auto inode = cut->input(pos);
+  return pin_delay(cut->input_num(), pin) + wire_delay(inode->fanout_num());
+}
+
+END_NAMESPACE_LUTMAP
@@ -11,15 +11,119 @@
 #include "SbjGraph.h"
 #include "AreaCover.h"
 #include "DelayCover.h"
+#include "DelayModel.h"
 #include "CutHolder.h"
 #include "CutResub.h"
 #include "MapGen.h"
 #include "MapRecord.h"
-#include "ym/OptionParser.h"
+#include "SaSearch.h"
+#include "mct2/MctSearch.h"
+#include <random>
+#include <stdexcept>
 
 
 BEGIN_NAMESPACE_MAGUS
 
+BEGIN_NONAMESPACE
+
+// オプション文字列を (キー, 値) のリストに分解する．
+//
+// オプション文字列は "key[=value]" を ',' で区切ったもの．
+// 値が省略された時は空文字列となる．
+vector<pair<string, string>>
+parse_option(
+  const string& option
+)
+{
+  vector<pair<string, string>> opt_list;
+  SizeType start = 0;
+  while ( start < option.size() ) {
+    auto end = option.find(',', start);
+    if ( end == string::npos ) {
+      end = option.size();
+    }
+    auto opt = option.substr(start, end - start);
+    start = end + 1;
+    if ( opt == string() ) {
+      continue;
+    }
+    auto p = opt.find('=');
+    if ( p == string::npos ) {
+      opt_list.push_back(make_pair(opt, string()));
+    }
+    else {
+      opt_list.push_back(make_pair(opt.substr(0, p), opt.substr(p + 1)));
+    }
+  }
+  return opt_list;
+}
+
+// オプションの値を非負の整数として読み込む．
+//
+// 空文字列や数字以外の文字を含む場合は std::invalid_argument を送出する．
+SizeType
+parse_num(
+  const string& key,
+  const string& val
+)
+{
+  // 桁あふれを防ぐための上限
+  const SizeType kMaxNum = 1U << 30;
+
+  if ( val == string() ) {
+    throw std::invalid_argument{"LutmapMgr: '" + key + "' requires a value"};
+  }
+  SizeType num = 0;
+  for ( auto c: val ) {
+    if ( c < '0' || c > '9' ) {
+      throw std::invalid_argument{"LutmapMgr: '" + key + "=" + val
+				  + "' is not a non-negative integer"};
+    }
+    num = num * 10 + (c - '0');
+    if ( num > kMaxNum ) {
+      throw std::invalid_argument{"LutmapMgr: '" + key + "=" + val
+				  + "' is too large"};
+    }
+  }
+  return num;
+}
+
+// ':' で区切られた非負の整数のリストを分解する．
+//
+// 空文字列や空の要素，数字以外の文字を含む場合は std::invalid_argument を送出する．
+vector<SizeType>
+parse_num_list(
+  const string& key,
+  const string& val
+)
+{
+  if ( val == string() ) {
+    throw std::invalid_argument{"LutmapMgr: '" + key + "' requires a value"};
+  }
+  vector<SizeType> num_list;
+  SizeType start = 0;
+  for ( ; ; ) {
+    auto end = val.find(':', start);
+    if ( end == string::npos ) {
+      end = val.size();
+    }
+    auto str = val.substr(start, end - start);
+    if ( str == string() ) {
+      throw std::invalid_argument{"LutmapMgr: '" + key + "=" + val
+				  + "' has an empty element"};
+    }
+    num_list.push_back(parse_num(key, str));
+    if ( end == val.size() ) {
+      break;
+    }
+    start = end + 1;
+  }
+  return num_list;
+}
+
+END_NONAMESPACE
+
+
 //////////////////////////////////////////////////////////////////////
 // クラス LutmapMgr
 //////////////////////////////////////////////////////////////////////
@@ -29,8 +133,27 @@ LutmapMgr::LutmapMgr(
   SizeType lut_size,
   const string& option
 ) : mLutSize{lut_size},
+    mStrash{false},
     mFanoutMode{false},
-    mDoCutResub{false}
+    mDoCutResub{false},
+    mCutNum{0},
+    mCutThreadNum{1},
+    mFlowIter{0},
+    mExactIter{0},
+    mSaCount{100},
+    mSaChainNum{1},
+    mSaExchange{false},
+    mMctCount{1000},
+    mMctThreadNum{1},
+    mSeed{std::mt19937::default_seed},
+    mWireBase{0},
+    mWirePerFanout{0},
+    mCostLimit{0},
+    mCostEpsilon{0},
+    mLutNum{0},
+    mDepth{0},
+    mPeakCutNum{0},
+    mCutBytesUsed{0}
 {
   set_option(option);
 }
@@ -49,21 +172,55 @@ LutmapMgr::area_map(
   using namespace nsLutmap;
 
   SbjGraph sbjgraph;
-  Bn2Sbj bn2sbj;
+  Bn2Sbj bn2sbj{mStrash};
   bn2sbj.convert(src_network, sbjgraph);
 
   // カットを列挙する．
   CutHolder cut_holder;
-  cut_holder.enum_cut(sbjgraph, mLutSize);
+  if ( mCutNum > 0 ) {
+    cut_holder.enum_priority_cut(sbjgraph, mLutSize, mCutNum);
+  }
+  else if ( mCutThreadNum != 1 ) {
+    cut_holder.enum_cut_mt(sbjgraph, mLutSize, mCutThreadNum);
+  }
+  else {
+    cut_holder.enum_cut(sbjgraph, mLutSize);
+  }
+  mPeakCutNum = cut_holder.peak_cut_num();
+  mCutBytesUsed = cut_holder.bytes_used();
 
   int slack = -1;
 
   // 最良カットを記録する．
   MapRecord maprec;
 
-  // 本当は mAlgorithm に応じた処理を行う．
-  AreaCover area_cover(mFanoutMode);
-  area_cover.record_cuts(sbjgraph, cut_holder, maprec);
+  if ( mAlgorithm == string("sa") ) {
+    // 焼きなまし法で境界ノードを探索する．
+    SaSearch sa{sbjgraph, cut_holder, mLutSize, mFanoutMode};
+    sa.set_seed(mSeed);
+    if ( mSaChainNum > 1 ) {
+      maprec = sa.search_mt(mSaCount, mSaChainNum, mSaExchange, false);
+    }
+    else {
+      maprec = sa.search(mSaCount, false);
+    }
+  }
+  else if ( mAlgorithm == string("mct") ) {
+    // モンテカルロ木探索で境界ノードを探索する．
+    nsMct2::MctSearch mct{sbjgraph, cut_holder, mLutSize, mFanoutMode};
+    mct.set_seed(mSeed);
+    if ( mMctThreadNum > 1 ) {
+      maprec = mct.search_mt(mMctCount, mMctThreadNum, false);
+    }
+    else {
+      maprec = mct.search(mMctCount, false);
+    }
+  }
+  else {
+    AreaCover area_cover(mFanoutMode);
+    area_cover.set_recovery(mFlowIter, mExactIter, slack);
+    area_cover.record_cuts(sbjgraph, cut_holder, maprec);
+  }
 
   if ( mDoCutResub ) {
     // cut resubstituion
@@ -86,28 +243,55 @@ LutmapMgr::delay_map(
   using namespace nsLutmap;
 
   SbjGraph sbjgraph;
-  Bn2Sbj bn2sbj;
+  Bn2Sbj bn2sbj{mStrash};
   bn2sbj.convert(src_network, sbjgraph);
 
   // カットを列挙する．
   CutHolder cut_holder;
-  cut_holder.enum_cut(sbjgraph, mLutSize);
+  if ( mCutNum > 0 ) {
+    cut_holder.enum_priority_cut(sbjgraph, mLutSize, mCutNum);
+  }
+  else if ( mCutThreadNum != 1 ) {
+    cut_holder.enum_cut_mt(sbjgraph, mLutSize, mCutThreadNum);
+  }
+  else {
+    cut_holder.enum_cut(sbjgraph, mLutSize);
+  }
+  mPeakCutNum = cut_holder.peak_cut_num();
+  mCutBytesUsed = cut_holder.bytes_used();
 
   // 最良カットを記録する．
   MapRecord maprec;
 
+  // 遅延モデルを作る．
+  // k 入力のカットには先頭の k 個のピン遅延を用いる．
+  // set_option() で値の数が LUT の入力数以上であることは確認済み．
+  DelayModel delay_model;
+  if ( !mPinDelayList.empty() ) {
+    for ( SizeType k = 1; k <= mLutSize; ++ k ) {
+      vector<SizeType> delay_list(mPinDelayList.begin(), mPinDelayList.begin() + k);
+      delay_model.set_pin_delay(k, delay_list);
+    }
+  }
+  delay_model.set_wire_delay(mWireBase, mWirePerFanout);
+
   // 本当は mAlgorithm に応じた処理を行う．
   DelayCover delay_cover(mFanoutMode, slack);
+  delay_cover.set_delay_model(delay_model);
+  delay_cover.set_cost_limit(mCostLimit, mCostEpsilon / 100.0);
   delay_cover.record_cuts(sbjgraph, cut_holder, maprec);
 
   if ( mDoCutResub ) {
     // cut resubstituion
     CutResub cut_resub;
+    cut_resub.set_delay_model(delay_model);
     cut_resub(sbjgraph, cut_holder, maprec, slack);
   }
 
   // 最終的なネットワークを生成する．
+  // LUT の入力は DelayCover と同じ規則でピンにつなぐ．
   MapGen gen;
+  gen.set_delay_model(delay_model);
   return gen.generate(sbjgraph, maprec, mLutNum, mDepth);
 }
 
@@ -118,16 +302,41 @@ LutmapMgr::set_option(
 )
 {
   mOption = option;
+  mAlgorithm = string();
+  mStrash = false;
   mFanoutMode = true;
   mDoCutResub = true;
-  OptionParser parser;
-  auto opt_list = parser.parse(mOption);
+  mCutNum = 0;
+  mCutThreadNum = 1;
+  mFlowIter = 0;
+  mExactIter = 0;
+  mSaCount = 100;
+  mSaChainNum = 1;
+  mSaExchange = false;
+  mMctCount = 1000;
+  mMctThreadNum = 1;
+  mSeed = std::mt19937::default_seed;
+  mPinDelayList.clear();
+  mWireBase = 0;
+  mWirePerFanout = 0;
+  mCostLimit = 0;
+  mCostEpsilon = 0;
+  auto opt_list = parse_option(mOption);
   for ( auto p: opt_list ) {
     auto key = p.first;
     auto val = p.second;
     if ( key == string("algorithm") ) {
+      if ( val != string() && val != string("sa") && val != string("mct") ) {
+	throw std::invalid_argument{"LutmapMgr: unknown algorithm '" + val + "'"};
+      }
       mAlgorithm = val;
     }
+    else if ( key == string("strash") ) {
+      mStrash = true;
+    }
+    else if ( key == string("no_strash") ) {
+      mStrash = false;
+    }
     else if ( key == string("fanout") ) {
       mFanoutMode = true;
     }
@@ -140,6 +349,96 @@ LutmapMgr::set_option(
     else if ( key == string("no_cut_resub") ) {
       mDoCutResub = false;
     }
+    else if ( key == string("priority_cut") ) {
+      // 値が省略された時のカット数は 8
+      mCutNum = 8;
+      if ( val != string() ) {
+	mCutNum = parse_num(key, val);
+	if ( mCutNum == 0 ) {
+	  throw std::invalid_argument{"LutmapMgr: 'priority_cut' must be positive"};
+	}
+      }
+    }
+    else if ( key == string("all_cut") ) {
+      mCutNum = 0;
+    }
+    else if ( key == string("cut_thread") ) {
+      // 値が省略された時はハードウェアの並列度に合わせる．
+      mCutThreadNum = 0;
+      if ( val != string() ) {
+	mCutThreadNum = parse_num(key, val);
+      }
+    }
+    else if ( key == string("flow_recovery") ) {
+      // 値が省略された時の回数は 1
+      mFlowIter = 1;
+      if ( val != string() ) {
+	mFlowIter = parse_num(key, val);
+      }
+    }
+    else if ( key == string("exact_recovery") ) {
+      // 値が省略された時の回数は 1
+      mExactIter = 1;
+      if ( val != string() ) {
+	mExactIter = parse_num(key, val);
+      }
+    }
+    else if ( key == string("sa_count") ) {
+      mSaCount = parse_num(key, val);
+    }
+    else if ( key == string("sa_chain") ) {
+      mSaChainNum = parse_num(key, val);
+      if ( mSaChainNum == 0 ) {
+	throw std::invalid_argument{"LutmapMgr: 'sa_chain' must be positive"};
+      }
+    }
+    else if ( key == string("sa_exchange") ) {
+      mSaExchange = true;
+    }
+    else if ( key == string("no_sa_exchange") ) {
+      mSaExchange = false;
+    }
+    else if ( key == string("mct_count") ) {
+      mMctCount = parse_num(key, val);
+    }
+    else if ( key == string("mct_thread") ) {
+      mMctThreadNum = parse_num(key, val);
+      if ( mMctThreadNum == 0 ) {
+	throw std::invalid_argument{"LutmapMgr: 'mct_thread' must be positive"};
+      }
+    }
+    else if ( key == string("seed") ) {
+      mSeed = parse_num(key, val);
+    }
+    else if ( key == string("pin_delay") ) {
+      auto num_list = parse_num_list(key, val);
+      for ( auto delay: num_list ) {
+	if ( delay == 0 ) {
+	  throw std::invalid_argument{"LutmapMgr: 'pin_delay=" + val
+				      + "' must be positive"};
+	}
+      }
+      if ( num_list.size() < mLutSize ) {
+	throw std::invalid_argument{"LutmapMgr: 'pin_delay=" + val
+				    + "' has fewer values than the LUT size"};
+      }
+      mPinDelayList = num_list;
+    }
+    else if ( key == string("wire_delay") ) {
+      auto num_list = parse_num_list(key, val);
+      if ( num_list.size() != 2 ) {
+	throw std::invalid_argument{"LutmapMgr: 'wire_delay=" + val
+				    + "' must be 'base:per_fanout'"};
+      }
+      mWireBase = num_list[0];
+      mWirePerFanout = num_list[1];
+    }
+    else if ( key == string("cost_limit") ) {
+      mCostLimit = parse_num(key, val);
+    }
+    else if ( key == string("cost_epsilon") ) {
+      mCostEpsilon = parse_num(key, val);
+    }
   }
 }
 
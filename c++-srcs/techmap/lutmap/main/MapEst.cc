@@ -64,39 +64,27 @@
 // コードを単純にするため極性ごとの段数を持たせるようにする．
 //
 //
-// - 参照回数の計算と極性判定のアルゴリズムについて
+// - estimate() のアルゴリズムについて
 //
-// マップ結果において複数箇所から参照されているかどうかを調べるため参照回数を計算する．
-// 単純には back_trace() の最初で要求されている極性の参照回数を増加させればよいが，
-// この参照回数を極性判定に用いるためには外部出力からの参照だけは最初に数えておきたい．
-// そこで back_trace() の中のカットの入力ノードに対して back_trace() を再帰呼び出しする
-// タイミングで参照回数の更新を行っている．
+// 使われる LUT と極性，段数は MapGen と共通の MapTrace で求める．
+// LUT 数は MapTrace の求めた LUT の数に外部入力の NOT ゲートと定数の数を加えたものとなる．
 //
 //
-// - estimate() のアルゴリズムについて
+// - 差分更新について
 //
-// estimate() は generate() とほぼ同様のことを行っている．
+// 内部のノードから参照される極性は外部出力から要求されている極性のみで決まる
+// (inv_req() の値はバックトレース中に変化しない)．
+// そのため各ノードの LUT 数は外部出力から要求されている極性と，
+// 使用中のノードのカットの入力になっているかどうかだけで決まる．
+// そこで使用中のノードのカットの入力となっている回数を保持しておき，
+// カットが変わったノードについて参照と参照解除を行うことで
+// LUT 数を差分で更新する．
+// 参照回数の増減は順番によらないので，参照/参照解除は MapTrace と同様に
+// 作業用のスタックを用いて再帰なしで行う．
 
 
 BEGIN_NAMESPACE_LUTMAP
 
-// @brief 作業領域の初期化を行う．
-void
-MapEst::init(
-  SizeType node_num
-)
-{
-  // 作業領域の初期化
-  // 具体的な初期化は NodeInfo のコンストラクタが行っている．
-  mNodeInfo.clear();
-  mNodeInfo.resize(node_num);
-  mConst0 = false;
-  mConst1 = false;
-  mLutNum = 0;
-
-  mFanoutPointList.clear();
-}
-
 // @brief マッピング結果から見積もりを行う．
 void
 MapEst::estimate(
@@ -106,145 +94,228 @@ MapEst::estimate(
   SizeType& depth
 )
 {
-#if LUTMAP_DEBUG_MAPEST
-  cout << "MapEst::estimate() start" << endl;
-#endif
+  mTrace.trace(sbjgraph, record);
 
-  init(sbjgraph.node_num());
+  lut_num = mTrace.lut_list().size();
 
-  SizeType ni = sbjgraph.input_num();
-  SizeType no = sbjgraph.output_num();
+  // 負極性が必要な外部入力には NOT ゲートが必要
+  for ( auto node: sbjgraph.input_list() ) {
+    if ( mTrace.inv_req(node) ) {
+      ++ lut_num;
+    }
+  }
 
-  // 外部出力から要求されている極性を記録する．
-  for ( SizeType i = 0; i < no; ++ i ) {
-    auto onode = sbjgraph.output(i);
+  // 定数は値ごとに1つ数える．
+  bool const0 = false;
+  bool const1 = false;
+  depth = 0;
+  for ( auto onode: sbjgraph.output_list() ) {
     auto node = onode->output_fanin();
+    bool inv = onode->output_fanin_inv();
     if ( node ) {
-      mNodeInfo[node->id()].inc_ref(onode->output_fanin_inv());
+      depth = std::max(depth, mTrace.depth(node, inv));
     }
-  }
-
-  // 外部入力の生成
-  for ( SizeType i = 0; i < ni; ++ i ) {
-    auto src_node = sbjgraph.input(i);
-    auto& node_info = mNodeInfo[src_node->id()];
-    node_info.set_map(0);
-    if ( node_info.inv_req() ) {
-      ++ mLutNum;
-
-#if LUTMAP_DEBUG_MAPEST
-      cout << src_node->id_str() << "[1]" << endl;
-#endif
-      node_info.set_map(1, true);
-    }
-  }
-
-  // 外部出力からバックトレースを行い全ノードの生成を行う．
-  lut_num = 0;
-  SizeType max_depth = 0;
-  for ( SizeType i = 0; i < no; ++ i ) {
-    auto src_onode = sbjgraph.output(i);
-    auto src_node = src_onode->output_fanin();
-    bool inv = src_onode->output_fanin_inv();
-    if ( src_node ) {
-      est_back_trace(src_node, inv, record);
-      SizeType depth = mNodeInfo[src_node->id()].depth(inv);
-      if ( max_depth < depth ) {
-	max_depth = depth;
-      }
+    else if ( inv ) {
+      const1 = true;
     }
     else {
-      if ( inv ) {
-	if ( !mConst1 ) {
-	  mConst1 = true;
-
-	  ++ mLutNum;
-
-#if LUTMAP_DEBUG_MAPEST
-	  cout << "constant-1" << endl;
-#endif
-	}
-      }
-      else {
-	if ( !mConst0 ) {
-	  mConst0 = true;
-
-	  ++ mLutNum;
-
-#if LUTMAP_DEBUG_MAPEST
-	  cout << "constant-0" << endl;
-#endif
-	}
-      }
+      const0 = true;
     }
   }
-
-  lut_num = mLutNum;
-  depth = max_depth;
+  if ( const0 ) {
+    ++ lut_num;
+  }
+  if ( const1 ) {
+    ++ lut_num;
+  }
 
   // ファンアウトポイントを記録する．
-  SizeType nl = sbjgraph.logic_num();
-  for ( SizeType i = 0; i < nl; ++ i ) {
-    auto src_node = sbjgraph.logic(i);
-    auto& node_info = mNodeInfo[src_node->id()];
-    if ( node_info.ref_count(false) > 1 || node_info.ref_count(true) > 1 ) {
-      mFanoutPointList.push_back(src_node);
+  mFanoutPointList.clear();
+  for ( auto node: sbjgraph.logic_list() ) {
+    if ( mTrace.ref_count(node, false) > 1 || mTrace.ref_count(node, true) > 1 ) {
+      mFanoutPointList.push_back(node);
     }
   }
-
-#if LUTMAP_DEBUG_MAPEST
-  cout << "MapEst::estimate() end" << endl;
-#endif
 }
 
-// @brief 最終結果を作るためのバックトレースを行う．
+// @brief 差分更新用の初期化を行う．
 void
-MapEst::est_back_trace(
-  const SbjNode* src_node,
-  bool inv,
+MapEst::init_incr(
+  const SbjGraph& sbjgraph,
   const MapRecord& record
 )
 {
-#if LUTMAP_DEBUG_MAPGEN
-  cout << "back_trace(" << src_node->id_str() << ", " << inv << ")" << endl;
-#endif
-
-  auto& node_info = mNodeInfo[src_node->id()];
+  SizeType n = sbjgraph.node_num();
+  mOutPolArray.clear();
+  mOutPolArray.resize(n, 0);
+  mIncrRefArray.clear();
+  mIncrRefArray.resize(n, 0);
+  mIncrCutArray.clear();
+  mIncrCutArray.resize(n, nullptr);
+  mIncrLutNum = 0;
+  mIncrStack.clear();
 
-  if ( node_info.is_mapped(inv) ) {
-    return;
+  // 外部出力から要求されている極性を記録する．
+  // 定数は estimate() と同様に値ごとに1つ数える．
+  bool const0 = false;
+  bool const1 = false;
+  for ( auto onode: sbjgraph.output_list() ) {
+    auto node = onode->output_fanin();
+    bool inv = onode->output_fanin_inv();
+    if ( node ) {
+      mOutPolArray[node->id()] |= inv ? 2U : 1U;
+    }
+    else if ( inv ) {
+      const1 = true;
+    }
+    else {
+      const0 = true;
+    }
+  }
+  if ( const0 ) {
+    ++ mIncrLutNum;
+  }
+  if ( const1 ) {
+    ++ mIncrLutNum;
   }
 
-  // 外部入力はどちらの極性でも生成済み
-  ASSERT_COND( !src_node->is_input() );
-
-  // src_node を根とするカットを取り出す．
-  auto cut = record.get_cut(src_node);
+  // 負極性のみ要求されている外部入力には NOT ゲートが必要
+  for ( auto node: sbjgraph.input_list() ) {
+    if ( mOutPolArray[node->id()] == 2U ) {
+      ++ mIncrLutNum;
+    }
+  }
 
-  ++ mLutNum;
+  // 外部出力から参照されている論理ノードを使用中にする．
+  for ( auto node: sbjgraph.logic_list() ) {
+    if ( mOutPolArray[node->id()] != 0U ) {
+      mIncrLutNum += incr_lut(node->id());
+      incr_activate(node, record);
+      incr_ref(record);
+    }
+  }
+}
 
-#if LUTMAP_DEBUG_MAPGEN
-  cout << src_node->id_str() << "[" << inv << "]" << endl;
-#endif
+// @brief カットの変更を反映させる．
+void
+MapEst::update(
+  const MapRecord& record,
+  const vector<const SbjNode*>& node_list
+)
+{
+  for ( auto node: node_list ) {
+    auto id = node->id();
+    auto old_cut = mIncrCutArray[id];
+    if ( old_cut == nullptr ) {
+      // 使われていない．
+      continue;
+    }
+    auto new_cut = record.get_cut(node);
+    if ( new_cut == old_cut ) {
+      continue;
+    }
+    mIncrCutArray[id] = new_cut;
+    // 共通の入力が一旦未使用になるのを避けるために参照を先に行う．
+    SizeType ni1 = new_cut->input_num();
+    for ( SizeType i = 0; i < ni1; ++ i ) {
+      mIncrStack.push_back(new_cut->input(i));
+    }
+    incr_ref(record);
+    SizeType ni0 = old_cut->input_num();
+    for ( SizeType i = 0; i < ni0; ++ i ) {
+      mIncrStack.push_back(old_cut->input(i));
+    }
+    incr_deref();
+  }
+}
 
-  // その入力に対応するノードを再帰的に生成する．
-  SizeType ni = cut->input_num();
-  SizeType depth = 0;
-  for ( SizeType i = 0; i < ni; ++ i ) {
-    auto src_inode = cut->input(i);
-    auto& inode_info = mNodeInfo[src_inode->id()];
-    bool iinv = inode_info.inv_req();
+// @brief 差分更新用にノードの LUT 数を返す．
+SizeType
+MapEst::incr_lut(
+  SizeType id
+) const
+{
+  auto pol = mOutPolArray[id];
+  if ( mIncrRefArray[id] > 0 ) {
+    // 内部から参照される極性は外部出力から負極性のみ要求されている時に負極性
+    pol |= (pol == 2U) ? 2U : 1U;
+  }
+  SizeType n = 0;
+  if ( pol & 1U ) {
+    ++ n;
+  }
+  if ( pol & 2U ) {
+    ++ n;
+  }
+  return n;
+}
 
-    inode_info.inc_ref(iinv);
-    est_back_trace(src_inode, iinv, record);
+// @brief 差分更新用に mIncrStack に積まれたノードの参照回数を増やす．
+void
+MapEst::incr_ref(
+  const MapRecord& record
+)
+{
+  while ( !mIncrStack.empty() ) {
+    auto node = mIncrStack.back();
+    mIncrStack.pop_back();
+    if ( !node->is_logic() ) {
+      continue;
+    }
+    auto id = node->id();
+    bool active = mOutPolArray[id] != 0U || mIncrRefArray[id] > 0;
+    SizeType old_lut = incr_lut(id);
+    ++ mIncrRefArray[id];
+    mIncrLutNum += incr_lut(id);
+    mIncrLutNum -= old_lut;
+    if ( !active ) {
+      incr_activate(node, record);
+    }
+  }
+}
 
-    SizeType depth1 = inode_info.depth(iinv);
-    if ( depth < depth1 ) {
-      depth = depth1;
+// @brief 差分更新用に mIncrStack に積まれたノードの参照回数を減らす．
+void
+MapEst::incr_deref()
+{
+  while ( !mIncrStack.empty() ) {
+    auto node = mIncrStack.back();
+    mIncrStack.pop_back();
+    if ( !node->is_logic() ) {
+      continue;
+    }
+    auto id = node->id();
+    ASSERT_COND( mIncrRefArray[id] > 0 );
+    SizeType old_lut = incr_lut(id);
+    -- mIncrRefArray[id];
+    mIncrLutNum += incr_lut(id);
+    mIncrLutNum -= old_lut;
+    if ( mOutPolArray[id] == 0U && mIncrRefArray[id] == 0 ) {
+      // 使われなくなったのでカットの入力の参照を解除する．
+      auto cut = mIncrCutArray[id];
+      mIncrCutArray[id] = nullptr;
+      SizeType ni = cut->input_num();
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	mIncrStack.push_back(cut->input(i));
+      }
     }
   }
+}
 
-  node_info.set_map(depth, inv);
+// @brief 差分更新用にノードを使用中にしてカットの入力を mIncrStack に積む．
+void
+MapEst::incr_activate(
+  const SbjNode* node,
+  const MapRecord& record
+)
+{
+  auto cut = record.get_cut(node);
+  ASSERT_COND( cut != nullptr );
+  mIncrCutArray[node->id()] = cut;
+  SizeType ni = cut->input_num();
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    mIncrStack.push_back(cut->input(i));
+  }
 }
 
 END_NAMESPACE_LUTMAP
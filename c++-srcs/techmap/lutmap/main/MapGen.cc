@@ -67,16 +67,9 @@
 // - 参照回数の計算と極性判定のアルゴリズムについて
 //
 // マップ結果において複数箇所から参照されているかどうかを調べるため参照回数を計算する．
-// 単純には back_trace() の最初で要求されている極性の参照回数を増加させればよいが，
-// この参照回数を極性判定に用いるためには外部出力からの参照だけは最初に数えておきたい．
-// そこで back_trace() の中のカットの入力ノードに対して back_trace() を再帰呼び出しする
-// タイミングで参照回数の更新を行っている．
-//
-//
-// - estimate() のアルゴリズムについて
-//
-// estimate() は generate() とほぼ同様のことを行っている．ただし，実際にノード生成を
-// 行うわけではないので NodeInfo::set_map() で設定するノード番号はすべて 1 となっている．
+// 参照回数の計算と各ノードの極性と段数の決定は MapEst と共通の MapTrace で行う．
+// MapTrace の求める LUT のリストはファンインが先に来る順に並んでいるので
+// 前から順に LUT を生成すればよい．
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -88,12 +81,14 @@ MapGen::init(
 )
 {
   // 作業領域の初期化
-  // 具体的な初期化は NodeInfo のコンストラクタが行っている．
-  mNodeInfo.clear();
-  mNodeInfo.resize(node_num);
+  mMapNodeArray.clear();
+  mMapNodeArray.resize(node_num * 2);
+  mArrivalArray.clear();
+  mArrivalArray.resize(node_num * 2, 0);
   mConst0 = {}; // 不正値
   mConst1 = {}; // 不正値
   mLutNum = 0;
+  mTvCache.clear();
 }
 
 // @brief マッピング結果を BnNetwork にセットする．
@@ -119,14 +114,8 @@ MapGen::generate(
   SizeType ni = sbjgraph.input_num();
   SizeType no = sbjgraph.output_num();
 
-  // 外部出力から要求されている極性を記録する．
-  for ( SizeType i = 0; i < no; ++ i ) {
-    auto onode = sbjgraph.output(i);
-    auto node = onode->output_fanin();
-    if ( node ) {
-      mNodeInfo[node->id()].inc_ref(onode->output_fanin_inv());
-    }
-  }
+  // 使われる LUT と極性を求める．
+  mTrace.trace(sbjgraph, record);
 
   // ポートの生成
   SizeType np = sbjgraph.port_num();
@@ -141,7 +130,7 @@ MapGen::generate(
     auto bn_port = mapgraph.new_port(sbjport->name(), dir_vect);
     for ( SizeType j = 0; j < nb; ++ j ) {
       auto sbjnode = sbjport->bit(j);
-      mNodeInfo[sbjnode->id()].set_map(bn_port.bit(j), 0);
+      set_map(sbjnode, false, bn_port.bit(j));
     }
   }
 
@@ -160,14 +149,14 @@ MapGen::generate(
 
     auto bn_dff = mapgraph.new_dff({}, has_clear, has_preset);
 
-    mNodeInfo[input->id()].set_map(bn_dff.data_in(), 0);
-    mNodeInfo[output->id()].set_map(bn_dff.data_out(), 0);
-    mNodeInfo[clock->id()].set_map(bn_dff.clock(), 0);
+    set_map(input, false, bn_dff.data_in());
+    set_map(output, false, bn_dff.data_out());
+    set_map(clock, false, bn_dff.clock());
     if ( has_clear ) {
-      mNodeInfo[clear->id()].set_map(bn_dff.clear(), 0);
+      set_map(clear, false, bn_dff.clear());
     }
     if ( has_preset ) {
-      mNodeInfo[preset->id()].set_map(bn_dff.preset(), 0);
+      set_map(preset, false, bn_dff.preset());
     }
   }
 
@@ -186,38 +175,42 @@ MapGen::generate(
 
     auto bn_latch = mapgraph.new_latch({}, has_clear, has_preset);
 
-    mNodeInfo[input->id()].set_map(bn_latch.data_in(), 0);
-    mNodeInfo[output->id()].set_map(bn_latch.data_out(), 0);
-    mNodeInfo[enable->id()].set_map(bn_latch.clock(), 0);
+    set_map(input, false, bn_latch.data_in());
+    set_map(output, false, bn_latch.data_out());
+    set_map(enable, false, bn_latch.clock());
     if ( has_clear ) {
-      mNodeInfo[clear->id()].set_map(bn_latch.clear(), 0);
+      set_map(clear, false, bn_latch.clear());
     }
     if ( has_preset ) {
-      mNodeInfo[preset->id()].set_map(bn_latch.preset(), 0);
+      set_map(preset, false, bn_latch.preset());
     }
   }
 
   // 外部入力の生成
   for ( SizeType i = 0; i < ni; ++ i ) {
     auto src_node = sbjgraph.input(i);
-    auto& node_info = mNodeInfo[src_node->id()];
-    if ( node_info.inv_req() ) {
+    if ( mTrace.inv_req(src_node) ) {
       // NOT ゲートを表す LUT を作る．
       auto tv = TvFunc::make_nega_literal(1, 0);
-      auto node = node_info.map_node();
+      auto node = map_node(src_node);
       auto inv = mapgraph.new_logic_tv({}, tv, {node});
 
       ++ mLutNum;
 
 #if LUTMAP_DEBUG_MAPGEN
-      cout << node->id_str() << "[1]" << endl;
+      cout << src_node->id_str() << "[1]" << endl;
 #endif
 
-      node_info.set_map(inv, 1, true);
+      set_map(src_node, true, inv);
     }
   }
 
-  // 外部出力からバックトレースを行い全ノードの生成を行う．
+  // LUT をファンインから順に生成する．
+  for ( auto& p: mTrace.lut_list() ) {
+    gen_lut(p.first, p.second, record, mapgraph);
+  }
+
+  // 外部出力を設定する．
   SizeType max_depth = 0;
   for ( SizeType i = 0; i < no; ++ i ) {
     auto src_onode = sbjgraph.output(i);
@@ -226,8 +219,9 @@ MapGen::generate(
     BnNode dst_node;
     SizeType depth;
     if ( src_node ) {
-      dst_node = gen_back_trace(src_node, inv, record, mapgraph);
-      depth = mNodeInfo[src_node->id()].depth(inv);
+      dst_node = map_node(src_node, inv);
+      ASSERT_COND( dst_node.is_valid() );
+      depth = mTrace.depth(src_node, inv);
       if ( max_depth < depth ) {
 	max_depth = depth;
       }
@@ -262,10 +256,8 @@ MapGen::generate(
       }
       depth = 0;
     }
-    auto dst_onode = mNodeInfo[src_onode->id()].map_node();
+    auto dst_onode = map_node(src_onode);
     mapgraph.set_output_src(dst_onode, dst_node);
-    // depth の設定のため
-    mNodeInfo[src_onode->id()].set_map(dst_onode, depth);
   }
 
   lut_num = mLutNum;
@@ -278,86 +270,122 @@ MapGen::generate(
   return BnNetwork{std::move(mapgraph)};
 }
 
-// @brief 最終結果を作るためのバックトレースを行う．
+// @brief LUT を作る．
 BnNode
-MapGen::gen_back_trace(
+MapGen::gen_lut(
   const SbjNode* src_node,
   bool output_inv,
   const MapRecord& record,
   BnModifier& mapnetwork
 )
 {
-#if LUTMAP_DEBUG_MAPGEN
-  cout << "back_trace(" << src_node->id_str() << ", " << output_inv << ")" << endl;
-#endif
-  auto& node_info = mNodeInfo[src_node->id()];
-
-  auto dst_node = node_info.map_node(output_inv);
-  if ( dst_node.is_valid() ) {
-    // すでに生成済みならそのノードを返す．
-    return dst_node;
-  }
-
-  // 外部入力はどちらの極性でも生成済み
-  ASSERT_COND( !src_node->is_input() );
-
   // node を根とするカットを取り出す．
   auto cut = record.get_cut(src_node);
-  if ( cut == nullptr ) {
-    cout << "Error!: " << src_node->id_str()
-	 << " has no cuts" << endl;
-    ASSERT_NOT_REACHED;
-  }
+  ASSERT_COND( cut != nullptr );
 
-  // その入力に対応するノードを再帰的に生成する．
+  // ファンインの極性と到着時刻を求める．
+  // ファンインのノードは MapTrace の順序により生成済みとなっている．
+  // 作業領域はノードごとに確保せずに使い回す．
   SizeType ni = cut->input_num();
-  SizeType depth = 0;
+  mInputInv.resize(ni);
+  mLevelList.resize(ni);
   for ( SizeType i = 0; i < ni; ++ i ) {
-    auto inode = cut->input(i);
-    auto& inode_info = mNodeInfo[inode->id()];
-    bool iinv = inode_info.inv_req();
-
-    inode_info.inc_ref(iinv);
-    gen_back_trace(inode, iinv, record, mapnetwork);
-
-    // 段数の計算を行う．
-    SizeType idepth = inode_info.depth(iinv);
-    if ( depth < idepth ) {
-      depth = idepth;
-    }
+    auto src_inode = cut->input(i);
+    bool iinv = mTrace.inv_req(src_inode);
+    mInputInv[i] = iinv;
+    mLevelList[i] = mArrivalArray[src_inode->id() * 2 + (iinv ? 1 : 0)];
   }
-  ++ depth;
-
-  // ファンインの極性とファンインのノードのリストを作る．
-  // 上のループで input_inv の設定を行うこともできるがそうすると
-  // gen_back_trace() の再帰のたびにスタック上に input_inv が作られる
-  // ことになるのであえてここで行う．
-  vector<bool> input_inv(ni, false);
-  vector<BnNode> fanin_list(ni);
+
+  // DelayCover や CutResub と同じ規則で各入力をピンに割り当てて
+  // ピンの順にファンインのリストを作る．
+  mDelayModel.assign_pins(cut, mLevelList, mPinList);
+  mFaninList.resize(ni);
+  SizeType arrival = 0;
   for ( SizeType i = 0; i < ni; ++ i ) {
     auto src_inode = cut->input(i);
-    auto& inode_info = mNodeInfo[src_inode->id()];
-    bool iinv = inode_info.inv_req();
-    input_inv[i] = iinv;
-    fanin_list[i] = inode_info.map_node(iinv);
+    auto pin = mPinList[i];
+    mFaninList[pin] = map_node(src_inode, mInputInv[i]);
+    ASSERT_COND( mFaninList[pin].is_valid() );
+    SizeType arrival1 = mLevelList[i] + mDelayModel.edge_delay(cut, i, pin);
+    if ( arrival < arrival1 ) {
+      arrival = arrival1;
+    }
   }
+  mArrivalArray[src_node->id() * 2 + (output_inv ? 1 : 0)] = arrival;
 
   // カットの実現している関数の真理値表を得る．
-  auto tv = cut->make_tv(output_inv, input_inv);
+  const auto& tv = get_tv(cut, output_inv, mInputInv, mPinList);
 
   // 新しいノードを作る．
-  dst_node = mapnetwork.new_logic_tv({}, tv, fanin_list);
+  auto dst_node = mapnetwork.new_logic_tv({}, tv, mFaninList);
 
   ++ mLutNum;
 
   // マップ結果をセットする．
-  node_info.set_map(dst_node, depth, output_inv);
+  set_map(src_node, output_inv, dst_node);
 
 #if LUTMAP_DEBUG_MAPGEN
-  cout << src_node->id_str() << " => " << dst_node.id() << ": " << depth << endl;
+  cout << src_node->id_str() << " => " << dst_node.id() << ": "
+       << mTrace.depth(src_node, output_inv) << endl;
 #endif
 
   return dst_node;
 }
 
+// @brief カットの実現する関数を返す．
+const TvFunc&
+MapGen::get_tv(
+  const Cut* cut,
+  bool output_inv,
+  const vector<bool>& input_inv,
+  const vector<SizeType>& pin_list
+)
+{
+  // 極性と入力の順序を変換した真理値表のワードに入力数を付加したものをキーにする．
+  // データパス系の回路では同じ関数のカットが多数現れるので
+  // TvFunc の生成は関数ごとに1回で済む．
+  SizeType ni = cut->input_num();
+  bool identity = true;
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    if ( pin_list[i] != i ) {
+      identity = false;
+      break;
+    }
+  }
+  if ( identity ) {
+    cut->make_tv_words(output_inv, input_inv, mTvWords);
+  }
+  else {
+    // 新しい真理値表の b ビット目は b の pin_list[i] ビット目を
+    // i ビット目に移した位置の値になる．
+    cut->make_tv_words(output_inv, input_inv, mTvWords0);
+    mTvWords.clear();
+    mTvWords.resize(mTvWords0.size(), 0ULL);
+    SizeType np = 1 << ni;
+    for ( SizeType b = 0; b < np; ++ b ) {
+      SizeType b0 = 0;
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	if ( (b >> pin_list[i]) & 1 ) {
+	  b0 |= (1U << i);
+	}
+      }
+      if ( (mTvWords0[b0 / 64] >> (b0 % 64)) & 1ULL ) {
+	mTvWords[b / 64] |= (1ULL << (b % 64));
+      }
+    }
+  }
+  mTvWords.push_back(ni);
+  auto p = mTvCache.find(mTvWords);
+  if ( p == mTvCache.end() ) {
+    // 極性の変換は済んでいるのでキーのワードから直接 TvFunc を作る．
+    SizeType np = 1 << ni;
+    vector<int> tv(np);
+    for ( SizeType b = 0; b < np; ++ b ) {
+      tv[b] = (mTvWords[b / 64] >> (b % 64)) & 1ULL;
+    }
+    p = mTvCache.emplace(mTvWords, TvFunc(ni, tv)).first;
+  }
+  return p->second;
+}
+
 END_NAMESPACE_LUTMAP
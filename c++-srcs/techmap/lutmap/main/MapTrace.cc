@@ -0,0 +1,127 @@
+
+/// @file MapTrace.cc
+/// @brief MapTrace の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "MapTrace.h"
+#include "MapRecord.h"
+#include "Cut.h"
+#include "SbjGraph.h"
+
+
+// 実装に関する覚書
+//
+// - 参照回数と極性について
+//
+// 内部のノードから参照される極性は inv_req() で決まり，
+// inv_req() は外部出力からの参照だけで決まる．
+// 内部からの参照は inv_req() の極性の参照回数を増やすだけなので
+// バックトレース中に inv_req() の値が変わることはない．
+// そのため最初に外部出力からの参照を数えておけば
+// たどる順番によらず同じ結果が得られる．
+//
+// - 段数について
+//
+// 外部入力の段数は 0 とし，NOT ゲートが必要な負極性は 1 とする．
+// LUT の段数はカットの入力の段数の最大値に 1 を足したものとなる．
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+//////////////////////////////////////////////////////////////////////
+// クラス MapTrace
+//////////////////////////////////////////////////////////////////////
+
+// @brief バックトレースを行う．
+void
+MapTrace::trace(
+  const SbjGraph& sbjgraph,
+  const MapRecord& record
+)
+{
+  // 領域は再利用する．
+  SizeType n = sbjgraph.node_num() * 2;
+  mRefCount.assign(n, 0);
+  mDepth.assign(n, 0);
+  mMapped.assign(n, 0);
+  mLutList.clear();
+
+  // 外部出力から要求されている極性を記録する．
+  for ( auto onode: sbjgraph.output_list() ) {
+    auto node = onode->output_fanin();
+    if ( node ) {
+      ++ mRefCount[index(node, onode->output_fanin_inv())];
+    }
+  }
+
+  // 外部入力はどちらの極性でも実現済みとする．
+  for ( auto node: sbjgraph.input_list() ) {
+    mMapped[index(node, false)] = 1;
+    if ( inv_req(node) ) {
+      mMapped[index(node, true)] = 1;
+      mDepth[index(node, true)] = 1;
+    }
+  }
+
+  for ( auto onode: sbjgraph.output_list() ) {
+    auto node = onode->output_fanin();
+    if ( node ) {
+      back_trace(node, onode->output_fanin_inv(), record);
+    }
+  }
+}
+
+// @brief 外部出力から (node, inv) のバックトレースを行う．
+void
+MapTrace::back_trace(
+  const SbjNode* node,
+  bool inv,
+  const MapRecord& record
+)
+{
+  if ( mMapped[index(node, inv)] ) {
+    return;
+  }
+
+  mStack.clear();
+  mStack.push_back(Frame{node, inv, 0, 0});
+  while ( !mStack.empty() ) {
+    // push_back() で参照が無効になるので値で取り出す．
+    auto frame = mStack.back();
+    auto cut = record.get_cut(frame.mNode);
+    ASSERT_COND( cut != nullptr );
+
+    if ( frame.mPos < cut->input_num() ) {
+      // 次の入力を処理する．
+      auto inode = cut->input(frame.mPos);
+      ++ mStack.back().mPos;
+      bool iinv = inv_req(inode);
+      auto iidx = index(inode, iinv);
+      ++ mRefCount[iidx];
+      if ( mMapped[iidx] ) {
+	auto& top = mStack.back();
+	top.mDepth = std::max(top.mDepth, mDepth[iidx]);
+      }
+      else {
+	mStack.push_back(Frame{inode, iinv, 0, 0});
+      }
+      continue;
+    }
+
+    // 全ての入力が処理済みになった．
+    auto idx = index(frame.mNode, frame.mInv);
+    mMapped[idx] = 1;
+    mDepth[idx] = frame.mDepth + 1;
+    mLutList.push_back(make_pair(frame.mNode, frame.mInv));
+    mStack.pop_back();
+    if ( !mStack.empty() ) {
+      auto& top = mStack.back();
+      top.mDepth = std::max(top.mDepth, mDepth[idx]);
+    }
+  }
+}
+
+END_NAMESPACE_LUTMAP
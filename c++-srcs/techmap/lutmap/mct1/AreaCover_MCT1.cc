@@ -8,7 +8,7 @@
 
 
 #include "AreaCover_MCT1.h"
-#include "MctSearch.h"
+#include "mct1/MctSearch.h"
 
 
 BEGIN_NAMESPACE_LUTMAP_MCT1
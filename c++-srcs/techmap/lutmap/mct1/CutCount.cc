@@ -86,10 +86,12 @@ CutCount::found(const SbjNode* root)
 // @param[in] root 根のノード
 // @param[in] ni 入力数
 // @param[in] inputs 入力ノードの配列
+// @param[in] tv_words カットの真理値表のワードの配列
 void
 CutCount::found(const SbjNode* root,
 		ymuint ni,
-		const SbjNode* inputs[])
+		const SbjNode* inputs[],
+		const std::uint64_t* tv_words)
 {
   // このカットがカバーするノードを求める．
   // ただし inputs[] のノードは含まない．
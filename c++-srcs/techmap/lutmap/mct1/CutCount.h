@@ -75,11 +75,13 @@ private:
   /// @param[in] root 根のノード
   /// @param[in] ni 入力数
   /// @param[in] inputs 入力ノードの配列
+  /// @param[in] tv_words カットの真理値表のワードの配列
   virtual
   void
   found(const SbjNode* root,
 	ymuint ni,
-	const SbjNode* inputs[]);
+	const SbjNode* inputs[],
+	const std::uint64_t* tv_words);
 
   /// @brief node を根とするカットを列挙し終わった直後に呼ばれる関数
   /// @param[in] node 根のノード
@@ -38,6 +38,7 @@ MctNode::MctNode(MctNode* parent,
   mSum = 0.0;
   mNum = 0;
   mMean = 0.0;
+  mVirtualLoss = 0;
 }
 
 // @brief デストラクタ
@@ -11,6 +11,7 @@
 
 #include "mct1_nsdef.h"
 #include "sbj_nsdef.h"
+#include <deque>
 
 
 BEGIN_NAMESPACE_LUTMAP_MCT1
@@ -81,6 +82,17 @@ public:
   void
   update(double val);
 
+  /// @brief 仮想損失(virtual loss)を加える．
+  ///
+  /// 評価中の試行を評価値 0 の試行とみなすことで
+  /// 並列探索時に他のスレッドが同じ経路を選びにくくする．
+  void
+  add_virtual_loss();
+
+  /// @brief 仮想損失を取り除く．
+  void
+  remove_virtual_loss();
+
   /// @brief UCB1 値を返す．
   /// @param[in] n_all_ln トータルの試行回数の ln
   double
@@ -122,6 +134,72 @@ private:
   // 現在の期待値 = mSum / mNum
   double mMean;
 
+  // 評価中の試行数(仮想損失)
+  SizeType mVirtualLoss;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class MctNodePool MctNode.h "MctNode.h"
+/// @brief MctNode をまとめて確保するためのクラス
+///
+/// ノードは std::deque にまとめて確保するので
+/// 一旦確保されたノードのアドレスは変わらない．
+/// 個々のノードを解放することはなく，clear() で全て解放する．
+//////////////////////////////////////////////////////////////////////
+class MctNodePool
+{
+public:
+
+  /// @brief コンストラクタ
+  MctNodePool() = default;
+
+  /// @brief デストラクタ
+  ~MctNodePool() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ノードを確保する．
+  /// @param[in] parent 親のノード
+  /// @param[in] root 選択されたカットの根のノード
+  /// @param[in] cand_list カット候補のリスト
+  MctNode*
+  new_node(MctNode* parent,
+	   const SbjNode* root,
+	   const vector<const SbjNode*>& cand_list)
+  {
+    mNodeArray.emplace_back(parent, root, cand_list);
+    return &mNodeArray.back();
+  }
+
+  /// @brief 確保したノード数を返す．
+  SizeType
+  node_num() const
+  {
+    return mNodeArray.size();
+  }
+
+  /// @brief 全てのノードを解放する．
+  void
+  clear()
+  {
+    mNodeArray.clear();
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ノードの本体
+  std::deque<MctNode> mNodeArray;
+
 };
 
 
@@ -188,13 +266,36 @@ MctNode::update(double val)
   mMean = mSum / mNum;
 }
 
+// @brief 仮想損失(virtual loss)を加える．
+inline
+void
+MctNode::add_virtual_loss()
+{
+  ++ mVirtualLoss;
+}
+
+// @brief 仮想損失を取り除く．
+inline
+void
+MctNode::remove_virtual_loss()
+{
+  ASSERT_COND( mVirtualLoss > 0 );
+  -- mVirtualLoss;
+}
+
 // @brief UCB1 値を返す．
 // @param[in] n_all トータルの試行回数の ln
+//
+// 評価中の試行は評価値 0 として数える．
 inline
 double
 MctNode::UCB1(double n_all_ln) const
 {
-  return mMean + 0.3 * sqrt(2 * n_all_ln / mNum);
+  if ( mVirtualLoss == 0 ) {
+    return mMean + 0.3 * sqrt(2 * n_all_ln / mNum);
+  }
+  double n = static_cast<double>(mNum + mVirtualLoss);
+  return mSum / n + 0.3 * sqrt(2 * n_all_ln / n);
 }
 
 END_NAMESPACE_LUTMAP_MCT1
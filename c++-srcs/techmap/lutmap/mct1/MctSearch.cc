@@ -7,14 +7,15 @@
 /// All rights reserved.
 
 
-#include "MctSearch.h"
+#include "mct1/MctSearch.h"
+#include "mct1/MctState.h"
 #include "MctNode.h"
-#include "MctState.h"
 #include "MapRecord.h"
 #include "SbjGraph.h"
 #include "LbCalc.h"
 
 #include "SbjDumper.h"
+#include <thread>
 
 
 #define UNIFORM_SAMPLING 0
@@ -33,27 +34,22 @@ BEGIN_NAMESPACE_LUTMAP_MCT1
 MctSearch::MctSearch(const SbjGraph& sbjgraph,
 		     const CutHolder& cut_holder,
 		     SizeType cut_size) :
-  mState(sbjgraph, cut_size),
-  mInsideNodeMark(sbjgraph.node_num(), false)
+  mSbjGraph(sbjgraph),
+  mCutSize(cut_size),
+  mNodePool(new MctNodePool),
+  mSeed(std::mt19937::default_seed),
+  mVerbose(false)
 {
   LbCalc lbcalc;
   mBaseline = lbcalc.lower_bound(sbjgraph, cut_holder);
 
-  SizeType nf = 0;
-  for (int i = 0; i < sbjgraph.logic_num(); ++ i) {
-    const SbjNode* node = sbjgraph.logic(i);
-    if ( node->fanout_num() > 1 ) {
-      ++ nf;
-    }
-  }
-  cout << "# of logic nodes   = " << sbjgraph.logic_num() << endl;
-  cout << "# of fanout points = " << nf << endl;
-
   mMinimumLutNum = sbjgraph.node_num() + 1;
 
-  mState.init();
-  trivial_move();
-  mRootNode = new MctNode(nullptr, nullptr, mState.candidates());
+  // 根のノードの候補は初期状態から求める．
+  MctState state(sbjgraph, cut_size);
+  state.init();
+  trivial_move(state);
+  mRootNode = mNodePool->new_node(nullptr, nullptr, state.candidates());
 }
 
 // @brief デストラクタ
@@ -63,46 +59,173 @@ MctSearch::~MctSearch()
 
 // @brief 探索を行う．
 // @param[in] search_limit 試行回数
+// @param[in] verbose verbose フラグ
+// @return 最良解を返す．
+const MapRecord&
+MctSearch::search(SizeType search_limit,
+		  bool verbose)
+{
+  mVerbose = verbose;
+  vector<std::uint32_t> seed_list{static_cast<std::uint32_t>(mSeed)};
+  return search_sub(search_limit, seed_list);
+}
+
+// @brief 複数のスレッドで探索を行う．
+// @param[in] search_limit 全スレッドの試行回数の合計
+// @param[in] thread_num スレッド数
+// @param[in] verbose verbose フラグ
+// @return 最良解を返す．
+const MapRecord&
+MctSearch::search_mt(SizeType search_limit,
+		     SizeType thread_num,
+		     bool verbose)
+{
+  ASSERT_COND( thread_num > 0 );
+
+  mVerbose = verbose;
+
+  // 0 番目のスレッドは search() と同じく mSeed を用いる．
+  // 残りのスレッドの乱数の種は mSeed から作る．
+  std::seed_seq seq{static_cast<std::uint32_t>(mSeed),
+		    static_cast<std::uint32_t>(thread_num)};
+  vector<std::uint32_t> seed_list(thread_num);
+  seq.generate(seed_list.begin(), seed_list.end());
+  seed_list[0] = static_cast<std::uint32_t>(mSeed);
+  return search_sub(search_limit, seed_list);
+}
+
+// @brief 探索を行う．
+// @param[in] search_limit 全スレッドの試行回数の合計
+// @param[in] seed_list 各スレッドの乱数の種のリスト
+const MapRecord&
+MctSearch::search_sub(SizeType search_limit,
+		      const vector<std::uint32_t>& seed_list)
+{
+  if ( mVerbose ) {
+    SizeType nf = 0;
+    for ( auto node: mSbjGraph.logic_list() ) {
+      if ( node->fanout_num() > 1 ) {
+	++ nf;
+      }
+    }
+    cout << "# of logic nodes   = " << mSbjGraph.logic_num() << endl;
+    cout << "# of fanout points = " << nf << endl;
+  }
+
+  SizeType thread_num = seed_list.size();
+  mWorkerList.clear();
+  for ( SizeType i = 0; i < thread_num; ++ i ) {
+    auto worker = new Worker{mSbjGraph, mCutSize, seed_list[i]};
+    worker->mMinimumLutNum = mSbjGraph.node_num() + 1;
+    mWorkerList.emplace_back(worker);
+  }
+  mNumAll = 0;
+
+  vector<std::thread> thread_list;
+  thread_list.reserve(thread_num - 1);
+  for ( SizeType id = 1; id < thread_num; ++ id ) {
+    thread_list.push_back(std::thread{[this, id, search_limit]{
+      run_worker(id, search_limit);
+    }});
+  }
+  run_worker(0, search_limit);
+  for ( auto& th: thread_list ) {
+    th.join();
+  }
+
+  // 各スレッドの最良解をまとめる．
+  // 同じ値の場合にはスレッド番号の小さい方を採る．
+  for ( auto& worker: mWorkerList ) {
+    if ( worker->mMinimumLutNum == mMinimumLutNum ) {
+      mBestRecord = worker->mBestRecord;
+      break;
+    }
+  }
+  mWorkerList.clear();
+
+  return mBestRecord;
+}
+
+// @brief 1つのスレッドの探索を行う．
+// @param[in] id スレッド番号
+// @param[in] search_limit 全スレッドの試行回数の合計
 void
-MctSearch::search(SizeType search_limit)
+MctSearch::run_worker(SizeType id,
+		      SizeType search_limit)
 {
-  for (mNumAll = 1; mNumAll <= search_limit; ++ mNumAll) {
-    mState.init();
-    trivial_move();
-    MctNode* node = tree_policy(mRootNode);
-    double val = default_policy(node);
-    back_up(node, val);
+  auto& worker = *mWorkerList[id];
+  for ( ; ; ) {
+    worker.mState.init();
+    trivial_move(worker.mState);
+    MctNode* node;
+    {
+      std::lock_guard<std::mutex> lck{mTreeMutex};
+      if ( mNumAll >= search_limit ) {
+	break;
+      }
+      ++ mNumAll;
+      node = tree_policy(worker, mRootNode);
+    }
+
+    // ランダムサンプリングはロックの外で行う．
+    SizeType ln0 = worker.mState.lut_num();
+    SizeType lut_num = default_policy(worker);
+    double val = mBaseline / lut_num;
+
+    {
+      std::lock_guard<std::mutex> lck{mTreeMutex};
+      back_up(node, val);
+      if ( mMinimumLutNum > lut_num ) {
+	mMinimumLutNum = lut_num;
+      }
+      if ( mVerbose ) {
+	cout << "#LUT = " << lut_num << "(" << ln0 << ")" << " / " << mMinimumLutNum << endl;
+      }
+    }
   }
 }
 
 // @brief 評価値の良い子ノードを見つける．
+// @param[in] worker 対象のスレッドの状態
+// @param[in] node 根のノード
 MctNode*
-MctSearch::tree_policy(MctNode* node)
+MctSearch::tree_policy(Worker& worker,
+		       MctNode* node)
 {
+  auto& state = worker.mState;
+  double num_all_ln = log(mNumAll) / log(2);
+  node->add_virtual_loss();
   for ( ; ; ) {
     if ( !node->is_expanded() ) {
       const SbjNode* root = node->expand_child();
-      move(root);
-      MctNode* child_node = new MctNode(node, root, mState.candidates());
+      move(state, root);
+      MctNode* child_node = mNodePool->new_node(node, root, state.candidates());
       node->insert_child(child_node);
+      child_node->add_virtual_loss();
       return child_node;
     }
     if ( node->child_num() == 0 ) {
       return node;
     }
-    node = node->best_child();
-    move(node->cut_root());
+    MctNode* parent = node;
+    node = parent->best_child();
+    // 仮想損失を加えて並び替えることで
+    // 他のスレッドが別の子供を選びやすくする．
+    node->add_virtual_loss();
+    parent->reorder(num_all_ln);
+    move(state, node->cut_root());
   }
 }
 
-// @brief ランダムサンプリングを行って評価値を求める．
-double
-MctSearch::default_policy(MctNode* node)
+// @brief ランダムサンプリングを行って LUT 数を求める．
+// @param[in] worker 対象のスレッドの状態
+SizeType
+MctSearch::default_policy(Worker& worker)
 {
-  SizeType ln0 = mState.lut_num();
+  auto& state = worker.mState;
   for ( ; ; ) {
-    const auto& cut_list = mState.candidates();
-    const auto& w_list = mState.weight_list();
+    const auto& cut_list = state.candidates();
+    const auto& w_list = state.weight_list();
     if ( cut_list.empty() ) {
       break;
     }
@@ -110,9 +233,9 @@ MctSearch::default_policy(MctNode* node)
 #if UNIFORM_SAMPLING
     int n = cut_list.size();
     std::uniform_int_distribution<int> rd(0, n - 1);
-    int r = rd(mRandGen);
+    int r = rd(worker.mRandGen);
     const SbjNode* root = cut_list[r];
-    move(root);
+    move(state, root);
 #else
     auto n = cut_list.size();
     vector<SizeType> acc_w(n);
@@ -125,7 +248,7 @@ MctSearch::default_policy(MctNode* node)
       acc_w[i] = sum;
     }
     std::uniform_int_distribution<int> rd(0, sum - 1);
-    int r = rd(mRandGen);
+    int r = rd(worker.mRandGen);
     int pos = 0;
     for ( ; pos < n; ++ pos) {
       if ( r < acc_w[pos] ) {
@@ -134,17 +257,15 @@ MctSearch::default_policy(MctNode* node)
     }
     ASSERT_COND( pos < n );
     const SbjNode* root = cut_list[pos];
-    move(root);
+    move(state, root);
 #endif
   }
-  SizeType ln = mState.lut_num();
-  if ( mMinimumLutNum > ln ) {
-    mMinimumLutNum = ln;
-    mState.copy_to(mBestRecord);
+  SizeType ln = state.lut_num();
+  if ( worker.mMinimumLutNum > ln ) {
+    worker.mMinimumLutNum = ln;
+    state.copy_to(worker.mBestRecord);
   }
-  double val = mBaseline / ln;
-  cout << "#LUT = " << ln << "(" << ln0 << ")" << " / " << mMinimumLutNum << endl;
-  return val;
+  return ln;
 }
 
 // @brief 評価値の更新を行う．
@@ -154,39 +275,42 @@ MctSearch::back_up(MctNode* node,
 {
   double num_all_ln = log(mNumAll) / log(2);
   for ( ; ; ) {
+    node->remove_virtual_loss();
     node->update(val);
     MctNode* parent = node->parent();
     if ( parent == nullptr ) {
       break;
     }
-    ASSERT_COND( parent->best_child() == node );
     parent->reorder(num_all_ln);
     node = parent;
   }
 }
 
 // @brief 状態を遷移させる．
+// @param[in] state 対象の状態
 // @param[in] cut_root カットの根のノード
 //
 // 初期状態は cut_root = nullptr とする．
 void
-MctSearch::move(const SbjNode* cut_root)
+MctSearch::move(MctState& state,
+		const SbjNode* cut_root)
 {
-  mState.update(cut_root);
-  trivial_move();
+  state.update(cut_root);
+  trivial_move(state);
 }
 
 // @brief trivial な選択を行う．
+// @param[in] state 対象の状態
 void
-MctSearch::trivial_move()
+MctSearch::trivial_move(MctState& state)
 {
   for ( ; ; ) {
-    const vector<const SbjNode*>& po_list = mState.pocandidates();
+    const vector<const SbjNode*>& po_list = state.pocandidates();
     if ( po_list.empty() ) {
       break;
     }
     const SbjNode* root = po_list[0];
-    mState.update(root);
+    state.update(root);
   }
 }
 
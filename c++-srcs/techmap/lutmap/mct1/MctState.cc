@@ -7,7 +7,7 @@
 /// All rights reserved.
 
 
-#include "MctState.h"
+#include "mct1/MctState.h"
 #include "MapRecord.h"
 
 #include "SbjGraph.h"
@@ -50,6 +50,10 @@ MctState::MctState(const SbjGraph& sbjgraph,
   for (int i = 0; i < sbjgraph.output_num(); ++ i) {
     const SbjNode* onode = sbjgraph.output(i);
     const SbjNode* node = onode->output_fanin();
+    if ( node == nullptr ) {
+      // 定数出力
+      continue;
+    }
     SizeType mask = 0;
     if ( onode->output_fanin_inv() ) {
       mask = 2;
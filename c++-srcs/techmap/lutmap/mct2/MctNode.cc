@@ -32,6 +32,7 @@ MctNode::MctNode(MctNode* parent,
   mSum = 0.0;
   mNum = 0;
   mMean = 0.0;
+  mVirtualLoss = 0;
 }
 
 // @brief デストラクタ
@@ -43,14 +44,15 @@ MctNode::~MctNode()
 //
 // is_expanded() == false のときのみ意味を持つ．
 // 取り出されたノードは展開済みとなる．
+// @param[in] pool ノードを確保するオブジェクト
 MctNode*
-MctNode::expand_child()
+MctNode::expand_child(MctNodePool& pool)
 {
   if ( is_expanded() ) {
     return nullptr;
   }
   bool select = (mUnexpandedNum == 1);
-  MctNode* child = new MctNode(this, mIndex + 1, select);
+  MctNode* child = pool.new_node(this, mIndex + 1, select);
   if ( mUnexpandedNum == 2 ) {
     mChildList[0] = child;
   }
@@ -11,10 +11,13 @@
 
 #include "mct2/mct2_nsdef.h"
 #include "sbj_nsdef.h"
+#include <deque>
 
 
 BEGIN_NAMESPACE_LUTMAP_MCT2
 
+class MctNodePool;
+
 //////////////////////////////////////////////////////////////////////
 /// @class MctNode MctNode.h "MctNode.h"
 /// @brief MCT で用いる探索木のノード
@@ -60,8 +63,9 @@ public:
   ///
   /// is_expanded() == false のときのみ意味を持つ．
   /// 取り出されたノードは展開済みとなる．
+  /// @param[in] pool ノードを確保するオブジェクト
   MctNode*
-  expand_child();
+  expand_child(MctNodePool& pool);
 
   /// @brief 子供ノードを取り出す．
   MctNode*
@@ -79,6 +83,17 @@ public:
   void
   update(double val);
 
+  /// @brief 仮想損失(virtual loss)を加える．
+  ///
+  /// 評価中の試行を評価値 0 の試行とみなすことで
+  /// 並列探索時に他のスレッドが同じ経路を選びにくくする．
+  void
+  add_virtual_loss();
+
+  /// @brief 仮想損失を取り除く．
+  void
+  remove_virtual_loss();
+
   /// @brief UCB1 値を返す．
   /// @param[in] n_all_ln トータルの試行回数の ln
   /// @param[in] cp 調整パラメータ
@@ -122,6 +137,72 @@ private:
   // 現在の期待値 = mSum / mNum
   double mMean;
 
+  // 評価中の試行数(仮想損失)
+  SizeType mVirtualLoss;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class MctNodePool MctNode.h "MctNode.h"
+/// @brief MctNode をまとめて確保するためのクラス
+///
+/// ノードは std::deque にまとめて確保するので
+/// 一旦確保されたノードのアドレスは変わらない．
+/// 個々のノードを解放することはなく，clear() で全て解放する．
+//////////////////////////////////////////////////////////////////////
+class MctNodePool
+{
+public:
+
+  /// @brief コンストラクタ
+  MctNodePool() = default;
+
+  /// @brief デストラクタ
+  ~MctNodePool() = default;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ノードを確保する．
+  /// @param[in] parent 親のノード
+  /// @param[in] index ファンアウトノードのインデックス
+  /// @param[in] select 境界ノードとして選ぶ時 true にするフラグ
+  MctNode*
+  new_node(MctNode* parent,
+	   SizeType index,
+	   bool select)
+  {
+    mNodeArray.emplace_back(parent, index, select);
+    return &mNodeArray.back();
+  }
+
+  /// @brief 確保したノード数を返す．
+  SizeType
+  node_num() const
+  {
+    return mNodeArray.size();
+  }
+
+  /// @brief 全てのノードを解放する．
+  void
+  clear()
+  {
+    mNodeArray.clear();
+  }
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // ノードの本体
+  std::deque<MctNode> mNodeArray;
+
 };
 
 
@@ -180,15 +261,38 @@ MctNode::update(double val)
   mMean = mSum / mNum;
 }
 
+// @brief 仮想損失(virtual loss)を加える．
+inline
+void
+MctNode::add_virtual_loss()
+{
+  ++ mVirtualLoss;
+}
+
+// @brief 仮想損失を取り除く．
+inline
+void
+MctNode::remove_virtual_loss()
+{
+  ASSERT_COND( mVirtualLoss > 0 );
+  -- mVirtualLoss;
+}
+
 // @brief UCB1 値を返す．
 // @param[in] n_all トータルの試行回数の ln
 // @param[in] cp 調整パラメータ
+//
+// 評価中の試行は評価値 0 として数える．
 inline
 double
 MctNode::UCB1(double n_all_ln,
 	      double cp) const
 {
-  return mMean + cp * sqrt(2 * n_all_ln / mNum);
+  if ( mVirtualLoss == 0 ) {
+    return mMean + cp * sqrt(2 * n_all_ln / mNum);
+  }
+  double n = static_cast<double>(mNum + mVirtualLoss);
+  return mSum / n + cp * sqrt(2 * n_all_ln / n);
 }
 
 END_NAMESPACE_LUTMAP_MCT2
@@ -17,6 +17,7 @@
 #include "SbjGraph.h"
 
 #include "SbjDumper.h"
+#include <thread>
 
 
 #define UNIFORM_SAMPLING 0
@@ -61,6 +62,9 @@ struct Gt
   }
 };
 
+// UCB1 の調整パラメータ
+const double kCp = 0.5;
+
 END_NONAMESPACE
 
 
@@ -80,8 +84,9 @@ MctSearch::MctSearch(const SbjGraph& sbjgraph,
   mSbjGraph(sbjgraph),
   mCutHolder(cut_holder),
   mCutSize(cut_size),
-  mAreaCover(flow_mode),
-  mState(sbjgraph),
+  mFlowMode(flow_mode),
+  mNodePool(new MctNodePool),
+  mSeed(std::mt19937::default_seed),
   mVerbose(false)
 {
 
@@ -116,10 +121,8 @@ MctSearch::MctSearch(const SbjGraph& sbjgraph,
     mInputSizeList.push_back(p.second);
   }
 
-  cout << "#logic = " << sbjgraph.logic_num() << ", #fp = " << mFanoutPointList.size() << endl;
-
   mMinimumLutNum = sbjgraph.node_num() + 1;
-  mRootNode = new MctNode(nullptr, 0, false);
+  mRootNode = mNodePool->new_node(nullptr, 0, false);
 }
 
 // @brief デストラクタ
@@ -136,111 +139,170 @@ MctSearch::search(SizeType search_limit,
 		  bool verbose)
 {
   mVerbose = verbose;
-  for (mNumAll = 1; mNumAll <= search_limit; ++ mNumAll) {
-    mState.init();
-    MctNode* node = tree_policy(mRootNode);
-    double val = default_policy(node);
-    back_up(node, val);
+  vector<std::uint32_t> seed_list{static_cast<std::uint32_t>(mSeed)};
+  return search_sub(search_limit, seed_list);
+}
+
+// @brief 複数のスレッドで探索を行う．
+// @param[in] search_limit 全スレッドの試行回数の合計
+// @param[in] thread_num スレッド数
+// @param[in] verbose verbose フラグ
+// @return 最良解を返す．
+const MapRecord&
+MctSearch::search_mt(SizeType search_limit,
+		     SizeType thread_num,
+		     bool verbose)
+{
+  ASSERT_COND( thread_num > 0 );
+
+  mVerbose = verbose;
+
+  // 0 番目のスレッドは search() と同じく mSeed を用いる．
+  // 残りのスレッドの乱数の種は mSeed から作る．
+  std::seed_seq seq{static_cast<std::uint32_t>(mSeed),
+		    static_cast<std::uint32_t>(thread_num)};
+  vector<std::uint32_t> seed_list(thread_num);
+  seq.generate(seed_list.begin(), seed_list.end());
+  seed_list[0] = static_cast<std::uint32_t>(mSeed);
+  return search_sub(search_limit, seed_list);
+}
+
+// @brief 探索を行う．
+// @param[in] search_limit 全スレッドの試行回数の合計
+// @param[in] seed_list 各スレッドの乱数の種のリスト
+const MapRecord&
+MctSearch::search_sub(SizeType search_limit,
+		      const vector<std::uint32_t>& seed_list)
+{
+  if ( mVerbose ) {
+    cout << "#logic = " << mSbjGraph.logic_num() << ", #fp = " << mFanoutPointList.size() << endl;
+  }
+
+  SizeType thread_num = seed_list.size();
+  mWorkerList.clear();
+  for ( SizeType i = 0; i < thread_num; ++ i ) {
+    auto worker = new Worker{mSbjGraph, mFlowMode, seed_list[i]};
+    worker->mMinimumLutNum = mSbjGraph.node_num() + 1;
+    mWorkerList.emplace_back(worker);
+  }
+  mNumAll = 0;
+
+  vector<std::thread> thread_list;
+  thread_list.reserve(thread_num - 1);
+  for ( SizeType id = 1; id < thread_num; ++ id ) {
+    thread_list.push_back(std::thread{[this, id, search_limit]{
+      run_worker(id, search_limit);
+    }});
+  }
+  run_worker(0, search_limit);
+  for ( auto& th: thread_list ) {
+    th.join();
+  }
+
+  // 各スレッドの最良解をまとめる．
+  // mMinimumLutNum は全スレッドの最小値なので
+  // それを持つ最初のスレッドの解を採る．
+  // どのスレッドも達していない場合は以前の最良解のままとなる．
+  for ( auto& worker: mWorkerList ) {
+    if ( worker->mMinimumLutNum == mMinimumLutNum ) {
+      mBestRecord = worker->mBestRecord;
+      break;
+    }
   }
+  mWorkerList.clear();
+
   return mBestRecord;
 }
 
+// @brief 1つのスレッドの探索を行う．
+// @param[in] id スレッド番号
+// @param[in] search_limit 全スレッドの試行回数の合計
+void
+MctSearch::run_worker(SizeType id,
+		      SizeType search_limit)
+{
+  auto& worker = *mWorkerList[id];
+  for ( ; ; ) {
+    worker.mState.init();
+    MctNode* node;
+    {
+      std::lock_guard<std::mutex> lck{mTreeMutex};
+      if ( mNumAll >= search_limit ) {
+	break;
+      }
+      ++ mNumAll;
+      node = tree_policy(worker, mRootNode);
+    }
+
+    // ランダムサンプリングはロックの外で行う．
+    SizeType lut_num = default_policy(worker);
+    double val = static_cast<double>(mUpperBound - lut_num) / mWidth;
+
+    {
+      std::lock_guard<std::mutex> lck{mTreeMutex};
+      back_up(node, val);
+      if ( mMinimumLutNum > lut_num ) {
+	mMinimumLutNum = lut_num;
+      }
+      if ( mVerbose ) {
+	int slack = mFanoutPointList.size() - node->index();
+	cout << "#LUT = " << lut_num << "(" << slack << ")" << " / " << mMinimumLutNum << endl;
+      }
+    }
+  }
+}
+
 // @brief 評価値の良い子ノードを見つける．
+// @param[in] worker 対象のスレッドの状態
+// @param[in] node 根のノード
 MctNode*
-MctSearch::tree_policy(MctNode* node)
+MctSearch::tree_policy(Worker& worker,
+		       MctNode* node)
 {
-  while ( mState.index() < mFanoutPointList.size() ) {
+  auto& state = worker.mState;
+  double num_all_ln = log(mNumAll);
+  node->add_virtual_loss();
+  while ( state.index() < mFanoutPointList.size() ) {
     if ( !node->is_expanded() ) {
-      MctNode* child_node = node->expand_child();
-      const SbjNode* fpnode = mFanoutPointList[mState.index()];
+      MctNode* child_node = node->expand_child(*mNodePool);
+      child_node->add_virtual_loss();
+      node->reorder(num_all_ln, kCp);
+      const SbjNode* fpnode = mFanoutPointList[state.index()];
       if ( child_node->is_selected() ) {
-	mState.add_boundary(fpnode);
+	state.add_boundary(fpnode);
       }
       else {
-	mState.add_block(fpnode);
+	state.add_block(fpnode);
       }
-      mState.next_index();
+      state.next_index();
       return child_node;
     }
-    node = node->best_child();
-    const SbjNode* fpnode = mFanoutPointList[mState.index()];
+    MctNode* parent = node;
+    node = parent->best_child();
+    // 仮想損失を加えて並び替えることで
+    // 他のスレッドが別の子供を選びやすくする．
+    node->add_virtual_loss();
+    parent->reorder(num_all_ln, kCp);
+    const SbjNode* fpnode = mFanoutPointList[state.index()];
     if ( node->is_selected() ) {
-      mState.add_boundary(fpnode);
+      state.add_boundary(fpnode);
     }
     else {
-      mState.add_block(fpnode);
+      state.add_block(fpnode);
     }
-    mState.next_index();
+    state.next_index();
   }
   return node;
 }
 
-// @brief ランダムサンプリングを行って評価値を求める．
-double
-MctSearch::default_policy(MctNode* node)
+// @brief ランダムサンプリングを行って LUT 数を求める．
+// @param[in] worker 対象のスレッドの状態
+SizeType
+MctSearch::default_policy(Worker& worker)
 {
-#if 0
-  int nf = mFanoutPointList.size();
-  int lut_num = INT_MAX;
-  if ( mState.index() < nf ) {
-    vector<bool> state(nf, false);
-    vector<bool> old_state(nf, false);
-    for (int i = 0; i < 100; ++ i) {
-      vector<const SbjNode*> boundary_list = mState.boundary_list();
-      boundary_list.reserve(nf);
-      for (int i = mState.index(); i < nf; ++ i) {
-	if ( state[i] ) {
-	  boundary_list.push_back(mFanoutPointList[i]);
-	}
-      }
-      MapRecord record;
-      mAreaCover.record_cuts(mSbjGraph, mCutHolder, boundary_list, record);
-      MapEst gen;
-      int lut_num1;
-      int depth;
-      gen.estimate(mSbjGraph, record, lut_num1, depth);
-      cout << "  #LUT1 = " << lut_num1 << " / " << mMinimumLutNum << endl;
-      if ( lut_num > lut_num1 ) {
-	lut_num = lut_num1;
-	if ( mMinimumLutNum > lut_num ) {
-	  mMinimumLutNum = lut_num;
-	  mBestRecord = record;
-	}
-      }
-      else {
-	int delta = lut_num - lut_num1;
-	double t = exp(delta);
-	std::uniform_real_distribution<double> rd(0, 1.0);
-	double r = rd(mRandGen);
-	if ( r < t ) {
-	  // 受け入れる．
-	  lut_num = lut_num1;
-	}
-	else {
-	  state = old_state;
-	}
-      }
-      old_state = state;
-      std::uniform_int_distribution rd(0, nf - mState.index() - 1);
-      int pos = rd(mRandGen);
-      state[pos] = !state[pos + mState.index()];
-    }
-  }
-  else {
-    MapRecord record;
-    mAreaCover.record_cuts(mSbjGraph, mCutHolder, mState.boundary_list(), record);
-    MapEst gen;
-    int depth;
-    gen.estimate(mSbjGraph, record, lut_num, depth);
-    if ( mMinimumLutNum > lut_num ) {
-      mMinimumLutNum = lut_num;
-      mBestRecord = record;
-    }
-  }
-#else
-#if 1
-  while ( mState.index() < mFanoutPointList.size() ) {
-    int index = mState.index();
+  auto& state = worker.mState;
+  while ( state.index() < mFanoutPointList.size() ) {
+    int index = state.index();
     int ni = mInputSizeList[index];
 #if 1
     // 1/2 の確率で選ばない．
@@ -256,54 +318,26 @@ MctSearch::default_policy(MctNode* node)
 #endif
 #endif
     std::uniform_real_distribution<double> rd(0, 1.0);
-    double r = rd(mRandGen);
+    double r = rd(worker.mRandGen);
     const SbjNode* fanout_node = mFanoutPointList[index];
     if ( r > ratio ) {
-      mState.add_boundary(fanout_node);
+      state.add_boundary(fanout_node);
     }
-    else {
-      //mState.add_block(fanout_node);
-    }
-    mState.next_index();
+    state.next_index();
   }
 
   MapRecord record;
-  mAreaCover.record_cuts(mSbjGraph, mCutHolder, mState.boundary_list(), mState.block_list(), record);
-#else
-
-  int nf = mFanoutPointList.size();
-  int idx = mState.index();
-  MapRecord record;
-  if ( idx < nf ) {
-    vector<const SbjNode*> boundary_list = mState.boundary_list();
-    std::uniform_int_distribution<int> rd(0, nf - 1);
-    int pos = rd(mRandGen);
-    if ( pos > idx ) {
-      const SbjNode* node = mFanoutPointList[pos];
-      boundary_list.push_back(node);
-    }
-    mAreaCover.record_cuts(mSbjGraph, mCutHolder, boundary_list, mState.block_list(), record);
-  }
-  else {
-    mAreaCover.record_cuts(mSbjGraph, mCutHolder, mState.boundary_list(), mState.block_list(), record);
-  }
-#endif
+  worker.mAreaCover.record_cuts(mSbjGraph, mCutHolder, state.boundary_list(), state.block_list(), record);
 
   MapEst gen;
   SizeType lut_num;
   SizeType depth;
   gen.estimate(mSbjGraph, record, lut_num, depth);
-  if ( mMinimumLutNum > lut_num ) {
-    mMinimumLutNum = lut_num;
-    mBestRecord = record;
-  }
-#endif
-  double val = static_cast<double>(mUpperBound - lut_num) / mWidth;
-  if ( mVerbose ) {
-    int slack = mFanoutPointList.size() - node->index();
-    cout << "#LUT = " << lut_num << "(" << slack << ")" << " / " << mMinimumLutNum << endl;
+  if ( worker.mMinimumLutNum > lut_num ) {
+    worker.mMinimumLutNum = lut_num;
+    worker.mBestRecord = record;
   }
-  return val;
+  return lut_num;
 }
 
 // @brief 評価値の更新を行う．
@@ -313,13 +347,13 @@ MctSearch::back_up(MctNode* node,
 {
   double num_all_ln = log(mNumAll);
   for ( ; ; ) {
+    node->remove_virtual_loss();
     node->update(val);
     MctNode* parent = node->parent();
     if ( parent == nullptr ) {
       break;
     }
-    ASSERT_COND( parent->best_child() == node );
-    parent->reorder(num_all_ln, 0.5);
+    parent->reorder(num_all_ln, kCp);
     node = parent;
   }
 }
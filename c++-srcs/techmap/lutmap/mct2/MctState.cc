@@ -25,6 +25,10 @@ MctState::MctState(const SbjGraph& sbjgraph)
   for (int i = 0; i < sbjgraph.output_num(); ++ i) {
     const SbjNode* onode = sbjgraph.output(i);
     const SbjNode* node = onode->output_fanin();
+    if ( node == nullptr ) {
+      // 定数出力は境界ノードにならない．
+      continue;
+    }
     mOutputList.push_back(node);
   }
 }
@@ -39,6 +43,7 @@ void
 MctState::init()
 {
   mBoundaryList.clear();
+  mBlockList.clear();
 
   for (int i = 0; i < mOutputList.size(); ++ i) {
     const SbjNode* node = mOutputList[i];
@@ -14,6 +14,7 @@
 #include "LbCalc.h"
 #include "SbjGraph.h"
 #include "SbjDumper.h"
+#include <thread>
 
 
 BEGIN_NAMESPACE_LUTMAP
@@ -35,7 +36,12 @@ SaSearch::SaSearch(
 ) : mSbjGraph{sbjgraph},
     mCutHolder{cut_holder},
     mCutSize{cut_size},
-    mAreaCover{flow_mode},
+    mFlowMode{flow_mode},
+    mSeed{std::mt19937::default_seed},
+    mExchange{false},
+    mExchangeStep{0},
+    mSyncCount{0},
+    mSyncGen{0},
     mVerbose{false}
 {
   mInitTemp  = 5.0;
@@ -56,6 +62,7 @@ SaSearch::SaSearch(
   }
 
   mMinimumLutNum = sbjgraph.node_num() + 1;
+  mBestChain = 0;
 }
 
 // @brief デストラクタ
@@ -63,10 +70,14 @@ SaSearch::~SaSearch()
 {
 }
 
+BEGIN_NONAMESPACE
+
+// replica exchange で隣接する連鎖の温度の比
+const double kLadderRatio = 0.5;
+
+END_NONAMESPACE
+
 // @brief 探索を行う．
-// @param[in] search_limit 試行回数
-// @brief verbose フラグをセットする．
-// @brief 最良解を返す．
 const MapRecord&
 SaSearch::search(
   SizeType search_limit,
@@ -74,114 +85,224 @@ SaSearch::search(
 )
 {
   mVerbose = verbose;
-  auto nf = mFanoutPointList.size();
-  std::uniform_int_distribution<int> rd(0, nf - 1);
-  std::uniform_real_distribution<double> rd_real1(0, 1.0);
-  vector<bool> state(nf, false);
-  auto prev_val = evaluate(state);
+  Chain chain{mFlowMode, static_cast<std::uint32_t>(mSeed)};
+  init_chain(chain, 0);
   for (double T = mInitTemp; T > mEndTemp; T = T * mDecrement) {
-    int n_acc = 0;
-    for (mNumAll = 1; mNumAll <= search_limit; ++ mNumAll) {
-      int pos = rd(mRandGen);
-      state[pos] = !state[pos];
-      auto val = evaluate(state);
-      if ( mVerbose ) {
-	cout << "#LUT = " << val << " / " << mMinimumLutNum
-	     << " @ " << T << " (" << n_acc << " / " << mNumAll << ")" << endl;
-      }
-      if ( prev_val < val ) {
-	int dint = prev_val - val;
-	double d = static_cast<double>(dint);
-	double t = exp(d / T);
-	double r = rd_real1(mRandGen);
-	if ( r > t ) {
-	  state[pos] = !state[pos];
-	}
-	else {
-	  prev_val = val;
-	  ++ n_acc;
-	}
-      }
-      else {
-	prev_val = val;
-	++ n_acc;
-      }
+    anneal(chain, 0, T, search_limit);
+  }
+  return mBestRecord;
+}
+
+// @brief 複数の連鎖を用いて探索を行う．
+const MapRecord&
+SaSearch::search_mt(
+  SizeType search_limit,
+  SizeType chain_num,
+  bool exchange,
+  bool verbose
+)
+{
+  ASSERT_COND( chain_num > 0 );
+
+  mVerbose = verbose;
+  mExchange = exchange;
+
+  // 各連鎖と交換判定用の乱数の種を mSeed から作る．
+  std::seed_seq seq{static_cast<std::uint32_t>(mSeed),
+		    static_cast<std::uint32_t>(chain_num)};
+  vector<std::uint32_t> seed_list(chain_num + 1);
+  seq.generate(seed_list.begin(), seed_list.end());
+
+  mChainList.clear();
+  mLadder.clear();
+  double scale = 1.0;
+  for ( SizeType i = 0; i < chain_num; ++ i ) {
+    auto chain = new Chain{mFlowMode, seed_list[i]};
+    if ( mExchange ) {
+      chain->mTempScale = scale;
+      scale *= kLadderRatio;
     }
+    mChainList.emplace_back(chain);
+    mLadder.push_back(i);
+  }
+  mExchangeRandGen.seed(seed_list[chain_num]);
+  mExchangeStep = 0;
+  mSyncCount = 0;
+
+  vector<std::thread> thread_list;
+  thread_list.reserve(chain_num - 1);
+  for ( SizeType id = 1; id < chain_num; ++ id ) {
+    thread_list.push_back(std::thread{[this, id, search_limit]{
+      run_chain(id, search_limit);
+    }});
   }
+  run_chain(0, search_limit);
+  for ( auto& th: thread_list ) {
+    th.join();
+  }
+  mChainList.clear();
+
   return mBestRecord;
 }
 
-#if 0
+// @brief 連鎖の初期状態を設定する．
+void
+SaSearch::init_chain(
+  Chain& chain,
+  SizeType id
+)
+{
+  SizeType nf = mFanoutPointList.size();
+  chain.mState.clear();
+  chain.mState.resize(nf, false);
+  chain.mAreaCover.init_incr(mSbjGraph, mCutHolder, {}, chain.mRecord);
+  chain.mMapEst.init_incr(mSbjGraph, chain.mRecord);
+  chain.mVal = evaluate(chain, id);
+}
 
-// @brief 現在の割り当てのもとで評価を行う．
-int
-SaSearch::evaluate(const vector<bool>& state)
+// @brief 温度 T で search_limit 回の試行を行う．
+void
+SaSearch::anneal(
+  Chain& chain,
+  SizeType id,
+  double T,
+  SizeType search_limit
+)
 {
   auto nf = mFanoutPointList.size();
-  vector<const SbjNode*> boundary_list;
-  boundary_list.reserve(nf);
-  vector<const SbjNode*> dupnode_list;
-  dupnode_list.reserve(nf);
-  for (int i = 0; i < nf; ++ i) {
-    const SbjNode* fpnode = mFanoutPointList[i];
-    if ( state[i] ) {
-      boundary_list.push_back(fpnode);
+  if ( nf == 0 ) {
+    return;
+  }
+  std::uniform_int_distribution<int> rd(0, nf - 1);
+  std::uniform_real_distribution<double> rd_real1(0, 1.0);
+  auto& state = chain.mState;
+  auto& area_cover = chain.mAreaCover;
+  auto& map_est = chain.mMapEst;
+  int n_acc = 0;
+  for ( SizeType num = 1; num <= search_limit; ++ num ) {
+    int pos = rd(chain.mRandGen);
+    state[pos] = !state[pos];
+    // 変更の影響を受けるノードのみ差分で更新する．
+    area_cover.flip_boundary(mFanoutPointList[pos]);
+    map_est.update(chain.mRecord, area_cover.changed_node_list());
+    auto val = evaluate(chain, id);
+    if ( mVerbose && mChainList.empty() ) {
+      cout << "#LUT = " << val << " / " << mMinimumLutNum
+	   << " @ " << T << " (" << n_acc << " / " << num << ")" << endl;
+    }
+    if ( chain.mVal < val ) {
+      int dint = chain.mVal - val;
+      double d = static_cast<double>(dint);
+      double t = exp(d / T);
+      double r = rd_real1(chain.mRandGen);
+      if ( r > t ) {
+	state[pos] = !state[pos];
+	area_cover.undo();
+	map_est.update(chain.mRecord, area_cover.changed_node_list());
+      }
+      else {
+	chain.mVal = val;
+	++ n_acc;
+      }
     }
     else {
-      dupnode_list.push_back(fpnode);
+      chain.mVal = val;
+      ++ n_acc;
     }
   }
+}
 
-  MapRecord record;
-  mAreaCover.record_cuts(mSbjGraph, mCutHolder, boundary_list, dupnode_list, record);
-
-  MapEst est;
-  int lut_num;
-  int depth;
-  est.estimate(mSbjGraph, record, lut_num, depth);
-
-  if ( mMinimumLutNum > lut_num ) {
-    mMinimumLutNum = lut_num;
-    mBestRecord = record;
+// @brief search_mt() で各スレッドが実行する関数
+void
+SaSearch::run_chain(
+  SizeType id,
+  SizeType search_limit
+)
+{
+  auto& chain = *mChainList[id];
+  init_chain(chain, id);
+  for (double T = mInitTemp; T > mEndTemp; T = T * mDecrement) {
+    anneal(chain, id, T * chain.mTempScale, search_limit);
+    if ( mExchange ) {
+      sync(T);
+    }
   }
-
-  return lut_num;
 }
 
-#else
+// @brief すべての連鎖が温度 T の試行を終えるまで待つ．
+void
+SaSearch::sync(
+  double T
+)
+{
+  std::unique_lock<std::mutex> lck{mSyncMutex};
+  SizeType gen = mSyncGen;
+  ++ mSyncCount;
+  if ( mSyncCount == mChainList.size() ) {
+    exchange(T);
+    mSyncCount = 0;
+    ++ mSyncGen;
+    mSyncCond.notify_all();
+  }
+  else {
+    mSyncCond.wait(lck, [&]{ return mSyncGen != gen; });
+  }
+}
 
-// @brief 現在の割り当てのもとで評価を行う．
-SizeType
-SaSearch::evaluate(
-  const vector<bool>& state
+// @brief 隣接する温度の連鎖の間で温度の交換を試みる．
+void
+SaSearch::exchange(
+  double T
 )
 {
-  SizeType nf = mFanoutPointList.size();
-  vector<const SbjNode*> boundary_list;
-  boundary_list.reserve(nf);
-  for (SizeType i = 0; i < nf; ++ i) {
-    auto fpnode = mFanoutPointList[i];
-    if ( state[i] ) {
-      boundary_list.push_back(fpnode);
+  // 温度の隣接する組を偶数番目からと奇数番目からとで交互に試す．
+  std::uniform_real_distribution<double> rd_real1(0, 1.0);
+  SizeType n = mLadder.size();
+  for ( SizeType i = mExchangeStep % 2; i + 1 < n; i += 2 ) {
+    auto& chain1 = *mChainList[mLadder[i]];
+    auto& chain2 = *mChainList[mLadder[i + 1]];
+    double beta1 = 1.0 / (T * chain1.mTempScale);
+    double beta2 = 1.0 / (T * chain2.mTempScale);
+    double e1 = static_cast<double>(chain1.mVal);
+    double e2 = static_cast<double>(chain2.mVal);
+    double d = (beta1 - beta2) * (e1 - e2);
+    if ( d >= 0.0 || rd_real1(mExchangeRandGen) < exp(d) ) {
+      std::swap(chain1.mTempScale, chain2.mTempScale);
+      std::swap(mLadder[i], mLadder[i + 1]);
     }
   }
+  ++ mExchangeStep;
 
-  MapRecord record;
-  mAreaCover.record_cuts(mSbjGraph, mCutHolder, boundary_list, record);
+  if ( mVerbose ) {
+    cout << "#LUT = " << mMinimumLutNum << " @ " << T << " :";
+    for ( auto id: mLadder ) {
+      cout << " " << mChainList[id]->mVal;
+    }
+    cout << endl;
+  }
+}
 
-  MapEst est;
-  SizeType lut_num;
-  SizeType depth;
-  est.estimate(mSbjGraph, record, lut_num, depth);
+// @brief 連鎖の現在の解を評価する．
+SizeType
+SaSearch::evaluate(
+  Chain& chain,
+  SizeType id
+)
+{
+  auto lut_num = chain.mMapEst.incr_lut_num();
 
-  if ( mMinimumLutNum > lut_num ) {
-    mMinimumLutNum = lut_num;
-    mBestRecord = record;
+  {
+    // 同じ値の場合は連鎖番号の小さい方を採る．
+    std::lock_guard<std::mutex> lck{mBestMutex};
+    if ( mMinimumLutNum > lut_num ||
+	 (mMinimumLutNum == lut_num && mBestChain > id) ) {
+      mMinimumLutNum = lut_num;
+      mBestChain = id;
+      mBestRecord = chain.mRecord;
+    }
   }
 
   return lut_num;
 }
 
-#endif
-
 END_NAMESPACE_LUTMAP
@@ -38,6 +38,7 @@ Bn2Sbj::convert(
 )
 {
   dst_network.clear();
+  dst_network.set_strash(mStrash);
 
   // ネットワーク名の設定
   dst_network.set_name(src_network.name());
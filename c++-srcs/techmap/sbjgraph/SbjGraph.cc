@@ -21,6 +21,45 @@
 
 BEGIN_NAMESPACE_SBJ
 
+BEGIN_NONAMESPACE
+
+// 構造ハッシュ表の最小サイズ
+const SizeType kStrashMinSize = 1024;
+
+// ハンドルをノード番号と極性をパックした値に変換する．
+inline
+SizeType
+strash_lit(
+  SbjHandle handle
+)
+{
+  return handle.node()->id() * 2 + static_cast<SizeType>(handle.inv());
+}
+
+// 構造ハッシュ用のハッシュ関数
+//
+// ファンインの順序には依存しない．
+inline
+SizeType
+strash_hash(
+  SbjNodeType type,
+  SizeType lit1,
+  SizeType lit2
+)
+{
+  if ( lit1 > lit2 ) {
+    std::swap(lit1, lit2);
+  }
+  std::uint64_t h = lit1 * 0x9E3779B97F4A7C15ULL;
+  h ^= lit2 * 0xC2B2AE3D27D4EB4FULL;
+  h ^= static_cast<std::uint64_t>(type);
+  h ^= (h >> 29);
+  return static_cast<SizeType>(h);
+}
+
+END_NONAMESPACE
+
+
 ///////////////////////////////////////////////////////////////////////
 // クラス SbjGraph
 ///////////////////////////////////////////////////////////////////////
@@ -69,6 +108,10 @@ SbjGraph::_copy(
   // 名前のコピー
   mName = src.mName;
 
+  // 構造ハッシュモードのコピー
+  // ( src に重複したノードがあればここでマージされる)
+  mStrash = src.mStrash;
+
   // 外部入力の生成
   for ( auto src_node: src.input_list() ) {
     auto dst_node = new_input(src_node->is_bipol());
@@ -213,6 +256,30 @@ SbjGraph::clear()
   mDffList.clear();
   mLatchList.clear();
   mPortArray.clear();
+  mStrashTable.clear();
+  mStrashNum = 0;
+}
+
+// @brief 構造ハッシュモードを設定する．
+void
+SbjGraph::set_strash(
+  bool flag
+)
+{
+  mStrash = flag;
+  mStrashTable.clear();
+  mStrashNum = 0;
+  if ( mStrash ) {
+    // 既存の論理ノードを登録する．
+    SizeType size = kStrashMinSize;
+    while ( size < mLogicList.size() * 2 ) {
+      size <<= 1;
+    }
+    mStrashTable.resize(size, nullptr);
+    for ( auto node: mLogicList ) {
+      _strash_reg(mNodeArray[node->id()]);
+    }
+  }
 }
 
 // @brief ポートを追加する(ベクタ版)．
@@ -604,6 +671,18 @@ SbjGraph::_new_logic_node(
   SbjHandle ihandle2
 )
 {
+  SizeType pos = 0;
+  if ( mStrash ) {
+    if ( (mStrashNum + 1) * 2 > mStrashTable.size() ) {
+      _strash_resize(std::max(mStrashTable.size() * 2, kStrashMinSize));
+    }
+    auto node = _strash_find(type, ihandle1, ihandle2, pos);
+    if ( node != nullptr ) {
+      // 同じ構造のノードがすでに存在した．
+      return node;
+    }
+  }
+
   SizeType id = mNodeArray.size();
   auto node = new SbjNode{id, type, ihandle1, ihandle2};
 
@@ -613,9 +692,86 @@ SbjGraph::_new_logic_node(
   // 論理ノードリストに登録
   mLogicList.push_back(node);
 
+  if ( mStrash ) {
+    // 構造ハッシュ表に登録
+    mStrashTable[pos] = node;
+    ++ mStrashNum;
+  }
+
   return node;
 }
 
+// @brief 構造ハッシュ表から同じ構造のノードを探す．
+SbjNode*
+SbjGraph::_strash_find(
+  SbjNodeType type,
+  SbjHandle ihandle1,
+  SbjHandle ihandle2,
+  SizeType& pos
+) const
+{
+  ASSERT_COND( !mStrashTable.empty() );
+
+  auto lit1 = strash_lit(ihandle1);
+  auto lit2 = strash_lit(ihandle2);
+  if ( lit1 > lit2 ) {
+    std::swap(lit1, lit2);
+  }
+  SizeType mask = mStrashTable.size() - 1;
+  for ( pos = strash_hash(type, lit1, lit2) & mask; ;
+	pos = (pos + 1) & mask ) {
+    auto node = mStrashTable[pos];
+    if ( node == nullptr ) {
+      return nullptr;
+    }
+    if ( node->type() != type ) {
+      continue;
+    }
+    auto lit1_n = strash_lit(node->fanin0_handle());
+    auto lit2_n = strash_lit(node->fanin1_handle());
+    if ( lit1_n > lit2_n ) {
+      std::swap(lit1_n, lit2_n);
+    }
+    if ( lit1 == lit1_n && lit2 == lit2_n ) {
+      return node;
+    }
+  }
+}
+
+// @brief 構造ハッシュ表にノードを登録する．
+void
+SbjGraph::_strash_reg(
+  SbjNode* node
+)
+{
+  SizeType pos;
+  auto node1 = _strash_find(node->type(),
+			    node->fanin0_handle(),
+			    node->fanin1_handle(),
+			    pos);
+  if ( node1 == nullptr ) {
+    mStrashTable[pos] = node;
+    ++ mStrashNum;
+  }
+}
+
+// @brief 構造ハッシュ表を拡大する．
+void
+SbjGraph::_strash_resize(
+  SizeType size
+)
+{
+  vector<SbjNode*> old_table;
+  old_table.swap(mStrashTable);
+  mStrashTable.resize(size, nullptr);
+  mStrashNum = 0;
+  for ( auto node: old_table ) {
+    if ( node != nullptr ) {
+      _strash_reg(node);
+    }
+  }
+}
+
 // DFFノードを作る．
 SbjDff*
 SbjGraph::new_dff(
@@ -25,13 +25,14 @@ SbjMinDepth::SbjMinDepth(
 {
   SizeType n = sbjgraph.node_num();
 
-  mTfiNodeList.reserve(n);
+  mSinkList.reserve(n);
+  mTouchedList.reserve(n);
+  mVisitedList.reserve(n);
+  mStack.reserve(n * 2 + 1);
 
   mNodeNum = n;
   mNodeArray = new SmdNode[n];
 
-  vector<vector<SmdEdge*>> foedge_list_array(n);
-
   // sbjgraph の構造を SmdNode にコピーする．
   mInputList.reserve(sbjgraph.input_list().size());
   for ( auto sbjnode: sbjgraph.input_list() ) {
@@ -47,23 +48,25 @@ SbjMinDepth::SbjMinDepth(
     auto node = &mNodeArray[id];
     node->set_id(id, true);
     mLogicNodeList.push_back(node);
-
-    auto isbjnode0 = sbjnode->fanin0();
-    auto inode0 = &mNodeArray[isbjnode0->id()];
-    node->set_fanin0(inode0);
-    auto edge0 = node->fanin0_edge();
-    foedge_list_array[inode0->id()].push_back(edge0);
-
-    auto isbjnode1 = sbjnode->fanin1();
-    auto inode1 = &mNodeArray[isbjnode1->id()];
-    node->set_fanin1(inode1);
-    auto edge1 = node->fanin1_edge();
-    foedge_list_array[inode1->id()].push_back(edge1);
+    node->set_fanin0(&mNodeArray[sbjnode->fanin0()->id()]);
+    node->set_fanin1(&mNodeArray[sbjnode->fanin1()->id()]);
   }
 
-  for ( SizeType i = 0; i < n; ++ i ) {
-    auto node = &mNodeArray[i];
-    node->set_fanout_array(foedge_list_array[node->id()]);
+  // ファンアウトは SbjNode のファンアウトリストから直接作る．
+  // 出力ノードへのファンアウトは含めない．
+  vector<SmdEdge*> foedge_list;
+  for ( SizeType id = 0; id < n; ++ id ) {
+    foedge_list.clear();
+    for ( auto& edge: sbjgraph.node(id)->fanout_list() ) {
+      auto onode = edge.to();
+      if ( !onode->is_logic() ) {
+	continue;
+      }
+      auto smd_onode = &mNodeArray[onode->id()];
+      auto foedge = edge.pos() == 0 ? smd_onode->fanin0_edge() : smd_onode->fanin1_edge();
+      foedge_list.push_back(foedge);
+    }
+    mNodeArray[id].set_fanout_array(foedge_list);
   }
 }
 
@@ -119,7 +122,18 @@ SbjMinDepth::operator()(
   return ans;
 }
 
-// node を根とする深さ d - 1 の k-feasible cut が存在するかどうか調べる．
+BEGIN_NONAMESPACE
+
+// augment() のスタックの要素がどうやってその頂点に至ったかを表す値
+const int kFromSink    = 0; // シンクから枝を逆にたどった．
+const int kInternalFwd = 1; // 出力側から入力側に分割ノード内の枝をたどった．
+const int kFanoutRev   = 2; // flow の流れている枝を順方向にたどった．
+const int kFaninFwd    = 3; // 入力側からファンインの枝を逆にたどった．
+const int kInternalRev = 4; // 入力側から出力側に分割ノード内の枝を逆流した．
+
+END_NONAMESPACE
+
+// @brief node を根とする深さ d の k-feasible cut が存在するかどうか調べる．
 bool
 SbjMinDepth::find_k_cut(
   SmdNode* node,
@@ -131,33 +145,22 @@ SbjMinDepth::find_k_cut(
     return false;
   }
 
-  // node の transitive fanin に rmark を付ける．
-  // node および 深さ d のノードに tmark を付ける．
-  mTfiNodeList.clear();
-  node->set_tmark();
-  mark_tfi(node, d);
+  // node および深さ d のノードに tmark を付ける．
+  mSinkList.clear();
+  mTouchedList.clear();
+  mark_sink(node, d);
 
   // PI から tmark の付いたノードまで至る素な経路が
   // k + 1 本以上あれば k-feasible cut は存在しない．
-  bool found = true;
-  SizeType c = 0;
-  for ( auto start: mInputList ) {
-    if ( !start->rmark() ) {
-      continue;
-    }
-    bool stat = dfs_fanout(start);
-    for ( auto node: mTfiNodeList ) {
-      node->clear_vmark();
-    }
-    if ( stat ) {
-      ++ c;
-      if ( c > k ) {
-	found = false;
-	break;
-      }
+  bool found = false;
+  for ( SizeType c = 0; c <= k; ++ c ) {
+    if ( !augment() ) {
+      found = true;
+      break;
     }
   }
-  for ( auto node: mTfiNodeList ) {
+
+  for ( auto node: mTouchedList ) {
     node->clear_rtfmark();
     if ( node->is_logic() ) {
       node->fanin0_edge()->clear_flow();
@@ -168,124 +171,168 @@ SbjMinDepth::find_k_cut(
   return found;
 }
 
-// node およびその TFI に rmark を付ける．
-// depth が d のノードに tmark を付ける．
+// @brief シンクとなるノードに tmark を付けて mSinkList に入れる．
 void
-SbjMinDepth::mark_tfi(
+SbjMinDepth::mark_sink(
   SmdNode* node,
   SizeType d
 )
 {
-  if ( !node->check_rmark() ) {
-    mTfiNodeList.push_back(node);
-    if ( node->depth() == d ) {
-      node->set_tmark();
-    }
-    if ( node->is_logic() ) {
-      mark_tfi(node->fanin0(), d);
-      mark_tfi(node->fanin1(), d);
-    }
-  }
-}
-
-// node のファンアウトを探索する．
-bool
-SbjMinDepth::dfs_fanout(
-  SmdNode* node
-)
-{
-  SizeType n = node->fanout_num();
-  for ( SizeType i = 0; i < n; ++ i ) {
-    auto edge = node->fanout_edge(i);
-    auto to_node = edge->to();
-    if ( !to_node->rmark() ) {
-      // target の TFI ではない．
-      continue;
-    }
-    if ( !to_node->check_vmark1() ) {
-      bool stat = dfs(to_node, 0);
-      if ( stat ) {
-	edge->set_flow();
-	return true;
+  // 深さが単調非減少なので深さ d のノードのファンインを
+  // 深さ d のノードだけたどればよい．
+  touch(node);
+  node->set_tmark();
+  mSinkList.push_back(node);
+  for ( SizeType rpos = 0; rpos < mSinkList.size(); ++ rpos ) {
+    auto node1 = mSinkList[rpos];
+    for ( auto inode: {node1->fanin0(), node1->fanin1()} ) {
+      if ( inode->is_logic() && inode->depth() == d && !inode->tmark() ) {
+	touch(inode);
+	inode->set_tmark();
+	mSinkList.push_back(inode);
       }
     }
   }
-  return false;
 }
 
+// @brief シンクからソースに至る増加路を探して流量を増やす．
 bool
-SbjMinDepth::dfs(
-  SmdNode* cur_node,
-  int dir
-)
+SbjMinDepth::augment()
 {
-  if ( cur_node->tmark() ) {
-    // target にたどり着いた
-    return true;
-  }
-
-  if ( dir == 0 ) {
-    // 前向き
-    auto edge0 = cur_node->fanin0_edge();
-    auto edge1 = cur_node->fanin1_edge();
-    if ( edge0->flow() ) {
-      auto from_node = edge0->from();
-      if ( !from_node->check_vmark2() ) {
-	bool stat = dfs(from_node, 1);
-	if ( stat ) {
-	  edge0->clear_flow();
-	  return true;
+  // 後続の頂点を順に調べて未訪問のものをスタックに積む．
+  // 外部入力の入力側の頂点に至ればそこがソースとつながっている．
+  mVisitedList.clear();
+  mStack.clear();
+  mStack.push_back(Frame{nullptr, false, kFromSink, nullptr, 0});
+  bool found = false;
+  while ( !mStack.empty() ) {
+    auto& frame = mStack.back();
+    auto node = frame.mNode;
+    SmdNode* next = nullptr;
+    bool next_out = false;
+    int kind = 0;
+    SmdEdge* edge = nullptr;
+    if ( node == nullptr ) {
+      // シンク: シンクに含まれないファンインの出力側に進む．
+      while ( frame.mPos < mSinkList.size() * 2 ) {
+	auto snode = mSinkList[frame.mPos / 2];
+	auto e = (frame.mPos % 2) == 0 ? snode->fanin0_edge() : snode->fanin1_edge();
+	++ frame.mPos;
+	auto inode = e->from();
+	if ( !inode->tmark() && !e->flow() && !inode->check_vmark2() ) {
+	  next = inode;
+	  next_out = true;
+	  kind = kFromSink;
+	  edge = e;
+	  break;
 	}
       }
     }
-    else if ( edge1->flow() ) {
-      auto from_node = edge1->from();
-      if ( !from_node->check_vmark2() ) {
-	bool stat = dfs(from_node, 1);
-	if ( stat ) {
-	  edge1->clear_flow();
-	  return true;
+    else if ( frame.mOut ) {
+      // 出力側の頂点
+      // - flow が流れていなければ同じノードの入力側に進む．
+      // - flow の流れているファンアウトの枝があればその先の入力側に進む．
+      if ( frame.mPos == 0 ) {
+	++ frame.mPos;
+	if ( !node->fmark() && !node->check_vmark1() ) {
+	  next = node;
+	  next_out = false;
+	  kind = kInternalFwd;
 	}
       }
-    }
-    else if ( !cur_node->check_vmark2() ) {
-      bool stat = dfs_fanout(cur_node);
-      if ( stat ) {
-	return true;
+      while ( next == nullptr && frame.mPos <= node->fanout_num() ) {
+	auto e = node->fanout_edge(frame.mPos - 1);
+	++ frame.mPos;
+	auto onode = e->to();
+	if ( e->flow() && !onode->tmark() && !onode->check_vmark1() ) {
+	  next = onode;
+	  next_out = false;
+	  kind = kFanoutRev;
+	  edge = e;
+	}
       }
     }
-  }
-  else {
-    if ( cur_node->is_logic() && !cur_node->check_vmark1() ) {
-      auto edge0 = cur_node->fanin0_edge();
-      if ( edge0->flow() ) {
-	auto from_node = edge0->from();
-	if ( !from_node->check_vmark2() ) {
-	  bool stat = dfs(from_node, 1);
-	  if ( stat ) {
-	    edge0->clear_flow();
-	    return true;
-	  }
-	}
+    else {
+      // 入力側の頂点
+      if ( node->is_input() ) {
+	// ソースにたどり着いた．
+	found = true;
+	break;
       }
-      auto edge1 = cur_node->fanin1_edge();
-      if ( edge1->flow() ) {
-	auto from_node = edge1->from();
-	if ( !from_node->check_vmark2() ) {
-	  bool stat = dfs(from_node, 1);
-	  if ( stat ) {
-	    edge1->clear_flow();
-	    return true;
+      // - ファンインの出力側に進む．
+      // - flow が流れていれば同じノードの出力側に進む．
+      while ( next == nullptr && frame.mPos < 3 ) {
+	auto pos = frame.mPos;
+	++ frame.mPos;
+	if ( pos < 2 ) {
+	  auto e = pos == 0 ? node->fanin0_edge() : node->fanin1_edge();
+	  auto inode = e->from();
+	  if ( !e->flow() && !inode->check_vmark2() ) {
+	    next = inode;
+	    next_out = true;
+	    kind = kFaninFwd;
+	    edge = e;
 	  }
 	}
+	else if ( node->fmark() && !node->check_vmark2() ) {
+	  next = node;
+	  next_out = true;
+	  kind = kInternalRev;
+	}
       }
     }
-    bool stat = dfs_fanout(cur_node);
-    if ( stat ) {
-      return true;
+
+    if ( next == nullptr ) {
+      // 後続がなくなったので戻る．
+      mStack.pop_back();
+      continue;
+    }
+    touch(next);
+    mVisitedList.push_back(next);
+    mStack.push_back(Frame{next, next_out, kind, edge, 0});
+  }
+
+  if ( found ) {
+    // スタック上の経路に沿って流量を更新する．
+    for ( SizeType i = 1; i < mStack.size(); ++ i ) {
+      auto& frame = mStack[i];
+      switch ( frame.mKind ) {
+      case kFromSink:
+      case kFaninFwd:
+	frame.mEdge->set_flow();
+	break;
+
+      case kFanoutRev:
+	frame.mEdge->clear_flow();
+	break;
+
+      case kInternalFwd:
+	frame.mNode->set_fmark();
+	break;
+
+      case kInternalRev:
+	frame.mNode->clear_fmark();
+	break;
+      }
     }
   }
-  return false;
+
+  for ( auto node: mVisitedList ) {
+    node->clear_vmark();
+  }
+
+  return found;
+}
+
+// @brief ノードに rmark を付けて mTouchedList に登録する．
+void
+SbjMinDepth::touch(
+  SmdNode* node
+)
+{
+  if ( !node->check_rmark() ) {
+    mTouchedList.push_back(node);
+  }
 }
 
 END_NAMESPACE_SBJ
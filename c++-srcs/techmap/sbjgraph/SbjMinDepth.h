@@ -52,35 +52,68 @@ private:
   // mindepth 関係の関数
   //////////////////////////////////////////////////////////////////////
 
-  // node を根とする深さ d - 1 の k-feasible cut が存在するかどうか調べる．
+  /// @brief node を根とする深さ d の k-feasible cut が存在するかどうか調べる．
+  ///
+  /// node および深さ d のノードをまとめたものをシンクとし，
+  /// 外部入力をソースとするネットワークの最大流が k 以下かどうかを
+  /// 調べる．ただし，増加路の探索は高々 k + 1 回しか行わない．
   bool
   find_k_cut(
-    SmdNode* node,
-    SizeType k,
-    SizeType d
+    SmdNode* node, ///< [in] 根のノード
+    SizeType k,    ///< [in] カットの入力数の最大値
+    SizeType d     ///< [in] 深さ
   );
 
-  // node およびその TFI に rmark を付ける．
-  // depth が d のノードに tmark を付ける．
+  /// @brief シンクとなるノードに tmark を付けて mSinkList に入れる．
+  ///
+  /// 深さ d のノードは node から深さ d のノードのみを通って
+  /// たどることができるので探索はその範囲に限られる．
   void
-  mark_tfi(
-    SmdNode* node,
-    SizeType d
+  mark_sink(
+    SmdNode* node, ///< [in] 根のノード
+    SizeType d     ///< [in] 深さ
   );
 
-  // node のファンアウトを探索する．
+  /// @brief シンクからソースに至る増加路を探して流量を増やす．
+  /// @return 増加路が見つかったら true を返す．
+  ///
+  /// 各ノードは入力側と出力側の2つの頂点に分割されているものとみなし，
+  /// 残余グラフ上をシンク側から逆向きに非再帰の深さ優先探索を行う．
   bool
-  dfs_fanout(
-    SmdNode* node
-  );
+  augment();
 
-  bool
-  dfs(
-    SmdNode* cur_node,
-    int dir
+  /// @brief ノードに rmark を付けて mTouchedList に登録する．
+  void
+  touch(
+    SmdNode* node ///< [in] 対象のノード
   );
 
 
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 増加路探索用のスタックの要素
+  struct Frame
+  {
+    // ノード(シンクの場合は nullptr)
+    SmdNode* mNode;
+
+    // 出力側の頂点の時 true
+    bool mOut;
+
+    // この頂点に至った操作の種類
+    int mKind;
+
+    // この頂点に至った枝
+    SmdEdge* mEdge;
+
+    // 次に調べる後続の位置
+    SizeType mPos;
+  };
+
+
 private:
   //////////////////////////////////////////////////////////////////////
   // データメンバ
@@ -95,8 +128,17 @@ private:
   // ソートされた論理ノードのリスト
   vector<SmdNode*> mLogicNodeList;
 
-  // mark_tfi で用いるノードのリスト
-  vector<SmdNode*> mTfiNodeList;
+  // シンクとなるノードのリスト
+  vector<SmdNode*> mSinkList;
+
+  // find_k_cut() で印を付けたノードのリスト
+  vector<SmdNode*> mTouchedList;
+
+  // augment() で訪れたノードのリスト
+  vector<SmdNode*> mVisitedList;
+
+  // augment() で用いるスタック
+  vector<Frame> mStack;
 
   // ノード数
   SizeType mNodeNum;
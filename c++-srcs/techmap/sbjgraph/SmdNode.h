@@ -284,6 +284,13 @@ public:
     mMark |= kFlowMask;
   }
 
+  /// @brief flow 用のマークを消す．
+  void
+  clear_fmark()
+  {
+    mMark &= ~kFlowMask;
+  }
+
   /// @brief range/target/flow マークを消す．
   void
   clear_rtfmark()
@@ -346,7 +353,7 @@ private:
   vector<SmdEdge*> mFanoutArray;
 
   // get_min_depth() 用の作業領域
-  SizeType mMark;
+  SizeType mMark{0};
 
   // 深さ
   SizeType mDepth;
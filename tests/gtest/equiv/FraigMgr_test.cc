@@ -0,0 +1,290 @@
+
+/// @file FraigMgr_test.cc
+/// @brief FraigMgr のテストプログラム
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "gtest/gtest.h"
+#include "FraigMgr.h"
+#include "FraigNode.h"
+#include "ym/Range.h"
+#include <random>
+
+
+BEGIN_NAMESPACE_MAGUS
+
+TEST(FraigMgrTest, strash)
+{
+  FraigMgr mgr{1};
+
+  auto x = mgr.make_input();
+  auto y = mgr.make_input();
+
+  auto h1 = mgr.make_and(x, y);
+  SizeType n = mgr.node_num();
+  // 入力の順番が違っても同じノードになる．
+  auto h2 = mgr.make_and(y, x);
+  EXPECT_EQ( h1, h2 );
+  EXPECT_EQ( n, mgr.node_num() );
+
+  // 極性が異なれば別のノードになる．
+  auto h3 = mgr.make_and(~x, y);
+  EXPECT_NE( h1, h3 );
+  EXPECT_EQ( n + 1, mgr.node_num() );
+}
+
+TEST(FraigMgrTest, strash_resize)
+{
+  // 構造ハッシュの初期サイズを超える数のノードを作る．
+  const SizeType N = 600;
+
+  FraigMgr mgr{1};
+
+  vector<FraigHandle> input_list(N * 2);
+  for ( SizeType i: Range(N * 2) ) {
+    input_list[i] = mgr.make_input();
+  }
+  vector<FraigHandle> and_list(N);
+  for ( SizeType i: Range(N) ) {
+    and_list[i] = mgr.make_and(input_list[i * 2], input_list[i * 2 + 1]);
+  }
+  SizeType n = mgr.node_num();
+
+  // 2回目はすべて構造ハッシュにヒットする．
+  for ( SizeType i: Range(N) ) {
+    auto h = mgr.make_and(input_list[i * 2 + 1], input_list[i * 2]);
+    EXPECT_EQ( and_list[i], h );
+  }
+  EXPECT_EQ( n, mgr.node_num() );
+}
+
+TEST(FraigMgrTest, sweep)
+{
+  FraigMgr mgr{1};
+  mgr.set_sweep_mode(true);
+
+  auto x = mgr.make_input();
+  auto y = mgr.make_input();
+  auto z = mgr.make_input();
+
+  // 構造は異なるが論理的には等価
+  auto h1 = mgr.make_and(x, mgr.make_and(y, z));
+  auto h2 = mgr.make_and(mgr.make_and(x, y), z);
+  EXPECT_NE( h1, h2 );
+
+  // x & ~x & y は定数0
+  auto h3 = mgr.make_and(mgr.make_and(x, y), mgr.make_and(~x, z));
+  EXPECT_FALSE( h3.is_zero() );
+
+  mgr.sweep();
+  EXPECT_EQ( mgr.rep_handle(h1), mgr.rep_handle(h2) );
+  EXPECT_EQ( mgr.rep_handle(~h1), mgr.rep_handle(~h2) );
+  EXPECT_TRUE( mgr.rep_handle(h3).is_zero() );
+  EXPECT_EQ( x, mgr.rep_handle(x) );
+}
+
+TEST(FraigMgrTest, sweep_many_cex)
+{
+  // 最小項の関数はランダムパタンではほぼ 0 となるので
+  // すべて同じクラスに入り，SAT の反例で分割される．
+  // 反例の数は1語(64個)を超える．
+  const SizeType NI = 12;
+  const SizeType N = 100;
+
+  FraigMgr mgr{1};
+  mgr.set_sweep_mode(true);
+
+  vector<FraigHandle> input_list(NI);
+  for ( SizeType i: Range(NI) ) {
+    input_list[i] = mgr.make_input();
+  }
+
+  std::mt19937 rg;
+  std::uniform_int_distribution<SizeType> rd(0, (1U << NI) - 1);
+  vector<SizeType> minterm_list(N);
+  vector<FraigHandle> h1_list(N);
+  vector<FraigHandle> h2_list(N);
+  for ( SizeType k: Range(N) ) {
+    auto m = rd(rg);
+    minterm_list[k] = m;
+    vector<FraigHandle> lit_list(NI);
+    for ( SizeType i: Range(NI) ) {
+      lit_list[i] = ((m >> i) & 1U) ? input_list[i] : ~input_list[i];
+    }
+    // 同じ最小項を前からと後ろからの2通りの構造で作る．
+    auto h1 = lit_list[0];
+    for ( SizeType i = 1; i < NI; ++ i ) {
+      h1 = mgr.make_and(h1, lit_list[i]);
+    }
+    auto h2 = lit_list[NI - 1];
+    for ( SizeType i = NI - 1; i > 0; -- i ) {
+      h2 = mgr.make_and(lit_list[i - 1], h2);
+    }
+    h1_list[k] = h1;
+    h2_list[k] = h2;
+  }
+
+  mgr.sweep();
+
+  for ( SizeType k: Range(N) ) {
+    auto r1 = mgr.rep_handle(h1_list[k]);
+    auto r2 = mgr.rep_handle(h2_list[k]);
+    EXPECT_FALSE( r1.is_const() );
+    EXPECT_EQ( r1, r2 );
+    for ( SizeType j: Range(k) ) {
+      // 最小項が等しい時だけ同じ代表になる．
+      auto rj = mgr.rep_handle(h1_list[j]);
+      if ( minterm_list[j] == minterm_list[k] ) {
+	EXPECT_EQ( rj, r1 );
+      }
+      else {
+	EXPECT_NE( rj, r1 );
+	EXPECT_NE( ~rj, r1 );
+      }
+    }
+  }
+}
+
+TEST(FraigMgrTest, truncate)
+{
+  FraigMgr mgr{1};
+
+  auto x = mgr.make_input();
+  auto y = mgr.make_input();
+  auto z = mgr.make_input();
+  auto f = mgr.make_and(x, y);
+  SizeType n = mgr.node_num();
+
+  // 後から作ったノードを削除する．
+  auto g1 = mgr.make_and(x, z);
+  auto g2 = mgr.make_and(g1, y);
+  EXPECT_EQ( n + 2, mgr.node_num() );
+  EXPECT_EQ( SatBool3::False, mgr.check_equiv(g2, f) );
+  mgr.truncate(n);
+  EXPECT_EQ( n, mgr.node_num() );
+
+  // 削除したノードの番号に別の関数のノードを作る．
+  // 前のノードの節が SATソルバに残っていると
+  // x & z と ~x & z が等しいことになり定数0と判定されてしまう．
+  auto h = mgr.make_and(~x, z);
+  ASSERT_FALSE( h.is_const() );
+  EXPECT_EQ( n, h.node()->id() );
+  EXPECT_EQ( SatBool3::False, mgr.check_equiv(h, mgr.make_zero()) );
+
+  // 削除したノードは構造ハッシュにも残っていない．
+  auto g3 = mgr.make_and(x, z);
+  EXPECT_EQ( n + 1, g3.node()->id() );
+  EXPECT_EQ( SatBool3::True, mgr.check_equiv(mgr.make_and(g3, y),
+					     mgr.make_and(f, z)) );
+}
+
+TEST(FraigMgrTest, cofactor)
+{
+  // 再収斂の多い XNOR の連鎖を作る．
+  // 共有を考慮しないとコファクターの計算は指数時間となる．
+  const SizeType N = 100;
+
+  FraigMgr mgr{1};
+
+  vector<FraigHandle> input_list(N);
+  for ( SizeType i: Range(N) ) {
+    input_list[i] = mgr.make_input();
+  }
+  auto make_xnor = [&](FraigHandle h1, FraigHandle h2) {
+    auto tmp1 = mgr.make_and( h1,  h2);
+    auto tmp2 = mgr.make_and(~h1, ~h2);
+    return ~mgr.make_and(~tmp1, ~tmp2);
+  };
+  auto make_chain = [&](FraigHandle h0) {
+    auto h = h0;
+    for ( SizeType i = 1; i < N; ++ i ) {
+      h = make_xnor(h, input_list[i]);
+    }
+    return h;
+  };
+  auto f = make_chain(input_list[0]);
+
+  auto f0 = mgr.make_cofactor(f, 0, true);
+  auto f1 = mgr.make_cofactor(f, 0, false);
+  EXPECT_EQ( make_chain(mgr.make_zero()), f0 );
+  EXPECT_EQ( make_chain(mgr.make_one()), f1 );
+
+  // 正負のコファクターをまとめて求める．
+  vector<vector<pair<SizeType, bool>>> assign_list_list(2);
+  assign_list_list[0].push_back(make_pair(0, false));
+  assign_list_list[1].push_back(make_pair(0, true));
+  auto ans_list = mgr.make_cofactor_batch({f}, assign_list_list);
+  EXPECT_EQ( f0, ans_list[0][0] );
+  EXPECT_EQ( f1, ans_list[1][0] );
+}
+
+TEST(FraigMgrTest, quantify)
+{
+  FraigMgr mgr{1};
+
+  auto x = mgr.make_input();
+  auto y = mgr.make_input();
+  auto z = mgr.make_input();
+
+  auto f = mgr.make_and(x, mgr.make_and(y, z));
+  // ∃x.(x & y & z) = y & z
+  EXPECT_EQ( mgr.make_and(y, z), mgr.make_exists(f, {0}) );
+  // ∀x.(x & y & z) = 0
+  EXPECT_TRUE( mgr.make_forall(f, {0}).is_zero() );
+  // ∃x,y.(x & y & z) = z
+  EXPECT_EQ( z, mgr.make_exists(f, {0, 1}) );
+  // ∀x.(~x + y) = y
+  auto g = ~mgr.make_and(x, ~y);
+  EXPECT_EQ( y, mgr.make_forall(g, {0}) );
+}
+
+TEST(FraigMgrTest, multi_mgr)
+{
+  // シグネチャのサイズの異なる FraigMgr が共存できる．
+  FraigMgr mgr1{1};
+  FraigMgr mgr2{7};
+
+  auto x1 = mgr1.make_input();
+  auto x2 = mgr2.make_input();
+  auto y1 = mgr1.make_input();
+  auto y2 = mgr2.make_input();
+
+  // 領域の拡大が起こるようにノードを交互に作る．
+  const SizeType N = 100;
+  auto f1 = x1;
+  auto f2 = x2;
+  for ( SizeType i = 0; i < N; ++ i ) {
+    f1 = mgr1.make_and(~f1, y1);
+    f2 = mgr2.make_and(~f2, y2);
+    y1 = mgr1.make_input();
+    y2 = mgr2.make_input();
+  }
+
+  // 構造は異なるが論理的には等価
+  auto g1 = ~mgr1.make_and(~x1, ~mgr1.make_and(x1, y1));
+  auto g2 = ~mgr2.make_and(~x2, ~mgr2.make_and(x2, y2));
+  EXPECT_EQ( x1, g1 );
+  EXPECT_EQ( x2, g2 );
+
+  // パタンの領域の先頭は 64 バイト境界に揃っていて，
+  // 各ノードのパタンは同じ間隔で詰めて並んでいる．
+  for ( auto mgr: {&mgr1, &mgr2} ) {
+    auto base = mgr->node(0)->pat();
+    auto addr = reinterpret_cast<PtrIntType>(base);
+    EXPECT_EQ( 0, addr % 64 );
+    auto stride = mgr->node(1)->pat() - base;
+    for ( SizeType id = 0; id < mgr->node_num(); ++ id ) {
+      EXPECT_EQ( base + id * stride, mgr->node(id)->pat() );
+    }
+  }
+
+  // 1ノードあたりの語数は 64 バイトの倍数に切り上げない．
+  FraigMgr mgr3{1};
+  mgr3.make_input();
+  mgr3.make_input();
+  EXPECT_EQ( 2, mgr3.node(1)->pat() - mgr3.node(0)->pat() );
+}
+
+END_NAMESPACE_MAGUS
@@ -0,0 +1,160 @@
+
+/// @file PatTable_test.cc
+/// @brief PatTable のテストプログラム
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+#include "gtest/gtest.h"
+#include "PatTable.h"
+#include "FraigNode.h"
+
+
+BEGIN_NAMESPACE_FRAIG
+
+class PatTableTest :
+  public ::testing::Test
+{
+public:
+
+  // パタンを指定して入力ノードを作る．
+  // ノード番号は作った順につく．
+  FraigNode*
+  new_node(
+    const vector<std::uint64_t>& pat
+  )
+  {
+    SizeType id = mNodes.node_num();
+    auto node = mNodes.new_input(id);
+    auto dst = mNodes.pat_row(id);
+    for ( SizeType i = 0; i < pat.size(); ++ i ) {
+      dst[i] = pat[i];
+    }
+    mNodes.calc_mark(id, 0, pat.size());
+    return node;
+  }
+
+  // 要素がノードのリストと一致するか調べる．
+  static
+  bool
+  same_list(
+    const vector<FraigNode*>* node_list,
+    const vector<FraigNode*>& exp_list
+  )
+  {
+    return node_list != nullptr && *node_list == exp_list;
+  }
+
+  // ノードの本体
+  // パタンは3語まで使う．
+  FraigNodeArray mNodes{3};
+
+};
+
+TEST_F(PatTableTest, refine)
+{
+  PatTable table{1};
+
+  // c は a の極性を反転させたパタンを持つ．
+  auto a = new_node({0x10UL, 5UL, 1UL});
+  auto b = new_node({0x10UL, 5UL, 2UL});
+  auto c = new_node({~0x10UL, ~5UL, ~3UL});
+  auto d = new_node({0x10UL, 7UL, 4UL});
+  auto e = new_node({0x20UL, 5UL, 5UL});
+  for ( auto node: {a, b, c, d, e} ) {
+    table.insert(node);
+  }
+  EXPECT_EQ( 2, table.class_num() );
+  EXPECT_TRUE( same_list(table.find(a), {a, b, c, d}) );
+  EXPECT_TRUE( same_list(table.find(e), {e}) );
+
+  // 2語目で d のみが分かれる．
+  table.refine(1);
+  EXPECT_EQ( 3, table.class_num() );
+  EXPECT_TRUE( same_list(table.find(a), {a, b, c}) );
+  EXPECT_TRUE( same_list(table.find(d), {d}) );
+  EXPECT_TRUE( same_list(table.find(e), {e}) );
+
+  // 3語目で全て分かれる．
+  table.refine(2);
+  EXPECT_EQ( 5, table.class_num() );
+  for ( auto node: {a, b, c, d, e} ) {
+    EXPECT_TRUE( same_list(table.find(node), {node}) );
+  }
+}
+
+TEST_F(PatTableTest, insert_after_refine)
+{
+  PatTable table{1};
+
+  auto a = new_node({0x10UL, 5UL});
+  auto b = new_node({0x10UL, 7UL});
+  auto c = new_node({0x20UL, 5UL});
+  for ( auto node: {a, b, c} ) {
+    table.insert(node);
+  }
+  table.refine(1);
+  EXPECT_EQ( 3, table.class_num() );
+
+  // 分割されたクラスの子に入る．
+  auto d = new_node({~0x10UL, ~7UL});
+  EXPECT_TRUE( same_list(table.find(d), {b}) );
+  table.insert(d);
+  EXPECT_TRUE( same_list(table.find(b), {b, d}) );
+
+  // 分割されたクラスの新しい子になる．
+  auto e = new_node({0x10UL, 9UL});
+  EXPECT_EQ( nullptr, table.find(e) );
+  table.insert(e);
+  EXPECT_TRUE( same_list(table.find(e), {e}) );
+
+  // 分割されていないクラスとは2語目で異なる．
+  auto f = new_node({0x20UL, 6UL});
+  EXPECT_EQ( nullptr, table.find(f) );
+  table.insert(f);
+  EXPECT_TRUE( same_list(table.find(f), {f}) );
+  EXPECT_TRUE( same_list(table.find(c), {c}) );
+
+  // 新しい根のクラスになる．
+  auto g = new_node({0x30UL, 5UL});
+  EXPECT_EQ( nullptr, table.find(g) );
+  table.insert(g);
+  EXPECT_TRUE( same_list(table.find(g), {g}) );
+
+  EXPECT_EQ( 6, table.class_num() );
+}
+
+TEST_F(PatTableTest, truncate)
+{
+  PatTable table{1};
+
+  auto a = new_node({0x10UL, 5UL});
+  auto b = new_node({0x10UL, 7UL});
+  auto c = new_node({0x10UL, 7UL});
+  table.insert(a);
+  table.insert(b);
+  table.refine(1);
+  table.insert(c);
+  auto d = new_node({0x10UL, 9UL});
+  auto e = new_node({0x20UL, 9UL});
+  table.insert(d);
+  table.insert(e);
+  EXPECT_EQ( 4, table.class_num() );
+
+  // c 以降のノードを削除する．
+  table.truncate(c->id());
+  EXPECT_EQ( 2, table.class_num() );
+  EXPECT_TRUE( same_list(table.find(a), {a}) );
+  EXPECT_TRUE( same_list(table.find(b), {b}) );
+  EXPECT_EQ( nullptr, table.find(d) );
+  EXPECT_EQ( nullptr, table.find(e) );
+
+  // 削除されたクラスの番号は再利用される．
+  auto f = new_node({0x20UL, 9UL});
+  table.insert(f);
+  EXPECT_TRUE( same_list(table.find(f), {f}) );
+  EXPECT_EQ( 3, table.class_num() );
+}
+
+END_NAMESPACE_FRAIG
@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include "EquivMgr.h"
+#include "SeqEnc.h"
 #include "ym/BnNetwork.h"
 #include "ym/BnNode.h"
 #include "ym/Range.h"
@@ -15,6 +16,38 @@
 
 BEGIN_NAMESPACE_MAGUS
 
+BEGIN_NONAMESPACE
+
+// 初期状態から入力系列をシミュレーションして最後の時刻の外部出力の値を返す．
+// 入力系列の形式は EquivMgr::check_seq() の反例と同じ．
+vector<bool>
+simulate_seq(
+  const BnNetwork& network,
+  const vector<bool>& input_seq
+)
+{
+  SeqEnc enc{network};
+  SizeType npi = enc.pi_num();
+  vector<std::uint64_t> state(enc.dff_num(), 0UL);
+  vector<std::uint64_t> pi_vals(npi);
+  vector<std::uint64_t> po_vals;
+  vector<std::uint64_t> next_vals;
+  for ( SizeType base = 0; base < input_seq.size(); base += npi ) {
+    for ( SizeType i: Range(npi) ) {
+      pi_vals[i] = input_seq[base + i] ? 1UL : 0UL;
+    }
+    enc.simulate(pi_vals, state, po_vals, next_vals);
+    state.swap(next_vals);
+  }
+  vector<bool> ans;
+  for ( auto val: po_vals ) {
+    ans.push_back(static_cast<bool>(val & 1UL));
+  }
+  return ans;
+}
+
+END_NONAMESPACE
+
 TEST(EquivTest, EquivTest1)
 {
   string filename1 = "blif/C499.blif";
@@ -182,4 +215,280 @@ TEST(EquivTest, EquivTest5)
   }
 }
 
+TEST(EquivTest, EquivTest_cex)
+{
+  string filename1 = "blif/C499.blif";
+  string path1 = DATAPATH + filename1;
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  SizeType ni = network1.input_num();
+  SizeType no = network1.output_num();
+
+  string filename2 = "blif/C499_reordered.blif";
+  string path2 = DATAPATH + filename2;
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  // 順序で対応を取ると等価ではない．
+  EquivMgr eqmgr;
+  EquivResult ans = eqmgr.check(network1, network2);
+  EXPECT_EQ( SatBool3::False, ans.result() );
+
+  // 反例をシミュレーションで確かめる．
+  const auto& cex_list = ans.counter_example_list();
+  ASSERT_EQ( no, cex_list.size() );
+  auto diff_list = eqmgr.replay(network1, network2, cex_list);
+  ASSERT_EQ( no, diff_list.size() );
+  for ( SizeType i: Range(no) ) {
+    const auto& cex = ans.counter_example(i);
+    const auto& diff = diff_list[i];
+    if ( ans.output_results()[i] == SatBool3::False ) {
+      EXPECT_EQ( ni, cex.size() );
+      EXPECT_TRUE( std::find(diff.begin(), diff.end(), i) != diff.end() );
+    }
+    else {
+      EXPECT_TRUE( cex.empty() );
+      EXPECT_TRUE( diff.empty() );
+    }
+  }
+}
+
+TEST(EquivTest, EquivTest_revision)
+{
+  string filename1 = "blif/C499.blif";
+  string path1 = DATAPATH + filename1;
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  string filename2 = "blif/C1355.blif";
+  string path2 = DATAPATH + filename2;
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  string filename3 = "blif/C499_reordered.blif";
+  string path3 = DATAPATH + filename3;
+  BnNetwork network3 = BnNetwork::read_blif(path3);
+  ASSERT_TRUE( network3.node_num() != 0 );
+
+  // 参照回路を一度だけ設定して複数の修正版を調べる．
+  EquivMgr eqmgr;
+  eqmgr.set_reference(network1);
+  ASSERT_TRUE( eqmgr.has_reference() );
+
+  EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network1).result() );
+  EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network2).result() );
+  // 順序で対応を取ると等価ではない．
+  EXPECT_EQ( SatBool3::False, eqmgr.check_revision(network3).result() );
+  // 前の修正版の結果に影響されない．
+  EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network3, true).result() );
+  EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network2).result() );
+
+  eqmgr.clear_reference();
+  EXPECT_FALSE( eqmgr.has_reference() );
+}
+
+TEST(EquivTest, EquivTest_revision_many)
+{
+  string path1 = DATAPATH + string{"blif/C499.blif"};
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  string path2 = DATAPATH + string{"blif/C1355.blif"};
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  string path3 = DATAPATH + string{"blif/C499_reordered.blif"};
+  BnNetwork network3 = BnNetwork::read_blif(path3);
+  ASSERT_TRUE( network3.node_num() != 0 );
+
+  // 修正版のノードは検証のたびに削除されるので
+  // 何度繰り返しても結果は変わらない．
+  EquivMgr eqmgr;
+  eqmgr.set_reference(network1);
+  SizeType var_num0 = eqmgr.reference_sat_variable_num();
+  SizeType clause_num0 = eqmgr.reference_sat_clause_num();
+  SizeType var_num1 = 0;
+  for ( SizeType r = 0; r < 5; ++ r ) {
+    EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network2).result() );
+    EXPECT_EQ( SatBool3::False, eqmgr.check_revision(network3).result() );
+    EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network3, true).result() );
+    EXPECT_EQ( SatBool3::True, eqmgr.check_revision(network1).result() );
+
+    // SATソルバは作り直されないので修正版の変数は残り，
+    // 2回目以降は使い回されて活性化リテラルの分しか増えない．
+    // 修正版の節はすべて無効になっている．
+    SizeType var_num = eqmgr.reference_sat_variable_num();
+    if ( r == 0 ) {
+      EXPECT_LT( var_num0, var_num );
+      var_num1 = var_num;
+    }
+    else {
+      EXPECT_GE( var_num1 + r * 4, var_num );
+    }
+    EXPECT_EQ( clause_num0, eqmgr.reference_sat_clause_num() );
+  }
+}
+
+TEST(EquivTest, EquivTest_seq)
+{
+  string filename = "blif/s5378.blif";
+  string path = DATAPATH + filename;
+  BnNetwork network1 = BnNetwork::read_blif(path);
+  ASSERT_TRUE( network1.node_num() != 0 );
+  BnNetwork network2 = BnNetwork::read_blif(path);
+
+  EquivMgr eqmgr;
+
+  // DFF を名前で対応させる．
+  EquivResult ans1 = eqmgr.check_seq(network1, network2, true);
+  EXPECT_EQ( SatBool3::True, ans1.result() );
+
+  // DFF をシミュレーションで対応させる．
+  EquivResult ans2 = eqmgr.check_seq(network1, network2, false);
+  EXPECT_EQ( SatBool3::True, ans2.result() );
+}
+
+TEST(EquivTest, EquivTest_seq_retimed)
+{
+  // AND の前に DFF を1段移動したもの
+  // DFF の1対1の対応はない．
+  string path1 = DATAPATH + string{"blif/seq_and.blif"};
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  string path2 = DATAPATH + string{"blif/seq_and_retimed.blif"};
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  EquivMgr eqmgr;
+  EquivResult ans = eqmgr.check_seq(network1, network2);
+  EXPECT_EQ( SatBool3::True, ans.result() );
+  ASSERT_EQ( 1, ans.output_results().size() );
+  EXPECT_EQ( SatBool3::True, ans.output_results()[0] );
+  EXPECT_TRUE( ans.counter_example(0).empty() );
+}
+
+TEST(EquivTest, EquivTest_seq_reencoded)
+{
+  // 状態を2つの DFF で冗長に符号化したもの
+  string path1 = DATAPATH + string{"blif/seq_toggle.blif"};
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  string path2 = DATAPATH + string{"blif/seq_toggle_dup.blif"};
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  EquivMgr eqmgr;
+  EquivResult ans = eqmgr.check_seq(network1, network2);
+  EXPECT_EQ( SatBool3::True, ans.result() );
+  ASSERT_EQ( 1, ans.output_results().size() );
+  EXPECT_EQ( SatBool3::True, ans.output_results()[0] );
+}
+
+TEST(EquivTest, EquivTest_seq_cex)
+{
+  // 遅延が1時刻異なるので等価ではない．
+  string path1 = DATAPATH + string{"blif/seq_delay2.blif"};
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  string path2 = DATAPATH + string{"blif/seq_delay3.blif"};
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  EquivMgr eqmgr;
+  EquivResult ans = eqmgr.check_seq(network1, network2);
+  EXPECT_EQ( SatBool3::False, ans.result() );
+  ASSERT_EQ( 1, ans.output_results().size() );
+  EXPECT_EQ( SatBool3::False, ans.output_results()[0] );
+
+  // 最短の反例は3時刻分で，最初の時刻の入力が 1 となる．
+  const auto& cex = ans.counter_example(0);
+  ASSERT_EQ( 3, cex.size() );
+  EXPECT_TRUE( cex[0] );
+
+  // 反例をシミュレーションで確かめる．
+  auto po1 = simulate_seq(network1, cex);
+  auto po2 = simulate_seq(network2, cex);
+  ASSERT_EQ( 1, po1.size() );
+  ASSERT_EQ( 1, po2.size() );
+  EXPECT_NE( po1[0], po2[0] );
+}
+
+TEST(EquivTest, EquivTest_nosweep)
+{
+  string filename1 = "blif/C499.blif";
+  string path1 = DATAPATH + filename1;
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  SizeType no = network1.output_num();
+
+  string filename2 = "blif/C1355.blif";
+  string path2 = DATAPATH + filename2;
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  // ノードを作るたびに等価なノードを求める．
+  EquivMgr eqmgr;
+  eqmgr.set_sweep_mode(false);
+  EquivResult ans = eqmgr.check(network1, network2);
+  EXPECT_EQ( SatBool3::True, ans.result() );
+  for ( SizeType i: Range(no) ) {
+    EXPECT_EQ( SatBool3::True, ans.output_results()[i] );
+  }
+}
+
+TEST(EquivTest, EquivTest_mt)
+{
+  string filename1 = "blif/C499.blif";
+  string path1 = DATAPATH + filename1;
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  SizeType no = network1.output_num();
+
+  string filename2 = "blif/C1355.blif";
+  string path2 = DATAPATH + filename2;
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  // 各出力の検証を4つのスレッドで行う．
+  EquivMgr eqmgr;
+  eqmgr.set_thread_num(4);
+  EquivResult ans = eqmgr.check(network1, network2);
+  EXPECT_EQ( SatBool3::True, ans.result() );
+  ASSERT_EQ( no, ans.output_results().size() );
+  for ( SizeType i: Range(no) ) {
+    EXPECT_EQ( SatBool3::True, ans.output_results()[i] );
+  }
+}
+
+TEST(EquivTest, EquivTest_timeout)
+{
+  string filename1 = "blif/C499.blif";
+  string path1 = DATAPATH + filename1;
+  BnNetwork network1 = BnNetwork::read_blif(path1);
+  ASSERT_TRUE( network1.node_num() != 0 );
+
+  SizeType no = network1.output_num();
+
+  string filename2 = "blif/C1355.blif";
+  string path2 = DATAPATH + filename2;
+  BnNetwork network2 = BnNetwork::read_blif(path2);
+  ASSERT_TRUE( network2.node_num() != 0 );
+
+  // 制限時間が短すぎるので SAT はすべてアボートする．
+  EquivMgr eqmgr;
+  eqmgr.set_time_limit(1.0e-9);
+  eqmgr.set_sat_budget(100, 0);
+  EquivResult ans = eqmgr.check(network1, network2);
+  EXPECT_EQ( SatBool3::X, ans.result() );
+  for ( SizeType i: Range(no) ) {
+    EXPECT_NE( SatBool3::False, ans.output_results()[i] );
+  }
+}
+
 END_NAMESPACE_MAGUS
@@ -0,0 +1,148 @@
+
+/// @file ADCostTest.cc
+/// @brief ADCostTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "ADCost.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class ADCostTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief 初期化
+  void
+  SetUp() override
+  {
+    mList.set_mgr(&mMgr);
+  }
+
+  /// @brief 要素を (深さ, 面積) のリストにして返す．
+  vector<pair<int, double>>
+  contents()
+  {
+    vector<pair<int, double>> ans_list;
+    for ( auto cost: mList ) {
+      ans_list.push_back(make_pair(cost->depth(), cost->area()));
+    }
+    return ans_list;
+  }
+
+  /// @brief (深さ, 面積) のリストを追加する．
+  void
+  insert(
+    const vector<pair<int, double>>& cost_list
+  )
+  {
+    for ( auto& p: cost_list ) {
+      mList.insert(nullptr, p.first, p.second);
+    }
+  }
+
+  // メモリ管理用のオブジェクト
+  ADCostMgr<double> mMgr;
+
+  // 対象のリスト
+  ADCostList<double> mList;
+
+};
+
+TEST_F(ADCostTest, insert)
+{
+  // 順不同で追加しても深さの降順(面積の昇順)に並ぶ．
+  insert({{1, 4.0}, {3, 1.0}, {0, 8.0}, {2, 2.0}});
+
+  vector<pair<int, double>> exp_list1{{3, 1.0}, {2, 2.0}, {1, 4.0}, {0, 8.0}};
+  EXPECT_EQ( exp_list1, contents() );
+  EXPECT_EQ( 4, mList.size() );
+
+  // 支配されている要素は追加されない．
+  mList.insert(nullptr, 2, 3.0);
+  EXPECT_EQ( exp_list1, contents() );
+
+  // 同じ深さで面積の小さい要素は上書きする．
+  mList.insert(nullptr, 2, 1.5);
+  vector<pair<int, double>> exp_list2{{3, 1.0}, {2, 1.5}, {1, 4.0}, {0, 8.0}};
+  EXPECT_EQ( exp_list2, contents() );
+
+  // 他の要素を支配する要素はそれらを削除する．
+  mList.insert(nullptr, 1, 1.0);
+  vector<pair<int, double>> exp_list3{{1, 1.0}, {0, 8.0}};
+  EXPECT_EQ( exp_list3, contents() );
+}
+
+TEST_F(ADCostTest, clear)
+{
+  insert({{3, 1.0}, {2, 2.0}, {1, 4.0}});
+  mList.clear();
+
+  EXPECT_EQ( 0, mList.size() );
+  EXPECT_TRUE( mList.begin() == mList.end() );
+
+  // 削除した要素は再利用される．
+  auto np = mMgr.alloc_num();
+  insert({{3, 1.0}, {2, 2.0}, {1, 4.0}});
+  EXPECT_EQ( 3, mList.size() );
+  EXPECT_EQ( np, mMgr.alloc_num() );
+}
+
+TEST_F(ADCostTest, prune_empty)
+{
+  mList.prune(1, 0.1);
+
+  EXPECT_EQ( 0, mList.size() );
+}
+
+TEST_F(ADCostTest, prune_epsilon)
+{
+  insert({{4, 10.0}, {3, 10.5}, {2, 11.0}, {1, 20.0}, {0, 21.0}});
+
+  mList.prune(0, 0.1);
+
+  // 一つ浅い要素の面積が 1.1 倍以内の要素が削除され，
+  // 末尾(深さ最小)の要素は残る．
+  vector<pair<int, double>> exp_list{{2, 11.0}, {0, 21.0}};
+  EXPECT_EQ( exp_list, contents() );
+}
+
+TEST_F(ADCostTest, prune_max_num)
+{
+  insert({{4, 1.0}, {3, 2.0}, {2, 3.0}, {1, 4.0}, {0, 5.0}});
+
+  mList.prune(3, 0.0);
+
+  // 先頭と末尾を含めて等間隔に残す．
+  vector<pair<int, double>> exp_list1{{4, 1.0}, {2, 3.0}, {0, 5.0}};
+  EXPECT_EQ( exp_list1, contents() );
+
+  // 上限以下なら何もしない．
+  mList.prune(3, 0.0);
+  EXPECT_EQ( exp_list1, contents() );
+
+  // 上限が 1 の時は末尾のみを残す．
+  mList.prune(1, 0.0);
+  vector<pair<int, double>> exp_list2{{0, 5.0}};
+  EXPECT_EQ( exp_list2, contents() );
+}
+
+TEST_F(ADCostTest, prune_both)
+{
+  insert({{5, 1.0}, {4, 1.05}, {3, 2.0}, {2, 3.0}, {1, 4.0}, {0, 4.2}});
+
+  mList.prune(2, 0.1);
+
+  // epsilon で {5, 1.0}, {1, 4.0} が削除された後に
+  // 上限の 2 個に間引かれる．
+  vector<pair<int, double>> exp_list{{4, 1.05}, {0, 4.2}};
+  EXPECT_EQ( exp_list, contents() );
+}
+
+END_NAMESPACE_LUTMAP
@@ -0,0 +1,154 @@
+
+/// @file AreaCoverTest.cc
+/// @brief AreaCoverTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "AreaCover.h"
+#include "DelayCover.h"
+#include "CutHolder.h"
+#include "MapRecord.h"
+#include "MapEst.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "SbjHandle.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class AreaCoverTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief ファイルを読み込んでカットを列挙する．
+  void
+  read(
+    const string& filename
+  )
+  {
+    string path = DATAPATH + filename;
+    BnNetwork network = BnNetwork::read_blif(path);
+    ASSERT_TRUE( network.node_num() != 0 );
+
+    Bn2Sbj bn2sbj;
+    bn2sbj.convert(network, mSbjGraph);
+
+    mCutHolder.enum_cut(mSbjGraph, 4);
+  }
+
+  /// @brief 面積回復付きでマッピングを行い LUT 数と段数を求める．
+  void
+  area_map(
+    SizeType flow_iter,
+    SizeType exact_iter,
+    int slack,
+    SizeType& lut_num,
+    SizeType& depth
+  )
+  {
+    AreaCover area_cover{true};
+    area_cover.set_recovery(flow_iter, exact_iter, slack);
+    MapRecord maprec;
+    area_cover.record_cuts(mSbjGraph, mCutHolder, maprec);
+
+    MapEst est;
+    est.estimate(mSbjGraph, maprec, lut_num, depth);
+  }
+
+  // サブジェクトグラフ
+  SbjGraph mSbjGraph;
+
+  // カットを保持するオブジェクト
+  CutHolder mCutHolder;
+
+};
+
+TEST_F(AreaCoverTest, exact_recovery)
+{
+  read("blif/C432.blif");
+
+  SizeType lut_num0;
+  SizeType depth0;
+  area_map(0, 0, -1, lut_num0, depth0);
+
+  // exact area による回復は現在の解のカットも候補に含むので
+  // LUT 数は増えない．
+  SizeType lut_num1;
+  SizeType depth1;
+  area_map(0, 1, -1, lut_num1, depth1);
+  EXPECT_LE( lut_num1, lut_num0 );
+
+  SizeType lut_num2;
+  SizeType depth2;
+  area_map(0, 3, -1, lut_num2, depth2);
+  EXPECT_LE( lut_num2, lut_num1 );
+}
+
+TEST_F(AreaCoverTest, recovery_with_slack)
+{
+  read("blif/C432.blif");
+
+  // 段数最小の解
+  DelayCover delay_cover{true, 0};
+  MapRecord maprec;
+  delay_cover.record_cuts(mSbjGraph, mCutHolder, maprec);
+  MapEst est;
+  SizeType lut_num0;
+  SizeType min_depth;
+  est.estimate(mSbjGraph, maprec, lut_num0, min_depth);
+
+  // 面積回復を行っても要求段数は守られる．
+  SizeType lut_num1;
+  SizeType depth1;
+  area_map(2, 0, 0, lut_num1, depth1);
+  EXPECT_EQ( min_depth, depth1 );
+
+  SizeType lut_num2;
+  SizeType depth2;
+  area_map(0, 0, 0, lut_num2, depth2);
+  SizeType lut_num3;
+  SizeType depth3;
+  area_map(0, 2, 0, lut_num3, depth3);
+  EXPECT_EQ( min_depth, depth3 );
+  EXPECT_LE( lut_num3, lut_num2 );
+
+  SizeType lut_num4;
+  SizeType depth4;
+  area_map(1, 1, 1, lut_num4, depth4);
+  EXPECT_LE( depth4, min_depth + 1 );
+}
+
+TEST_F(AreaCoverTest, long_chain)
+{
+  // 非常に段数の深い AND の鎖
+  // 参照/参照解除が再帰を用いていないことを確かめる．
+  const SizeType n = 100000;
+  auto node0 = mSbjGraph.new_input(false);
+  SbjHandle h{node0, false};
+  for ( SizeType i = 1; i < n; ++ i ) {
+    auto node = mSbjGraph.new_input(false);
+    h = mSbjGraph.new_and(h, SbjHandle{node, false});
+  }
+  mSbjGraph.new_output(h);
+
+  mCutHolder.enum_cut(mSbjGraph, 4);
+
+  SizeType lut_num0;
+  SizeType depth0;
+  area_map(0, 0, -1, lut_num0, depth0);
+
+  SizeType lut_num1;
+  SizeType depth1;
+  area_map(1, 1, -1, lut_num1, depth1);
+  // 1つの LUT で高々 3 個の AND を実現できる．
+  EXPECT_LE( (n - 1 + 2) / 3, lut_num1 );
+  EXPECT_LE( lut_num1, lut_num0 );
+}
+
+END_NAMESPACE_LUTMAP
@@ -0,0 +1,267 @@
+
+/// @file CutTest.cc
+/// @brief CutTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "Cut.h"
+#include "CutHolder.h"
+#include "CutMgr.h"
+#include "SbjGraph.h"
+#include "SbjHandle.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+BEGIN_NONAMESPACE
+
+// 葉の値を与えてノードの値を再帰的に求める．
+bool
+eval_ref(
+  const SbjNode* node,
+  const unordered_map<SizeType, bool>& leaf_val
+)
+{
+  if ( leaf_val.count(node->id()) > 0 ) {
+    return leaf_val.at(node->id());
+  }
+  bool val0 = eval_ref(node->fanin(0), leaf_val) ^ node->fanin_inv(0);
+  bool val1 = eval_ref(node->fanin(1), leaf_val) ^ node->fanin_inv(1);
+  if ( node->is_xor() ) {
+    return val0 ^ val1;
+  }
+  return val0 && val1;
+}
+
+// カットの真理値表を入力パタンごとに評価して確かめる．
+void
+check_tv(
+  const Cut* cut
+)
+{
+  SizeType ni = cut->input_num();
+  SizeType np = 1 << ni;
+  auto tv = cut->tv_words();
+  for ( SizeType p = 0; p < np; ++ p ) {
+    unordered_map<SizeType, bool> leaf_val;
+    for ( SizeType i = 0; i < ni; ++ i ) {
+      leaf_val.emplace(cut->input(i)->id(), static_cast<bool>((p >> i) & 1));
+    }
+    bool exp_val = eval_ref(cut->root(), leaf_val);
+    bool val = static_cast<bool>((tv[p / 64] >> (p % 64)) & 1ULL);
+    ASSERT_EQ( exp_val, val );
+  }
+  if ( ni < 6 ) {
+    // 未使用のビットは 0
+    EXPECT_EQ( 0ULL, tv[0] & ~Cut::tv_mask(ni) );
+  }
+}
+
+// 8入力の回路を作る．
+//
+// ((a & ~b) ^ (c & d)) & ~((e ^ f) & (g & ~h))
+void
+make_graph8(
+  SbjGraph& sbjgraph
+)
+{
+  vector<SbjHandle> h_list;
+  for ( SizeType i = 0; i < 8; ++ i ) {
+    h_list.push_back(SbjHandle{sbjgraph.new_input(false), false});
+  }
+  auto h1 = sbjgraph.new_and(h_list[0], ~h_list[1]);
+  auto h2 = sbjgraph.new_and(h_list[2], h_list[3]);
+  auto h3 = sbjgraph.new_xor(h1, h2);
+  auto h4 = sbjgraph.new_xor(h_list[4], h_list[5]);
+  auto h5 = sbjgraph.new_and(h_list[6], ~h_list[7]);
+  auto h6 = sbjgraph.new_and(h4, h5);
+  auto h7 = sbjgraph.new_and(h3, ~h6);
+  sbjgraph.new_output(h7);
+}
+
+END_NONAMESPACE
+
+TEST(CutTest, tv_words)
+{
+  // ((a & ~b) ^ c) | ~(b & d) を表す回路
+  SbjGraph sbjgraph;
+  auto a = sbjgraph.new_input(false);
+  auto b = sbjgraph.new_input(false);
+  auto c = sbjgraph.new_input(false);
+  auto d = sbjgraph.new_input(false);
+  auto h1 = sbjgraph.new_and(SbjHandle{a, false}, SbjHandle{b, true});
+  auto h2 = sbjgraph.new_xor(h1, SbjHandle{c, false});
+  auto h3 = sbjgraph.new_and(SbjHandle{b, false}, SbjHandle{d, false});
+  auto h4 = sbjgraph.new_and(~h2, h3);
+  sbjgraph.new_output(~h4);
+
+  CutHolder cut_holder;
+  cut_holder.enum_cut(sbjgraph, 4);
+
+  SizeType n = 0;
+  for ( auto node: sbjgraph.logic_list() ) {
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      ASSERT_EQ( 1, Cut::tv_word_num(cut->input_num()) );
+      check_tv(cut);
+      ++ n;
+    }
+  }
+  EXPECT_LT( 0, n );
+}
+
+TEST(CutTest, eval)
+{
+  SbjGraph sbjgraph;
+  make_graph8(sbjgraph);
+
+  CutHolder cut_holder;
+  cut_holder.enum_cut(sbjgraph, 4);
+
+  // Cut::eval() は真理値表と同じ値を返す．
+  for ( auto node: sbjgraph.logic_list() ) {
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      SizeType ni = cut->input_num();
+      vector<std::uint64_t> vals(ni);
+      for ( SizeType i = 0; i < ni; ++ i ) {
+	vals[i] = Cut::var_word(i, 0);
+      }
+      auto mask = Cut::tv_mask(ni);
+      EXPECT_EQ( cut->tv_words()[0], cut->eval(vals) & mask );
+    }
+  }
+}
+
+TEST(CutTest, tv_words_large)
+{
+  SbjGraph sbjgraph;
+  make_graph8(sbjgraph);
+
+  // 7入力以上のカットは複数のワードを持つ．
+  CutHolder cut_holder;
+  cut_holder.enum_cut(sbjgraph, 8);
+
+  SizeType n_large = 0;
+  for ( auto node: sbjgraph.logic_list() ) {
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      check_tv(cut);
+      if ( cut->input_num() > 6 ) {
+	++ n_large;
+      }
+    }
+  }
+  EXPECT_LT( 0, n_large );
+}
+
+TEST(CutTest, tv_words_priority)
+{
+  SbjGraph sbjgraph;
+  make_graph8(sbjgraph);
+
+  // 優先カットの真理値表はファンインのカットから合成される．
+  CutHolder cut_holder;
+  cut_holder.enum_priority_cut(sbjgraph, 8, 4);
+
+  SizeType n_large = 0;
+  for ( auto node: sbjgraph.logic_list() ) {
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      check_tv(cut);
+      if ( cut->input_num() > 6 ) {
+	++ n_large;
+      }
+    }
+  }
+  EXPECT_LT( 0, n_large );
+}
+
+TEST(CutTest, tv_words_mt)
+{
+  SbjGraph sbjgraph;
+  make_graph8(sbjgraph);
+
+  // 複数スレッドで列挙した場合も真理値表は正しい．
+  CutHolder cut_holder;
+  cut_holder.enum_cut_mt(sbjgraph, 6, 4);
+
+  for ( auto node: sbjgraph.logic_list() ) {
+    for ( auto cut: cut_holder.cut_list(node) ) {
+      check_tv(cut);
+    }
+  }
+}
+
+TEST(CutTest, cut_mgr_stats)
+{
+  SbjGraph sbjgraph;
+  make_graph8(sbjgraph);
+
+  auto root = sbjgraph.logic_list().front();
+  const SbjNode* inputs[2] = { root->fanin(0), root->fanin(1) };
+  std::uint64_t tv_words[1] = { 0x2ULL };
+
+  CutMgr mgr;
+  EXPECT_EQ( 0, mgr.cut_num() );
+  EXPECT_EQ( 0, mgr.peak_cut_num() );
+  EXPECT_EQ( 0, mgr.bytes_used() );
+
+  // チャンクを複数必要とする数だけ作る．
+  const SizeType n = 10000;
+  for ( SizeType i = 0; i < n; ++ i ) {
+    mgr.new_cut(root, 2, inputs, tv_words);
+  }
+  EXPECT_EQ( n, mgr.cut_num() );
+  EXPECT_EQ( n, mgr.peak_cut_num() );
+  EXPECT_LE( n * Cut::alloc_size(2), mgr.bytes_used() );
+
+  // clear() で最大値はリセットされない．
+  mgr.clear();
+  EXPECT_EQ( 0, mgr.cut_num() );
+  EXPECT_EQ( n, mgr.peak_cut_num() );
+  EXPECT_EQ( 0, mgr.bytes_used() );
+
+  mgr.new_cut(root, 2, inputs, tv_words);
+  EXPECT_EQ( 1, mgr.cut_num() );
+  EXPECT_EQ( n, mgr.peak_cut_num() );
+  EXPECT_LT( 0, mgr.bytes_used() );
+}
+
+TEST(CutTest, cut_holder_stats)
+{
+  SbjGraph sbjgraph;
+  make_graph8(sbjgraph);
+
+  CutHolder cut_holder1;
+  cut_holder1.enum_cut(sbjgraph, 6);
+
+  // cut_num() は保持しているカットリストの要素数の合計
+  SizeType n = 0;
+  for ( auto node: sbjgraph.logic_list() ) {
+    n += cut_holder1.cut_list(node).size();
+  }
+  EXPECT_LT( 0, n );
+  EXPECT_EQ( n, cut_holder1.cut_num() );
+  EXPECT_EQ( n, cut_holder1.peak_cut_num() );
+  EXPECT_LE( n * Cut::alloc_size(1), cut_holder1.bytes_used() );
+
+  // 複数スレッドの場合は全スレッドの合計となる．
+  CutHolder cut_holder2;
+  cut_holder2.enum_cut_mt(sbjgraph, 6, 4);
+  EXPECT_EQ( n, cut_holder2.cut_num() );
+  EXPECT_EQ( n, cut_holder2.peak_cut_num() );
+  EXPECT_LE( n * Cut::alloc_size(1), cut_holder2.bytes_used() );
+
+  // 優先カットでは保持するカット数は少なくなる．
+  CutHolder cut_holder3;
+  cut_holder3.enum_priority_cut(sbjgraph, 6, 1);
+  EXPECT_GE( n, cut_holder3.cut_num() );
+
+  // 最大値は次の列挙でもリセットされない．
+  cut_holder1.enum_priority_cut(sbjgraph, 6, 1);
+  EXPECT_EQ( cut_holder3.cut_num(), cut_holder1.cut_num() );
+  EXPECT_EQ( n, cut_holder1.peak_cut_num() );
+}
+
+END_NAMESPACE_LUTMAP
@@ -0,0 +1,244 @@
+
+/// @file DelayCoverTest.cc
+/// @brief DelayCoverTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "DelayCover.h"
+#include "DelayModel.h"
+#include "Cut.h"
+#include "CutHolder.h"
+#include "MapRecord.h"
+#include "MapEst.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class DelayCoverTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief 初期化
+  void
+  SetUp() override
+  {
+    string path = DATAPATH + string{"blif/C432.blif"};
+    BnNetwork network = BnNetwork::read_blif(path);
+    ASSERT_TRUE( network.node_num() != 0 );
+
+    Bn2Sbj bn2sbj;
+    bn2sbj.convert(network, mSbjGraph);
+
+    mCutHolder.enum_cut(mSbjGraph, 4);
+  }
+
+  /// @brief DelayCover でマッピングを行い LUT 数と段数を求める．
+  void
+  map(
+    DelayCover& delay_cover,
+    MapRecord& maprec,
+    SizeType& lut_num,
+    SizeType& depth
+  )
+  {
+    delay_cover.record_cuts(mSbjGraph, mCutHolder, maprec);
+
+    MapEst est;
+    est.estimate(mSbjGraph, maprec, lut_num, depth);
+  }
+
+  /// @brief 2つのマッピング結果で選ばれたカットの異なる論理ノード数を返す．
+  SizeType
+  diff_num(
+    const MapRecord& maprec1,
+    const MapRecord& maprec2
+  )
+  {
+    SizeType n = 0;
+    for ( auto node: mSbjGraph.logic_list() ) {
+      if ( maprec1.get_cut(node) != maprec2.get_cut(node) ) {
+	++ n;
+      }
+    }
+    return n;
+  }
+
+  // サブジェクトグラフ
+  SbjGraph mSbjGraph;
+
+  // カットを保持するオブジェクト
+  CutHolder mCutHolder;
+
+};
+
+TEST_F(DelayCoverTest, cost_limit)
+{
+  DelayCover delay_cover1{true, 0};
+  MapRecord maprec1;
+  SizeType lut_num1;
+  SizeType depth1;
+  map(delay_cover1, maprec1, lut_num1, depth1);
+
+  // 間引いても最小段数の要素は残るので段数は変わらない．
+  DelayCover delay_cover2{true, 0};
+  delay_cover2.set_cost_limit(2, 0.1);
+  MapRecord maprec2;
+  SizeType lut_num2;
+  SizeType depth2;
+  map(delay_cover2, maprec2, lut_num2, depth2);
+  EXPECT_EQ( depth1, depth2 );
+
+  // 上限が 1 の時は各ノードで最小段数の要素のみを残す．
+  DelayCover delay_cover3{true, 0};
+  delay_cover3.set_cost_limit(1, 0.0);
+  MapRecord maprec3;
+  SizeType lut_num3;
+  SizeType depth3;
+  map(delay_cover3, maprec3, lut_num3, depth3);
+  EXPECT_EQ( depth1, depth3 );
+
+  // 同じオブジェクトで再度実行しても結果は変わらない．
+  MapRecord maprec4;
+  SizeType lut_num4;
+  SizeType depth4;
+  map(delay_cover2, maprec4, lut_num4, depth4);
+  EXPECT_EQ( lut_num2, lut_num4 );
+  EXPECT_EQ( depth2, depth4 );
+}
+
+TEST_F(DelayCoverTest, slack)
+{
+  DelayCover delay_cover1{true, 0};
+  delay_cover1.set_cost_limit(4, 0.05);
+  MapRecord maprec1;
+  SizeType lut_num1;
+  SizeType depth1;
+  map(delay_cover1, maprec1, lut_num1, depth1);
+
+  // スラックの分だけ段数の制約が緩くなる．
+  DelayCover delay_cover2{true, 2};
+  delay_cover2.set_cost_limit(4, 0.05);
+  MapRecord maprec2;
+  SizeType lut_num2;
+  SizeType depth2;
+  map(delay_cover2, maprec2, lut_num2, depth2);
+  EXPECT_LE( depth2, depth1 + 2 );
+}
+
+TEST_F(DelayCoverTest, unit_model)
+{
+  DelayCover delay_cover1{true, 0};
+  MapRecord maprec1;
+  SizeType lut_num1;
+  SizeType depth1;
+  map(delay_cover1, maprec1, lut_num1, depth1);
+
+  // 全ピン 1，配線遅延 0 は単位遅延と同じ結果になる．
+  DelayModel model;
+  for ( SizeType k = 1; k <= 4; ++ k ) {
+    model.set_pin_delay(k, vector<SizeType>(k, 1));
+  }
+  model.set_wire_delay(0, 0);
+  DelayCover delay_cover2{true, 0};
+  delay_cover2.set_delay_model(model);
+  MapRecord maprec2;
+  SizeType lut_num2;
+  SizeType depth2;
+  map(delay_cover2, maprec2, lut_num2, depth2);
+  EXPECT_EQ( 0, diff_num(maprec1, maprec2) );
+  EXPECT_EQ( lut_num1, lut_num2 );
+  EXPECT_EQ( depth1, depth2 );
+}
+
+TEST_F(DelayCoverTest, pin_delay)
+{
+  DelayCover delay_cover1{true, 0};
+  MapRecord maprec1;
+  SizeType lut_num1;
+  SizeType depth1;
+  map(delay_cover1, maprec1, lut_num1, depth1);
+
+  // 最後のピンだけ極端に遅くすると選ばれるカットが変わる．
+  DelayModel model;
+  for ( SizeType k = 1; k <= 4; ++ k ) {
+    vector<SizeType> delay_list(k, 1);
+    delay_list[k - 1] = 10;
+    model.set_pin_delay(k, delay_list);
+  }
+  DelayCover delay_cover2{true, 0};
+  delay_cover2.set_delay_model(model);
+  MapRecord maprec2;
+  SizeType lut_num2;
+  SizeType depth2;
+  map(delay_cover2, maprec2, lut_num2, depth2);
+  EXPECT_LT( 0, diff_num(maprec1, maprec2) );
+}
+
+TEST_F(DelayCoverTest, wire_delay)
+{
+  DelayCover delay_cover1{true, 0};
+  MapRecord maprec1;
+  SizeType lut_num1;
+  SizeType depth1;
+  map(delay_cover1, maprec1, lut_num1, depth1);
+
+  // ファンアウト数の多いノードを入力とするカットが不利になる．
+  DelayModel model;
+  model.set_wire_delay(0, 5);
+  DelayCover delay_cover2{true, 0};
+  delay_cover2.set_delay_model(model);
+  MapRecord maprec2;
+  SizeType lut_num2;
+  SizeType depth2;
+  map(delay_cover2, maprec2, lut_num2, depth2);
+  EXPECT_LT( 0, diff_num(maprec1, maprec2) );
+}
+
+TEST_F(DelayCoverTest, assign_pins)
+{
+  const Cut* cut = nullptr;
+  for ( auto node: mSbjGraph.logic_list() ) {
+    for ( auto cut1: mCutHolder.cut_list(node) ) {
+      if ( cut1->input_num() == 4 ) {
+	cut = cut1;
+	break;
+      }
+    }
+    if ( cut != nullptr ) {
+      break;
+    }
+  }
+  ASSERT_TRUE( cut != nullptr );
+
+  // 到着の遅い入力ほど遅延の小さいピンに割り当てられる．
+  DelayModel model;
+  model.set_pin_delay(4, vector<SizeType>{4, 1, 3, 2});
+  vector<SizeType> level_list{0, 3, 1, 2};
+  vector<SizeType> pin_list;
+  model.assign_pins(cut, level_list, pin_list);
+  EXPECT_EQ( (vector<SizeType>{0, 1, 2, 3}), pin_list );
+  SizeType arrival = 0;
+  for ( SizeType i = 0; i < 4; ++ i ) {
+    arrival = std::max(arrival, level_list[i] + model.edge_delay(cut, i, pin_list[i]));
+  }
+  EXPECT_EQ( 4, arrival );
+
+  level_list = vector<SizeType>{3, 0, 2, 1};
+  model.assign_pins(cut, level_list, pin_list);
+  EXPECT_EQ( (vector<SizeType>{1, 0, 3, 2}), pin_list );
+
+  // 単位遅延では入力の順のままとなる．
+  DelayModel unit_model;
+  unit_model.assign_pins(cut, level_list, pin_list);
+  EXPECT_EQ( (vector<SizeType>{0, 1, 2, 3}), pin_list );
+}
+
+END_NAMESPACE_LUTMAP
@@ -0,0 +1,108 @@
+
+/// @file EnumCutMtTest.cc
+/// @brief EnumCutMtTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "CutHolder.h"
+#include "Cut.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+BEGIN_NONAMESPACE
+
+// ノードのカットを葉のノード番号のリストのリストにして返す．
+//
+// カットの順番と葉の順番はそのまま保つ．
+vector<vector<SizeType>>
+cut_contents(
+  const CutHolder& cut_holder,
+  const SbjNode* node
+)
+{
+  vector<vector<SizeType>> ans_list;
+  for ( auto cut: cut_holder.cut_list(node) ) {
+    EXPECT_EQ( node, cut->root() );
+    vector<SizeType> id_list;
+    for ( SizeType i = 0; i < cut->input_num(); ++ i ) {
+      id_list.push_back(cut->input(i)->id());
+    }
+    ans_list.push_back(id_list);
+  }
+  return ans_list;
+}
+
+END_NONAMESPACE
+
+class EnumCutMtTest :
+  public ::testing::TestWithParam<SizeType>
+{
+public:
+
+  /// @brief enum_cut() と enum_cut_mt() の結果を比較する．
+  void
+  do_test(
+    const string& filename,
+    SizeType limit
+  )
+  {
+    string path = DATAPATH + filename;
+    BnNetwork network = BnNetwork::read_blif(path);
+    ASSERT_TRUE( network.node_num() != 0 );
+
+    SbjGraph sbjgraph;
+    Bn2Sbj bn2sbj;
+    bn2sbj.convert(network, sbjgraph);
+
+    CutHolder cut_holder1;
+    auto nc1 = cut_holder1.enum_cut(sbjgraph, limit);
+
+    CutHolder cut_holder2;
+    auto nc2 = cut_holder2.enum_cut_mt(sbjgraph, limit, GetParam());
+    EXPECT_EQ( nc1, nc2 );
+    EXPECT_EQ( cut_holder1.limit(), cut_holder2.limit() );
+    EXPECT_EQ( cut_holder1.cut_num(), cut_holder2.cut_num() );
+    EXPECT_EQ( cut_holder1.peak_cut_num(), cut_holder2.peak_cut_num() );
+    EXPECT_LT( 0, cut_holder2.bytes_used() );
+
+    for ( SizeType id = 0; id < sbjgraph.node_num(); ++ id ) {
+      auto node = sbjgraph.node(id);
+      if ( node->is_output() ) {
+	continue;
+      }
+      EXPECT_EQ( cut_contents(cut_holder1, node),
+		 cut_contents(cut_holder2, node) );
+    }
+  }
+
+};
+
+TEST_P(EnumCutMtTest, C432)
+{
+  do_test("blif/C432.blif", 4);
+}
+
+TEST_P(EnumCutMtTest, C1355)
+{
+  do_test("blif/C1355.blif", 5);
+}
+
+TEST_P(EnumCutMtTest, s5378)
+{
+  do_test("blif/s5378.blif", 4);
+}
+
+// スレッド数 0 はハードウェアの並列度に合わせる．
+INSTANTIATE_TEST_CASE_P(EnumCutMtTest,
+			 EnumCutMtTest,
+			 ::testing::Values(0, 1, 2, 4));
+
+END_NAMESPACE_LUTMAP
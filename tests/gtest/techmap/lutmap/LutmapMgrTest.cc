@@ -0,0 +1,278 @@
+
+/// @file LutmapMgrTest.cc
+/// @brief LutmapMgrTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "LutmapMgr.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_MAGUS
+
+class LutmapMgrTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief 初期化
+  void
+  SetUp() override
+  {
+    string path = DATAPATH + string{"blif/C432.blif"};
+    mNetwork = BnNetwork::read_blif(path);
+    ASSERT_TRUE( mNetwork.node_num() != 0 );
+  }
+
+  // 対象のネットワーク
+  BnNetwork mNetwork;
+
+};
+
+TEST_F(LutmapMgrTest, area_map)
+{
+  LutmapMgr mgr{4, "no_cut_resub"};
+  auto dst_network = mgr.area_map(mNetwork);
+
+  EXPECT_EQ( mNetwork.input_num(), dst_network.input_num() );
+  EXPECT_EQ( mNetwork.output_num(), dst_network.output_num() );
+  EXPECT_LT( 0, mgr.lut_num() );
+  EXPECT_LT( 0, mgr.depth() );
+}
+
+TEST_F(LutmapMgrTest, strash)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  mgr1.area_map(mNetwork);
+
+  LutmapMgr mgr2{4, "no_cut_resub,strash"};
+  auto dst_network2 = mgr2.area_map(mNetwork);
+  EXPECT_EQ( mNetwork.input_num(), dst_network2.input_num() );
+  EXPECT_EQ( mNetwork.output_num(), dst_network2.output_num() );
+  EXPECT_LT( 0, mgr2.lut_num() );
+
+  // no_strash で元に戻る．
+  LutmapMgr mgr3{4, "no_cut_resub,strash,no_strash"};
+  mgr3.area_map(mNetwork);
+  EXPECT_EQ( mgr1.lut_num(), mgr3.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr3.depth() );
+}
+
+TEST_F(LutmapMgrTest, priority_cut)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  mgr1.delay_map(mNetwork, 0);
+
+  // 値を省略した時は各ノード 8 個
+  LutmapMgr mgr2{4, "no_cut_resub,priority_cut"};
+  auto dst_network2 = mgr2.delay_map(mNetwork, 0);
+  EXPECT_EQ( mNetwork.output_num(), dst_network2.output_num() );
+  EXPECT_LT( 0, mgr2.lut_num() );
+  // 全カットを用いた時の段数が最小となる．
+  EXPECT_LE( mgr1.depth(), mgr2.depth() );
+
+  LutmapMgr mgr3{4, "no_cut_resub,priority_cut=2"};
+  auto dst_network3 = mgr3.delay_map(mNetwork, 0);
+  EXPECT_EQ( mNetwork.output_num(), dst_network3.output_num() );
+  EXPECT_LE( mgr1.depth(), mgr3.depth() );
+
+  // all_cut で元に戻る．
+  LutmapMgr mgr4{4, "no_cut_resub,priority_cut=2,all_cut"};
+  mgr4.delay_map(mNetwork, 0);
+  EXPECT_EQ( mgr1.lut_num(), mgr4.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr4.depth() );
+}
+
+TEST_F(LutmapMgrTest, cut_stats)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  EXPECT_EQ( 0, mgr1.peak_cut_num() );
+  EXPECT_EQ( 0, mgr1.cut_bytes_used() );
+  mgr1.area_map(mNetwork);
+  EXPECT_LT( 0, mgr1.peak_cut_num() );
+  EXPECT_LT( 0, mgr1.cut_bytes_used() );
+
+  // 優先カットの方がカット数は少ない．
+  LutmapMgr mgr2{4, "no_cut_resub,priority_cut=2"};
+  mgr2.area_map(mNetwork);
+  EXPECT_LT( 0, mgr2.peak_cut_num() );
+  EXPECT_GT( mgr1.peak_cut_num(), mgr2.peak_cut_num() );
+
+  // スレッド数によらずカット数は同じ．
+  LutmapMgr mgr3{4, "no_cut_resub,cut_thread=2"};
+  mgr3.area_map(mNetwork);
+  EXPECT_EQ( mgr1.peak_cut_num(), mgr3.peak_cut_num() );
+}
+
+TEST_F(LutmapMgrTest, bad_priority_cut)
+{
+  LutmapMgr mgr{4};
+  EXPECT_THROW( mgr.set_option("priority_cut=0"), std::invalid_argument );
+  EXPECT_THROW( mgr.set_option("priority_cut=-1"), std::invalid_argument );
+  EXPECT_THROW( mgr.set_option("priority_cut=abc"), std::invalid_argument );
+  EXPECT_THROW( mgr.set_option("priority_cut=8x"), std::invalid_argument );
+  EXPECT_THROW( mgr.set_option("priority_cut=99999999999"), std::invalid_argument );
+  EXPECT_NO_THROW( mgr.set_option("priority_cut=1") );
+}
+
+TEST_F(LutmapMgrTest, cut_thread)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  mgr1.area_map(mNetwork);
+
+  // 複数スレッドで列挙したカットは同一なので結果も同じになる．
+  LutmapMgr mgr2{4, "no_cut_resub,cut_thread=4"};
+  mgr2.area_map(mNetwork);
+  EXPECT_EQ( mgr1.lut_num(), mgr2.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr2.depth() );
+
+  // 値を省略した時はハードウェアの並列度に合わせる．
+  LutmapMgr mgr3{4, "no_cut_resub,cut_thread"};
+  mgr3.area_map(mNetwork);
+  EXPECT_EQ( mgr1.lut_num(), mgr3.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr3.depth() );
+}
+
+TEST_F(LutmapMgrTest, recovery)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  mgr1.area_map(mNetwork);
+
+  LutmapMgr mgr2{4, "no_cut_resub,flow_recovery,exact_recovery=2"};
+  auto dst_network2 = mgr2.area_map(mNetwork);
+  EXPECT_EQ( mNetwork.output_num(), dst_network2.output_num() );
+  EXPECT_LT( 0, mgr2.lut_num() );
+
+  LutmapMgr mgr3{4, "no_cut_resub,exact_recovery"};
+  mgr3.area_map(mNetwork);
+  // exact area による回復では LUT 数は増えない．
+  EXPECT_LE( mgr3.lut_num(), mgr1.lut_num() );
+}
+
+TEST_F(LutmapMgrTest, sa)
+{
+  LutmapMgr mgr1{4, "no_cut_resub,algorithm=sa,sa_count=5,seed=3"};
+  auto dst_network1 = mgr1.area_map(mNetwork);
+  EXPECT_EQ( mNetwork.input_num(), dst_network1.input_num() );
+  EXPECT_EQ( mNetwork.output_num(), dst_network1.output_num() );
+  EXPECT_LT( 0, mgr1.lut_num() );
+
+  // 同じ種ならば同じ結果となる．
+  LutmapMgr mgr2{4, "no_cut_resub,algorithm=sa,sa_count=5,seed=3"};
+  mgr2.area_map(mNetwork);
+  EXPECT_EQ( mgr1.lut_num(), mgr2.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr2.depth() );
+
+  // 複数の連鎖の場合も同様
+  for ( auto opt: {"sa_chain=3", "sa_chain=3,sa_exchange"} ) {
+    string option = string{"no_cut_resub,algorithm=sa,sa_count=5,seed=3,"} + opt;
+    LutmapMgr mgr3{4, option};
+    mgr3.area_map(mNetwork);
+    LutmapMgr mgr4{4, option};
+    mgr4.area_map(mNetwork);
+    EXPECT_LT( 0, mgr3.lut_num() );
+    EXPECT_EQ( mgr3.lut_num(), mgr4.lut_num() );
+    EXPECT_EQ( mgr3.depth(), mgr4.depth() );
+  }
+
+  LutmapMgr mgr5{4};
+  EXPECT_THROW( mgr5.set_option("algorithm=foo"), std::invalid_argument );
+  EXPECT_THROW( mgr5.set_option("sa_chain=0"), std::invalid_argument );
+  EXPECT_THROW( mgr5.set_option("sa_count=x"), std::invalid_argument );
+}
+
+TEST_F(LutmapMgrTest, mct)
+{
+  LutmapMgr mgr1{4, "no_cut_resub,algorithm=mct,mct_count=50,seed=3"};
+  auto dst_network1 = mgr1.area_map(mNetwork);
+  EXPECT_EQ( mNetwork.input_num(), dst_network1.input_num() );
+  EXPECT_EQ( mNetwork.output_num(), dst_network1.output_num() );
+  EXPECT_LT( 0, mgr1.lut_num() );
+
+  // スレッド数 1 の場合は同じ種ならば同じ結果となる．
+  LutmapMgr mgr2{4, "no_cut_resub,algorithm=mct,mct_count=50,seed=3,mct_thread=1"};
+  mgr2.area_map(mNetwork);
+  EXPECT_EQ( mgr1.lut_num(), mgr2.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr2.depth() );
+
+  LutmapMgr mgr3{4, "no_cut_resub,algorithm=mct,mct_count=50,seed=3,mct_thread=4"};
+  auto dst_network3 = mgr3.area_map(mNetwork);
+  EXPECT_EQ( mNetwork.output_num(), dst_network3.output_num() );
+  EXPECT_LT( 0, mgr3.lut_num() );
+
+  LutmapMgr mgr4{4};
+  EXPECT_THROW( mgr4.set_option("mct_thread=0"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("mct_count="), std::invalid_argument );
+}
+
+TEST_F(LutmapMgrTest, delay_model)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  mgr1.delay_map(mNetwork, 0);
+
+  // 単位遅延を明示的に指定した時は結果は変わらない．
+  LutmapMgr mgr2{4, "no_cut_resub,pin_delay=1:1:1:1,wire_delay=0:0"};
+  mgr2.delay_map(mNetwork, 0);
+  EXPECT_EQ( mgr1.lut_num(), mgr2.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr2.depth() );
+
+  // 単位遅延でない場合も正しいネットワークが得られる．
+  LutmapMgr mgr3{4, "pin_delay=1:1:2:4,wire_delay=1:2"};
+  auto dst_network3 = mgr3.delay_map(mNetwork, 0);
+  EXPECT_EQ( mNetwork.input_num(), dst_network3.input_num() );
+  EXPECT_EQ( mNetwork.output_num(), dst_network3.output_num() );
+  EXPECT_LT( 0, mgr3.lut_num() );
+
+  // set_option() で単位遅延に戻る．
+  mgr3.set_option("no_cut_resub");
+  mgr3.delay_map(mNetwork, 0);
+  EXPECT_EQ( mgr1.lut_num(), mgr3.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr3.depth() );
+
+  // 不正な値は例外となる．
+  LutmapMgr mgr4{4};
+  EXPECT_THROW( mgr4.set_option("pin_delay=1:0:1:1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("pin_delay=1:-1:1:1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("pin_delay=1:1:x:1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("pin_delay=1::1:1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("pin_delay="), std::invalid_argument );
+  // LUT の入力数より値が少ない．
+  EXPECT_THROW( mgr4.set_option("pin_delay=1:1:1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("wire_delay=1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("wire_delay=0:1:2"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("wire_delay=-1:0"), std::invalid_argument );
+  EXPECT_NO_THROW( mgr4.set_option("pin_delay=1:1:2:3:5,wire_delay=0:0") );
+}
+
+TEST_F(LutmapMgrTest, cost_limit)
+{
+  LutmapMgr mgr1{4, "no_cut_resub"};
+  mgr1.delay_map(mNetwork, 0);
+
+  // 最小遅延の解は残るので段数は変わらない．
+  LutmapMgr mgr2{4, "no_cut_resub,cost_limit=1"};
+  auto dst_network2 = mgr2.delay_map(mNetwork, 0);
+  EXPECT_EQ( mNetwork.output_num(), dst_network2.output_num() );
+  EXPECT_EQ( mgr1.depth(), mgr2.depth() );
+
+  LutmapMgr mgr3{4, "no_cut_resub,cost_limit=3,cost_epsilon=10"};
+  mgr3.delay_map(mNetwork, 0);
+  EXPECT_EQ( mgr1.depth(), mgr3.depth() );
+
+  // set_option() で制限なしに戻る．
+  mgr3.set_option("no_cut_resub");
+  mgr3.delay_map(mNetwork, 0);
+  EXPECT_EQ( mgr1.lut_num(), mgr3.lut_num() );
+  EXPECT_EQ( mgr1.depth(), mgr3.depth() );
+
+  LutmapMgr mgr4{4};
+  EXPECT_THROW( mgr4.set_option("cost_limit="), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("cost_limit=-1"), std::invalid_argument );
+  EXPECT_THROW( mgr4.set_option("cost_epsilon=0.1"), std::invalid_argument );
+}
+
+END_NAMESPACE_MAGUS
@@ -0,0 +1,162 @@
+
+/// @file MapEstTest.cc
+/// @brief MapEstTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "MapEst.h"
+#include "AreaCover.h"
+#include "CutHolder.h"
+#include "MapRecord.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "SbjHandle.h"
+#include "ym/BnNetwork.h"
+#include <random>
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class MapEstTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief ファイルを読み込んでカットを列挙する．
+  void
+  read(
+    const string& filename
+  )
+  {
+    string path = DATAPATH + filename;
+    BnNetwork network = BnNetwork::read_blif(path);
+    ASSERT_TRUE( network.node_num() != 0 );
+
+    Bn2Sbj bn2sbj;
+    bn2sbj.convert(network, mSbjGraph);
+
+    mCutHolder.enum_cut(mSbjGraph, 4);
+  }
+
+  /// @brief estimate() で LUT 数を求める．
+  SizeType
+  lut_num(
+    const MapRecord& maprec
+  )
+  {
+    MapEst est;
+    SizeType lut_num;
+    SizeType depth;
+    est.estimate(mSbjGraph, maprec, lut_num, depth);
+    return lut_num;
+  }
+
+  /// @brief 2つの解が同一か調べる．
+  void
+  check_same(
+    const MapRecord& maprec1,
+    const MapRecord& maprec2
+  )
+  {
+    for ( SizeType id = 0; id < mSbjGraph.node_num(); ++ id ) {
+      auto node = mSbjGraph.node(id);
+      ASSERT_EQ( maprec1.get_cut(node), maprec2.get_cut(node) );
+    }
+  }
+
+  /// @brief flip_boundary() と undo() をランダムに行って差分更新を確かめる．
+  void
+  do_test(
+    bool fanout_mode,
+    SizeType seed
+  )
+  {
+    vector<const SbjNode*> fp_list;
+    for ( auto node: mSbjGraph.logic_list() ) {
+      if ( node->fanout_num() > 1 ) {
+	fp_list.push_back(node);
+      }
+    }
+    ASSERT_FALSE( fp_list.empty() );
+
+    AreaCover area_cover{fanout_mode};
+    MapRecord maprec;
+    area_cover.init_incr(mSbjGraph, mCutHolder, {}, maprec);
+    MapEst map_est;
+    map_est.init_incr(mSbjGraph, maprec);
+    ASSERT_EQ( lut_num(maprec), map_est.incr_lut_num() );
+
+    std::mt19937 rg{static_cast<std::uint32_t>(seed)};
+    std::uniform_int_distribution<SizeType> rd(0, fp_list.size() - 1);
+    std::uniform_int_distribution<int> rd_undo(0, 2);
+    for ( SizeType i = 0; i < 500; ++ i ) {
+      MapRecord prev{maprec};
+      SizeType prev_num = map_est.incr_lut_num();
+
+      area_cover.flip_boundary(fp_list[rd(rg)]);
+      map_est.update(maprec, area_cover.changed_node_list());
+      ASSERT_EQ( lut_num(maprec), map_est.incr_lut_num() );
+
+      if ( rd_undo(rg) == 0 ) {
+	// undo() で元の解に戻る．
+	area_cover.undo();
+	map_est.update(maprec, area_cover.changed_node_list());
+	check_same(prev, maprec);
+	ASSERT_EQ( prev_num, map_est.incr_lut_num() );
+	ASSERT_EQ( lut_num(maprec), map_est.incr_lut_num() );
+      }
+    }
+  }
+
+  // サブジェクトグラフ
+  SbjGraph mSbjGraph;
+
+  // カットを保持するオブジェクト
+  CutHolder mCutHolder;
+
+};
+
+TEST_F(MapEstTest, incr_C432)
+{
+  read("blif/C432.blif");
+  do_test(true, 1);
+  do_test(false, 2);
+}
+
+TEST_F(MapEstTest, incr_C1355)
+{
+  read("blif/C1355.blif");
+  do_test(true, 3);
+  do_test(false, 4);
+}
+
+TEST_F(MapEstTest, long_chain)
+{
+  // 非常に段数の深い AND の鎖
+  // 参照/参照解除が再帰を用いていないことを確かめる．
+  const SizeType n = 100000;
+  auto node0 = mSbjGraph.new_input(false);
+  SbjHandle h{node0, false};
+  for ( SizeType i = 1; i < n; ++ i ) {
+    auto node = mSbjGraph.new_input(false);
+    h = mSbjGraph.new_and(h, SbjHandle{node, false});
+  }
+  mSbjGraph.new_output(h);
+
+  mCutHolder.enum_cut(mSbjGraph, 2);
+
+  AreaCover area_cover{true};
+  MapRecord maprec;
+  area_cover.record_cuts(mSbjGraph, mCutHolder, maprec);
+
+  MapEst map_est;
+  map_est.init_incr(mSbjGraph, maprec);
+  EXPECT_EQ( n - 1, map_est.incr_lut_num() );
+  EXPECT_EQ( lut_num(maprec), map_est.incr_lut_num() );
+}
+
+END_NAMESPACE_LUTMAP
@@ -0,0 +1,133 @@
+
+/// @file MctSearchTest.cc
+/// @brief MctSearchTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "mct1/MctSearch.h"
+#include "mct2/MctSearch.h"
+#include "CutHolder.h"
+#include "MapRecord.h"
+#include "MapEst.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class MctSearchTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief 初期化
+  void
+  SetUp() override
+  {
+    string path = DATAPATH + string{"blif/C432.blif"};
+    BnNetwork network = BnNetwork::read_blif(path);
+    ASSERT_TRUE( network.node_num() != 0 );
+
+    Bn2Sbj bn2sbj;
+    bn2sbj.convert(network, mSbjGraph);
+
+    mCutHolder.enum_cut(mSbjGraph, 4);
+  }
+
+  /// @brief LUT 数を求める．
+  SizeType
+  lut_num(
+    const MapRecord& maprec
+  )
+  {
+    MapEst est;
+    SizeType lut_num;
+    SizeType depth;
+    est.estimate(mSbjGraph, maprec, lut_num, depth);
+    return lut_num;
+  }
+
+  /// @brief 2つの解が同一か調べる．
+  void
+  check_same(
+    const MapRecord& maprec1,
+    const MapRecord& maprec2
+  )
+  {
+    for ( auto node: mSbjGraph.logic_list() ) {
+      EXPECT_EQ( maprec1.get_cut(node), maprec2.get_cut(node) );
+    }
+  }
+
+  // サブジェクトグラフ
+  SbjGraph mSbjGraph;
+
+  // カットを保持するオブジェクト
+  CutHolder mCutHolder;
+
+};
+
+TEST_F(MctSearchTest, mct2_single_thread)
+{
+  // スレッド数 1 の search_mt() は search() と同じ結果となる．
+  nsMct2::MctSearch mct1{mSbjGraph, mCutHolder, 4, true};
+  mct1.set_seed(5);
+  auto maprec1 = mct1.search(100, false);
+
+  nsMct2::MctSearch mct2{mSbjGraph, mCutHolder, 4, true};
+  mct2.set_seed(5);
+  auto maprec2 = mct2.search_mt(100, 1, false);
+
+  check_same(maprec1, maprec2);
+  EXPECT_EQ( lut_num(maprec1), lut_num(maprec2) );
+  EXPECT_LT( 0, lut_num(maprec1) );
+}
+
+TEST_F(MctSearchTest, mct2_multi_thread)
+{
+  nsMct2::MctSearch mct{mSbjGraph, mCutHolder, 4, true};
+  mct.set_seed(5);
+  auto maprec = mct.search_mt(100, 4, false);
+
+  // 外部出力から参照されているノードはカットを持つ．
+  for ( auto onode: mSbjGraph.output_list() ) {
+    auto node = onode->output_fanin();
+    if ( node != nullptr && node->is_logic() ) {
+      EXPECT_TRUE( maprec.get_cut(node) != nullptr );
+    }
+  }
+  EXPECT_LT( 0, lut_num(maprec) );
+}
+
+TEST_F(MctSearchTest, mct1_single_thread)
+{
+  // スレッド数 1 の search_mt() は search() と同じ結果となる．
+  nsMct1::MctSearch mct1{mSbjGraph, mCutHolder, 4};
+  mct1.set_seed(5);
+  mct1.search(50, false);
+
+  nsMct1::MctSearch mct2{mSbjGraph, mCutHolder, 4};
+  mct2.set_seed(5);
+  mct2.search_mt(50, 1, false);
+
+  EXPECT_EQ( mct1.best_lut_num(), mct2.best_lut_num() );
+  EXPECT_LT( 0, mct1.best_lut_num() );
+  EXPECT_GE( mSbjGraph.node_num(), mct1.best_lut_num() );
+}
+
+TEST_F(MctSearchTest, mct1_multi_thread)
+{
+  nsMct1::MctSearch mct{mSbjGraph, mCutHolder, 4};
+  mct.set_seed(5);
+  mct.search_mt(50, 4, false);
+
+  EXPECT_LT( 0, mct.best_lut_num() );
+  EXPECT_GE( mSbjGraph.node_num(), mct.best_lut_num() );
+}
+
+END_NAMESPACE_LUTMAP
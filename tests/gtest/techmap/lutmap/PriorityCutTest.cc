@@ -0,0 +1,131 @@
+
+/// @file PriorityCutTest.cc
+/// @brief PriorityCutTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "CutHolder.h"
+#include "Cut.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "SbjHandle.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+BEGIN_NONAMESPACE
+
+// カットの葉のノード番号の集合を返す．
+vector<SizeType>
+leaf_set(
+  const Cut* cut
+)
+{
+  vector<SizeType> id_list;
+  for ( SizeType i = 0; i < cut->input_num(); ++ i ) {
+    id_list.push_back(cut->input(i)->id());
+  }
+  std::sort(id_list.begin(), id_list.end());
+  return id_list;
+}
+
+// ノードのカットの葉の集合のリストを返す．
+vector<vector<SizeType>>
+leaf_set_list(
+  const CutHolder& cut_holder,
+  const SbjNode* node
+)
+{
+  vector<vector<SizeType>> ans_list;
+  for ( auto cut: cut_holder.cut_list(node) ) {
+    ans_list.push_back(leaf_set(cut));
+  }
+  return ans_list;
+}
+
+END_NONAMESPACE
+
+TEST(PriorityCutTest, simple)
+{
+  // a & b & c の2段の回路
+  SbjGraph sbjgraph;
+  auto a = sbjgraph.new_input(false);
+  auto b = sbjgraph.new_input(false);
+  auto c = sbjgraph.new_input(false);
+  auto h1 = sbjgraph.new_and(SbjHandle{a, false}, SbjHandle{b, false});
+  auto h2 = sbjgraph.new_and(h1, SbjHandle{c, false});
+  sbjgraph.new_output(h2);
+
+  auto id_a = a->id();
+  auto id_b = b->id();
+  auto id_c = c->id();
+  auto id1 = h1.node()->id();
+
+  // カット数の制限が十分なら全てのカットが得られる．
+  CutHolder cut_holder1;
+  cut_holder1.enum_priority_cut(sbjgraph, 3, 4);
+  auto cut_list1 = leaf_set_list(cut_holder1, h2.node());
+  ASSERT_EQ( 2, cut_list1.size() );
+  // 段数の小さい方が先にくる．
+  vector<SizeType> exp_cut1{id_a, id_b, id_c};
+  std::sort(exp_cut1.begin(), exp_cut1.end());
+  vector<SizeType> exp_cut2{id1, id_c};
+  std::sort(exp_cut2.begin(), exp_cut2.end());
+  EXPECT_EQ( exp_cut1, cut_list1[0] );
+  EXPECT_EQ( exp_cut2, cut_list1[1] );
+
+  // カット数が 1 の時は最良のカットのみを残す．
+  CutHolder cut_holder2;
+  cut_holder2.enum_priority_cut(sbjgraph, 3, 1);
+  auto cut_list2 = leaf_set_list(cut_holder2, h2.node());
+  ASSERT_EQ( 1, cut_list2.size() );
+  EXPECT_EQ( exp_cut1, cut_list2[0] );
+
+  // 入力数の制限を越えるカットは作らない．
+  CutHolder cut_holder3;
+  cut_holder3.enum_priority_cut(sbjgraph, 2, 4);
+  auto cut_list3 = leaf_set_list(cut_holder3, h2.node());
+  ASSERT_EQ( 1, cut_list3.size() );
+  EXPECT_EQ( exp_cut2, cut_list3[0] );
+}
+
+TEST(PriorityCutTest, C432)
+{
+  string path = DATAPATH + string{"blif/C432.blif"};
+  BnNetwork network = BnNetwork::read_blif(path);
+  ASSERT_TRUE( network.node_num() != 0 );
+
+  SbjGraph sbjgraph;
+  Bn2Sbj bn2sbj;
+  bn2sbj.convert(network, sbjgraph);
+
+  const SizeType limit = 4;
+  const SizeType cut_num = 6;
+
+  CutHolder cut_holder1;
+  auto nc1 = cut_holder1.enum_cut(sbjgraph, limit);
+
+  CutHolder cut_holder2;
+  auto nc2 = cut_holder2.enum_priority_cut(sbjgraph, limit, cut_num);
+  EXPECT_LE( nc2, nc1 );
+
+  for ( auto node: sbjgraph.logic_list() ) {
+    auto cut_list1 = leaf_set_list(cut_holder1, node);
+    auto cut_list2 = leaf_set_list(cut_holder2, node);
+    EXPECT_LE( cut_list2.size(), cut_num );
+    EXPECT_FALSE( cut_list2.empty() );
+    // 優先カットはすべて通常のカットにも含まれる．
+    for ( auto& cut: cut_list2 ) {
+      EXPECT_LE( cut.size(), limit );
+      EXPECT_NE( cut_list1.end(),
+		 std::find(cut_list1.begin(), cut_list1.end(), cut) );
+    }
+  }
+}
+
+END_NAMESPACE_LUTMAP
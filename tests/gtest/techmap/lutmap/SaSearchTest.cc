@@ -0,0 +1,123 @@
+
+/// @file SaSearchTest.cc
+/// @brief SaSearchTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "SaSearch.h"
+#include "CutHolder.h"
+#include "MapRecord.h"
+#include "MapEst.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_LUTMAP
+
+class SaSearchTest :
+  public ::testing::Test
+{
+public:
+
+  /// @brief 初期化
+  void
+  SetUp() override
+  {
+    string path = DATAPATH + string{"blif/C432.blif"};
+    BnNetwork network = BnNetwork::read_blif(path);
+    ASSERT_TRUE( network.node_num() != 0 );
+
+    Bn2Sbj bn2sbj;
+    bn2sbj.convert(network, mSbjGraph);
+
+    mCutHolder.enum_cut(mSbjGraph, 4);
+  }
+
+  /// @brief 探索を行う．
+  ///
+  /// chain_num が 0 の時は search() を用いる．
+  MapRecord
+  search(
+    SizeType seed,
+    SizeType chain_num,
+    bool exchange
+  )
+  {
+    SaSearch sa{mSbjGraph, mCutHolder, 4, true};
+    sa.set_seed(seed);
+    if ( chain_num == 0 ) {
+      return sa.search(10, false);
+    }
+    return sa.search_mt(10, chain_num, exchange, false);
+  }
+
+  /// @brief LUT 数を求める．
+  SizeType
+  lut_num(
+    const MapRecord& maprec
+  )
+  {
+    MapEst est;
+    SizeType lut_num;
+    SizeType depth;
+    est.estimate(mSbjGraph, maprec, lut_num, depth);
+    return lut_num;
+  }
+
+  /// @brief 2つの解が同一か調べる．
+  void
+  check_same(
+    const MapRecord& maprec1,
+    const MapRecord& maprec2
+  )
+  {
+    for ( auto node: mSbjGraph.logic_list() ) {
+      EXPECT_EQ( maprec1.get_cut(node), maprec2.get_cut(node) );
+    }
+    EXPECT_EQ( lut_num(maprec1), lut_num(maprec2) );
+  }
+
+  // サブジェクトグラフ
+  SbjGraph mSbjGraph;
+
+  // カットを保持するオブジェクト
+  CutHolder mCutHolder;
+
+};
+
+TEST_F(SaSearchTest, search)
+{
+  auto maprec1 = search(1, 0, false);
+  auto maprec2 = search(1, 0, false);
+  check_same(maprec1, maprec2);
+  EXPECT_LT( 0, lut_num(maprec1) );
+  EXPECT_GE( mSbjGraph.logic_num(), lut_num(maprec1) );
+}
+
+TEST_F(SaSearchTest, search_mt)
+{
+  // 同じ種ならばスレッドの実行順によらず同じ解となる．
+  auto maprec1 = search(1, 3, false);
+  auto maprec2 = search(1, 3, false);
+  check_same(maprec1, maprec2);
+  EXPECT_LT( 0, lut_num(maprec1) );
+}
+
+TEST_F(SaSearchTest, search_mt_exchange)
+{
+  auto maprec1 = search(1, 3, true);
+  auto maprec2 = search(1, 3, true);
+  check_same(maprec1, maprec2);
+  EXPECT_LT( 0, lut_num(maprec1) );
+
+  auto maprec3 = search(7, 4, true);
+  auto maprec4 = search(7, 4, true);
+  check_same(maprec3, maprec4);
+}
+
+END_NAMESPACE_LUTMAP
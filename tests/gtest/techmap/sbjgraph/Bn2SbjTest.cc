@@ -0,0 +1,70 @@
+
+/// @file Bn2SbjTest.cc
+/// @brief Bn2SbjTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "Bn2Sbj.h"
+#include "SbjGraph.h"
+#include "ym/BnNetwork.h"
+
+
+BEGIN_NAMESPACE_SBJ
+
+TEST(Bn2SbjTest, no_strash)
+{
+  string path = DATAPATH + string{"blif/dup_gates.blif"};
+  BnNetwork network = BnNetwork::read_blif(path);
+  ASSERT_TRUE( network.node_num() != 0 );
+
+  SbjGraph graph;
+  Bn2Sbj bn2sbj;
+  bn2sbj.convert(network, graph);
+
+  EXPECT_FALSE( graph.is_strash() );
+  // 重複したゲートはそのまま残る．
+  EXPECT_EQ( 5, graph.logic_num() );
+}
+
+TEST(Bn2SbjTest, strash)
+{
+  string path = DATAPATH + string{"blif/dup_gates.blif"};
+  BnNetwork network = BnNetwork::read_blif(path);
+  ASSERT_TRUE( network.node_num() != 0 );
+
+  SbjGraph graph;
+  Bn2Sbj bn2sbj{true};
+  bn2sbj.convert(network, graph);
+
+  EXPECT_TRUE( graph.is_strash() );
+  // n1, n2, n3 と x, y がそれぞれ併合される．
+  EXPECT_EQ( 2, graph.logic_num() );
+  EXPECT_EQ( 3, graph.output_num() );
+  EXPECT_EQ( graph.output(0)->fanin0(), graph.output(1)->fanin0() );
+}
+
+TEST(Bn2SbjTest, strash_C432)
+{
+  string path = DATAPATH + string{"blif/C432.blif"};
+  BnNetwork network = BnNetwork::read_blif(path);
+  ASSERT_TRUE( network.node_num() != 0 );
+
+  SbjGraph graph1;
+  Bn2Sbj bn2sbj1;
+  bn2sbj1.convert(network, graph1);
+
+  SbjGraph graph2;
+  Bn2Sbj bn2sbj2{true};
+  bn2sbj2.convert(network, graph2);
+
+  // 構造ハッシュでノード数が増えることはない．
+  EXPECT_LE( graph2.logic_num(), graph1.logic_num() );
+  EXPECT_EQ( graph1.input_num(), graph2.input_num() );
+  EXPECT_EQ( graph1.output_num(), graph2.output_num() );
+}
+
+END_NAMESPACE_SBJ
@@ -0,0 +1,133 @@
+
+/// @file SbjGraphTest.cc
+/// @brief SbjGraphTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "SbjGraph.h"
+#include "SbjHandle.h"
+#include "SbjNode.h"
+
+
+BEGIN_NAMESPACE_SBJ
+
+TEST(SbjGraphTest, no_strash)
+{
+  SbjGraph graph;
+
+  EXPECT_FALSE( graph.is_strash() );
+
+  auto node1 = graph.new_input(false);
+  auto node2 = graph.new_input(false);
+  SbjHandle h1{node1, false};
+  SbjHandle h2{node2, true};
+
+  auto h3 = graph.new_and(h1, h2);
+  auto h4 = graph.new_and(h1, h2);
+
+  EXPECT_NE( h3, h4 );
+  EXPECT_EQ( 2, graph.logic_num() );
+}
+
+TEST(SbjGraphTest, strash_and)
+{
+  SbjGraph graph;
+  graph.set_strash(true);
+
+  EXPECT_TRUE( graph.is_strash() );
+
+  auto node1 = graph.new_input(false);
+  auto node2 = graph.new_input(false);
+  SbjHandle h1{node1, false};
+  SbjHandle h2{node2, true};
+
+  auto h3 = graph.new_and(h1, h2);
+  // 同じ構造
+  auto h4 = graph.new_and(h1, h2);
+  // ファンインの順序が逆
+  auto h5 = graph.new_and(h2, h1);
+  // ファンインの極性が異なる
+  auto h6 = graph.new_and(h1, ~h2);
+
+  EXPECT_EQ( h3, h4 );
+  EXPECT_EQ( h3, h5 );
+  EXPECT_NE( h3, h6 );
+  EXPECT_EQ( 2, graph.logic_num() );
+}
+
+TEST(SbjGraphTest, strash_xor)
+{
+  SbjGraph graph;
+  graph.set_strash(true);
+
+  auto node1 = graph.new_input(false);
+  auto node2 = graph.new_input(false);
+  SbjHandle h1{node1, false};
+  SbjHandle h2{node2, false};
+
+  auto h3 = graph.new_xor(h1, h2);
+  auto h4 = graph.new_xor(~h2, h1);
+  // AND とは区別される．
+  auto h5 = graph.new_and(h1, h2);
+
+  EXPECT_EQ( h3.node(), h4.node() );
+  EXPECT_EQ( ~h3, h4 );
+  EXPECT_NE( h3.node(), h5.node() );
+  EXPECT_EQ( 2, graph.logic_num() );
+}
+
+TEST(SbjGraphTest, strash_many)
+{
+  // 構造ハッシュ表の拡大が正しく行われるか調べる．
+  SbjGraph graph;
+  graph.set_strash(true);
+
+  const SizeType ni = 64;
+  vector<SbjHandle> input_list(ni);
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    input_list[i] = SbjHandle{graph.new_input(false), false};
+  }
+  vector<SbjHandle> and_list;
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    for ( SizeType j = i + 1; j < ni; ++ j ) {
+      and_list.push_back(graph.new_and(input_list[i], input_list[j]));
+    }
+  }
+  SizeType n = and_list.size();
+  EXPECT_EQ( n, graph.logic_num() );
+
+  SizeType k = 0;
+  for ( SizeType i = 0; i < ni; ++ i ) {
+    for ( SizeType j = i + 1; j < ni; ++ j, ++ k ) {
+      auto h = graph.new_and(input_list[j], input_list[i]);
+      EXPECT_EQ( and_list[k], h );
+    }
+  }
+  EXPECT_EQ( n, graph.logic_num() );
+}
+
+TEST(SbjGraphTest, set_strash_after)
+{
+  // 構造ハッシュモードにする前に作られたノードも共有される．
+  SbjGraph graph;
+
+  auto node1 = graph.new_input(false);
+  auto node2 = graph.new_input(false);
+  SbjHandle h1{node1, false};
+  SbjHandle h2{node2, false};
+
+  auto h3 = graph.new_and(h1, h2);
+
+  graph.set_strash(true);
+
+  auto h4 = graph.new_and(h1, h2);
+
+  EXPECT_EQ( h3, h4 );
+  EXPECT_EQ( 1, graph.logic_num() );
+}
+
+END_NAMESPACE_SBJ
@@ -0,0 +1,115 @@
+/// @file SbjMinDepthTest.cc
+/// @brief SbjMinDepthTest の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2022 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "gtest/gtest.h"
+#include "SbjGraph.h"
+#include "SbjHandle.h"
+#include "SbjNode.h"
+
+
+BEGIN_NAMESPACE_SBJ
+
+TEST(SbjMinDepthTest, balanced_tree)
+{
+  // 8入力の平衡 AND 木
+  SbjGraph graph;
+
+  vector<SbjHandle> h_list;
+  for ( SizeType i = 0; i < 8; ++ i ) {
+    auto node = graph.new_input(false);
+    h_list.push_back(SbjHandle{node, false});
+  }
+  while ( h_list.size() > 1 ) {
+    vector<SbjHandle> h_list1;
+    for ( SizeType i = 0; i < h_list.size(); i += 2 ) {
+      h_list1.push_back(graph.new_and(h_list[i], h_list[i + 1]));
+    }
+    h_list.swap(h_list1);
+  }
+  graph.new_output(h_list[0]);
+  auto id = h_list[0].node()->id();
+
+  vector<SizeType> depth_array;
+  EXPECT_EQ( 3, graph.get_min_depth(2, depth_array) );
+  EXPECT_EQ( 3, depth_array[id] );
+
+  EXPECT_EQ( 2, graph.get_min_depth(4, depth_array) );
+  EXPECT_EQ( 2, depth_array[id] );
+
+  EXPECT_EQ( 1, graph.get_min_depth(8, depth_array) );
+  EXPECT_EQ( 1, depth_array[id] );
+}
+
+TEST(SbjMinDepthTest, chain)
+{
+  // ((((a & b) & c) & d) & e) の鎖
+  SbjGraph graph;
+
+  vector<SbjHandle> i_list;
+  for ( SizeType i = 0; i < 5; ++ i ) {
+    auto node = graph.new_input(false);
+    i_list.push_back(SbjHandle{node, false});
+  }
+  vector<SbjHandle> h_list;
+  auto h = i_list[0];
+  for ( SizeType i = 1; i < 5; ++ i ) {
+    h = graph.new_and(h, i_list[i]);
+    h_list.push_back(h);
+  }
+  graph.new_output(h);
+
+  vector<SizeType> depth_array;
+  EXPECT_EQ( 4, graph.get_min_depth(2, depth_array) );
+  for ( SizeType i = 0; i < 4; ++ i ) {
+    EXPECT_EQ( i + 1, depth_array[h_list[i].node()->id()] );
+  }
+
+  // a & b & c を1つの LUT にまとめて残りをもう1つの LUT にする．
+  EXPECT_EQ( 2, graph.get_min_depth(3, depth_array) );
+  EXPECT_EQ( 1, depth_array[h_list[0].node()->id()] );
+  EXPECT_EQ( 1, depth_array[h_list[1].node()->id()] );
+  EXPECT_EQ( 2, depth_array[h_list[2].node()->id()] );
+  EXPECT_EQ( 2, depth_array[h_list[3].node()->id()] );
+
+  EXPECT_EQ( 2, graph.get_min_depth(4, depth_array) );
+  EXPECT_EQ( 1, depth_array[h_list[2].node()->id()] );
+
+  EXPECT_EQ( 1, graph.get_min_depth(5, depth_array) );
+}
+
+TEST(SbjMinDepthTest, reconvergent)
+{
+  // (a & b) ^ (a & c) | (b & c)
+  // a, b, c が再収斂している．
+  SbjGraph graph;
+
+  auto a = graph.new_input(false);
+  auto b = graph.new_input(false);
+  auto c = graph.new_input(false);
+  SbjHandle ha{a, false};
+  SbjHandle hb{b, false};
+  SbjHandle hc{c, false};
+  auto h1 = graph.new_and(ha, hb);
+  auto h2 = graph.new_and(ha, hc);
+  auto h3 = graph.new_xor(h1, h2);
+  auto h4 = graph.new_and(hb, hc);
+  auto h5 = graph.new_and(~h3, ~h4);
+  graph.new_output(~h5);
+  auto id = h5.node()->id();
+
+  vector<SizeType> depth_array;
+  // 2入力だと構造そのままの段数になる．
+  EXPECT_EQ( 3, graph.get_min_depth(2, depth_array) );
+  EXPECT_EQ( 3, depth_array[id] );
+
+  // 3入力なら {a, b, c} を入力とする1つの LUT になる．
+  EXPECT_EQ( 1, graph.get_min_depth(3, depth_array) );
+  EXPECT_EQ( 1, depth_array[id] );
+}
+
+END_NAMESPACE_SBJ